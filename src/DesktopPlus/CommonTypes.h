@@ -11,6 +11,7 @@
 #include <DirectXMath.h>
 #include <string>
 
+#include "Util.h"
 #include "DPRect.h"
 
 #include "PixelShader.h"
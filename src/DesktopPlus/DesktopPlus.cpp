@@ -17,9 +17,12 @@
 #include "DuplicationManager.h"
 #include "OutputManager.h"
 #include "OverlayManager.h"
+#include "OverlayPropertyWriter.h"
 #include "ThreadManager.h"
+#include "TrackedPoseSnapshot.h"
 #include "InterprocessMessaging.h"
 #include "ElevatedMode.h"
+#include "WindowList.h"
 
 // Below are lists of errors expect from Dxgi API calls when a transition event like mode change, PnpStop, PnpStart
 // desktop switch, TDR or session disconnect/reconnect. In all these cases we want the application to clean up the threads that process
@@ -267,6 +270,7 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
 
     //Init WinRT DLL
     DPWinRT_Init();
+    DPWinRT_SetWindowTitleLookup(WindowInfo::FindWindowWithTitle);
 
     THREADMANAGER ThreadMgr;
     OutputManager OutMgr(PauseDuplicationEvent, ResumeDuplicationEvent);
@@ -463,6 +467,11 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
             OutMgr.UpdatePerformanceStates();
         }
 
+        //Apply overlay property writes queued up during this iteration in one go
+        OverlayPropertyWriter::Get().Flush();
+        //Get fresh poses on next use
+        TrackedPoseSnapshot::Get().Invalidate();
+
         // Check if for errors
         if (Ret != DUPL_RETURN_SUCCESS)
         {
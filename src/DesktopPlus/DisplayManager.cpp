@@ -1,6 +1,7 @@
 #include "DisplayManager.h"
 using namespace DirectX;
 
+#include "Util.h"
 #include "DPRect.h"
 
 //
@@ -0,0 +1,103 @@
+#include "GazeFadeBatch.h"
+
+#include <algorithm>
+#include <cmath>
+
+void GazeFadeBatch::Clear()
+{
+    m_OverlayIDs.clear();
+    m_PosX.clear();
+    m_PosY.clear();
+    m_PosZ.clear();
+    m_GazeDistance.clear();
+    m_Rate.clear();
+    m_Alpha.clear();
+}
+
+void GazeFadeBatch::Add(unsigned int overlay_id, const Vector3& overlay_pos, float gaze_distance, float rate)
+{
+    m_OverlayIDs.push_back(overlay_id);
+    m_PosX.push_back(overlay_pos.x);
+    m_PosY.push_back(overlay_pos.y);
+    m_PosZ.push_back(overlay_pos.z);
+    //Distance the gaze point is offset from HMD (useful range 0.25 - 1.0)
+    m_GazeDistance.push_back(gaze_distance);
+    //Rate the fading gets applied when looking off the gaze point (useful range 4.0 - 30, depends on overlay size)
+    m_Rate.push_back(rate * 10.0f);
+}
+
+void GazeFadeBatch::Compute(const Matrix4& mat_hmd)
+{
+    const size_t fade_count = m_OverlayIDs.size();
+    m_Alpha.resize(fade_count);
+
+    const float hmd_x = mat_hmd[12], hmd_y = mat_hmd[13], hmd_z = mat_hmd[14];
+    const float hmd_back_x = mat_hmd[8], hmd_back_y = mat_hmd[9], hmd_back_z = mat_hmd[10];
+
+    const float* pos_x = m_PosX.data();
+    const float* pos_y = m_PosY.data();
+    const float* pos_z = m_PosZ.data();
+    const float* fade_gaze_distance = m_GazeDistance.data();
+    const float* fade_rate = m_Rate.data();
+    float* fade_alpha = m_Alpha.data();
+
+    //No branches or calls in here so this can be vectorized
+    for (size_t k = 0; k < fade_count; ++k)
+    {
+        const float hmd_dx = pos_x[k] - hmd_x;
+        const float hmd_dy = pos_y[k] - hmd_y;
+        const float hmd_dz = pos_z[k] - hmd_z;
+        const float hmd_distance = sqrtf((hmd_dx * hmd_dx) + (hmd_dy * hmd_dy) + (hmd_dz * hmd_dz));
+
+        //Infinite/Auto distance mode matches gaze distance to distance between HMD and overlay
+        //Otherwise, the useful range starts at ~0.20 - 0.25 (lower is in HMD or culled away), so offset the settings value
+        float gaze_distance = (fade_gaze_distance[k] == 0.0f) ? hmd_distance : fade_gaze_distance[k] + 0.20f;
+
+        //Gaze point is in front of the HMD, like OffsetTransformFromSelf(mat_hmd, 0.0f, 0.0f, -gaze_distance)
+        const float gaze_dx = pos_x[k] - (hmd_x - (gaze_distance * hmd_back_x));
+        const float gaze_dy = pos_y[k] - (hmd_y - (gaze_distance * hmd_back_y));
+        const float gaze_dz = pos_z[k] - (hmd_z - (gaze_distance * hmd_back_z));
+        const float distance = sqrtf((gaze_dx * gaze_dx) + (gaze_dy * gaze_dy) + (gaze_dz * gaze_dz));
+
+        gaze_distance = std::min(gaze_distance, 1.0f); //To get useful fading past 1m distance we'll have to limit the value to 1m here for the math below
+
+        //There's nothing smart behind this, just trial and error
+        fade_alpha[k] = std::max(0.0f, std::min((distance * -fade_rate[k]) + ((gaze_distance - 0.1f) * 10.0f), 1.0f));
+    }
+}
+
+size_t GazeFadeBatch::GetCount() const
+{
+    return m_OverlayIDs.size();
+}
+
+unsigned int GazeFadeBatch::GetOverlayID(size_t index) const
+{
+    return m_OverlayIDs[index];
+}
+
+float GazeFadeBatch::GetAlpha(size_t index) const
+{
+    return m_Alpha[index];
+}
+
+float GazeFadeBatch::MapAlphaToOpacityRange(float alpha, float opacity, float gazefade_opacity)
+{
+    const float range_length = opacity - gazefade_opacity;
+
+    if (range_length >= 0.0f)
+    {
+        return (alpha * range_length) + gazefade_opacity;
+    }
+    else //Gaze Fade target opacity higher than overlay opacity, invert behavior
+    {
+        return ((alpha - 1.0f) * range_length) + opacity;
+    }
+}
+
+float GazeFadeBatch::LimitOpacityChange(float opacity_prev, float opacity_target)
+{
+    const float diff = opacity_target - opacity_prev;
+
+    return opacity_prev + std::max(-0.1f, std::min(diff, 0.1f));
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+
+#include "Matrices.h"
+
+//Gaze fade math for all fade-enabled overlays in one pass, used by OutputManager::DetachedOverlayGazeFadeAll()
+//Overlay positions and fade settings are gathered into flat arrays first, then Compute() runs over them against the frame's HMD pose.
+//No OpenVR calls are made in here. Mapping to the opacity range, hover and per-frame change limit are applied by the caller using the static helpers.
+class GazeFadeBatch
+{
+    private:
+        std::vector<unsigned int> m_OverlayIDs;
+        std::vector<float> m_PosX;
+        std::vector<float> m_PosY;
+        std::vector<float> m_PosZ;
+        std::vector<float> m_GazeDistance;
+        std::vector<float> m_Rate;
+        std::vector<float> m_Alpha;
+
+    public:
+        void Clear();
+        //gaze_distance and rate are the raw config values (configid_float_overlay_gazefade_distance/rate), gaze_distance 0 is auto
+        void Add(unsigned int overlay_id, const Vector3& overlay_pos, float gaze_distance, float rate);
+        //Calculates fade alpha (0.0 - 1.0) for every added overlay
+        void Compute(const Matrix4& mat_hmd);
+
+        size_t GetCount() const;
+        unsigned int GetOverlayID(size_t index) const;
+        float GetAlpha(size_t index) const;             //Only valid after Compute()
+
+        //Maps fade alpha to the gazefade_opacity - opacity range, inverted if gazefade_opacity is the higher one
+        static float MapAlphaToOpacityRange(float alpha, float opacity, float gazefade_opacity);
+        //Limits the opacity change per frame to smooth out abrupt changes (i.e. overlay capture took a bit to re-enable or laser pointer forces full alpha)
+        static float LimitOpacityChange(float opacity_prev, float opacity_target);
+};
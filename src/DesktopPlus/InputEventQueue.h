@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+enum InputEventType : unsigned char
+{
+    input_event_mouse_move,         //Absolute move, X and Y in normalized virtual desktop coordinates (0 - 65535)
+    input_event_mouse_wheel,        //Vertical wheel, delta in X (multiples of WHEEL_DELTA)
+    input_event_mouse_hwheel,       //Horizontal wheel, delta in X
+    input_event_mouse_button,       //Code is the virtual key code of the button
+    input_event_key,                //Code is the scancode, or the virtual key code if IsScancode isn't set
+    input_event_unicode             //Code is a UTF-16 code unit
+};
+
+//Platform-neutral input event, translated to the system's event format by InputSimulator when sending
+struct InputEvent
+{
+    InputEventType Type = input_event_key;
+    bool IsDown = false;            //Buttons, keys and unicode events
+    bool IsScancode = false;
+    bool IsExtended = false;        //Extended scancode
+    unsigned short Code = 0;
+    int X = 0;
+    int Y = 0;
+};
+
+//Queue of input waiting to be sent, reducing redundant events as they're added
+//Consecutive absolute mouse moves are reduced to the last one and consecutive wheel events of the same axis have their deltas summed up
+//Also tracks the key state the queued events will result in, as the system's key state doesn't know about them until they're sent
+class InputEventQueue
+{
+    private:
+        std::vector<InputEvent> m_Events;
+        signed char m_KeyState[256];            //0 = not queued, 1 = down, -1 = up
+        bool m_IsMouseMoveQueued;
+
+    public:
+        InputEventQueue() : m_IsMouseMoveQueued(false)
+        {
+            std::fill(std::begin(m_KeyState), std::end(m_KeyState), 0);
+        }
+
+        //Merges with the previous event if both are mouse moves or wheel events of the same axis
+        void Push(const InputEvent& input_event)
+        {
+            if (input_event.Type == input_event_mouse_move)
+            {
+                m_IsMouseMoveQueued = true;
+            }
+
+            if ( (!m_Events.empty()) && (m_Events.back().Type == input_event.Type) )
+            {
+                InputEvent& event_last = m_Events.back();
+
+                //Only the last position of consecutive moves matters
+                if (input_event.Type == input_event_mouse_move)
+                {
+                    event_last.X = input_event.X;
+                    event_last.Y = input_event.Y;
+                    return;
+                }
+
+                //Wheel deltas of the same axis add up
+                if ( (input_event.Type == input_event_mouse_wheel) || (input_event.Type == input_event_mouse_hwheel) )
+                {
+                    event_last.X += input_event.X;
+                    return;
+                }
+            }
+
+            m_Events.push_back(input_event);
+        }
+
+        //Pushes a key or mouse button event and tracks the resulting key state for GetKeyState()
+        void PushKey(unsigned char keycode, const InputEvent& input_event)
+        {
+            Push(input_event);
+            m_KeyState[keycode] = (input_event.IsDown) ? 1 : -1;
+        }
+
+        //Appends events without merging, for keyboard text
+        void Append(const InputEvent* events, size_t count)
+        {
+            m_Events.insert(m_Events.end(), events, events + count);
+        }
+
+        //Makes sure count more events can be appended without reallocating. Grows geometrically, as text can be appended many times before the queue is sent
+        void Reserve(size_t count)
+        {
+            const size_t size_max = m_Events.size() + count;
+
+            if (m_Events.capacity() < size_max)
+            {
+                m_Events.reserve(std::max(size_max, m_Events.capacity() * 2));
+            }
+        }
+
+        //Returns 1 if the queued events leave the key down, -1 if up and 0 if they don't touch it
+        int GetKeyState(unsigned char keycode) const
+        {
+            return m_KeyState[keycode];
+        }
+
+        void SetKeyState(unsigned char keycode, bool down)
+        {
+            m_KeyState[keycode] = (down) ? 1 : -1;
+        }
+
+        bool IsMouseMoveQueued() const
+        {
+            return m_IsMouseMoveQueued;
+        }
+
+        bool IsEmpty() const
+        {
+            return m_Events.empty();
+        }
+
+        const std::vector<InputEvent>& GetEvents() const
+        {
+            return m_Events;
+        }
+
+        //Clears the queue after it was sent. Keeps the capacity
+        void Clear()
+        {
+            m_Events.clear();
+            std::fill(std::begin(m_KeyState), std::end(m_KeyState), 0);
+            m_IsMouseMoveQueued = false;
+        }
+};
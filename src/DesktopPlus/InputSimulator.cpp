@@ -4,45 +4,10 @@
 #include "OutputManager.h"
 #include "Util.h"
 
-void InputSimulator::SetEventForMouseKeyCode(INPUT& input_event, unsigned char keycode, bool down) const
+void InputSimulator::SetEventForKeyCode(InputEvent& input_event, unsigned char keycode, bool down) const
 {
-    input_event.type = INPUT_MOUSE;
-
-    if (down)
-    {
-        switch (keycode)
-        {
-            case VK_LBUTTON:  input_event.mi.dwFlags = MOUSEEVENTF_LEFTDOWN;   break;
-            case VK_RBUTTON:  input_event.mi.dwFlags = MOUSEEVENTF_RIGHTDOWN;  break;
-            case VK_MBUTTON:  input_event.mi.dwFlags = MOUSEEVENTF_MIDDLEDOWN; break;
-            case VK_XBUTTON1: input_event.mi.dwFlags = MOUSEEVENTF_XDOWN;
-                              input_event.mi.mouseData = XBUTTON1;             break;
-            case VK_XBUTTON2: input_event.mi.dwFlags = MOUSEEVENTF_XDOWN;
-                              input_event.mi.mouseData = XBUTTON2;             break;
-            default:          break;
-        }
-    }
-    else
-    {
-        switch (keycode)
-        {
-            case VK_LBUTTON:  input_event.mi.dwFlags = MOUSEEVENTF_LEFTUP;   break;
-            case VK_RBUTTON:  input_event.mi.dwFlags = MOUSEEVENTF_RIGHTUP;  break;
-            case VK_MBUTTON:  input_event.mi.dwFlags = MOUSEEVENTF_MIDDLEUP; break;
-            case VK_XBUTTON1: input_event.mi.dwFlags = MOUSEEVENTF_XUP;
-                              input_event.mi.mouseData = XBUTTON1;           break;
-            case VK_XBUTTON2: input_event.mi.dwFlags = MOUSEEVENTF_XUP;
-                              input_event.mi.mouseData = XBUTTON2;           break;
-            default:          break;
-        }
-    }
-
-
-}
-
-void InputSimulator::SetEventForKeyCode(INPUT& input_event, unsigned char keycode, bool down) const
-{
-    input_event.type = INPUT_KEYBOARD;
+    input_event.Type   = input_event_key;
+    input_event.IsDown = down;
 
     //Use scancodes if possible to increase compatibility (e.g. DirectInput games need scancodes)
     UINT scancode = ::MapVirtualKey(keycode, MAPVK_VK_TO_VSC_EX);
@@ -75,27 +40,149 @@ void InputSimulator::SetEventForKeyCode(INPUT& input_event, unsigned char keycod
             }
         }
 
-        input_event.ki.dwFlags = (is_extended) ? KEYEVENTF_SCANCODE | KEYEVENTF_EXTENDEDKEY : KEYEVENTF_SCANCODE;
-        input_event.ki.wScan   = scancode;
+        input_event.IsScancode = true;
+        input_event.IsExtended = is_extended;
+        input_event.Code       = (unsigned short)scancode;
     }
     else //No scancode, use keycode
     {
-        input_event.ki.dwFlags = 0;
-        input_event.ki.wVk     = keycode;
+        input_event.IsScancode = false;
+        input_event.IsExtended = false;
+        input_event.Code       = keycode;
     }
+}
+
+void InputSimulator::SetINPUTForEvent(INPUT& input, const InputEvent& input_event)
+{
+    input = { 0 };
 
-    if (!down)
+    switch (input_event.Type)
     {
-        input_event.ki.dwFlags |= KEYEVENTF_KEYUP;
+        case input_event_mouse_move:
+        {
+            input.type       = INPUT_MOUSE;
+            input.mi.dx      = input_event.X;
+            input.mi.dy      = input_event.Y;
+            input.mi.dwFlags = MOUSEEVENTF_MOVE | MOUSEEVENTF_VIRTUALDESK | MOUSEEVENTF_ABSOLUTE;
+            break;
+        }
+        case input_event_mouse_wheel:
+        case input_event_mouse_hwheel:
+        {
+            //mouseData is a DWORD, but holds a signed value for wheel events
+            input.type         = INPUT_MOUSE;
+            input.mi.dwFlags   = (input_event.Type == input_event_mouse_wheel) ? MOUSEEVENTF_WHEEL : MOUSEEVENTF_HWHEEL;
+            input.mi.mouseData = (DWORD)input_event.X;
+            break;
+        }
+        case input_event_mouse_button:
+        {
+            input.type = INPUT_MOUSE;
+
+            if (input_event.IsDown)
+            {
+                switch (input_event.Code)
+                {
+                    case VK_LBUTTON:  input.mi.dwFlags = MOUSEEVENTF_LEFTDOWN;   break;
+                    case VK_RBUTTON:  input.mi.dwFlags = MOUSEEVENTF_RIGHTDOWN;  break;
+                    case VK_MBUTTON:  input.mi.dwFlags = MOUSEEVENTF_MIDDLEDOWN; break;
+                    case VK_XBUTTON1: input.mi.dwFlags = MOUSEEVENTF_XDOWN;
+                                      input.mi.mouseData = XBUTTON1;             break;
+                    case VK_XBUTTON2: input.mi.dwFlags = MOUSEEVENTF_XDOWN;
+                                      input.mi.mouseData = XBUTTON2;             break;
+                    default:          break;
+                }
+            }
+            else
+            {
+                switch (input_event.Code)
+                {
+                    case VK_LBUTTON:  input.mi.dwFlags = MOUSEEVENTF_LEFTUP;   break;
+                    case VK_RBUTTON:  input.mi.dwFlags = MOUSEEVENTF_RIGHTUP;  break;
+                    case VK_MBUTTON:  input.mi.dwFlags = MOUSEEVENTF_MIDDLEUP; break;
+                    case VK_XBUTTON1: input.mi.dwFlags = MOUSEEVENTF_XUP;
+                                      input.mi.mouseData = XBUTTON1;           break;
+                    case VK_XBUTTON2: input.mi.dwFlags = MOUSEEVENTF_XUP;
+                                      input.mi.mouseData = XBUTTON2;           break;
+                    default:          break;
+                }
+            }
+            break;
+        }
+        case input_event_key:
+        {
+            input.type = INPUT_KEYBOARD;
+
+            if (input_event.IsScancode)
+            {
+                input.ki.dwFlags = (input_event.IsExtended) ? KEYEVENTF_SCANCODE | KEYEVENTF_EXTENDEDKEY : KEYEVENTF_SCANCODE;
+                input.ki.wScan   = input_event.Code;
+            }
+            else
+            {
+                input.ki.wVk = input_event.Code;
+            }
+
+            if (!input_event.IsDown)
+            {
+                input.ki.dwFlags |= KEYEVENTF_KEYUP;
+            }
+            break;
+        }
+        case input_event_unicode:
+        {
+            input.type       = INPUT_KEYBOARD;
+            input.ki.dwFlags = (input_event.IsDown) ? KEYEVENTF_UNICODE : KEYEVENTF_UNICODE | KEYEVENTF_KEYUP;
+            input.ki.wScan   = input_event.Code;
+            break;
+        }
     }
 }
 
 InputSimulator::InputSimulator() : 
-    m_SpaceMultiplierX(1.0f), m_SpaceMultiplierY(1.0f), m_SpaceOffsetX(0), m_SpaceOffsetY(0), m_ForwardToElevatedModeProcess(false), m_ElevatedModeHasTextQueued(false)
+    m_SpaceMultiplierX(1.0f), m_SpaceMultiplierY(1.0f), m_SpaceOffsetX(0), m_SpaceOffsetY(0), m_TextTableLayout(nullptr), m_IsBatching(false), 
+    m_ForwardToElevatedModeProcess(false), m_ElevatedModeHasTextQueued(false)
 {
     RefreshScreenOffsets();
 }
 
+void InputSimulator::QueueKeyEvent(unsigned char keycode, bool down)
+{
+    InputEvent input_event;
+
+    if ((keycode <= 6) && (keycode != VK_CANCEL)) //Mouse buttons need to be handled differently
+    {
+        input_event.Type   = input_event_mouse_button;
+        input_event.IsDown = down;
+        input_event.Code   = keycode;
+    }
+    else
+    {
+        SetEventForKeyCode(input_event, keycode, down);
+    }
+
+    m_InputQueue.PushKey(keycode, input_event);
+}
+
+void InputSimulator::SendQueueIfNotBatching()
+{
+    if (!m_IsBatching)
+    {
+        Flush();
+    }
+}
+
+bool InputSimulator::IsKeyDown(unsigned char keycode) const
+{
+    //GetAsyncKeyState() doesn't know about queued input yet, so a down and up of the same key within a batch would otherwise get lost
+    const int queued_key_state = m_InputQueue.GetKeyState(keycode);
+
+    if (queued_key_state != 0)
+        return (queued_key_state == 1);
+
+    return (::GetAsyncKeyState(keycode) < 0);    //Most significant bit set, meaning pressed
+}
+
 void InputSimulator::RefreshScreenOffsets()
 {
     if (m_ForwardToElevatedModeProcess)
@@ -118,14 +205,14 @@ void InputSimulator::MouseMove(int x, int y)
         return;
     }
 
-    INPUT input_event = { 0 };
+    InputEvent input_event;
 
-    input_event.type = INPUT_MOUSE;
-    input_event.mi.dx = (x + m_SpaceOffsetX) * m_SpaceMultiplierX;
-    input_event.mi.dy = (y + m_SpaceOffsetY) * m_SpaceMultiplierY;
-    input_event.mi.dwFlags = MOUSEEVENTF_MOVE | MOUSEEVENTF_VIRTUALDESK | MOUSEEVENTF_ABSOLUTE;
+    input_event.Type = input_event_mouse_move;
+    input_event.X    = (x + m_SpaceOffsetX) * m_SpaceMultiplierX;
+    input_event.Y    = (y + m_SpaceOffsetY) * m_SpaceMultiplierY;
     
-    ::SendInput(1, &input_event, sizeof(INPUT));
+    m_InputQueue.Push(input_event);
+    SendQueueIfNotBatching();
 }
 
 void InputSimulator::MouseSetLeftDown(bool down)
@@ -145,24 +232,24 @@ void InputSimulator::MouseSetMiddleDown(bool down)
 
 void InputSimulator::MouseWheelHorizontal(float delta)
 {
-    INPUT input_event = { 0 };
+    InputEvent input_event;
 
-    input_event.type = INPUT_MOUSE;
-    input_event.mi.dwFlags = MOUSEEVENTF_HWHEEL;
-    input_event.mi.mouseData = WHEEL_DELTA * delta;
+    input_event.Type = input_event_mouse_hwheel;
+    input_event.X    = (int)(WHEEL_DELTA * delta);
 
-    ::SendInput(1, &input_event, sizeof(INPUT));
+    m_InputQueue.Push(input_event);
+    SendQueueIfNotBatching();
 }
 
 void InputSimulator::MouseWheelVertical(float delta)
 {
-    INPUT input_event = { 0 };
+    InputEvent input_event;
 
-    input_event.type = INPUT_MOUSE;
-    input_event.mi.dwFlags = MOUSEEVENTF_WHEEL;
-    input_event.mi.mouseData = WHEEL_DELTA * delta;
+    input_event.Type = input_event_mouse_wheel;
+    input_event.X    = (int)(WHEEL_DELTA * delta);
 
-    ::SendInput(1, &input_event, sizeof(INPUT));
+    m_InputQueue.Push(input_event);
+    SendQueueIfNotBatching();
 }
 
 void InputSimulator::KeyboardSetDown(unsigned char keycode)
@@ -185,21 +272,11 @@ void InputSimulator::KeyboardSetDown(unsigned char keycode)
         keycode = (keycode == VK_LBUTTON) ? VK_RBUTTON : VK_LBUTTON;
     }
 
-    INPUT input_event = { 0 };
-
-    if (GetAsyncKeyState(keycode) < 0)  //Only send if not already pressed
+    if (IsKeyDown(keycode))  //Only send if not already pressed
         return;
 
-    if ((keycode <= 6) && (keycode != VK_CANCEL)) //Mouse buttons need to be handled differently
-    {
-        SetEventForMouseKeyCode(input_event, keycode, true);
-    }
-    else
-    {
-        SetEventForKeyCode(input_event, keycode, true);
-    }
-
-    ::SendInput(1, &input_event, sizeof(INPUT));
+    QueueKeyEvent(keycode, true);
+    SendQueueIfNotBatching();
 }
 
 void InputSimulator::KeyboardSetUp(unsigned char keycode)
@@ -222,21 +299,11 @@ void InputSimulator::KeyboardSetUp(unsigned char keycode)
         keycode = (keycode == VK_LBUTTON) ? VK_RBUTTON : VK_LBUTTON;
     }
 
-    INPUT input_event = { 0 };
-
-    if (GetAsyncKeyState(keycode) >= 0) //Only send if already down
+    if (!IsKeyDown(keycode)) //Only send if already down
         return;
 
-    if ((keycode <= 6) && (keycode != VK_CANCEL)) //Mouse buttons need to be handled differently
-    {
-        SetEventForMouseKeyCode(input_event, keycode, false);
-    }
-    else
-    {
-        SetEventForKeyCode(input_event, keycode, false);
-    }
-
-    ::SendInput(1, &input_event, sizeof(INPUT));
+    QueueKeyEvent(keycode, false);
+    SendQueueIfNotBatching();
 }
 
 //Why so awfully specific, seems wasteful? Spamming the key events separately can confuse applications sometimes and we want to make sure the keys are really pressed at once
@@ -251,30 +318,15 @@ void InputSimulator::KeyboardSetDown(unsigned char keycodes[3])
         return;
     }
 
-    INPUT input_event[3] = { 0 };
-
-    int used_event_count = 0;
     for (int i = 0; i < 3; ++i)
     {
-        if ( (keycodes[i] == 0) || (GetAsyncKeyState(keycodes[i]) < 0) )  //Most significant bit set, meaning pressed
+        if ( (keycodes[i] == 0) || (IsKeyDown(keycodes[i])) )
             continue; //Nothing to be done, skip
 
-        if ((keycodes[i] <= 6) && (keycodes[i] != VK_CANCEL)) //Mouse buttons need to be handled differently
-        {
-            SetEventForMouseKeyCode(input_event[used_event_count], keycodes[i], true);
-        }
-        else
-        {
-            SetEventForKeyCode(input_event[used_event_count], keycodes[i], true);
-        }
-
-        used_event_count++;
+        QueueKeyEvent(keycodes[i], true);
     }
 
-    if (used_event_count != 0)
-    {
-        ::SendInput(used_event_count, input_event, sizeof(INPUT));
-    }
+    SendQueueIfNotBatching();
 }
 
 void InputSimulator::KeyboardSetUp(unsigned char keycodes[3])
@@ -288,30 +340,15 @@ void InputSimulator::KeyboardSetUp(unsigned char keycodes[3])
         return;
     }
 
-    INPUT input_event[3] = { 0 };
-
-    int used_event_count = 0;
     for (int i = 0; i < 3; ++i)
     {
-        if ( (keycodes[i] == 0) || (GetAsyncKeyState(keycodes[i]) > 0) )    //Most significant bit not set, meaning not pressed
+        if ( (keycodes[i] == 0) || (!IsKeyDown(keycodes[i])) )
             continue; //Nothing to be done, skip
 
-        if ((keycodes[i] <= 6) && (keycodes[i] != VK_CANCEL)) //Mouse buttons need to be handled differently
-        {
-            SetEventForMouseKeyCode(input_event[used_event_count], keycodes[i], false);
-        }
-        else
-        {
-            SetEventForKeyCode(input_event[used_event_count], keycodes[i], false);
-        }
-
-        used_event_count++;
+        QueueKeyEvent(keycodes[i], false);
     }
 
-    if (used_event_count != 0)
-    {
-        ::SendInput(used_event_count, input_event, sizeof(INPUT));
-    }
+    SendQueueIfNotBatching();
 }
 
 void InputSimulator::KeyboardToggleState(unsigned char keycode)
@@ -329,7 +366,7 @@ void InputSimulator::KeyboardToggleState(unsigned char keycode)
         return;
     }
 
-    if (GetAsyncKeyState(keycode) < 0)  //If already pressed, release key
+    if (IsKeyDown(keycode))  //If already pressed, release key
     {
         KeyboardSetUp(keycode);
     }
@@ -350,32 +387,15 @@ void InputSimulator::KeyboardToggleState(unsigned char keycodes[3])
         return;
     }
 
-    INPUT input_event[3] = { 0 };
-
-    int used_event_count = 0;
     for (int i = 0; i < 3; ++i)
     {
         if (keycodes[i] == 0)
             continue; //Nothing to be done, skip
 
-        bool already_down = (GetAsyncKeyState(keycodes[i]) < 0);    //Most significant bit set, meaning pressed
-
-        if ((keycodes[i] <= 6) && (keycodes[i] != VK_CANCEL)) //Mouse buttons need to be handled differently
-        {
-            SetEventForMouseKeyCode(input_event[used_event_count], keycodes[i], !already_down);
-        }
-        else
-        {
-            SetEventForKeyCode(input_event[used_event_count], keycodes[i], !already_down);
-        }
-
-        used_event_count++;
+        QueueKeyEvent(keycodes[i], !IsKeyDown(keycodes[i]));
     }
 
-    if (used_event_count != 0)
-    {
-        ::SendInput(used_event_count, input_event, sizeof(INPUT));
-    }
+    SendQueueIfNotBatching();
 }
 
 void InputSimulator::KeyboardPressAndRelease(unsigned char keycode)
@@ -389,31 +409,70 @@ void InputSimulator::KeyboardPressAndRelease(unsigned char keycode)
     if (keycode == 0)
         return;
 
-    INPUT input_event[2] = { 0 };
+    if (!IsKeyDown(keycode))  //Only send down event if not already pressed
+    {
+        QueueKeyEvent(keycode, true);
+    }
 
-    bool already_down = (GetAsyncKeyState(keycode) < 0);    //Most significant bit set, meaning pressed
-    int upid = 1 - already_down;
+    QueueKeyEvent(keycode, false);
+    SendQueueIfNotBatching();
+}
 
-    if ((keycode <= 6) && (keycode != VK_CANCEL)) //Mouse buttons need to be handled differently
+void InputSimulator::RefreshTextTable()
+{
+    //Same as KeyboardText() used to do per character, but only once per keyboard layout
+    //At least 0-9 & A-Z are simulated as proper key events in order to trigger shortcuts and non-text events in applications. Everything else is a unicode event
+    m_TextTranslator.ResetTable();
+    m_TextTableLayout = ::GetKeyboardLayout(0);
+
+    for (unsigned char c = 0; c < 128; ++c)
     {
-        if (!already_down)  //Only send down event if not already pressed
+        InputEvent events[KeyboardTextTranslator::k_TableSlotsPerChar];
+        unsigned char vkey = 0;
+        bool use_shift = false;
+
+        if (c == '\b')                                        //Backspace, needs special handling
         {
-            SetEventForMouseKeyCode(input_event[0], keycode, true);
+            vkey = VK_BACK;
         }
-
-        SetEventForMouseKeyCode(input_event[upid], keycode, false);
-    }
-    else
-    {
-        if (!already_down)  //Only send down event if not already pressed
+        else if (c == '\n')                                   //Enter, needs special handling
         {
-            SetEventForKeyCode(input_event[0], keycode, true);
+            vkey = VK_RETURN;
+        }
+        else if ( ((c >= '0') && (c <= '9')) || (c == ' ') )  //0 - 9 and space
+        {
+            vkey = c;
+        }
+        else if ((c >= 'a') && (c <= 'z'))                    //a - z
+        {
+            vkey = c - ('a' - 'A');
+        }
+        else if ((c >= 'A') && (c <= 'Z'))                    //A - Z, with shift
+        {
+            vkey = c;
+            use_shift = true;
         }
 
-        SetEventForKeyCode(input_event[upid], keycode, false);
-    }
+        if (vkey != 0)
+        {
+            int event_count = 0;
+
+            if (use_shift)
+            {
+                SetEventForKeyCode(events[event_count++], VK_SHIFT, true);
+            }
+
+            SetEventForKeyCode(events[event_count++], vkey, true);
+            SetEventForKeyCode(events[event_count++], vkey, false);
 
-    ::SendInput(upid + 1, input_event, sizeof(INPUT));
+            if (use_shift)
+            {
+                SetEventForKeyCode(events[event_count++], VK_SHIFT, false);
+            }
+
+            m_TextTranslator.SetCharEvents(c, events, event_count);
+        }
+    }
 }
 
 void InputSimulator::KeyboardText(const char* str_utf8, bool always_use_unicode_event)
@@ -431,104 +490,41 @@ void InputSimulator::KeyboardText(const char* str_utf8, bool always_use_unicode_
         return;
     }
 
-    //Convert to UTF16
-    std::wstring wstr = WStringConvertFromUTF8(str_utf8);
+    const size_t str_length = strlen(str_utf8);
 
-    INPUT input_event = { 0 };
-    input_event.type = INPUT_KEYBOARD;
+    //Plus 3 for the state reset
+    m_InputQueue.Reserve(KeyboardTextTranslator::GetEventCountMax(str_length) + 3);
 
-    if (!always_use_unicode_event)
+    if (always_use_unicode_event)
     {
-        //This function could just use KEYEVENTF_UNICODE on all printable characters to get working text input (we still do that for type string actions though)
-        //However, in order to trigger shortcuts and non-text events in applications, at least 0-9 & A-Z are simulated as proper key events
-        //For consistent handling, capslock and shift are reset at the start, but that shouldn't be an issue in practice
-
-        if ((::GetKeyState(VK_CAPITAL) & 0x0001) != 0) //Turn off capslock if it's on
-        {
-            SetEventForKeyCode(input_event, VK_CAPITAL, true);
-            m_KeyboardTextQueue.push_back(input_event);
-
-            SetEventForKeyCode(input_event, VK_CAPITAL, false);
-            m_KeyboardTextQueue.push_back(input_event);
-        }
-
-        if (::GetAsyncKeyState(VK_SHIFT) < 0) //Release shift if it's down
-        {
-            SetEventForKeyCode(input_event, VK_SHIFT, false);
-            m_KeyboardTextQueue.push_back(input_event);
-        }
-
-        for (wchar_t current_char: wstr)
-        {
-            if (current_char == '\b')   //Backspace, needs special handling
-            {
-                SetEventForKeyCode(input_event, VK_BACK, true);
-                m_KeyboardTextQueue.push_back(input_event);
-
-                SetEventForKeyCode(input_event, VK_BACK, false);
-                m_KeyboardTextQueue.push_back(input_event);
-            }
-            else if (current_char == '\n')  //Enter, needs special handling
-            {
-                SetEventForKeyCode(input_event, VK_RETURN, true);
-                m_KeyboardTextQueue.push_back(input_event);
-
-                SetEventForKeyCode(input_event, VK_RETURN, false);
-                m_KeyboardTextQueue.push_back(input_event);
-            }
-            else if ( ((current_char >= '0') && (current_char <= '9')) || (current_char == ' ') ) //0 - 9 and space, simulate keydown/up                          
-            {
-                SetEventForKeyCode(input_event, current_char, true);
-                m_KeyboardTextQueue.push_back(input_event);
-
-                SetEventForKeyCode(input_event, current_char, false);
-                m_KeyboardTextQueue.push_back(input_event);
-            }
-            else if ((current_char >= 'a') && (current_char <= 'z')) //a - z, simulate keydown/up  
-            {
-                SetEventForKeyCode(input_event, current_char - ('a' - 'A'), true);
-                m_KeyboardTextQueue.push_back(input_event);
-
-                SetEventForKeyCode(input_event, current_char - ('a' - 'A'), false);
-                m_KeyboardTextQueue.push_back(input_event);
-            }
-            else if ((current_char >= 'A') && (current_char <= 'Z')) //A - Z, simulate keydown/up  
-            {
-                SetEventForKeyCode(input_event, VK_SHIFT, true);
-                m_KeyboardTextQueue.push_back(input_event);
+        KeyboardTextTranslator::TranslateUnicode(str_utf8, str_length, m_InputQueue);
+        return;
+    }
 
-                SetEventForKeyCode(input_event, current_char, true);
-                m_KeyboardTextQueue.push_back(input_event);
+    if ( (!m_TextTranslator.HasTable()) || (m_TextTableLayout != ::GetKeyboardLayout(0)) )
+    {
+        RefreshTextTable();
+    }
 
-                SetEventForKeyCode(input_event, current_char, false);
-                m_KeyboardTextQueue.push_back(input_event);
+    //For consistent handling, capslock and shift are reset at the start, but that shouldn't be an issue in practice
+    InputEvent input_event;
 
-                SetEventForKeyCode(input_event, VK_SHIFT, false);
-                m_KeyboardTextQueue.push_back(input_event);
-            }
-            else
-            {
-                input_event.ki.dwFlags = KEYEVENTF_UNICODE;
-                input_event.ki.wScan = current_char;
-                m_KeyboardTextQueue.push_back(input_event);
+    if ((::GetKeyState(VK_CAPITAL) & 0x0001) != 0) //Turn off capslock if it's on
+    {
+        SetEventForKeyCode(input_event, VK_CAPITAL, true);
+        m_InputQueue.Push(input_event);
 
-                input_event.ki.dwFlags = KEYEVENTF_UNICODE | KEYEVENTF_KEYUP;
-                m_KeyboardTextQueue.push_back(input_event);
-            }
-        }
+        SetEventForKeyCode(input_event, VK_CAPITAL, false);
+        m_InputQueue.Push(input_event);
     }
-    else
-    {
-        for (wchar_t current_char: wstr)
-        {
-            input_event.ki.dwFlags = KEYEVENTF_UNICODE;
-            input_event.ki.wScan = current_char;
-            m_KeyboardTextQueue.push_back(input_event);
 
-            input_event.ki.dwFlags = KEYEVENTF_UNICODE | KEYEVENTF_KEYUP;
-            m_KeyboardTextQueue.push_back(input_event);
-        }
+    if (IsKeyDown(VK_SHIFT)) //Release shift if it's down
+    {
+        SetEventForKeyCode(input_event, VK_SHIFT, false);
+        m_InputQueue.PushKey(VK_SHIFT, input_event);
     }
+
+    m_TextTranslator.Translate(str_utf8, str_length, m_InputQueue);
 }
 
 void InputSimulator::KeyboardTextFinish()
@@ -544,12 +540,41 @@ void InputSimulator::KeyboardTextFinish()
         return;
     }
 
-    if (!m_KeyboardTextQueue.empty())
+    SendQueueIfNotBatching();
+}
+
+void InputSimulator::BatchBegin()
+{
+    m_IsBatching = true;
+}
+
+void InputSimulator::BatchEnd()
+{
+    m_IsBatching = false;
+    Flush();
+}
+
+void InputSimulator::Flush()
+{
+    if (!m_InputQueue.IsEmpty())
     {
-        ::SendInput(m_KeyboardTextQueue.size(), m_KeyboardTextQueue.data(), sizeof(INPUT));
+        const std::vector<InputEvent>& events = m_InputQueue.GetEvents();
+        m_InputBuffer.resize(events.size());
 
-        m_KeyboardTextQueue.clear();
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            SetINPUTForEvent(m_InputBuffer[i], events[i]);
+        }
+
+        ::SendInput((UINT)m_InputBuffer.size(), m_InputBuffer.data(), sizeof(INPUT));
     }
+
+    m_InputQueue.Clear();
+}
+
+bool InputSimulator::IsMouseMoveQueued() const
+{
+    return m_InputQueue.IsMouseMoveQueued();
 }
 
 void InputSimulator::SetElevatedModeForwardingActive(bool do_forward)
@@ -6,6 +6,9 @@
 #include <vector>
 #include <windows.h>
 
+#include "InputEventQueue.h"
+#include "KeyboardTextTranslator.h"
+
 //Dashboard_Back exists, but not doesn't map to "Go Back" ...okay!
 #define Button_Dashboard_GoHome vr::k_EButton_IndexController_A
 #define Button_Dashboard_GoBack vr::k_EButton_IndexController_B
@@ -18,12 +21,22 @@ class InputSimulator
         int m_SpaceOffsetX;
         int m_SpaceOffsetY;
 
-        std::vector<INPUT> m_KeyboardTextQueue;
+        InputEventQueue m_InputQueue;           //Input waiting to be sent. Also holds keyboard text until KeyboardTextFinish()
+        std::vector<INPUT> m_InputBuffer;       //m_InputQueue translated for SendInput(), kept around to not reallocate every time
+        KeyboardTextTranslator m_TextTranslator;
+        HKL m_TextTableLayout;                  //Keyboard layout m_TextTranslator's table was built for, as scancodes depend on it
+        bool m_IsBatching;
         bool m_ForwardToElevatedModeProcess;
         bool m_ElevatedModeHasTextQueued;
 
-        void SetEventForMouseKeyCode(INPUT& input_event, unsigned char keycode, bool down) const;
-        void SetEventForKeyCode(INPUT& input_event, unsigned char keycode, bool down) const;
+        void SetEventForKeyCode(InputEvent& input_event, unsigned char keycode, bool down) const;
+        static void SetINPUTForEvent(INPUT& input, const InputEvent& input_event);
+
+        void RefreshTextTable();
+
+        void QueueKeyEvent(unsigned char keycode, bool down);       //Also tracks the key state for IsKeyDown()
+        void SendQueueIfNotBatching();
+        bool IsKeyDown(unsigned char keycode) const;                //GetAsyncKeyState(), but taking queued input into account
 
     public:
         InputSimulator();
@@ -45,6 +58,14 @@ class InputSimulator
         void KeyboardText(const char* str_utf8, bool always_use_unicode_event = false);
         void KeyboardTextFinish();
 
+        //Input is queued between BatchBegin() and BatchEnd() and sent in a single SendInput() call at the end, keeping the order of events
+        //Consecutive absolute mouse moves are reduced to the last one and consecutive wheel events have their deltas summed up
+        //Outside of a batch, input is sent right away
+        void BatchBegin();
+        void BatchEnd();
+        void Flush();               //Sends queued input immediately, even during a batch. For when the input needs to be seen by the system before continuing
+        bool IsMouseMoveQueued() const;
+
         void SetElevatedModeForwardingActive(bool do_forward);
 };
 
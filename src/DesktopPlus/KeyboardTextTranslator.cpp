@@ -0,0 +1,145 @@
+#include "KeyboardTextTranslator.h"
+
+#include <algorithm>
+
+#include "UTF8Decode.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+    #define KEYBOARDTEXTTRANSLATOR_USE_SSE
+    #include <emmintrin.h>
+#endif
+
+KeyboardTextTranslator::KeyboardTextTranslator()
+{
+    std::fill(std::begin(m_TableEventCount), std::end(m_TableEventCount), 0);
+}
+
+void KeyboardTextTranslator::ResetTable()
+{
+    m_Table.assign(128 * k_TableSlotsPerChar, InputEvent());
+
+    for (unsigned char c = 0; c < 128; ++c)
+    {
+        InputEvent* events = &m_Table[c * k_TableSlotsPerChar];
+
+        events[0].Type   = input_event_unicode;
+        events[0].IsDown = true;
+        events[0].Code   = c;
+        events[1]        = events[0];
+        events[1].IsDown = false;
+
+        m_TableEventCount[c] = 2;
+    }
+}
+
+void KeyboardTextTranslator::SetCharEvents(unsigned char c, const InputEvent* events, int event_count)
+{
+    if ( (c >= 128) || (event_count > k_TableSlotsPerChar) || (m_Table.empty()) )
+        return;
+
+    std::copy(events, events + event_count, &m_Table[c * k_TableSlotsPerChar]);
+    m_TableEventCount[c] = (unsigned char)event_count;
+}
+
+bool KeyboardTextTranslator::HasTable() const
+{
+    return !m_Table.empty();
+}
+
+void KeyboardTextTranslator::AppendChar(unsigned char c, InputEventQueue& queue) const
+{
+    queue.Append(&m_Table[c * k_TableSlotsPerChar], m_TableEventCount[c]);
+}
+
+void KeyboardTextTranslator::Translate(const char* str_utf8, size_t length, InputEventQueue& queue) const
+{
+    const unsigned char* str     = (const unsigned char*)str_utf8;
+    const unsigned char* str_end = str + length;
+
+    while (str != str_end)
+    {
+        #ifdef KEYBOARDTEXTTRANSLATOR_USE_SSE
+            //Skip through runs of ASCII 16 bytes at a time, with no decoding needed
+            while ( (str_end - str >= 16) && (_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)str)) == 0) )
+            {
+                for (const unsigned char* str_block_end = str + 16; str != str_block_end; ++str)
+                {
+                    AppendChar(*str, queue);
+                }
+            }
+
+            if (str == str_end)
+                break;
+        #endif
+
+        if (*str < 0x80)
+        {
+            AppendChar(*str, queue);
+            ++str;
+            continue;
+        }
+
+        AppendUnicodeChar(DecodeUTF8(str, str_end), queue);
+    }
+}
+
+void KeyboardTextTranslator::TranslateScalar(const char* str_utf8, size_t length, InputEventQueue& queue) const
+{
+    const unsigned char* str     = (const unsigned char*)str_utf8;
+    const unsigned char* str_end = str + length;
+
+    while (str != str_end)
+    {
+        if (*str < 0x80)
+        {
+            AppendChar(*str, queue);
+            ++str;
+            continue;
+        }
+
+        AppendUnicodeChar(DecodeUTF8(str, str_end), queue);
+    }
+}
+
+void KeyboardTextTranslator::TranslateUnicode(const char* str_utf8, size_t length, InputEventQueue& queue)
+{
+    const unsigned char* str     = (const unsigned char*)str_utf8;
+    const unsigned char* str_end = str + length;
+
+    while (str != str_end)
+    {
+        AppendUnicodeChar(DecodeUTF8(str, str_end), queue);
+    }
+}
+
+void KeyboardTextTranslator::AppendUnicodeChar(uint32_t codepoint, InputEventQueue& queue)
+{
+    InputEvent events[4];
+
+    for (int i = 0; i < 4; ++i)
+    {
+        events[i].Type   = input_event_unicode;
+        events[i].IsDown = ((i % 2) == 0);
+    }
+
+    if (codepoint >= 0x10000)   //Surrogate pair
+    {
+        codepoint -= 0x10000;
+        events[0].Code = events[1].Code = (unsigned short)(0xD800 + (codepoint >> 10));
+        events[2].Code = events[3].Code = (unsigned short)(0xDC00 + (codepoint & 0x3FF));
+
+        queue.Append(events, 4);
+    }
+    else
+    {
+        events[0].Code = events[1].Code = (unsigned short)codepoint;
+
+        queue.Append(events, 2);
+    }
+}
+
+size_t KeyboardTextTranslator::GetEventCountMax(size_t length)
+{
+    //Shifted ASCII letters, or a 4-byte sequence resulting in a surrogate pair of 2 events each
+    return length * 4;
+}
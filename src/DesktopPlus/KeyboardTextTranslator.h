@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+#include "InputEventQueue.h"
+
+//Translates UTF-8 text into key events for InputSimulator::KeyboardText(), kept free of Windows headers
+//ASCII characters are looked up in a table of precomputed events, filled in by InputSimulator for the current keyboard layout.
+//Everything else is sent as unicode events, with characters outside the BMP as surrogate pairs
+class KeyboardTextTranslator
+{
+    public:
+        static const int k_TableSlotsPerChar = 4;
+
+    private:
+        std::vector<InputEvent> m_Table;        //k_TableSlotsPerChar slots per ASCII character
+        unsigned char m_TableEventCount[128];
+
+        void AppendChar(unsigned char c, InputEventQueue& queue) const;
+
+    public:
+        KeyboardTextTranslator();
+
+        //Sets all characters to unicode events, to be overridden by SetCharEvents() where key events are wanted
+        void ResetTable();
+        void SetCharEvents(unsigned char c, const InputEvent* events, int event_count);     //event_count is at most k_TableSlotsPerChar
+        bool HasTable() const;
+
+        //Appends the events for the text to the queue. The table has to be set up. Runs of ASCII are skipped through 16 bytes at a time with SSE2 if available
+        void Translate(const char* str_utf8, size_t length, InputEventQueue& queue) const;
+        //Same as Translate() without SIMD, for reference
+        void TranslateScalar(const char* str_utf8, size_t length, InputEventQueue& queue) const;
+        //Appends unicode events for everything, doesn't need the table
+        static void TranslateUnicode(const char* str_utf8, size_t length, InputEventQueue& queue);
+
+        //Appends a down and up unicode event for the codepoint, as surrogate pair if needed
+        static void AppendUnicodeChar(uint32_t codepoint, InputEventQueue& queue);
+        //Events needed for the text in the worst case, for InputEventQueue::Reserve()
+        static size_t GetEventCountMax(size_t length);
+};
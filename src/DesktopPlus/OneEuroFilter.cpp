@@ -0,0 +1,96 @@
+#include "OneEuroFilter.h"
+
+#include <cmath>
+
+static const float k_fPi = 3.14159265f;
+
+OneEuroFilter::OneEuroFilter(float min_cutoff, float beta, float derivative_cutoff) : m_MinCutoff(min_cutoff),
+                                                                                      m_Beta(beta),
+                                                                                      m_DerivativeCutoff(derivative_cutoff),
+                                                                                      m_PredictionTime(0.0f),
+                                                                                      m_HasPrevious(false),
+                                                                                      m_TimePrevious(0.0),
+                                                                                      m_ValuePrevious(0.0f),
+                                                                                      m_DerivativePrevious(0.0f)
+{
+}
+
+float OneEuroFilter::SmoothingFactor(float time_delta, float cutoff)
+{
+    const float tau = 1.0f / (2.0f * k_fPi * cutoff);
+    return 1.0f / (1.0f + (tau / time_delta));
+}
+
+void OneEuroFilter::SetParameters(float min_cutoff, float beta, float derivative_cutoff)
+{
+    m_MinCutoff        = min_cutoff;
+    m_Beta             = beta;
+    m_DerivativeCutoff = derivative_cutoff;
+}
+
+void OneEuroFilter::SetPredictionTime(float seconds)
+{
+    m_PredictionTime = seconds;
+}
+
+float OneEuroFilter::Filter(float value, double time)
+{
+    const float time_delta = float(time - m_TimePrevious);
+
+    //Duplicate timestamp, nothing new to filter. Return the previous output instead of letting the unfiltered sample through
+    if ( (m_HasPrevious) && (time_delta == 0.0f) && (m_MinCutoff > 0.0f) )
+    {
+        return m_ValuePrevious + (m_DerivativePrevious * m_PredictionTime);
+    }
+
+    //Nothing to go on for the first value, and a negative time delta would break the math
+    if ( (!m_HasPrevious) || (time_delta <= 0.0f) || (m_MinCutoff <= 0.0f) )
+    {
+        if ( (!m_HasPrevious) || (time_delta < 0.0f) )
+        {
+            m_DerivativePrevious = 0.0f;
+        }
+
+        m_HasPrevious   = true;
+        m_TimePrevious  = time;
+        m_ValuePrevious = value;
+
+        return value;
+    }
+
+    //Speed estimate, low-pass filtered with a fixed cutoff
+    const float derivative = (value - m_ValuePrevious) / time_delta;
+    const float alpha_derivative = SmoothingFactor(time_delta, m_DerivativeCutoff);
+    m_DerivativePrevious += alpha_derivative * (derivative - m_DerivativePrevious);
+
+    //Value, low-pass filtered with a cutoff depending on the speed
+    const float cutoff = m_MinCutoff + (m_Beta * fabs(m_DerivativePrevious));
+    const float alpha  = SmoothingFactor(time_delta, cutoff);
+    m_ValuePrevious += alpha * (value - m_ValuePrevious);
+    m_TimePrevious   = time;
+
+    return m_ValuePrevious + (m_DerivativePrevious * m_PredictionTime);
+}
+
+void OneEuroFilter::Reset()
+{
+    m_HasPrevious        = false;
+    m_TimePrevious       = 0.0;
+    m_ValuePrevious      = 0.0f;
+    m_DerivativePrevious = 0.0f;
+}
+
+bool OneEuroFilter::HasPrevious() const
+{
+    return m_HasPrevious;
+}
+
+double OneEuroFilter::GetTimePrevious() const
+{
+    return m_TimePrevious;
+}
+
+float OneEuroFilter::GetVelocity() const
+{
+    return m_DerivativePrevious;
+}
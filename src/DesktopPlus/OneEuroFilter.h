@@ -0,0 +1,36 @@
+#pragma once
+
+//One Euro filter (Casiez et al. 2012) for noisy, low-latency input signals
+//This is a low-pass filter with a cutoff frequency that rises with the signal's speed. Slow movements are smoothed heavily to remove jitter,
+//while fast movements pass through with little lag. The filtered speed can optionally be used to predict the value a bit ahead.
+//Pure component without any OpenVR or Windows dependencies. One instance filters one scalar, use one per axis for vectors.
+class OneEuroFilter
+{
+    private:
+        float m_MinCutoff;          //Hz, cutoff at zero speed
+        float m_Beta;               //Cutoff increase per unit/second of speed
+        float m_DerivativeCutoff;   //Hz, cutoff for the speed estimate
+        float m_PredictionTime;     //Seconds
+
+        bool m_HasPrevious;
+        double m_TimePrevious;
+        float m_ValuePrevious;
+        float m_DerivativePrevious;
+
+        static float SmoothingFactor(float time_delta, float cutoff);
+
+    public:
+        OneEuroFilter(float min_cutoff = 1.0f, float beta = 0.0f, float derivative_cutoff = 1.0f);
+
+        void SetParameters(float min_cutoff, float beta, float derivative_cutoff);
+        void SetPredictionTime(float seconds);
+
+        //Returns the filtered value. time is in seconds and must not go backwards. The first value after a reset is passed through
+        //A value with the same time as the previous one is ignored and the previous filtered value returned
+        float Filter(float value, double time);
+        void Reset();
+
+        bool HasPrevious() const;
+        double GetTimePrevious() const;
+        float GetVelocity() const;  //Filtered speed in units/second. Taken against the previous filtered value like in the paper, so it includes the filter lag
+};
@@ -8,8 +8,13 @@ using namespace DirectX;
 
 #include <limits.h>
 #include <time.h>
+#include <algorithm>
 
 #include "OverlayManager.h"
+#include "OverlayPropertyWriter.h"
+#include "OverlayRaycaster.h"
+#include "GazeFadeBatch.h"
+#include "TrackedPoseSnapshot.h"
 #include "WindowManager.h"
 #include "Util.h"
 
@@ -84,6 +89,7 @@ OutputManager::OutputManager(HANDLE PauseDuplicationEvent, HANDLE ResumeDuplicat
     m_MouseDefaultHotspotX(0),
     m_MouseDefaultHotspotY(0),
     m_MouseIgnoreMoveEventMissCount(0),
+    m_MouseLaserPointerFilterOverlayID(k_ulOverlayID_None),
     m_IsFirstLaunch(false),
     m_ComInitDone(false),
     m_DragModeDeviceID(-1),
@@ -94,6 +100,7 @@ OutputManager::OutputManager(HANDLE PauseDuplicationEvent, HANDLE ResumeDuplicat
     m_DragGestureScaleDistanceLast(0.0f),
     m_DashboardActivatedOnce(false),
     m_DashboardHMD_Y(-100.0f),
+    m_OriginCache(ovrl_origin_MAX),
     m_MultiGPUTargetDevice(nullptr),
     m_MultiGPUTargetDeviceContext(nullptr),
     m_MultiGPUTexStaging(nullptr),
@@ -279,6 +286,8 @@ void OutputManager::CleanRefs()
         m_MultiGPUTexTarget->Release();
         m_MultiGPUTexTarget = nullptr;
     }
+
+    m_OUtoSBSConverters.CleanRefs();
 }
 
 //
@@ -525,8 +534,6 @@ DUPL_RETURN OutputManager::InitOutput(HWND Window, _Out_ INT& SingleOutput, _Out
     //In case this was called due to a resolution change, check if the crop was just exactly the set desktop in each overlay and adapt then
     if (!ConfigManager::Get().GetConfigBool(configid_bool_performance_single_desktop_mirroring))
     {
-        unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
-
         for (unsigned int i = 0; i < OverlayManager::Get().GetOverlayCount(); ++i)
         {
             OverlayConfigData& data = OverlayManager::Get().GetConfigData(i);
@@ -546,14 +553,11 @@ DUPL_RETURN OutputManager::InitOutput(HWND Window, _Out_ INT& SingleOutput, _Out
 
                     if (crop_rect == desktop_rect)
                     {
-                        OverlayManager::Get().SetCurrentOverlayID(i);
-                        CropToDisplay(desktop_id, true);
+                        CropToDisplay(i, desktop_id, true);
                     }
                 }
             }
         }
-
-        OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
     }
 
     ResetOverlays();
@@ -700,8 +704,7 @@ std::tuple<vr::EVRInitError, vr::EVROverlayError, bool> OutputManager::InitOverl
             if ((activity_level == vr::k_EDeviceActivityLevel_UserInteraction) || (activity_level == vr::k_EDeviceActivityLevel_UserInteraction_Timeout))
             {
                 //Also check if the HMD is tracking properly right now so the notification can actually be seen (fresh SteamVR start is active but not tracking for example)
-                vr::TrackedDevicePose_t poses[vr::k_unTrackedDeviceIndex_Hmd + 1];
-                vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(vr::TrackingUniverseStanding, GetTimeNowToPhotons(), poses, vr::k_unTrackedDeviceIndex_Hmd + 1);
+                const vr::TrackedDevicePose_t* poses = TrackedPoseSnapshot::Get().GetPoses();
 
                 use_vr_notification = (poses[vr::k_unTrackedDeviceIndex_Hmd].eTrackingResult == vr::TrackingResult_Running_OK);
             }
@@ -871,30 +874,20 @@ DUPL_RETURN_UPD OutputManager::Update(_In_ PTR_INFO* PointerInfo,  _In_ DPRect&
 
     bool has_updated_overlay = false;
 
-    //Check all overlays for overlap and collect clipping region from matches
+    //Find overlays overlapping with the dirty region and collect clipping region from them
     DPRect clipping_region(-1, -1, -1, -1);
 
-    for (unsigned int i = 0; i < OverlayManager::Get().GetOverlayCount(); ++i)
+    OverlayManager::Get().GetDesktopDuplicationRectIndex().ForEachOverlapping(DirtyRectTotal, [&](unsigned int /*overlay_id*/, const DPRect& cropping_region)
     {
-        const Overlay& overlay = OverlayManager::Get().GetOverlay(i);
-
-        if ( (overlay.IsVisible()) && ( (overlay.GetTextureSource() == ovrl_texsource_desktop_duplication) || (overlay.GetTextureSource() == ovrl_texsource_desktop_duplication_3dou_converted) ) )
+        if (clipping_region.GetTL().x != -1)
         {
-            const DPRect& cropping_region = overlay.GetValidatedCropRect();
-
-            if (DirtyRectTotal.Overlaps(cropping_region))
-            {
-                if (clipping_region.GetTL().x != -1)
-                {
-                    clipping_region.Add(cropping_region);
-                }
-                else
-                {
-                    clipping_region = cropping_region;
-                }
-            }
+            clipping_region.Add(cropping_region);
         }
-    }
+        else
+        {
+            clipping_region = cropping_region;
+        }
+    });
 
     m_OutputLastClippingRect = clipping_region;
 
@@ -1207,8 +1200,13 @@ bool OutputManager::HandleIPCMessage(const MSG& msg)
                     case configid_bool_overlay_enabled:
                     case configid_bool_overlay_gazefade_enabled:
                     case configid_bool_overlay_update_invisible:
+                    {
+                        ApplySettingTransform();
+                        break;
+                    }
                     case configid_bool_misc_apply_steamvr2_dashboard_offset:
                     {
+                        m_OriginCache.Invalidate(ovrl_origin_dashboard);
                         ApplySettingTransform();
                         break;
                     }
@@ -1243,6 +1241,11 @@ bool OutputManager::HandleIPCMessage(const MSG& msg)
 
                         break;
                     }
+                    case configid_bool_performance_winrt_skip_unchanged_frames:
+                    {
+                        DPWinRT_SetCaptureChangeDetectionEnabled(msg.lParam);
+                        break;
+                    }
                     case configid_bool_windows_winrt_keep_on_screen:
                     {
                         WindowManager::Get().UpdateConfigState();
@@ -1507,12 +1510,9 @@ void OutputManager::HandleWinRTMessage(const MSG& msg)
             IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), -1);
 
             //Apply change to overlay
-            unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
-            OverlayManager::Get().SetCurrentOverlayID(overlay_id);
-            ApplySettingCrop();
-            ApplySettingTransform();
+            ApplySettingCrop(overlay_id);
+            ApplySettingTransform(overlay_id);
             //Mouse scale is set by WinRT library
-            OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
 
             break;
         }
@@ -1532,21 +1532,17 @@ void OutputManager::HandleWinRTMessage(const MSG& msg)
             data.ConfigInt[configid_int_overlay_winrt_desktop_id]       = -2;
             data.ConfigIntPtr[configid_intptr_overlay_state_winrt_hwnd] = msg.lParam;
             overlay.SetTextureSource(ovrl_texsource_winrt_capture);
+            OverlayManager::Get().UpdateHotState(overlay_id);
 
             //Apply change to overlay
-            unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
-            OverlayManager::Get().SetCurrentOverlayID(overlay_id);
-
             ResetOverlayActiveCount();
-            ResetCurrentOverlay();
+            ResetOverlay(overlay_id);
 
             if (ConfigManager::Get().GetConfigBool(configid_bool_windows_winrt_auto_focus))
             {
                 WindowManager::Get().RaiseAndFocusWindow((HWND)data.ConfigIntPtr[configid_intptr_overlay_state_winrt_hwnd], &m_InputSim);
             }
 
-            OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
-
             //Send update to UI
             IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), (int)overlay_id);
             IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_overlay_capture_source), ovrl_capsource_winrt_capture);
@@ -1572,15 +1568,11 @@ void OutputManager::HandleWinRTMessage(const MSG& msg)
             data.ConfigInt[configid_int_overlay_winrt_desktop_id]       = msg.lParam;
             data.ConfigIntPtr[configid_intptr_overlay_state_winrt_hwnd] = 0;
             overlay.SetTextureSource(ovrl_texsource_winrt_capture);
+            OverlayManager::Get().UpdateHotState(overlay_id);
 
             //Apply change to overlay
-            unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
-            OverlayManager::Get().SetCurrentOverlayID(overlay_id);
-
             ResetOverlayActiveCount();
-            ResetCurrentOverlay();
-
-            OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
+            ResetOverlay(overlay_id);
 
             //Send update to UI
             IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), (int)overlay_id);
@@ -1689,19 +1681,14 @@ IDXGIAdapter* OutputManager::GetDXGIAdapter()
 void OutputManager::ResetOverlays()
 {
     //Reset all overlays
-    unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
     for (unsigned int i = 0; i < OverlayManager::Get().GetOverlayCount(); ++i)
     {
-        OverlayManager::Get().SetCurrentOverlayID(i);
-
-        ApplySettingCrop();
-        ApplySettingTransform();
-        ApplySettingCaptureSource();
-        ApplySetting3DMode();
+        ApplySettingCrop(i);
+        ApplySettingTransform(i);
+        ApplySettingCaptureSource(i);
+        ApplySetting3DMode(i);
     }
 
-    OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
-
     //These apply to all overlays within the function itself
     ApplySettingInputMode();
     ApplySettingUpdateLimiter();
@@ -1722,17 +1709,21 @@ void OutputManager::ResetOverlays()
 
 void OutputManager::ResetCurrentOverlay()
 {
-    //Reset current overlay
-    ApplySettingCrop();
-    ApplySettingTransform();
-    ApplySettingCaptureSource();
+    ResetOverlay(OverlayManager::Get().GetCurrentOverlayID());
+}
+
+void OutputManager::ResetOverlay(unsigned int overlay_id)
+{
+    ApplySettingCrop(overlay_id);
+    ApplySettingTransform(overlay_id);
+    ApplySettingCaptureSource(overlay_id);
     ApplySettingInputMode();
-    ApplySetting3DMode();
+    ApplySetting3DMode(overlay_id);
 
     ApplySettingUpdateLimiter();
 
     //Make sure that the entire overlay texture gets at least one full update for regions that will never be dirty (i.e. blank space not occupied by any desktop)
-    if (ConfigManager::Get().GetConfigInt(configid_int_overlay_capture_source) == ovrl_capsource_desktop_duplication)
+    if (OverlayManager::Get().GetConfigData(overlay_id).ConfigInt[configid_int_overlay_capture_source] == ovrl_capsource_desktop_duplication)
     {
         m_OutputPendingFullRefresh = true;
     }
@@ -1811,8 +1802,6 @@ void OutputManager::ShowOverlay(unsigned int id)
         return;
     }
 
-    unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
-    OverlayManager::Get().SetCurrentOverlayID(id);
     vr::VROverlayHandle_t ovrl_handle = overlay.GetHandle();
     const OverlayConfigData& data = OverlayManager::Get().GetConfigData(id);
 
@@ -1827,7 +1816,7 @@ void OutputManager::ShowOverlay(unsigned int id)
         WindowManager::Get().SetActive(true);
     }
 
-    if ( (ConfigManager::Get().GetConfigBool(configid_bool_overlay_input_enabled)) && (ConfigManager::Get().GetConfigBool(configid_bool_input_mouse_hmd_pointer_override)) &&
+    if ( (data.ConfigBool[configid_bool_overlay_input_enabled]) && (ConfigManager::Get().GetConfigBool(configid_bool_input_mouse_hmd_pointer_override)) &&
         (!ConfigManager::Get().GetConfigBool(configid_bool_state_overlay_dragmode)) && (!ConfigManager::Get().GetConfigBool(configid_bool_state_overlay_selectmode)) )
     {
         vr::VROverlay()->SetOverlayInputMethod(ovrl_handle, vr::VROverlayInputMethod_Mouse);
@@ -1856,7 +1845,7 @@ void OutputManager::ShowOverlay(unsigned int id)
 
     overlay.SetVisible(true);
 
-    ApplySettingTransform();
+    ApplySettingTransform(id);
 
     //Overlay could affect update limiter, so apply setting
     if (data.ConfigInt[configid_int_overlay_update_limit_override_mode] != update_limit_mode_off)
@@ -1869,8 +1858,6 @@ void OutputManager::ShowOverlay(unsigned int id)
     {
         RefreshOpenVROverlayTexture(DPRect(-1, -1, -1, -1), true);
     }
-
-    OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
 }
 
 void OutputManager::HideOverlay(unsigned int id)
@@ -1882,8 +1869,6 @@ void OutputManager::HideOverlay(unsigned int id)
         return;
     }
 
-    unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
-    OverlayManager::Get().SetCurrentOverlayID(id);
     vr::VROverlayHandle_t ovrl_handle = overlay.GetHandle();
     const OverlayConfigData& data = OverlayManager::Get().GetConfigData(id);
 
@@ -1924,8 +1909,6 @@ void OutputManager::HideOverlay(unsigned int id)
         //Pause capture
         DPWinRT_PauseCapture(ovrl_handle, true);
     }
-
-    OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
 }
 
 void OutputManager::ResetOverlayActiveCount()
@@ -1936,20 +1919,15 @@ void OutputManager::ResetOverlayActiveCount()
     m_OvrlDesktopDuplActiveCount = 0;
 
     //Check every existing overlay for visibility and count them as active
-    for (unsigned int i = 0; i < OverlayManager::Get().GetOverlayCount(); ++i)
-    {
-        Overlay& overlay = OverlayManager::Get().GetOverlay(i);
-        OverlayConfigData& data = OverlayManager::Get().GetConfigData(i);
+    const OverlayHotState& hot_state = OverlayManager::Get().GetHotState();
+    const unsigned int overlay_count = OverlayManager::Get().GetOverlayCount();
 
-        if (overlay.IsVisible())
-        {
-            m_OvrlActiveCount++;
+    for (unsigned int i = 0; i < overlay_count; ++i)
+    {
+        const bool is_visible = hot_state.Visible[i];
 
-            if (data.ConfigInt[configid_int_overlay_capture_source] == ovrl_capsource_desktop_duplication)
-            {
-                m_OvrlDesktopDuplActiveCount++;
-            }
-        }
+        m_OvrlActiveCount            += is_visible;
+        m_OvrlDesktopDuplActiveCount += ( (is_visible) && (hot_state.CaptureSource[i] == ovrl_capsource_desktop_duplication) );
     }
 
     //Fixup desktop duplication state
@@ -2069,10 +2047,7 @@ void OutputManager::DoAction(ActionID action_id)
                         OverlayConfigData& data = OverlayManager::Get().GetConfigData((unsigned int)action.IntID);
                         data.ConfigBool[configid_bool_overlay_enabled] = !data.ConfigBool[configid_bool_overlay_enabled];
 
-                        unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
-                        OverlayManager::Get().SetCurrentOverlayID((unsigned int)action.IntID);
-                        ApplySettingTransform();
-                        OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
+                        ApplySettingTransform((unsigned int)action.IntID);
 
                         //Sync change
                         IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), (int)action.IntID);
@@ -2209,10 +2184,7 @@ void OutputManager::ToggleOverlayGroupEnabled(int group_id)
         {
             data.ConfigBool[configid_bool_overlay_enabled] = !data.ConfigBool[configid_bool_overlay_enabled];
 
-            unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
-            OverlayManager::Get().SetCurrentOverlayID(i);
-            ApplySettingTransform();
-            OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
+            ApplySettingTransform(i);
 
             //Sync change
             IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), i);
@@ -2338,20 +2310,22 @@ int OutputManager::EnumerateOutputs(int target_desktop_id, Microsoft::WRL::ComPt
     return output_id_adapter;
 }
 
-void OutputManager::ConvertOUtoSBS(Overlay& overlay, OUtoSBSConverter& converter)
+void OutputManager::ConvertOUtoSBS(Overlay& overlay, const DPRect* dirty_rect)
 {
     //Convert()'s arguments are almost all stuff from OutputManager, so we take this roundabout way of calling it
+    //Overlays with the same crop share a converter, so only the first of them in an update actually converts
     const DPRect& crop_rect = overlay.GetValidatedCropRect();
+    ID3D11Texture2D* tex_sbs = nullptr;
 
-    HRESULT hr = converter.Convert(m_Device, m_DeviceContext, m_MultiGPUTargetDevice, m_MultiGPUTargetDeviceContext, m_OvrlTex,
-                                   m_DesktopWidth, m_DesktopHeight, crop_rect.GetTL().x, crop_rect.GetTL().y, crop_rect.GetWidth(), crop_rect.GetHeight());
+    HRESULT hr = m_OUtoSBSConverters.Convert(m_Device, m_DeviceContext, m_MultiGPUTargetDevice, m_MultiGPUTargetDeviceContext, m_OvrlTex, m_DesktopWidth, m_DesktopHeight,
+                                             crop_rect.GetTL().x, crop_rect.GetTL().y, crop_rect.GetWidth(), crop_rect.GetHeight(), dirty_rect, &tex_sbs);
 
     if (hr == S_OK)
     {
         vr::Texture_t vrtex;
         vrtex.eType = vr::TextureType_DirectX;
         vrtex.eColorSpace = vr::ColorSpace_Gamma;
-        vrtex.handle = converter.GetTexture(); //OUtoSBSConverter takes care of multi-gpu support automatically, so no further processing needed
+        vrtex.handle = tex_sbs; //OUtoSBSConverter takes care of multi-gpu support automatically, so no further processing needed
 
         vr::VROverlay()->SetOverlayTexture(overlay.GetHandle(), &vrtex);
     }
@@ -3191,23 +3165,34 @@ DUPL_RETURN_UPD OutputManager::RefreshOpenVROverlayTexture(DPRect& DirtyRectTota
         if (force_full_copy) //This is down here so a failed partial copy is picked up as well
         {
             vr::VROverlay()->SetOverlayTexture(m_OvrlHandleDesktopTexture, &vrtex);
+        }
+
+        //Apply potential texture change to all desktop duplication overlays and notify the ones that need it of the duplication update
+        const OverlayHotState& hot_state = OverlayManager::Get().GetHotState();
+        const unsigned int overlay_count = OverlayManager::Get().GetOverlayCount();
+        const DPRect* dirty_rect = (force_full_copy) ? nullptr : &DirtyRectTotal;
+
+        m_OUtoSBSConverters.BeginUpdate();
 
-            //Apply potential texture change to all overlays and notify them of duplication update
-            for (unsigned int i = 0; i < OverlayManager::Get().GetOverlayCount(); ++i)
+        for (unsigned int i = 0; i < overlay_count; ++i)
+        {
+            if (hot_state.CaptureSource[i] != ovrl_capsource_desktop_duplication)
+                continue;
+
+            if (force_full_copy)
             {
-                Overlay& overlay = OverlayManager::Get().GetOverlay(i);
-                overlay.AssignDesktopDuplicationTexture();
-                overlay.OnDesktopDuplicationUpdate();
+                OverlayManager::Get().GetOverlay(i).AssignDesktopDuplicationTexture();
             }
-        }
-        else
-        {
-            //Notifiy all overlays of duplication update
-            for (unsigned int i = 0; i < OverlayManager::Get().GetOverlayCount(); ++i)
+
+            //Only converted overlays do anything on update (see Overlay::OnDesktopDuplicationUpdate())
+            if ( (hot_state.Visible[i]) && (hot_state.TextureSource[i] == ovrl_texsource_desktop_duplication_3dou_converted) )
             {
-                OverlayManager::Get().GetOverlay(i).OnDesktopDuplicationUpdate();
+                OverlayManager::Get().GetOverlay(i).OnDesktopDuplicationUpdate(dirty_rect);
             }
         }
+
+        //Converters not used in this update missed the dirty rect, drop them
+        m_OUtoSBSConverters.EndUpdate();
     }
 
     return DUPL_RETURN_UPD_SUCCESS_REFRESHED_OVERLAY;
@@ -3389,10 +3374,7 @@ bool OutputManager::HandleOpenVREvents()
                         if (!m_OvrlDashboardActive)
                         {
                             ::Sleep(50);
-                            unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
-                            OverlayManager::Get().SetCurrentOverlayID(i);
-                            ApplySettingTransform();
-                            OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
+                            ApplySettingTransform(i);
                         }
                     }
                 }
@@ -3472,6 +3454,9 @@ bool OutputManager::HandleOpenVREvents()
     }
 
     //Now handle events for the actual overlays
+    //Simulated input is batched from here on so the many small mouse moves and scroll events per frame end up in a single SendInput() call
+    m_InputSim.BatchBegin();
+
     unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
     for (unsigned int i = 0; i < OverlayManager::Get().GetOverlayCount(); ++i)
     {
@@ -3609,6 +3594,8 @@ bool OutputManager::HandleOpenVREvents()
                 case vr::VREvent_ChaperoneUniverseHasChanged:
                 {
                     //We also get this when tracking is lost, which ends up updating the dashboard position
+                    m_OriginCache.Invalidate(ovrl_origin_dashboard);
+
                     if (m_OvrlActiveCount != 0)
                     {
                         ApplySettingTransform();
@@ -3649,8 +3636,9 @@ bool OutputManager::HandleOpenVREvents()
     m_VRInput.HandleGlobalActionShortcuts(*this);
     m_VRInput.HandleGlobalOverlayGroupShortcuts(*this);
 
-    //Finish up pending keyboard input collected into the queue
+    //Finish up pending keyboard input collected into the queue and send all batched input
     m_InputSim.KeyboardTextFinish();
+    m_InputSim.BatchEnd();
 
     UpdateKeyboardHelperModifierState();
     HandleHotkeys();
@@ -3663,17 +3651,17 @@ bool OutputManager::HandleOpenVREvents()
         dashboard_origin_was_updated = true;
     }
 
+    //Per-overlay updates are done by ID, only ApplySettingTransform() still needs the overlay to be set as current
     for (unsigned int i = 0; i < OverlayManager::Get().GetOverlayCount(); ++i)
     {
-        OverlayManager::Get().SetCurrentOverlayID(i);
-        Overlay& overlay = OverlayManager::Get().GetCurrentOverlay();
-        const OverlayConfigData& data = OverlayManager::Get().GetCurrentConfigData();
+        const Overlay& overlay = OverlayManager::Get().GetOverlay(i);
+        const OverlayConfigData& data = OverlayManager::Get().GetConfigData(i);
 
         if (data.ConfigBool[configid_bool_overlay_enabled])
         {
             if (overlay.IsVisible())
             {
-                if (m_DragModeOverlayID == overlay.GetID())
+                if (m_DragModeOverlayID == i)
                 {
                     if (m_DragModeDeviceID != -1)
                     {
@@ -3686,23 +3674,20 @@ bool OutputManager::HandleOpenVREvents()
                 }
                 else if (data.ConfigInt[configid_int_overlay_detached_origin] == ovrl_origin_hmd_floor)
                 {
-                    DetachedTransformUpdateHMDFloor();
+                    DetachedTransformUpdateHMDFloor(i);
                 }
                 else if ( (dashboard_origin_was_updated) && (m_DragModeDeviceID == -1) && (!m_DragGestureActive) && 
                           ( (i == k_ulOverlayID_Dashboard) || (data.ConfigInt[configid_int_overlay_detached_origin] == ovrl_origin_dashboard) ) )
                 {
-                    ApplySettingTransform();
+                    ApplySettingTransform(i);
                 }
 
-                DetachedInteractionAutoToggle();
+                DetachedInteractionAutoToggle(i);
             }
-
-            DetachedOverlayGazeFade();
         }
     }
 
-    OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
-
+    DetachedOverlayGazeFadeAll();
     DetachedOverlayGlobalHMDPointerAll();
 
     return false;
@@ -3803,9 +3788,17 @@ void OutputManager::OnOpenVRMouseEvent(const vr::VREvent_t& vr_event, unsigned i
                 offset_y = m_DesktopY;
             }
 
+            float mouse_x = vr_event.data.mouse.x;
+            float mouse_y = vr_event.data.mouse.y;
+
+            if (ConfigManager::Get().GetConfigBool(configid_bool_input_mouse_laser_pointer_smoothing))
+            {
+                LaserPointerSmoothingApply(overlay_current.GetID(), mouse_x, mouse_y);
+            }
+
             //GL space (0,0 is bottom left), so we need to flip that around
-            int pointer_x = (round(vr_event.data.mouse.x) - hotspot_x) + offset_x;
-            int pointer_y = ((-round(vr_event.data.mouse.y) + content_height) - hotspot_y) + offset_y;
+            int pointer_x = (round(mouse_x) - hotspot_x) + offset_x;
+            int pointer_y = ((-round(mouse_y) + content_height) - hotspot_y) + offset_y;
 
             //If double click assist is current active, check if there was an obviously deliberate movement and cancel it then
             if ((ConfigManager::Get().GetConfigInt(configid_int_state_mouse_dbl_click_assist_duration_ms) != 0) &&
@@ -3844,7 +3837,10 @@ void OutputManager::OnOpenVRMouseEvent(const vr::VREvent_t& vr_event, unsigned i
             }
 
             //Check coordinates if HMDPointerOverride is enabled
-            if ((ConfigManager::Get().GetConfigBool(configid_bool_input_mouse_hmd_pointer_override)) && ( (device_is_hmd) || (device_is_never_tracked) ) )
+            //Skipped while a move from an earlier event in this batch is still queued, as GetCursorPos() can't match m_MouseLastLaserPointerX/Y before it's sent.
+            //The check runs again on the first mouse move of the next batch, so other sources moving the cursor are still caught
+            if ((ConfigManager::Get().GetConfigBool(configid_bool_input_mouse_hmd_pointer_override)) && ( (device_is_hmd) || (device_is_never_tracked) ) && 
+                (!m_InputSim.IsMouseMoveQueued()))
             {
                 POINT pt;
                 ::GetCursorPos(&pt);
@@ -3892,14 +3888,26 @@ void OutputManager::OnOpenVRMouseEvent(const vr::VREvent_t& vr_event, unsigned i
             {
                 //Move a single pixel in the direction of the new pointer position
                 m_InputSim.MouseMove(m_MouseLastLaserPointerX + sgn(pointer_x - m_MouseLastLaserPointerX), m_MouseLastLaserPointerY + sgn(pointer_y - m_MouseLastLaserPointerY));
+                m_InputSim.Flush(); //Don't let this get merged with the following move
 
                 m_MouseLastLaserPointerMoveBlocked = false;
                 //Real movement continues on the next mouse move event
             }
             else
             {
+                //Skip moves to where the cursor already is, which happens a lot when the smoothed pointer jitters less than a pixel
+                //Only done with smoothing enabled, otherwise every event moves the cursor like before and no GetCursorPos() call is made
+                POINT pt;
+                bool is_cursor_at_pointer = ( (ConfigManager::Get().GetConfigBool(configid_bool_input_mouse_laser_pointer_smoothing)) &&
+                                              (pointer_x == m_MouseLastLaserPointerX) && (pointer_y == m_MouseLastLaserPointerY) && (::GetCursorPos(&pt)) && 
+                                              (pt.x == pointer_x) && (pt.y == pointer_y) );
+
                 //Finally do the actual cursor movement if we're still here
-                m_InputSim.MouseMove(pointer_x, pointer_y);
+                if (!is_cursor_at_pointer)
+                {
+                    m_InputSim.MouseMove(pointer_x, pointer_y);
+                }
+
                 m_MouseLastLaserPointerX = pointer_x;
                 m_MouseLastLaserPointerY = pointer_y;
             }
@@ -4060,6 +4068,35 @@ void OutputManager::OnOpenVRMouseEvent(const vr::VREvent_t& vr_event, unsigned i
     }
 }
 
+void OutputManager::LaserPointerSmoothingApply(unsigned int overlay_id, float& mouse_x, float& mouse_y)
+{
+    LARGE_INTEGER perf_counter, perf_frequency;
+    ::QueryPerformanceCounter(&perf_counter);
+    ::QueryPerformanceFrequency(&perf_frequency);
+    const double time = double(perf_counter.QuadPart) / double(perf_frequency.QuadPart);
+
+    //Start over when the pointer is on a different overlay or wasn't on any for a bit, so it doesn't glide in from the last position
+    if ( (overlay_id != m_MouseLaserPointerFilterOverlayID) || (time - m_MouseLaserPointerFilterX.GetTimePrevious() > 0.25) )
+    {
+        m_MouseLaserPointerFilterX.Reset();
+        m_MouseLaserPointerFilterY.Reset();
+        m_MouseLaserPointerFilterOverlayID = overlay_id;
+    }
+
+    //Parameters are cheap to set, so just do it every time instead of tracking config changes
+    const float min_cutoff = ConfigManager::Get().GetConfigFloat(configid_float_input_mouse_laser_pointer_smoothing_min_cutoff);
+    const float beta       = ConfigManager::Get().GetConfigFloat(configid_float_input_mouse_laser_pointer_smoothing_beta) / 1000.0f;
+    const float prediction = ConfigManager::Get().GetConfigFloat(configid_float_input_mouse_laser_pointer_smoothing_prediction_ms) / 1000.0f;
+
+    m_MouseLaserPointerFilterX.SetParameters(min_cutoff, beta, 1.0f);
+    m_MouseLaserPointerFilterY.SetParameters(min_cutoff, beta, 1.0f);
+    m_MouseLaserPointerFilterX.SetPredictionTime(prediction);
+    m_MouseLaserPointerFilterY.SetPredictionTime(prediction);
+
+    mouse_x = m_MouseLaserPointerFilterX.Filter(mouse_x, time);
+    mouse_y = m_MouseLaserPointerFilterY.Filter(mouse_y, time);
+}
+
 void OutputManager::OnKeyboardClosed()
 {
     //Tell UI that the keyboard helper should no longer be displayed
@@ -4285,10 +4322,16 @@ void OutputManager::CropToActiveWindow()
 
 void OutputManager::CropToDisplay(int display_id, bool do_not_apply_setting)
 {
-    int& crop_x      = ConfigManager::Get().GetConfigIntRef(configid_int_overlay_crop_x);
-    int& crop_y      = ConfigManager::Get().GetConfigIntRef(configid_int_overlay_crop_y);
-    int& crop_width  = ConfigManager::Get().GetConfigIntRef(configid_int_overlay_crop_width);
-    int& crop_height = ConfigManager::Get().GetConfigIntRef(configid_int_overlay_crop_height);
+    CropToDisplay(OverlayManager::Get().GetCurrentOverlayID(), display_id, do_not_apply_setting);
+}
+
+void OutputManager::CropToDisplay(unsigned int overlay_id, int display_id, bool do_not_apply_setting)
+{
+    OverlayConfigData& data = OverlayManager::Get().GetConfigData(overlay_id);
+    int& crop_x      = data.ConfigInt[configid_int_overlay_crop_x];
+    int& crop_y      = data.ConfigInt[configid_int_overlay_crop_y];
+    int& crop_width  = data.ConfigInt[configid_int_overlay_crop_width];
+    int& crop_height = data.ConfigInt[configid_int_overlay_crop_height];
     
     if ( (!ConfigManager::Get().GetConfigBool(configid_bool_performance_single_desktop_mirroring)) && (display_id >= 0) && (display_id < m_DesktopRects.size()) ) 
     {
@@ -4313,7 +4356,7 @@ void OutputManager::CropToDisplay(int display_id, bool do_not_apply_setting)
     }
 
     //Send change to UI as well (also set override since this may be called during one)
-    IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), OverlayManager::Get().GetCurrentOverlayID());
+    IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), (int)overlay_id);
     IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_overlay_crop_x),      crop_x);
     IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_overlay_crop_y),      crop_y);
     IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_int_overlay_crop_width),  crop_width);
@@ -4336,8 +4379,8 @@ void OutputManager::CropToDisplay(int display_id, bool do_not_apply_setting)
     //Applying the setting when a duplication resets happens right after has the chance of screwing up the transform (too many transform updates?), so give the option to not do it
     if (!do_not_apply_setting)
     {
-        ApplySettingCrop();
-        ApplySettingTransform();
+        ApplySettingCrop(overlay_id);
+        ApplySettingTransform(overlay_id);
     }
 }
 
@@ -4385,9 +4428,15 @@ void OutputManager::AddOverlay(unsigned int base_id, bool is_ui_overlay)
 
 void OutputManager::ApplySettingCaptureSource()
 {
-    Overlay& overlay = OverlayManager::Get().GetCurrentOverlay();
+    ApplySettingCaptureSource(OverlayManager::Get().GetCurrentOverlayID());
+}
 
-    switch (ConfigManager::Get().GetConfigInt(configid_int_overlay_capture_source))
+void OutputManager::ApplySettingCaptureSource(unsigned int overlay_id)
+{
+    Overlay& overlay = OverlayManager::Get().GetOverlay(overlay_id);
+    const OverlayConfigData& data = OverlayManager::Get().GetConfigData(overlay_id);
+
+    switch (data.ConfigInt[configid_int_overlay_capture_source])
     {
         case ovrl_capsource_desktop_duplication:
         {
@@ -4396,7 +4445,7 @@ void OutputManager::ApplySettingCaptureSource()
                 OverlayTextureSource tex_source = overlay.GetTextureSource();
                 if ((tex_source != ovrl_texsource_desktop_duplication) || (tex_source != ovrl_texsource_desktop_duplication_3dou_converted))
                 {
-                    ApplySetting3DMode(); //Sets texture source for us when capture source is desktop duplication
+                    ApplySetting3DMode(overlay_id); //Sets texture source for us when capture source is desktop duplication
                 }
             }
             else
@@ -4411,14 +4460,12 @@ void OutputManager::ApplySettingCaptureSource()
             {
                 if (DPWinRT_IsCaptureFromHandleSupported())
                 {
-                    OverlayConfigData& data = OverlayManager::Get().GetCurrentConfigData();
-
                     if (data.ConfigIntPtr[configid_intptr_overlay_state_winrt_hwnd] != 0)
                     {
                         if (DPWinRT_StartCaptureFromHWND(overlay.GetHandle(), (HWND)data.ConfigIntPtr[configid_intptr_overlay_state_winrt_hwnd]))
                         {
                             overlay.SetTextureSource(ovrl_texsource_winrt_capture);
-                            ApplySetting3DMode(); //Syncs 3D state if needed
+                            ApplySetting3DMode(overlay_id); //Syncs 3D state if needed
 
                             //Pause if not visible
                             if (!overlay.IsVisible())
@@ -4438,7 +4485,7 @@ void OutputManager::ApplySettingCaptureSource()
                         if (DPWinRT_StartCaptureFromDesktop(overlay.GetHandle(), data.ConfigInt[configid_int_overlay_winrt_desktop_id]))
                         {
                             overlay.SetTextureSource(ovrl_texsource_winrt_capture);
-                            ApplySetting3DMode();
+                            ApplySetting3DMode(overlay_id);
 
                             //Pause if not visible
                             if (!overlay.IsVisible())
@@ -4467,14 +4514,19 @@ void OutputManager::ApplySettingCaptureSource()
 
 void OutputManager::ApplySetting3DMode()
 {
-    const Overlay& overlay_current = OverlayManager::Get().GetCurrentOverlay();
-    const OverlayConfigData& data = OverlayManager::Get().GetCurrentConfigData();
+    ApplySetting3DMode(OverlayManager::Get().GetCurrentOverlayID());
+}
 
-    vr::VROverlayHandle_t ovrl_handle = overlay_current.GetHandle();
-    int mode = ConfigManager::Get().GetConfigInt(configid_int_overlay_3D_mode);
+void OutputManager::ApplySetting3DMode(unsigned int overlay_id)
+{
+    Overlay& overlay = OverlayManager::Get().GetOverlay(overlay_id);
+    const OverlayConfigData& data = OverlayManager::Get().GetConfigData(overlay_id);
+
+    vr::VROverlayHandle_t ovrl_handle = overlay.GetHandle();
+    int mode = data.ConfigInt[configid_int_overlay_3D_mode];
 
     //Override mode to none if texsource is none or the desktop duplication output is invalid
-    if ( (overlay_current.GetTextureSource() == ovrl_texsource_none) || ( (data.ConfigInt[configid_int_overlay_capture_source] == ovrl_capsource_desktop_duplication) && (m_OutputInvalid) ) )
+    if ( (overlay.GetTextureSource() == ovrl_texsource_none) || ( (data.ConfigInt[configid_int_overlay_capture_source] == ovrl_capsource_desktop_duplication) && (m_OutputInvalid) ) )
     {
         mode = ovrl_3Dmode_none;
     }
@@ -4503,11 +4555,11 @@ void OutputManager::ApplySetting3DMode()
     {
         if ((mode == ovrl_3Dmode_ou) || (mode == ovrl_3Dmode_hou))
         {
-            OverlayManager::Get().GetCurrentOverlay().SetTextureSource(ovrl_texsource_desktop_duplication_3dou_converted);
+            overlay.SetTextureSource(ovrl_texsource_desktop_duplication_3dou_converted);
         }
         else
         {
-            OverlayManager::Get().GetCurrentOverlay().SetTextureSource(ovrl_texsource_desktop_duplication);
+            overlay.SetTextureSource(ovrl_texsource_desktop_duplication);
         }
     }
     //WinRT OU3D state is set in ApplySettingCrop since it needs cropping values
@@ -4538,28 +4590,34 @@ void OutputManager::ApplySetting3DMode()
         RefreshOpenVROverlayTexture(DPRect(-1, -1, -1, -1), true);
     }
 
-    ApplySettingCrop();
+    ApplySettingCrop(overlay_id);
 }
 
 void OutputManager::ApplySettingTransform()
 {
-    Overlay& overlay = OverlayManager::Get().GetCurrentOverlay();
+    ApplySettingTransform(OverlayManager::Get().GetCurrentOverlayID());
+}
+
+void OutputManager::ApplySettingTransform(unsigned int overlay_id)
+{
+    Overlay& overlay = OverlayManager::Get().GetOverlay(overlay_id);
+    const OverlayConfigData& data = OverlayManager::Get().GetConfigData(overlay_id);
     vr::VROverlayHandle_t ovrl_handle = overlay.GetHandle();
 
     //Fixup overlay visibility if needed
     //This has to be done first since there seem to be issues with moving invisible overlays
-    const bool is_detached = ConfigManager::Get().GetConfigBool(configid_bool_overlay_detached);
+    const bool is_detached = data.ConfigBool[configid_bool_overlay_detached];
     bool should_be_visible = overlay.ShouldBeVisible();
 
-    if ( (!should_be_visible) && (is_detached) && (m_OvrlDashboardActive) && (m_OvrlDashboardActive) && (ConfigManager::Get().GetConfigBool(configid_bool_overlay_enabled)) &&
+    if ( (!should_be_visible) && (is_detached) && (m_OvrlDashboardActive) && (m_OvrlDashboardActive) && (data.ConfigBool[configid_bool_overlay_enabled]) &&
          (ConfigManager::Get().GetConfigBool(configid_bool_state_overlay_dragselectmode_show_hidden)) )
     {
         should_be_visible = true;
         overlay.SetOpacity(0.25f);
     }
-    else if ( (!ConfigManager::Get().GetConfigBool(configid_bool_overlay_gazefade_enabled)) && (overlay.GetOpacity() != ConfigManager::Get().GetConfigFloat(configid_float_overlay_opacity)) )
+    else if ( (!data.ConfigBool[configid_bool_overlay_gazefade_enabled]) && (overlay.GetOpacity() != data.ConfigFloat[configid_float_overlay_opacity]) )
     {
-        overlay.SetOpacity(ConfigManager::Get().GetConfigFloat(configid_float_overlay_opacity));
+        overlay.SetOpacity(data.ConfigFloat[configid_float_overlay_opacity]);
         should_be_visible = overlay.ShouldBeVisible(); //Re-evaluate this in case the overlay was left hidden after deactivating gaze fade
     }
 
@@ -4573,10 +4631,10 @@ void OutputManager::ApplySettingTransform()
         HideOverlay(overlay.GetID());
     }
 
-    float width = ConfigManager::Get().GetConfigFloat(configid_float_overlay_width);
+    float width = data.ConfigFloat[configid_float_overlay_width];
     float height = 0.0f;
     float dashboard_offset = 0.0f;
-    OverlayOrigin overlay_origin = (is_detached) ? (OverlayOrigin)ConfigManager::Get().GetConfigInt(configid_int_overlay_detached_origin) : ovrl_origin_dashboard;
+    OverlayOrigin overlay_origin = (is_detached) ? (OverlayOrigin)data.ConfigInt[configid_int_overlay_detached_origin] : ovrl_origin_dashboard;
 
     if ( (overlay.GetID() == k_ulOverlayID_Dashboard) && (should_be_visible) )
     {
@@ -4587,7 +4645,7 @@ void OutputManager::ApplySettingTransform()
         const DPRect& crop_rect = overlay.GetValidatedCropRect();
         int crop_width = crop_rect.GetWidth(), crop_height = crop_rect.GetHeight();
 
-        int mode_3d = ConfigManager::Get().GetConfigInt(configid_int_overlay_3D_mode);
+        int mode_3d = data.ConfigInt[configid_int_overlay_3D_mode];
 
         if (m_OutputInvalid) //No cropping on invalid output image
         {
@@ -4631,11 +4689,11 @@ void OutputManager::ApplySettingTransform()
     vr::VROverlay()->SetOverlayWidthInMeters(ovrl_handle, width);
 
     //Update Curvature
-    vr::VROverlay()->SetOverlayCurvature(ovrl_handle, ConfigManager::Get().GetConfigFloat(configid_float_overlay_curvature));
+    vr::VROverlay()->SetOverlayCurvature(ovrl_handle, data.ConfigFloat[configid_float_overlay_curvature]);
 
     //Update Brightness
     //We use the logarithmic counterpart since the changes in higher steps are barely visible while the lower range can really use those additional steps
-    float brightness = lin2log(ConfigManager::Get().GetConfigFloat(configid_float_overlay_brightness));
+    float brightness = lin2log(data.ConfigFloat[configid_float_overlay_brightness]);
     vr::VROverlay()->SetOverlayColor(ovrl_handle, brightness, brightness, brightness);
 
     //Update transform
@@ -4646,48 +4704,44 @@ void OutputManager::ApplySettingTransform()
     {
         case ovrl_origin_room:
         {
-            matrix = ConfigManager::Get().GetOverlayDetachedTransform().toOpenVR34();
-            vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, universe_origin, &matrix);
+            matrix = ConfigManager::Get().GetOverlayDetachedTransform(overlay_id).toOpenVR34();
+            OverlayPropertyWriter::Get().SetTransformAbsolute(ovrl_handle, universe_origin, matrix);
             break;
         }
         case ovrl_origin_hmd_floor:
         {
-            DetachedTransformUpdateHMDFloor();
+            DetachedTransformUpdateHMDFloor(overlay.GetID());
             break;
         }
         case ovrl_origin_seated_universe:
         {
-            Matrix4 matrix = DragGetBaseOffsetMatrix();
-            matrix *= ConfigManager::Get().GetOverlayDetachedTransform();
-
-            vr::HmdMatrix34_t matrix_ovr = matrix.toOpenVR34();
-            vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, &matrix_ovr);
+            vr::HmdMatrix34_t matrix_ovr = GetOverlayMatrix(overlay_id).toOpenVR34();
+            OverlayPropertyWriter::Get().SetTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, matrix_ovr);
             break;
         }
         case ovrl_origin_dashboard:
         {
             if (is_detached)
             {
-                Matrix4 matrix_base = DragGetBaseOffsetMatrix() * ConfigManager::Get().GetOverlayDetachedTransform();
-                matrix = matrix_base.toOpenVR34();
+                matrix = GetOverlayMatrix(overlay_id).toOpenVR34();
             }
             else //Attach to dashboard dummy to pretend we have normal dashboard overlay
             {
                 vr::VROverlay()->GetTransformForOverlayCoordinates(m_OvrlHandleDashboardDummy, universe_origin, {0.5f, -0.5f}, &matrix); //-0.5 is past bottom end of the overlay, might break someday
 
                 //Y: Align from bottom edge, and add 0.28m base offset to make space for the UI bar 
-                OffsetTransformFromSelf(matrix, ConfigManager::Get().GetConfigFloat(configid_float_overlay_offset_right),
-                                                ConfigManager::Get().GetConfigFloat(configid_float_overlay_offset_up) + height + dashboard_offset + 0.28,
-                                                ConfigManager::Get().GetConfigFloat(configid_float_overlay_offset_forward));
+                OffsetTransformFromSelf(matrix, data.ConfigFloat[configid_float_overlay_offset_right],
+                                                data.ConfigFloat[configid_float_overlay_offset_up] + height + dashboard_offset + 0.28,
+                                                data.ConfigFloat[configid_float_overlay_offset_forward]);
             }
 
-            vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, universe_origin, &matrix);
+            OverlayPropertyWriter::Get().SetTransformAbsolute(ovrl_handle, universe_origin, matrix);
             break;
         }
         case ovrl_origin_hmd:
         {
-            matrix = ConfigManager::Get().GetOverlayDetachedTransform().toOpenVR34();
-            vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(ovrl_handle, vr::k_unTrackedDeviceIndex_Hmd, &matrix);
+            matrix = ConfigManager::Get().GetOverlayDetachedTransform(overlay_id).toOpenVR34();
+            OverlayPropertyWriter::Get().SetTransformTrackedDeviceRelative(ovrl_handle, vr::k_unTrackedDeviceIndex_Hmd, matrix);
             break;
         }
         case ovrl_origin_right_hand:
@@ -4696,12 +4750,12 @@ void OutputManager::ApplySettingTransform()
 
             if (device_index != vr::k_unTrackedDeviceIndexInvalid)
             {
-                matrix = ConfigManager::Get().GetOverlayDetachedTransform().toOpenVR34();
-                vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(ovrl_handle, device_index, &matrix);
+                matrix = ConfigManager::Get().GetOverlayDetachedTransform(overlay_id).toOpenVR34();
+                OverlayPropertyWriter::Get().SetTransformTrackedDeviceRelative(ovrl_handle, device_index, matrix);
             }
             else //No controller connected, uh put it to 0?
             {
-                vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, universe_origin, &matrix);
+                OverlayPropertyWriter::Get().SetTransformAbsolute(ovrl_handle, universe_origin, matrix);
             }
             break;
         }
@@ -4711,12 +4765,12 @@ void OutputManager::ApplySettingTransform()
 
             if (device_index != vr::k_unTrackedDeviceIndexInvalid)
             {
-                matrix = ConfigManager::Get().GetOverlayDetachedTransform().toOpenVR34();
-                vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(ovrl_handle, device_index, &matrix);
+                matrix = ConfigManager::Get().GetOverlayDetachedTransform(overlay_id).toOpenVR34();
+                OverlayPropertyWriter::Get().SetTransformTrackedDeviceRelative(ovrl_handle, device_index, matrix);
             }
             else //No controller connected, uh put it to 0?
             {
-                vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, universe_origin, &matrix);
+                OverlayPropertyWriter::Get().SetTransformAbsolute(ovrl_handle, universe_origin, matrix);
             }
             break;
         }
@@ -4726,12 +4780,12 @@ void OutputManager::ApplySettingTransform()
 
             if (index_tracker != vr::k_unTrackedDeviceIndexInvalid)
             {
-                matrix = ConfigManager::Get().GetOverlayDetachedTransform().toOpenVR34();
-                vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(ovrl_handle, index_tracker, &matrix);
+                matrix = ConfigManager::Get().GetOverlayDetachedTransform(overlay_id).toOpenVR34();
+                OverlayPropertyWriter::Get().SetTransformTrackedDeviceRelative(ovrl_handle, index_tracker, matrix);
             }
             else //Not connected, uh put it to 0?
             {
-                vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, universe_origin, &matrix);
+                OverlayPropertyWriter::Get().SetTransformAbsolute(ovrl_handle, universe_origin, matrix);
             }
 
             break;
@@ -4755,8 +4809,13 @@ void OutputManager::ApplySettingTransform()
 
 void OutputManager::ApplySettingCrop()
 {
-    Overlay& overlay = OverlayManager::Get().GetCurrentOverlay();
-    OverlayConfigData& data = OverlayManager::Get().GetCurrentConfigData();
+    ApplySettingCrop(OverlayManager::Get().GetCurrentOverlayID());
+}
+
+void OutputManager::ApplySettingCrop(unsigned int overlay_id)
+{
+    Overlay& overlay = OverlayManager::Get().GetOverlay(overlay_id);
+    OverlayConfigData& data = OverlayManager::Get().GetConfigData(overlay_id);
     vr::VROverlayHandle_t ovrl_handle = overlay.GetHandle();
 
     //UI overlays don't do any cropping and handle the texture bounds themselves
@@ -4767,11 +4826,11 @@ void OutputManager::ApplySettingCrop()
     if (data.ConfigInt[configid_int_overlay_desktop_id] == -2)
     {
         data.ConfigInt[configid_int_overlay_desktop_id] = 0;
-        IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), OverlayManager::Get().GetCurrentOverlayID());
+        IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), (int)overlay_id);
         IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_overlay_desktop_id), 0);
         IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), -1);
 
-        CropToDisplay(0);
+        CropToDisplay(overlay_id, 0, false);
         return; //CropToDisplay will call this function again
     }
 
@@ -4796,7 +4855,7 @@ void OutputManager::ApplySettingCrop()
     overlay.UpdateValidatedCropRect();
     const DPRect& crop_rect = overlay.GetValidatedCropRect();
 
-    const int mode_3d = ConfigManager::Get().GetConfigInt(configid_int_overlay_3D_mode);
+    const int mode_3d = data.ConfigInt[configid_int_overlay_3D_mode];
     const bool is_ou3d = (mode_3d == ovrl_3Dmode_ou) || (mode_3d == ovrl_3Dmode_hou);
 
     //Use full texture if everything checks out or 3D mode is Over-Under (converted to a 1:1 fitting texture)
@@ -4821,7 +4880,7 @@ void OutputManager::ApplySettingCrop()
     }
 
     //If capture source is WinRT, set 3D mode with cropping values
-    if (ConfigManager::Get().GetConfigInt(configid_int_overlay_capture_source) == ovrl_capsource_winrt_capture)
+    if (data.ConfigInt[configid_int_overlay_capture_source] == ovrl_capsource_winrt_capture)
     {
         DPWinRT_SetOverlayOverUnder3D(ovrl_handle, is_ou3d, crop_rect.GetTL().x, crop_rect.GetTL().y, crop_rect.GetWidth(), crop_rect.GetHeight());
     }
@@ -4845,18 +4904,15 @@ void OutputManager::ApplySettingInputMode()
 
     bool drag_or_select_mode_enabled = ( (ConfigManager::Get().GetConfigBool(configid_bool_state_overlay_dragmode)) || (ConfigManager::Get().GetConfigBool(configid_bool_state_overlay_selectmode)) );
     //Always applies to all overlays
-    unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
     for (unsigned int i = 0; i < OverlayManager::Get().GetOverlayCount(); ++i)
     {
-        OverlayManager::Get().SetCurrentOverlayID(i);
-
-        const Overlay& overlay_current = OverlayManager::Get().GetCurrentOverlay();
-        vr::VROverlayHandle_t ovrl_handle = overlay_current.GetHandle();
+        vr::VROverlayHandle_t ovrl_handle = OverlayManager::Get().GetOverlay(i).GetHandle();
+        const OverlayConfigData& data = OverlayManager::Get().GetConfigData(i);
 
-        if ((ConfigManager::Get().GetConfigBool(configid_bool_overlay_input_enabled)) || (drag_or_select_mode_enabled) )
+        if ((data.ConfigBool[configid_bool_overlay_input_enabled]) || (drag_or_select_mode_enabled) )
         {
             //Don't activate drag mode for HMD origin when the pointer is also the HMD (or it's the dashboard overlay)
-            if ( ((vr::VROverlay()->GetPrimaryDashboardDevice() == vr::k_unTrackedDeviceIndex_Hmd) && (ConfigManager::Get().GetConfigInt(configid_int_overlay_detached_origin) == ovrl_origin_hmd)) )
+            if ( ((vr::VROverlay()->GetPrimaryDashboardDevice() == vr::k_unTrackedDeviceIndex_Hmd) && (data.ConfigInt[configid_int_overlay_detached_origin] == ovrl_origin_hmd)) )
             {
                 vr::VROverlay()->SetOverlayInputMethod(ovrl_handle, vr::VROverlayInputMethod_None);
             }
@@ -4876,14 +4932,12 @@ void OutputManager::ApplySettingInputMode()
         if ( (!drag_or_select_mode_enabled) && (!ConfigManager::Get().GetConfigBool(configid_bool_state_overlay_dragmode)) && (i != k_ulOverlayID_Dashboard) )
         {
             IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), (int)i);
-            IPCManager::Get().SendStringToUIApp(configid_str_state_detached_transform_current, ConfigManager::Get().GetOverlayDetachedTransform().toString(), m_WindowHandle);
+            IPCManager::Get().SendStringToUIApp(configid_str_state_detached_transform_current, ConfigManager::Get().GetOverlayDetachedTransform(i).toString(), m_WindowHandle);
             IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), -1);
         }
 
-        ApplySettingTransform();
+        ApplySettingTransform(i);
     }
-
-    OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
 }
 
 void OutputManager::ApplySettingMouseInput()
@@ -4901,16 +4955,14 @@ void OutputManager::ApplySettingMouseInput()
     bool drag_mode_enabled   = ConfigManager::Get().GetConfigBool(configid_bool_state_overlay_dragmode);
     bool select_mode_enabled = ConfigManager::Get().GetConfigBool(configid_bool_state_overlay_selectmode);
     //Always applies to all overlays
-    unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
     for (unsigned int i = 0; i < OverlayManager::Get().GetOverlayCount(); ++i)
     {
-        OverlayManager::Get().SetCurrentOverlayID(i);
-
-        Overlay& overlay = OverlayManager::Get().GetCurrentOverlay();
+        const Overlay& overlay = OverlayManager::Get().GetOverlay(i);
+        const OverlayConfigData& data = OverlayManager::Get().GetConfigData(i);
         vr::VROverlayHandle_t ovrl_handle = overlay.GetHandle();
 
         //Set input method (possibly overridden by ApplyInputMethod() right afterwards)
-        if (ConfigManager::Get().GetConfigBool(configid_bool_overlay_input_enabled))
+        if (data.ConfigBool[configid_bool_overlay_input_enabled])
         {
             if ((drag_mode_enabled) && (i != k_ulOverlayID_Dashboard))
             {
@@ -4941,7 +4993,7 @@ void OutputManager::ApplySettingMouseInput()
         vr::VROverlay()->SetOverlayFlag(ovrl_handle, vr::VROverlayFlags_HideLaserIntersection, hide_intersection);
 
         //Set mouse scale
-        if (ConfigManager::Get().GetConfigInt(configid_int_overlay_capture_source) == ovrl_capsource_desktop_duplication)
+        if (data.ConfigInt[configid_int_overlay_capture_source] == ovrl_capsource_desktop_duplication)
         {
             vr::HmdVector2_t mouse_scale;
             mouse_scale.v[0] = m_DesktopWidth;
@@ -4996,8 +5048,6 @@ void OutputManager::ApplySettingMouseInput()
             vr::VROverlay()->SetOverlayIntersectionMask(ovrl_handle, nullptr, 0);
         }
     }
-
-    OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
 }
 
 void OutputManager::ApplySettingUpdateLimiter()
@@ -5035,17 +5085,17 @@ void OutputManager::ApplySettingUpdateLimiter()
     limit_delay_global.QuadPart = 1000.0f * limit_ms;
 
     //See if there are any overrides from visible overlays
-    //This is the straight forward and least error-prone way, not quite the most efficient one
-    //Calls to this are minimized and there typically aren't many overlays so it's not really that bad (and we do iterate over all of them in many other places too)
+    //Overlays are filtered with the hot state first, so config data is only accessed for the ones that actually have an override or are WinRT overlays
     bool is_first_override = true;
-    for (unsigned int i = k_ulOverlayID_Dashboard; i < OverlayManager::Get().GetOverlayCount(); ++i)
-    {
-        const Overlay& overlay        = OverlayManager::Get().GetOverlay(i);
-        const OverlayConfigData& data = OverlayManager::Get().GetConfigData(i);
+    const OverlayHotState& hot_state = OverlayManager::Get().GetHotState();
+    const unsigned int overlay_count = OverlayManager::Get().GetOverlayCount();
 
-        if ( (overlay.IsVisible()) && (data.ConfigInt[configid_int_overlay_capture_source] == ovrl_capsource_desktop_duplication) && 
-             (data.ConfigInt[configid_int_overlay_update_limit_override_mode] != update_limit_mode_off) )
+    for (unsigned int i = k_ulOverlayID_Dashboard; i < overlay_count; ++i)
+    {
+        if ( (hot_state.Visible[i]) && (hot_state.CaptureSource[i] == ovrl_capsource_desktop_duplication) && (hot_state.UpdateLimitOverrideMode[i] != update_limit_mode_off) )
         {
+            const OverlayConfigData& data = OverlayManager::Get().GetConfigData(i);
+
             float override_ms = 0.0f;
 
             if (data.ConfigInt[configid_int_overlay_update_limit_override_mode] == update_limit_mode_ms)
@@ -5069,8 +5119,9 @@ void OutputManager::ApplySettingUpdateLimiter()
                 is_first_override = false;
             }
         }
-        else if (data.ConfigInt[configid_int_overlay_capture_source] == ovrl_capsource_winrt_capture) //Set limit values for WinRT overlays as well
+        else if (hot_state.CaptureSource[i] == ovrl_capsource_winrt_capture) //Set limit values for WinRT overlays as well
         {
+            const OverlayConfigData& data = OverlayManager::Get().GetConfigData(i);
             LARGE_INTEGER limit_delay = limit_delay_global;
 
             if (data.ConfigInt[configid_int_overlay_update_limit_override_mode] == update_limit_mode_ms)
@@ -5088,7 +5139,7 @@ void OutputManager::ApplySettingUpdateLimiter()
             }
 
             //Calling this regardless of change might be overkill, but doesn't seem too bad for now
-            DPWinRT_SetOverlayUpdateLimitDelay(overlay.GetHandle(), limit_delay.QuadPart);
+            DPWinRT_SetOverlayUpdateLimitDelay(hot_state.Handle[i], limit_delay.QuadPart);
         }
     }
     
@@ -5101,8 +5152,7 @@ void OutputManager::DragStart(bool is_gesture_drag)
     //Doesn't need calls to the other DragUpdate() or DragFinish() functions in that case
     vr::TrackedDeviceIndex_t device_index = vr::VROverlay()->GetPrimaryDashboardDevice();
 
-    vr::TrackedDevicePose_t poses[vr::k_unMaxTrackedDeviceCount];
-    vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(vr::TrackingUniverseStanding, GetTimeNowToPhotons(), poses, vr::k_unMaxTrackedDeviceCount);
+    const vr::TrackedDevicePose_t* poses = TrackedPoseSnapshot::Get().GetPoses();
 
     Overlay& overlay = OverlayManager::Get().GetCurrentOverlay();
     vr::VROverlayHandle_t ovrl_handle = overlay.GetHandle();
@@ -5176,7 +5226,7 @@ void OutputManager::DragStart(bool is_gesture_drag)
             {
                 if (poses[vr::k_unTrackedDeviceIndex_Hmd].bPoseIsValid)
                 {
-                    vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, &poses[vr::k_unTrackedDeviceIndex_Hmd].mDeviceToAbsoluteTracking);
+                    OverlayPropertyWriter::Get().SetTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, poses[vr::k_unTrackedDeviceIndex_Hmd].mDeviceToAbsoluteTracking);
                 }
                 break;
             }
@@ -5186,7 +5236,7 @@ void OutputManager::DragStart(bool is_gesture_drag)
 
                 if ( (index_right_hand != vr::k_unTrackedDeviceIndexInvalid) && (poses[index_right_hand].bPoseIsValid) )
                 {
-                    vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, &poses[index_right_hand].mDeviceToAbsoluteTracking);
+                    OverlayPropertyWriter::Get().SetTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, poses[index_right_hand].mDeviceToAbsoluteTracking);
                 }
                 break;
             }
@@ -5196,7 +5246,7 @@ void OutputManager::DragStart(bool is_gesture_drag)
 
                 if ( (index_left_hand != vr::k_unTrackedDeviceIndexInvalid) && (poses[index_left_hand].bPoseIsValid) )
                 {
-                    vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, &poses[index_left_hand].mDeviceToAbsoluteTracking);
+                    OverlayPropertyWriter::Get().SetTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, poses[index_left_hand].mDeviceToAbsoluteTracking);
                 }
                 break;
             }
@@ -5206,12 +5256,15 @@ void OutputManager::DragStart(bool is_gesture_drag)
 
                 if ( (index_tracker != vr::k_unTrackedDeviceIndexInvalid) && (poses[index_tracker].bPoseIsValid) )
                 {
-                    vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, &poses[index_tracker].mDeviceToAbsoluteTracking);
+                    OverlayPropertyWriter::Get().SetTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, poses[index_tracker].mDeviceToAbsoluteTracking);
                 }
                 break;
             }
         }
 
+        //Make sure any transform set above or still pending is applied before reading it back
+        OverlayPropertyWriter::Get().Flush();
+
         vr::HmdMatrix34_t transform_target;
         vr::TrackingUniverseOrigin origin;
         vr::VROverlay()->GetOverlayTransformAbsolute(ovrl_handle, &origin, &transform_target);
@@ -5221,12 +5274,11 @@ void OutputManager::DragStart(bool is_gesture_drag)
 
 void OutputManager::DragUpdate()
 {
-    vr::TrackedDevicePose_t poses[vr::k_unMaxTrackedDeviceCount];
-    vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(vr::TrackingUniverseStanding, GetTimeNowToPhotons(), poses, vr::k_unMaxTrackedDeviceCount);
+    const vr::TrackedDevicePose_t* poses = TrackedPoseSnapshot::Get().GetPoses();
 
     if (poses[m_DragModeDeviceID].bPoseIsValid)
     {       
-        Matrix4 matrix_source_current = poses[m_DragModeDeviceID].mDeviceToAbsoluteTracking;
+        Matrix4 matrix_source_current = TrackedPoseSnapshot::Get().GetPoseMatrix(m_DragModeDeviceID);
         Matrix4 matrix_target_new = m_DragModeMatrixTargetStart;
 
         Matrix4 matrix_source_start_inverse = m_DragModeMatrixSourceStart;
@@ -5239,14 +5291,13 @@ void OutputManager::DragUpdate()
         matrix_source_current = matrix_target_new;
 
         vr::HmdMatrix34_t vrmat = matrix_source_current.toOpenVR34();
-        vr::VROverlay()->SetOverlayTransformAbsolute(OverlayManager::Get().GetOverlay(m_DragModeOverlayID).GetHandle(), vr::TrackingUniverseStanding, &vrmat);
+        OverlayPropertyWriter::Get().SetTransformAbsolute(OverlayManager::Get().GetOverlay(m_DragModeOverlayID).GetHandle(), vr::TrackingUniverseStanding, vrmat);
     }
 }
 
 void OutputManager::DragAddDistance(float distance)
 {
-    vr::TrackedDevicePose_t poses[vr::k_unMaxTrackedDeviceCount];
-    vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(vr::TrackingUniverseStanding, GetTimeNowToPhotons(), poses, vr::k_unMaxTrackedDeviceCount);
+    const vr::TrackedDevicePose_t* poses = TrackedPoseSnapshot::Get().GetPoses();
 
     if (poses[m_DragModeDeviceID].bPoseIsValid)
     {
@@ -5298,20 +5349,68 @@ void OutputManager::DragAddWidth(float width)
 
 Matrix4 OutputManager::DragGetBaseOffsetMatrix()
 {
-    Matrix4 matrix; //Identity
+    return DragGetBaseOffsetMatrix(OverlayManager::Get().GetCurrentOverlayID());
+}
 
-    float width = ConfigManager::Get().GetConfigFloat(configid_float_overlay_width);
+Matrix4 OutputManager::DragGetBaseOffsetMatrix(unsigned int overlay_id)
+{
+    const OverlayConfigData& data = OverlayManager::Get().GetConfigData(overlay_id);
     OverlayOrigin overlay_origin;
 
-    if (ConfigManager::Get().GetConfigBool(configid_bool_overlay_detached))
+    if (data.ConfigBool[configid_bool_overlay_detached])
     {
-        overlay_origin = (OverlayOrigin)ConfigManager::Get().GetConfigInt(configid_int_overlay_detached_origin);
+        overlay_origin = (OverlayOrigin)data.ConfigInt[configid_int_overlay_detached_origin];
     }
     else
     {
         overlay_origin = ovrl_origin_dashboard;
     }
 
+    return GetOriginMatrix(overlay_origin);
+}
+
+const Matrix4& OutputManager::GetOverlayMatrix(unsigned int overlay_id)
+{
+    const OverlayConfigData& data = OverlayManager::Get().GetConfigData(overlay_id);
+    const OverlayOrigin overlay_origin = (data.ConfigBool[configid_bool_overlay_detached]) ? (OverlayOrigin)data.ConfigInt[configid_int_overlay_detached_origin] : ovrl_origin_dashboard;
+
+    //Make sure the origin matrix is current first
+    GetOriginMatrix(overlay_origin);
+
+    return m_OriginCache.GetOverlayMatrix(overlay_id, overlay_origin, ConfigManager::Get().GetOverlayDetachedTransform(overlay_id));
+}
+
+const Matrix4& OutputManager::GetOriginMatrix(OverlayOrigin overlay_origin)
+{
+    //Origins following tracked devices are current for one pose snapshot, the others until invalidated
+    unsigned int input_stamp = 0;
+
+    switch (overlay_origin)
+    {
+        case ovrl_origin_hmd_floor:
+        case ovrl_origin_hmd:
+        case ovrl_origin_right_hand:
+        case ovrl_origin_left_hand:
+        case ovrl_origin_aux:
+        {
+            input_stamp = TrackedPoseSnapshot::Get().GetFrameStamp();
+            break;
+        }
+        default: break;
+    }
+
+    if (!m_OriginCache.IsCurrent(overlay_origin, input_stamp))
+    {
+        m_OriginCache.Set(overlay_origin, input_stamp, ComputeOriginMatrix(overlay_origin));
+    }
+
+    return m_OriginCache.Get(overlay_origin);
+}
+
+Matrix4 OutputManager::ComputeOriginMatrix(OverlayOrigin overlay_origin)
+{
+    Matrix4 matrix; //Identity
+
     vr::TrackingUniverseOrigin universe_origin = vr::TrackingUniverseStanding;
 
     switch (overlay_origin)
@@ -5322,8 +5421,7 @@ Matrix4 OutputManager::DragGetBaseOffsetMatrix()
         }
         case ovrl_origin_hmd_floor:
         {
-            vr::TrackedDevicePose_t poses[vr::k_unTrackedDeviceIndex_Hmd + 1];
-            vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(universe_origin, GetTimeNowToPhotons(), poses, vr::k_unTrackedDeviceIndex_Hmd + 1);
+            const vr::TrackedDevicePose_t* poses = TrackedPoseSnapshot::Get().GetPoses();
 
             if (poses[vr::k_unTrackedDeviceIndex_Hmd].bPoseIsValid)
             {
@@ -5407,8 +5505,7 @@ Matrix4 OutputManager::DragGetBaseOffsetMatrix()
              
             if (device_index != vr::k_unTrackedDeviceIndexInvalid)
             {
-                vr::TrackedDevicePose_t poses[vr::k_unMaxTrackedDeviceCount];
-                vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(universe_origin, GetTimeNowToPhotons(), poses, vr::k_unMaxTrackedDeviceCount);
+                const vr::TrackedDevicePose_t* poses = TrackedPoseSnapshot::Get().GetPoses();
 
                 if (poses[device_index].bPoseIsValid)
                 {
@@ -5426,30 +5523,27 @@ void OutputManager::DragFinish()
 {
     DragUpdate();
 
-    unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID(); //DragGetBaseOffsetMatrix() needs the right overlay as current
-    OverlayManager::Get().SetCurrentOverlayID(m_DragModeOverlayID);
-
-    Overlay& overlay = OverlayManager::Get().GetOverlay(m_DragModeOverlayID);
+    const unsigned int overlay_id = m_DragModeOverlayID;
+    Overlay& overlay = OverlayManager::Get().GetOverlay(overlay_id);
     vr::VROverlayHandle_t ovrl_handle = overlay.GetHandle();
 
     vr::HmdMatrix34_t transform_target;
     vr::TrackingUniverseOrigin origin;
 
+    OverlayPropertyWriter::Get().Flush(); //Apply last drag update before reading it back
     vr::VROverlay()->GetOverlayTransformAbsolute(ovrl_handle, &origin, &transform_target);
     Matrix4 matrix_target_finish = transform_target;
 
-    Matrix4 matrix_target_base = DragGetBaseOffsetMatrix();
+    Matrix4 matrix_target_base = DragGetBaseOffsetMatrix(overlay_id);
     matrix_target_base.invert();
 
-    ConfigManager::Get().GetOverlayDetachedTransform() = matrix_target_base * matrix_target_finish;
-    ApplySettingTransform();
+    ConfigManager::Get().GetOverlayDetachedTransform(overlay_id) = matrix_target_base * matrix_target_finish;
+    ApplySettingTransform(overlay_id);
 
     //Restore normal mode
     m_DragModeDeviceID = -1;
     m_DragModeOverlayID = k_ulOverlayID_None;
     ResetMouseLastLaserPointerPos();
-
-    OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
 }
 
 void OutputManager::DragGestureStart()
@@ -5474,14 +5568,12 @@ void OutputManager::DragGestureUpdate()
         OverlayConfigData& overlay_data = OverlayManager::Get().GetConfigData(m_DragModeOverlayID);
         vr::VROverlayHandle_t ovrl_handle = overlay.GetHandle();
 
-        vr::TrackingUniverseOrigin universe_origin = vr::TrackingUniverseStanding;
-        vr::TrackedDevicePose_t poses[vr::k_unMaxTrackedDeviceCount];
-        vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(universe_origin, GetTimeNowToPhotons(), poses, vr::k_unMaxTrackedDeviceCount);
+        const vr::TrackedDevicePose_t* poses = TrackedPoseSnapshot::Get().GetPoses();
 
         if ( (poses[index_right].bPoseIsValid) && (poses[index_left].bPoseIsValid) )
         {
-            Matrix4 mat_right = poses[index_right].mDeviceToAbsoluteTracking;
-            Matrix4 mat_left  = poses[index_left].mDeviceToAbsoluteTracking;
+            Matrix4 mat_right = TrackedPoseSnapshot::Get().GetPoseMatrix(index_right);
+            Matrix4 mat_left  = TrackedPoseSnapshot::Get().GetPoseMatrix(index_left);
 
             //Gesture Scale
             m_DragGestureScaleDistanceLast = mat_right.getTranslation().distance(mat_left.getTranslation());
@@ -5527,7 +5619,7 @@ void OutputManager::DragGestureUpdate()
                 mat_overlay.setTranslation(pos);
 
                 vr::HmdMatrix34_t vrmat = mat_overlay.toOpenVR34();
-                vr::VROverlay()->SetOverlayTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, &vrmat);
+                OverlayPropertyWriter::Get().SetTransformAbsolute(ovrl_handle, vr::TrackingUniverseStanding, vrmat);
             }
 
             m_DragGestureRotateMatLast = matrix_rotate_current;
@@ -5537,34 +5629,24 @@ void OutputManager::DragGestureUpdate()
 
 void OutputManager::DragGestureFinish()
 {
-    unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID(); //DragGetBaseOffsetMatrix() needs the right overlay as current
-    OverlayManager::Get().SetCurrentOverlayID(m_DragModeOverlayID);
-
-    Matrix4 matrix_target_base = DragGetBaseOffsetMatrix();
+    Matrix4 matrix_target_base = DragGetBaseOffsetMatrix(m_DragModeOverlayID);
     matrix_target_base.invert();
 
-    ConfigManager::Get().GetOverlayDetachedTransform() = matrix_target_base * m_DragModeMatrixTargetStart;
-    ApplySettingTransform();
+    ConfigManager::Get().GetOverlayDetachedTransform(m_DragModeOverlayID) = matrix_target_base * m_DragModeMatrixTargetStart;
+    ApplySettingTransform(m_DragModeOverlayID);
 
     m_DragGestureActive = false;
     m_DragModeOverlayID = k_ulOverlayID_None;
-    OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
 }
 
 void OutputManager::DetachedTransformSyncAll()
 {
-    unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
-
     for (unsigned int i = 1; i < OverlayManager::Get().GetOverlayCount(); ++i)
     {
-        OverlayManager::Get().SetCurrentOverlayID(i);
-
         IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), (int)i);
-        IPCManager::Get().SendStringToUIApp(configid_str_state_detached_transform_current, ConfigManager::Get().GetOverlayDetachedTransform().toString(), m_WindowHandle);
+        IPCManager::Get().SendStringToUIApp(configid_str_state_detached_transform_current, ConfigManager::Get().GetOverlayDetachedTransform(i).toString(), m_WindowHandle);
         IPCManager::Get().PostMessageToUIApp(ipcmsg_set_config, ConfigManager::Get().GetWParamForConfigID(configid_int_state_overlay_current_id_override), -1);
     }
-
-    OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
 }
 
 void OutputManager::DetachedTransformReset(vr::VROverlayHandle_t ovrl_handle_ref)
@@ -5590,11 +5672,15 @@ void OutputManager::DetachedTransformReset(vr::VROverlayHandle_t ovrl_handle_ref
         bool ref_overlay_changed = false;
         float ref_overlay_alpha_orig = 0.0f;
 
+        //Reference overlay state is read back directly below, so pending writes need to be applied first
+        OverlayPropertyWriter::Get().Flush();
+
         //GetTransformForOverlayCoordinates() won't work if the reference overlay is not visible, so make it "visible" by showing it with 0% alpha
         if (!vr::VROverlay()->IsOverlayVisible(ovrl_handle_ref))
         {
             vr::VROverlay()->GetOverlayAlpha(ovrl_handle_ref, &ref_overlay_alpha_orig);
-            vr::VROverlay()->SetOverlayAlpha(ovrl_handle_ref, 0.0f);
+            OverlayPropertyWriter::Get().SetAlpha(ovrl_handle_ref, 0.0f);
+            OverlayPropertyWriter::Get().Flush();
             vr::VROverlay()->ShowOverlay(ovrl_handle_ref);
 
             //Showing overlays and getting coordinates from them has a race condition if it's the first time the overlay is shown
@@ -5634,16 +5720,14 @@ void OutputManager::DetachedTransformReset(vr::VROverlayHandle_t ovrl_handle_ref
         if (ref_overlay_changed)
         {
             vr::VROverlay()->HideOverlay(ovrl_handle_ref);
-            vr::VROverlay()->SetOverlayAlpha(ovrl_handle_ref, ref_overlay_alpha_orig);
+            OverlayPropertyWriter::Get().SetAlpha(ovrl_handle_ref, ref_overlay_alpha_orig);
         }
 
         //If the reference overlay appears to be below ground we assume it has an invalid origin (i.e. dashboard tab never opened for dashboard overlay) and try to provide a better default
         if (transform.getTranslation().y < 0.0f)
         {
             //Get HMD pose
-            vr::TrackedDevicePose_t poses[vr::k_unTrackedDeviceIndex_Hmd + 1];
-            vr::TrackingUniverseOrigin universe_origin = vr::TrackingUniverseStanding;
-            vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(universe_origin, GetTimeNowToPhotons(), poses, vr::k_unTrackedDeviceIndex_Hmd + 1);
+            const vr::TrackedDevicePose_t* poses = TrackedPoseSnapshot::Get().GetPoses();
 
             if (poses[vr::k_unTrackedDeviceIndex_Hmd].bPoseIsValid)
             {
@@ -5757,9 +5841,7 @@ void OutputManager::DetachedTransformAdjust(unsigned int packed_value)
     if (target == ipcactv_ovrl_pos_adjust_lookat)
     {
         //Get HMD pose
-        vr::TrackedDevicePose_t poses[vr::k_unTrackedDeviceIndex_Hmd + 1];
-        vr::TrackingUniverseOrigin universe_origin = vr::TrackingUniverseStanding;
-        vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(universe_origin, GetTimeNowToPhotons(), poses, vr::k_unTrackedDeviceIndex_Hmd + 1);
+        const vr::TrackedDevicePose_t* poses = TrackedPoseSnapshot::Get().GetPoses();
 
         if (poses[vr::k_unTrackedDeviceIndex_Hmd].bPoseIsValid)
         {
@@ -5826,13 +5908,10 @@ void OutputManager::DetachedTransformAdjust(unsigned int packed_value)
     ApplySettingTransform();
 }
 
-void OutputManager::DetachedTransformUpdateHMDFloor()
+void OutputManager::DetachedTransformUpdateHMDFloor(unsigned int overlay_id)
 {
-    Matrix4 matrix = DragGetBaseOffsetMatrix();
-    matrix *= ConfigManager::Get().GetOverlayDetachedTransform();
-
-    vr::HmdMatrix34_t matrix_ovr = matrix.toOpenVR34();
-    vr::VROverlay()->SetOverlayTransformAbsolute(OverlayManager::Get().GetCurrentOverlay().GetHandle(), vr::TrackingUniverseStanding, &matrix_ovr);
+    vr::HmdMatrix34_t matrix_ovr = GetOverlayMatrix(overlay_id).toOpenVR34();
+    OverlayPropertyWriter::Get().SetTransformAbsolute(OverlayManager::Get().GetOverlay(overlay_id).GetHandle(), vr::TrackingUniverseStanding, matrix_ovr);
 }
 
 void OutputManager::DetachedTransformUpdateSeatedPosition()
@@ -5846,35 +5925,33 @@ void OutputManager::DetachedTransformUpdateSeatedPosition()
         mat_seated_zero = vr::VRSystem()->GetSeatedZeroPoseToStandingAbsoluteTrackingPose();
     }
 
+    m_OriginCache.Set(ovrl_origin_seated_universe, 0, mat_seated_zero);
+
     //Update transforms of relevant overlays
-    unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
     for (unsigned int i = 1; i < OverlayManager::Get().GetOverlayCount(); ++i)
     {
-        OverlayManager::Get().SetCurrentOverlayID(i);
-
-        if (ConfigManager::Get().GetConfigInt(configid_int_overlay_detached_origin) == ovrl_origin_seated_universe)
+        if (OverlayManager::Get().GetConfigData(i).ConfigInt[configid_int_overlay_detached_origin] == ovrl_origin_seated_universe)
         {
-            ApplySettingTransform();
+            ApplySettingTransform(i);
         }
     }
 
-    OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
-
     m_SeatedTransformLast = mat_seated_zero;
 }
 
-void OutputManager::DetachedInteractionAutoToggle()
+void OutputManager::DetachedInteractionAutoToggle(unsigned int overlay_id)
 {
     //Don't change flags while any drag is currently active
     if ((m_DragModeDeviceID != -1) || (m_DragGestureActive))
         return;
 
-    Overlay& overlay = OverlayManager::Get().GetCurrentOverlay();
+    Overlay& overlay = OverlayManager::Get().GetOverlay(overlay_id);
+    const OverlayConfigData& data = OverlayManager::Get().GetConfigData(overlay_id);
     vr::VROverlayHandle_t ovrl_handle = overlay.GetHandle();
 
     float max_distance = ConfigManager::Get().GetConfigFloat(configid_float_input_detached_interaction_max_distance);
 
-    if ((ConfigManager::Get().GetConfigBool(configid_bool_overlay_detached)) && (overlay.IsVisible()) && (max_distance != 0.0f) && (!vr::VROverlay()->IsDashboardVisible()))
+    if ((data.ConfigBool[configid_bool_overlay_detached]) && (overlay.IsVisible()) && (max_distance != 0.0f) && (!vr::VROverlay()->IsDashboardVisible()))
     {
         bool do_set_interactive = false;
 
@@ -5884,10 +5961,9 @@ void OutputManager::DetachedInteractionAutoToggle()
             max_distance += 0.01f;
         }
 
-        vr::TrackedDevicePose_t poses[vr::k_unMaxTrackedDeviceCount];
-        vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(vr::TrackingUniverseStanding, GetTimeNowToPhotons(), poses, vr::k_unMaxTrackedDeviceCount);
+        const vr::TrackedDevicePose_t* poses = TrackedPoseSnapshot::Get().GetPoses();
 
-        OverlayOrigin origin = (OverlayOrigin)ConfigManager::Get().GetConfigInt(configid_int_overlay_detached_origin);
+        OverlayOrigin origin = (OverlayOrigin)data.ConfigInt[configid_int_overlay_detached_origin];
 
         //Check left and right hand controller
         vr::ETrackedControllerRole controller_role = vr::TrackedControllerRole_LeftHand;
@@ -5902,7 +5978,7 @@ void OutputManager::DetachedInteractionAutoToggle()
                 if ((device_index < vr::k_unMaxTrackedDeviceCount) && (poses[device_index].bPoseIsValid))
                 {
                     //Get matrix with tip offset
-                    Matrix4 mat_controller = poses[device_index].mDeviceToAbsoluteTracking;
+                    Matrix4 mat_controller = TrackedPoseSnapshot::Get().GetPoseMatrix(device_index);
                     mat_controller = mat_controller * GetControllerTipMatrix( (controller_role == vr::TrackedControllerRole_RightHand) );
 
                     //Set up intersection test
@@ -5938,92 +6014,73 @@ void OutputManager::DetachedInteractionAutoToggle()
     }
 }
 
-void OutputManager::DetachedOverlayGazeFade()
+void OutputManager::DetachedOverlayGazeFadeAll()
 {
-    if (  (ConfigManager::Get().GetConfigBool(configid_bool_overlay_gazefade_enabled)) && (!ConfigManager::Get().GetConfigBool(configid_bool_state_overlay_dragmode)) && 
-         (!ConfigManager::Get().GetConfigBool(configid_bool_state_overlay_selectmode)) )
-    {
-        vr::TrackingUniverseOrigin universe_origin = vr::TrackingUniverseStanding;
-        vr::TrackedDevicePose_t poses[vr::k_unTrackedDeviceIndex_Hmd + 1];
-        vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(universe_origin, GetTimeNowToPhotons(), poses, vr::k_unTrackedDeviceIndex_Hmd + 1);
+    //Gaze fade is done for all overlays in one go. Per-overlay input is gathered first, then the fade math runs over plain arrays
+    static GazeFadeBatch fade_batch;
 
-        if (poses[vr::k_unTrackedDeviceIndex_Hmd].bPoseIsValid)
-        {
-            //Distance the gaze point is offset from HMD (useful range 0.25 - 1.0)
-            float gaze_distance = ConfigManager::Get().GetConfigFloat(configid_float_overlay_gazefade_distance);
-            //Rate the fading gets applied when looking off the gaze point (useful range 4.0 - 30, depends on overlay size) 
-            float fade_rate = ConfigManager::Get().GetConfigFloat(configid_float_overlay_gazefade_rate) * 10.0f; 
+    if ( (ConfigManager::Get().GetConfigBool(configid_bool_state_overlay_dragmode)) || (ConfigManager::Get().GetConfigBool(configid_bool_state_overlay_selectmode)) )
+        return;
 
-            Matrix4 mat_pose = poses[vr::k_unTrackedDeviceIndex_Hmd].mDeviceToAbsoluteTracking;
+    if (!TrackedPoseSnapshot::Get().GetPose(vr::k_unTrackedDeviceIndex_Hmd).bPoseIsValid)
+        return;
 
-            Matrix4 mat_overlay = DragGetBaseOffsetMatrix();
-            mat_overlay *= ConfigManager::Get().GetOverlayDetachedTransform();
+    fade_batch.Clear();
 
-            //Infinite/Auto distance mode
-            if (gaze_distance == 0.0f) 
-            {
-                gaze_distance = mat_overlay.getTranslation().distance(mat_pose.getTranslation()); //Match gaze distance to distance between HMD and overlay
-            }
-            else
-            {
-                gaze_distance += 0.20f; //Useful range starts at ~0.20 - 0.25 (lower is in HMD or culled away), so offset the settings value
-            }
+    for (unsigned int i = 0; i < OverlayManager::Get().GetOverlayCount(); ++i)
+    {
+        const OverlayConfigData& data = OverlayManager::Get().GetConfigData(i);
 
-            OffsetTransformFromSelf(mat_pose, 0.0f, 0.0f, -gaze_distance);
+        if ( (!data.ConfigBool[configid_bool_overlay_enabled]) || (!data.ConfigBool[configid_bool_overlay_gazefade_enabled]) )
+            continue;
 
-            Vector3 pos_gaze = mat_pose.getTranslation();
-            float distance = mat_overlay.getTranslation().distance(pos_gaze);
+        fade_batch.Add(i, GetOverlayMatrix(i).getTranslation(), data.ConfigFloat[configid_float_overlay_gazefade_distance], data.ConfigFloat[configid_float_overlay_gazefade_rate]);
+    }
 
-            gaze_distance = std::min(gaze_distance, 1.0f); //To get useful fading past 1m distance we'll have to limit the value to 1m here for the math below
+    if (fade_batch.GetCount() == 0)
+        return;
 
-            float alpha = clamp((distance * -fade_rate) + ((gaze_distance - 0.1f) * 10.0f), 0.0f, 1.0f); //There's nothing smart behind this, just trial and error
+    fade_batch.Compute(TrackedPoseSnapshot::Get().GetPoseMatrix(vr::k_unTrackedDeviceIndex_Hmd));
 
-            const float max_alpha = ConfigManager::Get().GetConfigFloat(configid_float_overlay_opacity);
-            const float min_alpha = ConfigManager::Get().GetConfigFloat(configid_float_overlay_gazefade_opacity);
-            Overlay& current_overlay = OverlayManager::Get().GetCurrentOverlay();
+    const unsigned int floating_ui_hovered_id = (unsigned int)ConfigManager::Get().GetConfigInt(configid_int_state_interface_floating_ui_hovered_id);
 
-            //Use max alpha when the overlay or the Floating UI targeting the overlay is being pointed at
-            if ((vr::VROverlay()->IsHoverTargetOverlay(current_overlay.GetHandle())) || 
-                ((unsigned int)ConfigManager::Get().GetConfigInt(configid_int_state_interface_floating_ui_hovered_id) == current_overlay.GetID()))
-            {
-                alpha = std::max(min_alpha, max_alpha); //Take whatever's more visible as the user probably wants to be able to see the overlay
-            }
-            else //Adapt alpha result from a 0.0 - 1.0 range to gazefade_opacity - overlay_opacity and invert if necessary
-            {
-                const float range_length = max_alpha - min_alpha;
+    for (size_t k = 0; k < fade_batch.GetCount(); ++k)
+    {
+        const OverlayConfigData& data = OverlayManager::Get().GetConfigData(fade_batch.GetOverlayID(k));
+        Overlay& overlay = OverlayManager::Get().GetOverlay(fade_batch.GetOverlayID(k));
 
-                if (range_length >= 0.0f)
-                {
-                    alpha = (alpha * range_length) + min_alpha;
-                }
-                else //Gaze Fade target opacity higher than overlay opcacity, invert behavior
-                {
-                    alpha = ((alpha - 1.0f) * range_length) + max_alpha;
-                }
-            }
+        const float max_alpha = data.ConfigFloat[configid_float_overlay_opacity];
+        const float min_alpha = data.ConfigFloat[configid_float_overlay_gazefade_opacity];
+        const float hover_alpha = std::max(min_alpha, max_alpha); //Take whatever's more visible as the user probably wants to be able to see the overlay
 
-            //Limit alpha change per frame to smooth out things when abrupt changes happen (i.e. overlay capture took a bit to re-enable or laser pointer forces full alpha)
-            const float prev_alpha = current_overlay.GetOpacity();
-            const float diff = alpha - prev_alpha;
+        //Adapt alpha result from a 0.0 - 1.0 range to gazefade_opacity - overlay_opacity and invert if necessary
+        float alpha = GazeFadeBatch::MapAlphaToOpacityRange(fade_batch.GetAlpha(k), max_alpha, min_alpha);
 
-            current_overlay.SetOpacity(prev_alpha + clamp(diff, -0.1f, 0.1f));
+        //Use max alpha when the overlay or the Floating UI targeting the overlay is being pointed at
+        //The hover check is an RPC, so skip it when it wouldn't change anything
+        if (alpha < hover_alpha)
+        {
+            if ( (floating_ui_hovered_id == overlay.GetID()) || ( (overlay.IsVisible()) && (vr::VROverlay()->IsHoverTargetOverlay(overlay.GetHandle())) ) )
+            {
+                alpha = hover_alpha;
+            }
         }
+
+        overlay.SetOpacity(GazeFadeBatch::LimitOpacityChange(overlay.GetOpacity(), alpha));
     }
 }
 
 void OutputManager::DetachedOverlayGazeFadeAutoConfigure()
 {
-    vr::TrackedDevicePose_t poses[vr::k_unTrackedDeviceIndex_Hmd + 1];
-    vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(vr::TrackingUniverseStanding, GetTimeNowToPhotons(), poses, vr::k_unTrackedDeviceIndex_Hmd + 1);
+    const vr::TrackedDevicePose_t* poses = TrackedPoseSnapshot::Get().GetPoses();
 
     if (poses[vr::k_unTrackedDeviceIndex_Hmd].bPoseIsValid)
     {
         OverlayConfigData& data = OverlayManager::Get().GetCurrentConfigData();
 
-        Matrix4 mat_pose = poses[vr::k_unTrackedDeviceIndex_Hmd].mDeviceToAbsoluteTracking;
+        Matrix4 mat_pose = TrackedPoseSnapshot::Get().GetPoseMatrix(vr::k_unTrackedDeviceIndex_Hmd);
 
-        Matrix4 mat_overlay = DragGetBaseOffsetMatrix();
-        mat_overlay *= ConfigManager::Get().GetOverlayDetachedTransform();
+        const Matrix4& mat_overlay = GetOverlayMatrix(OverlayManager::Get().GetCurrentOverlayID());
 
         //Match gaze distance to distance between HMD and overlay
         float gaze_distance = mat_overlay.getTranslation().distance(mat_pose.getTranslation());
@@ -6051,17 +6108,19 @@ void OutputManager::DetachedOverlayGlobalHMDPointerAll()
         return;
 
     static vr::VROverlayHandle_t ovrl_last_enter = vr::k_ulOverlayHandleInvalid;
+    //The local intersection test decides which overlay is targeted, so no edge margin to not pick an overlay the pointer is only close to
+    static OverlayRaycaster raycaster;
+    static std::vector<OverlayRaycastShape> raycast_shapes;
+    static std::vector<OverlayRaycastHit> raycast_hits;
+    static std::vector<unsigned int> raycast_unknown_ids;
 
-    vr::TrackingUniverseOrigin universe_origin = vr::TrackingUniverseStanding;
-    vr::TrackedDevicePose_t poses[vr::k_unTrackedDeviceIndex_Hmd + 1];
-    vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(universe_origin, GetTimeNowToPhotons(), poses, vr::k_unTrackedDeviceIndex_Hmd + 1);
+    const vr::TrackedDevicePose_t* poses = TrackedPoseSnapshot::Get().GetPoses();
 
     if (!poses[vr::k_unTrackedDeviceIndex_Hmd].bPoseIsValid)
         return;
 
     //Set up intersection test
-    bool hit_nothing = true;
-    Matrix4 mat_hmd = poses[vr::k_unTrackedDeviceIndex_Hmd].mDeviceToAbsoluteTracking;
+    Matrix4 mat_hmd = TrackedPoseSnapshot::Get().GetPoseMatrix(vr::k_unTrackedDeviceIndex_Hmd);
     Vector3 v_pos = mat_hmd.getTranslation();
     Vector3 forward = {mat_hmd[8], mat_hmd[9], mat_hmd[10]};
     forward *= -1.0f;
@@ -6079,27 +6138,59 @@ void OutputManager::DetachedOverlayGlobalHMDPointerAll()
     float max_distance = ConfigManager::Get().GetConfigFloat(configid_float_input_global_hmd_pointer_max_distance);
     max_distance = (max_distance != 0.0f) ? max_distance + 0.20f /* HMD origin is inside the headset */ : FLT_MAX /* 0 == infinite */; 
     
-    unsigned int current_overlay_old = OverlayManager::Get().GetCurrentOverlayID();
-    
-    for (unsigned int i = 1; i < OverlayManager::Get().GetOverlayCount(); ++i)
-    {
-        OverlayManager::Get().SetCurrentOverlayID(i);
-        Overlay& overlay = OverlayManager::Get().GetCurrentOverlay();
-        const OverlayConfigData& data = OverlayManager::Get().GetCurrentConfigData();
+    const OverlayHotState& hot_state = OverlayManager::Get().GetHotState();
+    const unsigned int overlay_count = OverlayManager::Get().GetOverlayCount();
+
+    raycast_shapes.clear();
+    raycast_unknown_ids.clear();
 
-        if (overlay.IsVisible())
+    //Cached, so this doesn't cost an RPC per overlay (or at all, usually)
+    const Matrix4& mat_seated_zero = GetOriginMatrix(ovrl_origin_seated_universe);
+
+    for (unsigned int i = 1; i < overlay_count; ++i)
+    {
+        if (hot_state.Visible[i])
         {
-            if ( (vr::VROverlay()->ComputeOverlayIntersection(OverlayManager::Get().GetCurrentOverlay().GetHandle(), &params, &results)) && (results.fDistance <= max_distance) &&
-                 (results.fDistance < nearest_results.fDistance) )
+            OverlayRaycastShape shape;
+
+            if (DetachedOverlayGetRaycastShape(i, poses, mat_seated_zero, shape))
+            {
+                raycast_shapes.push_back(shape);
+            }
+            else
             {
-                hit_nothing = false;
-                nearest_target_overlay = OverlayManager::Get().GetCurrentOverlay().GetHandle();
-                nearest_results = results;
-            }  
+                raycast_unknown_ids.push_back(i);
+            }
         }
     }
 
-    OverlayManager::Get().SetCurrentOverlayID(current_overlay_old);
+    //Hierarchy is only rebuilt if any shape changed
+    raycaster.Update(raycast_shapes);
+    raycaster.Raycast(v_pos, forward, max_distance, raycast_hits);
+
+    //Local result is trusted, so only the nearest local hit is tested with OpenVR. This also gets the UV coordinates needed for the mouse position
+    //A local miss needs no RPC at all
+    if (!raycast_hits.empty())
+    {
+        vr::VROverlayHandle_t ovrl_handle = hot_state.Handle[raycast_hits[0].OverlayID];
+
+        if ( (vr::VROverlay()->ComputeOverlayIntersection(ovrl_handle, &params, &results)) && (results.fDistance <= max_distance) )
+        {
+            nearest_target_overlay = ovrl_handle;
+            nearest_results = results;
+        }
+    }
+
+    //Overlays without known shape are always tested with OpenVR
+    for (unsigned int i : raycast_unknown_ids)
+    {
+        if ( (vr::VROverlay()->ComputeOverlayIntersection(hot_state.Handle[i], &params, &results)) && (results.fDistance <= max_distance) &&
+             (results.fDistance < nearest_results.fDistance) )
+        {
+            nearest_target_overlay = hot_state.Handle[i];
+            nearest_results = results;
+        }
+    }
 
     //If we hit a different overlay (or lack thereof)...
     if (nearest_target_overlay != ovrl_last_enter)
@@ -6152,15 +6243,76 @@ void OutputManager::DetachedOverlayGlobalHMDPointerAll()
     ovrl_last_enter = nearest_target_overlay;
 }
 
+bool OutputManager::DetachedOverlayGetRaycastShape(unsigned int overlay_id, const vr::TrackedDevicePose_t* poses, const Matrix4& mat_seated_zero, OverlayRaycastShape& shape) const
+{
+    const Overlay& overlay = OverlayManager::Get().GetOverlay(overlay_id);
+    const OverlayConfigData& data = OverlayManager::Get().GetConfigData(overlay_id);
+
+    //Get transform as last set by us and make it absolute standing
+    vr::ETrackingUniverseOrigin origin;
+    vr::TrackedDeviceIndex_t device_index;
+    vr::HmdMatrix34_t matrix;
+
+    if (!OverlayPropertyWriter::Get().GetLastTransform(overlay.GetHandle(), origin, device_index, matrix))
+        return false;
+
+    shape.Transform = matrix;
+
+    if (device_index != vr::k_unTrackedDeviceIndexInvalid)
+    {
+        if ( (device_index >= vr::k_unMaxTrackedDeviceCount) || (!poses[device_index].bPoseIsValid) )
+            return false;
+
+        shape.Transform = TrackedPoseSnapshot::Get().GetPoseMatrix(device_index) * shape.Transform;
+    }
+    else if (origin == vr::TrackingUniverseSeated)
+    {
+        shape.Transform = mat_seated_zero * shape.Transform;
+    }
+    else if (origin != vr::TrackingUniverseStanding)
+    {
+        return false;
+    }
+
+    //UI overlays get their size and mouse scale from the UI process, which isn't known here
+    if (overlay.GetTextureSource() == ovrl_texsource_ui)
+        return false;
+
+    //Get size the same way ApplySettingTransform() does
+    const DPRect& crop_rect = overlay.GetValidatedCropRect();
+    bool is_desktop_duplication = (data.ConfigInt[configid_int_overlay_capture_source] == ovrl_capsource_desktop_duplication);
+
+    if ( (overlay.GetTextureSource() == ovrl_texsource_none) || ( (is_desktop_duplication) && (m_OutputInvalid) ) )
+        return false;
+
+    //Desktop duplication overlays use the full desktop as mouse scale
+    const int mode_3d = data.ConfigInt[configid_int_overlay_3D_mode];
+    const float aspect = OverlayRaycaster::GetOverlayAspectRatio(crop_rect.GetWidth(), crop_rect.GetHeight(),
+                                                                 (is_desktop_duplication) ? m_DesktopWidth  : 0,
+                                                                 (is_desktop_duplication) ? m_DesktopHeight : 0,
+                                                                 ( (mode_3d == ovrl_3Dmode_sbs) || (mode_3d == ovrl_3Dmode_ou) ), (mode_3d == ovrl_3Dmode_ou));
+
+    if (aspect == 0.0f)
+        return false;
+
+    shape.OverlayID = overlay_id;
+    shape.Width     = data.ConfigFloat[configid_float_overlay_width];
+    shape.Height    = shape.Width * aspect;
+    shape.Curvature = data.ConfigFloat[configid_float_overlay_curvature];
+
+    return true;
+}
+
 void OutputManager::UpdateDashboardHMD_Y()
 {
-    vr::TrackingUniverseOrigin universe_origin = vr::TrackingUniverseStanding;
-    vr::TrackedDevicePose_t poses[vr::k_unTrackedDeviceIndex_Hmd + 1];
-    vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(universe_origin, GetTimeNowToPhotons(), poses, vr::k_unTrackedDeviceIndex_Hmd + 1);
+    //Dashboard origin depends on this and it's also called whenever the dashboard has moved
+    m_OriginCache.Invalidate(ovrl_origin_dashboard);
+
+    const vr::TrackedDevicePose_t* poses = TrackedPoseSnapshot::Get().GetPoses();
 
     if (poses[vr::k_unTrackedDeviceIndex_Hmd].bPoseIsValid)
     {
-        Matrix4 mat_pose = poses[vr::k_unTrackedDeviceIndex_Hmd].mDeviceToAbsoluteTracking;
+        Matrix4 mat_pose = TrackedPoseSnapshot::Get().GetPoseMatrix(vr::k_unTrackedDeviceIndex_Hmd);
         m_DashboardHMD_Y = mat_pose.getTranslation().y;
     }
 }
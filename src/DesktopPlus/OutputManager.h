@@ -15,9 +15,12 @@
 #include "VRInput.h"
 #include "BackgroundOverlay.h"
 #include "OUtoSBSConverter.h"
+#include "OverlayOriginCache.h"
+#include "OneEuroFilter.h"
 #include "InterprocessMessaging.h"
 
 class Overlay;
+struct OverlayRaycastShape;
 //
 // This class evolved into handling almost everything
 // Updates the output texture, sends it to OpenVR, handles OpenVR events, IPC messages...
@@ -44,6 +47,7 @@ class OutputManager
 
         void ResetOverlays();
         void ResetCurrentOverlay();
+        void ResetOverlay(unsigned int overlay_id);
 
         ID3D11Texture2D* GetOverlayTexture() const; //This returns m_OvrlTex, the backing texture used by the desktop texture overlay (and all overlays stealing its texture)
         ID3D11Texture2D* GetMultiGPUTargetTexture() const;
@@ -78,7 +82,7 @@ class OutputManager
         //This updates the cached desktop rects and count and optionally chooses the adapters/desktop for desktop duplication (previously part of InitOutput())
         int EnumerateOutputs(int target_desktop_id = -1, Microsoft::WRL::ComPtr<IDXGIAdapter>* out_adapter_preferred = nullptr, Microsoft::WRL::ComPtr<IDXGIAdapter>* out_adapter_vr = nullptr);
 
-        void ConvertOUtoSBS(Overlay& overlay, OUtoSBSConverter& converter);
+        void ConvertOUtoSBS(Overlay& overlay, const DPRect* dirty_rect);  //Only valid during RefreshOpenVROverlayTexture(), where the converter cache is updated
 
     private:
     // Methods
@@ -93,6 +97,7 @@ class OutputManager
 
         bool HandleOpenVREvents();  //Returns true if quit event happened
         void OnOpenVRMouseEvent(const vr::VREvent_t& vr_event, unsigned int& current_overlay_old);
+        void LaserPointerSmoothingApply(unsigned int overlay_id, float& mouse_x, float& mouse_y);
         void OnKeyboardClosed();
         void HandleKeyboardHelperMessage(LPARAM lparam);
         bool HandleOverlayProfileLoadMessage(LPARAM lparam);
@@ -103,13 +108,19 @@ class OutputManager
         void ShowWindowSwitcher();
         void ResetMouseLastLaserPointerPos();
         void CropToActiveWindow();
-        void CropToDisplay(int display_id, bool do_not_apply_setting = false);
+        void CropToDisplay(int display_id, bool do_not_apply_setting = false);                      //Of current overlay
+        void CropToDisplay(unsigned int overlay_id, int display_id, bool do_not_apply_setting);
         void AddOverlay(unsigned int base_id, bool is_ui_overlay = false);
 
+        //The overloads without overlay ID apply to the current overlay
         void ApplySettingCaptureSource();
+        void ApplySettingCaptureSource(unsigned int overlay_id);
         void ApplySetting3DMode();
+        void ApplySetting3DMode(unsigned int overlay_id);
         void ApplySettingTransform();
+        void ApplySettingTransform(unsigned int overlay_id);
         void ApplySettingCrop();
+        void ApplySettingCrop(unsigned int overlay_id);
         void ApplySettingInputMode();
         void ApplySettingMouseInput();
         void ApplySettingUpdateLimiter();
@@ -118,7 +129,11 @@ class OutputManager
         void DragUpdate();
         void DragAddDistance(float distance);
         void DragAddWidth(float width);
-        Matrix4 DragGetBaseOffsetMatrix();
+        Matrix4 DragGetBaseOffsetMatrix();                              //Of current overlay
+        Matrix4 DragGetBaseOffsetMatrix(unsigned int overlay_id);
+        const Matrix4& GetOriginMatrix(OverlayOrigin overlay_origin);   //Cached, see OverlayOriginCache
+        const Matrix4& GetOverlayMatrix(unsigned int overlay_id);       //DragGetBaseOffsetMatrix() * detached transform, cached as well
+        Matrix4 ComputeOriginMatrix(OverlayOrigin overlay_origin);
         void DragFinish();
 
         void DragGestureStart();
@@ -128,13 +143,16 @@ class OutputManager
         void DetachedTransformSyncAll();
         void DetachedTransformReset(vr::VROverlayHandle_t ovrl_handle_ref = vr::k_ulOverlayHandleInvalid);
         void DetachedTransformAdjust(unsigned int packed_value);
-        void DetachedTransformUpdateHMDFloor();
+        void DetachedTransformUpdateHMDFloor(unsigned int overlay_id);
         void DetachedTransformUpdateSeatedPosition();
 
-        void DetachedInteractionAutoToggle();
-        void DetachedOverlayGazeFade();
+        //These take the overlay explicitly and don't depend on the current overlay, so they can be called for any overlay without switching it
+        void DetachedInteractionAutoToggle(unsigned int overlay_id);
+        void DetachedOverlayGazeFadeAll();
         void DetachedOverlayGazeFadeAutoConfigure();
         void DetachedOverlayGlobalHMDPointerAll();
+        bool DetachedOverlayGetRaycastShape(unsigned int overlay_id, const vr::TrackedDevicePose_t* poses, const Matrix4& mat_seated_zero,   //False if not enough is known
+                                            OverlayRaycastShape& shape) const;
 
         void UpdateDashboardHMD_Y();
         bool HasDashboardMoved();
@@ -214,6 +232,9 @@ class OutputManager
         int m_MouseDefaultHotspotX;
         int m_MouseDefaultHotspotY;
         int m_MouseIgnoreMoveEventMissCount;
+        OneEuroFilter m_MouseLaserPointerFilterX;
+        OneEuroFilter m_MouseLaserPointerFilterY;
+        unsigned int m_MouseLaserPointerFilterOverlayID;
 
         bool m_IsFirstLaunch;
         bool m_ComInitDone;
@@ -232,6 +253,7 @@ class OutputManager
         Matrix4 m_DashboardTransformLast;       //This is only used to check if the dashboard has moved from events we can't detect otherwise
         float m_DashboardHMD_Y;                 //The HMDs y-position when the dashboard was activated. Used for dashboard-relative positioning
         Matrix4 m_SeatedTransformLast;
+        OverlayOriginCache m_OriginCache;
 
         //These are only used when duplicating outputs from a different GPU
         ID3D11Device* m_MultiGPUTargetDevice;   //Target D3D11 device, meaning the one the HMD is connected to
@@ -239,6 +261,8 @@ class OutputManager
         ID3D11Texture2D* m_MultiGPUTexStaging;  //Staging texture, owned by m_Device
         ID3D11Texture2D* m_MultiGPUTexTarget;   //Target texture to copy to, owned by m_MultiGPUTargetDevice
 
+        OUtoSBSConverterCache m_OUtoSBSConverters;
+
         int m_PerformanceFrameCount;
         ULONGLONG m_PerformanceFrameCountStartTick;
         LARGE_INTEGER m_PerformanceUpdateLimiterDelay;
@@ -0,0 +1,69 @@
+#include "OverlayHandleMap.h"
+
+OverlayHandleMap::OverlayHandleMap() : m_SlotMask(0)
+{
+}
+
+size_t OverlayHandleMap::HashHandle(vr::VROverlayHandle_t handle)
+{
+    //Handles are not guaranteed to be well distributed in the lower bits, so mix them up first (finalizer from MurmurHash3)
+    uint64_t h = handle;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+
+    return (size_t)h;
+}
+
+void OverlayHandleMap::Build(const std::vector<vr::VROverlayHandle_t>& handles)
+{
+    //Keep load factor at or below 50% so probe sequences stay short
+    size_t slot_count = 16;
+    while (slot_count < handles.size() * 2)
+    {
+        slot_count *= 2;
+    }
+
+    m_Slots.assign(slot_count, {vr::k_ulOverlayHandleInvalid, k_ulIDNone});
+    m_SlotMask = slot_count - 1;
+
+    for (unsigned int i = 0; i < handles.size(); ++i)
+    {
+        if (handles[i] == vr::k_ulOverlayHandleInvalid)
+            continue;
+
+        size_t slot_id = HashHandle(handles[i]) & m_SlotMask;
+
+        //Linear probing. If the same handle is in the list twice, the lower ID wins, same as a linear search would
+        while ( (m_Slots[slot_id].Handle != vr::k_ulOverlayHandleInvalid) && (m_Slots[slot_id].Handle != handles[i]) )
+        {
+            slot_id = (slot_id + 1) & m_SlotMask;
+        }
+
+        if (m_Slots[slot_id].Handle == vr::k_ulOverlayHandleInvalid)
+        {
+            m_Slots[slot_id] = {handles[i], i};
+        }
+    }
+}
+
+unsigned int OverlayHandleMap::Find(vr::VROverlayHandle_t handle) const
+{
+    if ( (m_Slots.empty()) || (handle == vr::k_ulOverlayHandleInvalid) )
+        return k_ulIDNone;
+
+    size_t slot_id = HashHandle(handle) & m_SlotMask;
+
+    //There's always at least one empty slot, so this terminates
+    while (m_Slots[slot_id].Handle != vr::k_ulOverlayHandleInvalid)
+    {
+        if (m_Slots[slot_id].Handle == handle)
+            return m_Slots[slot_id].ID;
+
+        slot_id = (slot_id + 1) & m_SlotMask;
+    }
+
+    return k_ulIDNone;
+}
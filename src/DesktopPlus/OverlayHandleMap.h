@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+#include <climits>
+
+#include "openvr.h"
+
+//Flat open-addressing hash map from OpenVR overlay handle to overlay ID, used by OverlayManager::FindOverlayID()
+//Overlay handles rarely change compared to how often they're looked up (every overlay event), so the map is simply rebuilt from the handle list
+//on changes. This avoids having to deal with deletion in the probe sequences.
+class OverlayHandleMap
+{
+    private:
+        struct Slot
+        {
+            vr::VROverlayHandle_t Handle;           //k_ulOverlayHandleInvalid for empty slots
+            unsigned int ID;
+        };
+
+        std::vector<Slot> m_Slots;                  //Size is always a power of two
+        size_t m_SlotMask;
+
+        static size_t HashHandle(vr::VROverlayHandle_t handle);
+
+    public:
+        static const unsigned int k_ulIDNone = UINT_MAX;                //Same as k_ulOverlayID_None, kept separate so this doesn't depend on OverlayManager.h
+
+        OverlayHandleMap();
+
+        void Build(const std::vector<vr::VROverlayHandle_t>& handles);  //Index in handles is the overlay ID, invalid handles are skipped
+        unsigned int Find(vr::VROverlayHandle_t handle) const;          //Returns k_ulIDNone if not found
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+
+#include "openvr.h"
+#include "DPRect.h"
+#include "Overlays.h"
+
+//Flags returned by OverlayHotState::Update() for caches built from the hot state
+enum OverlayHotStateChangeFlags
+{
+    ovrl_hotstate_change_none       = 0,
+    ovrl_hotstate_change_rect_index = 1 << 0,       //Visibility, texture source or crop rect changed (desktop duplication rect index)
+    ovrl_hotstate_change_handle     = 1 << 1        //Overlay handle changed (handle map)
+};
+
+//Mirror of the few overlay values needed by the per-frame loops in OutputManager, stored as structure of arrays indexed by overlay ID
+//This allows iterating over all overlays without touching the comparatively large Overlay and OverlayConfigData objects
+//Kept in sync by Overlay and OverlayManager on changes, read-only for everything else
+struct OverlayHotState
+{
+    std::vector<vr::VROverlayHandle_t> Handle;
+    std::vector<unsigned char> Visible;                 //Not vector<bool> to keep element access cheap
+    std::vector<OverlayTextureSource> TextureSource;
+    std::vector<DPRect> CropRect;                       //Validated cropping rectangle
+    std::vector<int> CaptureSource;                     //configid_int_overlay_capture_source
+    std::vector<int> UpdateLimitOverrideMode;           //configid_int_overlay_update_limit_override_mode
+
+    //Resizes all arrays to overlay_count. New entries are set to the values of an overlay that hasn't been set up yet
+    //Capture source and update limit mode default to 0 (ovrl_capsource_desktop_duplication and update_limit_mode_off)
+    void Resize(size_t overlay_count)
+    {
+        Handle.resize(overlay_count, vr::k_ulOverlayHandleInvalid);
+        Visible.resize(overlay_count, 0);
+        TextureSource.resize(overlay_count, ovrl_texsource_none);
+        CropRect.resize(overlay_count);
+        CaptureSource.resize(overlay_count, 0);
+        UpdateLimitOverrideMode.resize(overlay_count, 0);
+    }
+
+    //Copies the mirrored values of the overlay with the given ID. Does nothing if it's out of range
+    //OverlayT is Overlay, or anything with the same getters. Returns OverlayHotStateChangeFlags for what changed
+    template<typename OverlayT>
+    int Update(unsigned int id, const OverlayT& overlay, int capture_source, int update_limit_override_mode)
+    {
+        if (id >= Handle.size())
+            return ovrl_hotstate_change_none;
+
+        int changes = ovrl_hotstate_change_none;
+
+        if ( (Visible[id] != (unsigned char)overlay.IsVisible()) || (TextureSource[id] != overlay.GetTextureSource()) || (!(CropRect[id] == overlay.GetValidatedCropRect())) )
+        {
+            changes |= ovrl_hotstate_change_rect_index;
+        }
+
+        if (Handle[id] != overlay.GetHandle())
+        {
+            changes |= ovrl_hotstate_change_handle;
+        }
+
+        Handle[id]                  = overlay.GetHandle();
+        Visible[id]                 = overlay.IsVisible();
+        TextureSource[id]           = overlay.GetTextureSource();
+        CropRect[id]                = overlay.GetValidatedCropRect();
+        CaptureSource[id]           = capture_source;
+        UpdateLimitOverrideMode[id] = update_limit_override_mode;
+
+        return changes;
+    }
+};
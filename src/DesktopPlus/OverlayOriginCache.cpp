@@ -0,0 +1,72 @@
+#include "OverlayOriginCache.h"
+
+OverlayOriginCache::OverlayOriginCache(int origin_count) : m_Nodes(origin_count), m_VersionCounter(0), m_OverlayComputeCount(0)
+{
+}
+
+bool OverlayOriginCache::IsCurrent(int origin, unsigned int input_stamp) const
+{
+    return ( (m_Nodes[origin].IsValid) && (m_Nodes[origin].InputStamp == input_stamp) );
+}
+
+const Matrix4& OverlayOriginCache::Get(int origin) const
+{
+    return m_Nodes[origin].Matrix;
+}
+
+void OverlayOriginCache::Set(int origin, unsigned int input_stamp, const Matrix4& matrix)
+{
+    m_VersionCounter++;
+
+    //Skip 0 on wrap-around so unset overlay nodes never match
+    if (m_VersionCounter == 0)
+    {
+        m_VersionCounter++;
+    }
+
+    m_Nodes[origin].Matrix     = matrix;
+    m_Nodes[origin].InputStamp = input_stamp;
+    m_Nodes[origin].Version    = m_VersionCounter;
+    m_Nodes[origin].IsValid    = true;
+}
+
+void OverlayOriginCache::Invalidate(int origin)
+{
+    m_Nodes[origin].IsValid = false;
+}
+
+void OverlayOriginCache::InvalidateAll()
+{
+    for (Node& node : m_Nodes)
+    {
+        node.IsValid = false;
+    }
+}
+
+const Matrix4& OverlayOriginCache::GetOverlayMatrix(unsigned int overlay_id, int origin, const Matrix4& transform)
+{
+    if (overlay_id >= m_OverlayNodes.size())
+    {
+        m_OverlayNodes.resize(overlay_id + 1);
+    }
+
+    const Node& node_origin = m_Nodes[origin];
+    OverlayNode& node = m_OverlayNodes[overlay_id];
+
+    if ( (node.Origin != origin) || (node.OriginVersion != node_origin.Version) || (!(node.Transform == transform)) )
+    {
+        node.Matrix        = node_origin.Matrix * transform;
+        node.Transform     = transform;
+        node.Origin        = origin;
+        node.OriginVersion = node_origin.Version;
+
+        m_OverlayComputeCount++;
+    }
+
+    return node.Matrix;
+}
+
+unsigned int OverlayOriginCache::GetOverlayComputeCount() const
+{
+    return m_OverlayComputeCount;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+
+#include "Matrices.h"
+
+//Caches the base matrix of each overlay origin, together with the stamp of the input it was computed from
+//Origins following tracked devices use the pose snapshot's frame stamp as input stamp, so they're computed at most once per frame.
+//Origins that only change on certain events (seated universe, dashboard) use a constant stamp and are invalidated explicitly by those events instead.
+//
+//The final matrix of each overlay (origin matrix * overlay transform) is cached on top of that. It's only recomputed after its origin's matrix was set again
+//or the overlay transform changed.
+//Origins are OverlayOrigin values, taken as int to not depend on ConfigManager.h here
+class OverlayOriginCache
+{
+    private:
+        struct Node
+        {
+            Matrix4 Matrix;
+            unsigned int InputStamp = 0;
+            unsigned int Version = 0;                   //Changes every time the matrix is set, 0 is never used
+            bool IsValid = false;
+        };
+
+        struct OverlayNode
+        {
+            Matrix4 Matrix;
+            Matrix4 Transform;                          //Overlay transform the matrix was computed with
+            int Origin = -1;
+            unsigned int OriginVersion = 0;
+        };
+
+        std::vector<Node> m_Nodes;
+        std::vector<OverlayNode> m_OverlayNodes;        //Indexed by overlay ID
+        unsigned int m_VersionCounter;
+        unsigned int m_OverlayComputeCount;
+
+    public:
+        OverlayOriginCache(int origin_count);
+
+        bool IsCurrent(int origin, unsigned int input_stamp) const;
+        const Matrix4& Get(int origin) const;
+        void Set(int origin, unsigned int input_stamp, const Matrix4& matrix);
+        void Invalidate(int origin);
+        void InvalidateAll();
+
+        //Returns the origin's matrix multiplied with transform. The origin has to be valid
+        const Matrix4& GetOverlayMatrix(unsigned int overlay_id, int origin, const Matrix4& transform);
+        unsigned int GetOverlayComputeCount() const;    //Times GetOverlayMatrix() had to recompute
+};
@@ -0,0 +1,221 @@
+#include "OverlayPropertyWriter.h"
+
+#include <cmath>
+
+//Differences below these are not visible, but can come up from float math on values that didn't actually change
+static const float k_fAlphaEpsilon  = 0.001f;
+static const float k_fMatrixEpsilon = 0.00001f;
+
+static bool MatricesNearlyEqual(const vr::HmdMatrix34_t& a, const vr::HmdMatrix34_t& b)
+{
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int col = 0; col < 4; ++col)
+        {
+            if (fabs(a.m[row][col] - b.m[row][col]) > k_fMatrixEpsilon)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+//OverlayPropertyWriter::Get() is defined in OverlayPropertyWriterOpenVR.cpp, as the application's instance uses the OpenVR backend
+
+OverlayPropertyWriter::OverlayPropertyWriter(std::unique_ptr<OverlayPropertyBackend> backend) :
+    m_Backend(std::move(backend)),
+    m_RPCCount(0),
+    m_SkippedCount(0),
+    m_RPCCountLastFrame(0),
+    m_SkippedCountLastFrame(0)
+{
+}
+
+void OverlayPropertyWriter::RegisterOverlay(vr::VROverlayHandle_t handle)
+{
+    if (handle == vr::k_ulOverlayHandleInvalid)
+        return;
+
+    //A write to the previous overlay may still be queued, so keep that flag
+    PropertyState& state = m_States[handle];
+    const bool is_queued = state.IsQueued;
+
+    state = PropertyState();
+    state.IsQueued = is_queued;
+}
+
+void OverlayPropertyWriter::UnregisterOverlay(vr::VROverlayHandle_t handle)
+{
+    m_States.erase(handle);
+}
+
+void OverlayPropertyWriter::Queue(vr::VROverlayHandle_t handle, PropertyState& state)
+{
+    if (!state.IsQueued)
+    {
+        state.IsQueued = true;
+        m_QueuedHandles.push_back(handle);
+    }
+}
+
+void OverlayPropertyWriter::SetAlpha(vr::VROverlayHandle_t handle, float alpha)
+{
+    const auto it = m_States.find(handle);
+
+    if (it == m_States.end())
+    {
+        //Not ours, write through
+        if ( (handle != vr::k_ulOverlayHandleInvalid) && (m_Backend->IsAvailable()) )
+        {
+            m_Backend->SetOverlayAlpha(handle, alpha);
+            m_RPCCount++;
+        }
+
+        return;
+    }
+
+    PropertyState& state = it->second;
+
+    if ( (state.AlphaKnown) && (fabs(state.Alpha - alpha) <= k_fAlphaEpsilon) )
+    {
+        m_SkippedCount++;
+        return;
+    }
+
+    state.AlphaKnown   = true;
+    state.Alpha        = alpha;
+    state.AlphaPending = true;
+    Queue(handle, state);
+}
+
+void OverlayPropertyWriter::SetTransform(vr::VROverlayHandle_t handle, TransformType type, vr::ETrackingUniverseOrigin origin, vr::TrackedDeviceIndex_t device_index,
+                                         const vr::HmdMatrix34_t& matrix)
+{
+    const auto it = m_States.find(handle);
+
+    if (it == m_States.end())
+    {
+        //Not ours, write through
+        if ( (handle != vr::k_ulOverlayHandleInvalid) && (m_Backend->IsAvailable()) )
+        {
+            if (type == transform_absolute)
+            {
+                m_Backend->SetOverlayTransformAbsolute(handle, origin, matrix);
+            }
+            else
+            {
+                m_Backend->SetOverlayTransformTrackedDeviceRelative(handle, device_index, matrix);
+            }
+
+            m_RPCCount++;
+        }
+
+        return;
+    }
+
+    PropertyState& state = it->second;
+
+    if ( (state.Transform == type) && (state.TransformOrigin == origin) && (state.TransformDeviceIndex == device_index) && (MatricesNearlyEqual(state.TransformMatrix, matrix)) )
+    {
+        m_SkippedCount++;
+        return;
+    }
+
+    state.Transform            = type;
+    state.TransformOrigin      = origin;
+    state.TransformDeviceIndex = device_index;
+    state.TransformMatrix      = matrix;
+    state.TransformPending     = true;
+    Queue(handle, state);
+}
+
+void OverlayPropertyWriter::SetTransformAbsolute(vr::VROverlayHandle_t handle, vr::ETrackingUniverseOrigin origin, const vr::HmdMatrix34_t& matrix)
+{
+    SetTransform(handle, transform_absolute, origin, vr::k_unTrackedDeviceIndexInvalid, matrix);
+}
+
+void OverlayPropertyWriter::SetTransformTrackedDeviceRelative(vr::VROverlayHandle_t handle, vr::TrackedDeviceIndex_t device_index, const vr::HmdMatrix34_t& matrix)
+{
+    SetTransform(handle, transform_device_relative, vr::TrackingUniverseStanding, device_index, matrix);
+}
+
+void OverlayPropertyWriter::Flush()
+{
+    //Nothing can be written without OpenVR, so just drop everything then. Overlays stay registered, but nothing is known about their state anymore
+    if (!m_Backend->IsAvailable())
+    {
+        for (auto& state : m_States)
+        {
+            state.second = PropertyState();
+        }
+
+        m_QueuedHandles.clear();
+    }
+
+    for (vr::VROverlayHandle_t handle : m_QueuedHandles)
+    {
+        const auto it = m_States.find(handle);
+
+        if (it == m_States.end()) //Unregistered after queuing
+            continue;
+
+        PropertyState& state = it->second;
+
+        if (state.AlphaPending)
+        {
+            m_Backend->SetOverlayAlpha(handle, state.Alpha);
+            m_RPCCount++;
+        }
+
+        if (state.TransformPending)
+        {
+            if (state.Transform == transform_absolute)
+            {
+                m_Backend->SetOverlayTransformAbsolute(handle, state.TransformOrigin, state.TransformMatrix);
+            }
+            else
+            {
+                m_Backend->SetOverlayTransformTrackedDeviceRelative(handle, state.TransformDeviceIndex, state.TransformMatrix);
+            }
+
+            m_RPCCount++;
+        }
+
+        state.AlphaPending     = false;
+        state.TransformPending = false;
+        state.IsQueued         = false;
+    }
+
+    m_QueuedHandles.clear();
+
+    m_RPCCountLastFrame     = m_RPCCount;
+    m_SkippedCountLastFrame = m_SkippedCount;
+    m_RPCCount     = 0;
+    m_SkippedCount = 0;
+}
+
+bool OverlayPropertyWriter::GetLastTransform(vr::VROverlayHandle_t handle, vr::ETrackingUniverseOrigin& origin, vr::TrackedDeviceIndex_t& device_index, 
+                                             vr::HmdMatrix34_t& matrix) const
+{
+    const auto it = m_States.find(handle);
+
+    if ( (it == m_States.end()) || (it->second.Transform == transform_none) )
+        return false;
+
+    const PropertyState& state = it->second;
+    origin       = state.TransformOrigin;
+    device_index = state.TransformDeviceIndex;
+    matrix       = state.TransformMatrix;
+
+    return true;
+}
+
+unsigned int OverlayPropertyWriter::GetRPCCountLastFrame() const
+{
+    return m_RPCCountLastFrame;
+}
+
+unsigned int OverlayPropertyWriter::GetSkippedCountLastFrame() const
+{
+    return m_SkippedCountLastFrame;
+}
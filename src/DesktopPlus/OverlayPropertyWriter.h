@@ -0,0 +1,91 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "openvr.h"
+
+//Change-detecting writer for frequently set IVROverlay properties
+//Every IVROverlay setter is an RPC into vrserver, but a lot of the per-frame code (gaze fade, drag, HMD floor origin) sets values that didn't change.
+//Writes going through this are compared against the last written value and dropped if they're the same (within a small epsilon).
+//Remaining writes are queued and applied in one go by Flush(), which is called once per main loop iteration.
+//
+//All alpha and transform writes to Desktop+ overlays need to go through here, or else the cached state would go out of sync.
+//Code that needs to read back these properties has to call Flush() first.
+//
+//Only overlays registered with RegisterOverlay() are cached. Writes to any other handle (e.g. overlays of other applications) are passed on right away,
+//as their properties can change without going through here.
+
+//Receives the writes applied by OverlayPropertyWriter. See OverlayPropertyWriterOpenVR.h for the implementation used by the application
+class OverlayPropertyBackend
+{
+    public:
+        virtual ~OverlayPropertyBackend() = default;
+
+        virtual bool IsAvailable() const = 0;       //False if nothing can be written right now (i.e. OpenVR isn't initialized)
+        virtual void SetOverlayAlpha(vr::VROverlayHandle_t handle, float alpha) = 0;
+        virtual void SetOverlayTransformAbsolute(vr::VROverlayHandle_t handle, vr::ETrackingUniverseOrigin origin, const vr::HmdMatrix34_t& matrix) = 0;
+        virtual void SetOverlayTransformTrackedDeviceRelative(vr::VROverlayHandle_t handle, vr::TrackedDeviceIndex_t device_index, const vr::HmdMatrix34_t& matrix) = 0;
+};
+
+class OverlayPropertyWriter
+{
+    private:
+        enum TransformType
+        {
+            transform_none,
+            transform_absolute,
+            transform_device_relative
+        };
+
+        struct PropertyState
+        {
+            //Value last written or pending to be written
+            bool AlphaKnown = false;
+            float Alpha = 1.0f;
+            TransformType Transform = transform_none;
+            vr::ETrackingUniverseOrigin TransformOrigin = vr::TrackingUniverseStanding;
+            vr::TrackedDeviceIndex_t TransformDeviceIndex = vr::k_unTrackedDeviceIndexInvalid;
+            vr::HmdMatrix34_t TransformMatrix = {0};
+
+            bool AlphaPending = false;
+            bool TransformPending = false;
+            bool IsQueued = false;
+        };
+
+        std::unique_ptr<OverlayPropertyBackend> m_Backend;
+        std::unordered_map<vr::VROverlayHandle_t, PropertyState> m_States;     //Registered overlays
+        std::vector<vr::VROverlayHandle_t> m_QueuedHandles;
+
+        unsigned int m_RPCCount;                //Since last Flush()
+        unsigned int m_SkippedCount;
+        unsigned int m_RPCCountLastFrame;
+        unsigned int m_SkippedCountLastFrame;
+
+        void Queue(vr::VROverlayHandle_t handle, PropertyState& state);
+        void SetTransform(vr::VROverlayHandle_t handle, TransformType type, vr::ETrackingUniverseOrigin origin, vr::TrackedDeviceIndex_t device_index,
+                          const vr::HmdMatrix34_t& matrix);
+
+    public:
+        static OverlayPropertyWriter& Get();
+
+        OverlayPropertyWriter(std::unique_ptr<OverlayPropertyBackend> backend);
+        OverlayPropertyWriter(const OverlayPropertyWriter&) = delete;
+        OverlayPropertyWriter& operator=(const OverlayPropertyWriter&) = delete;
+
+        void RegisterOverlay(vr::VROverlayHandle_t handle);     //Starts caching writes to an overlay created by this process. Drops state of a previous overlay with the same handle value
+        void UnregisterOverlay(vr::VROverlayHandle_t handle);   //Stops caching writes to the overlay, e.g. before destroying it. Queued writes are dropped
+
+        void SetAlpha(vr::VROverlayHandle_t handle, float alpha);
+        void SetTransformAbsolute(vr::VROverlayHandle_t handle, vr::ETrackingUniverseOrigin origin, const vr::HmdMatrix34_t& matrix);
+        void SetTransformTrackedDeviceRelative(vr::VROverlayHandle_t handle, vr::TrackedDeviceIndex_t device_index, const vr::HmdMatrix34_t& matrix);
+
+        void Flush();                                       //Applies all queued writes
+
+        //Last transform written (or queued) through this. device_index is k_unTrackedDeviceIndexInvalid for absolute transforms. Returns false if there's none
+        bool GetLastTransform(vr::VROverlayHandle_t handle, vr::ETrackingUniverseOrigin& origin, vr::TrackedDeviceIndex_t& device_index, vr::HmdMatrix34_t& matrix) const;
+
+        unsigned int GetRPCCountLastFrame() const;          //Writes applied by the last Flush(), including those to unregistered overlays since the Flush() before
+        unsigned int GetSkippedCountLastFrame() const;      //Writes dropped as no-op between the last two Flush() calls
+};
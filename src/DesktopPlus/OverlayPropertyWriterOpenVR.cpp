@@ -0,0 +1,28 @@
+#include "OverlayPropertyWriterOpenVR.h"
+
+static OverlayPropertyWriter g_OverlayPropertyWriter(std::make_unique<OverlayPropertyBackendOpenVR>());
+
+OverlayPropertyWriter& OverlayPropertyWriter::Get()
+{
+    return g_OverlayPropertyWriter;
+}
+
+bool OverlayPropertyBackendOpenVR::IsAvailable() const
+{
+    return (vr::VROverlay() != nullptr);
+}
+
+void OverlayPropertyBackendOpenVR::SetOverlayAlpha(vr::VROverlayHandle_t handle, float alpha)
+{
+    vr::VROverlay()->SetOverlayAlpha(handle, alpha);
+}
+
+void OverlayPropertyBackendOpenVR::SetOverlayTransformAbsolute(vr::VROverlayHandle_t handle, vr::ETrackingUniverseOrigin origin, const vr::HmdMatrix34_t& matrix)
+{
+    vr::VROverlay()->SetOverlayTransformAbsolute(handle, origin, &matrix);
+}
+
+void OverlayPropertyBackendOpenVR::SetOverlayTransformTrackedDeviceRelative(vr::VROverlayHandle_t handle, vr::TrackedDeviceIndex_t device_index, const vr::HmdMatrix34_t& matrix)
+{
+    vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(handle, device_index, &matrix);
+}
@@ -0,0 +1,14 @@
+//OpenVR backend of OverlayPropertyWriter, used by the application's instance
+
+#pragma once
+
+#include "OverlayPropertyWriter.h"
+
+class OverlayPropertyBackendOpenVR : public OverlayPropertyBackend
+{
+    public:
+        bool IsAvailable() const override;
+        void SetOverlayAlpha(vr::VROverlayHandle_t handle, float alpha) override;
+        void SetOverlayTransformAbsolute(vr::VROverlayHandle_t handle, vr::ETrackingUniverseOrigin origin, const vr::HmdMatrix34_t& matrix) override;
+        void SetOverlayTransformTrackedDeviceRelative(vr::VROverlayHandle_t handle, vr::TrackedDeviceIndex_t device_index, const vr::HmdMatrix34_t& matrix) override;
+};
@@ -0,0 +1,307 @@
+#include "OverlayRaycaster.h"
+
+#include <algorithm>
+#include <cfloat>
+
+static const float k_fPi = 3.14159265f;
+static const unsigned int k_ulMaxLeafShapes = 2;
+
+bool OverlayRaycastShape::operator==(const OverlayRaycastShape& rhs) const
+{
+    return ( (OverlayID == rhs.OverlayID) && (Transform == rhs.Transform) && (Width == rhs.Width) && (Height == rhs.Height) && (Curvature == rhs.Curvature) );
+}
+
+bool OverlayRaycastShape::operator!=(const OverlayRaycastShape& rhs) const
+{
+    return !(*this == rhs);
+}
+
+//Slab test, returns entry distance or FLT_MAX on miss
+static float RayAABBDistance(const Vector3& origin, const Vector3& direction_inv, const Vector3& bmin, const Vector3& bmax, float max_distance)
+{
+    float t_min = 0.0f;
+    float t_max = max_distance;
+
+    const float o[3]  = {origin.x, origin.y, origin.z};
+    const float di[3] = {direction_inv.x, direction_inv.y, direction_inv.z};
+    const float lo[3] = {bmin.x, bmin.y, bmin.z};
+    const float hi[3] = {bmax.x, bmax.y, bmax.z};
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        float t0 = (lo[axis] - o[axis]) * di[axis];
+        float t1 = (hi[axis] - o[axis]) * di[axis];
+
+        if (t0 > t1)
+            std::swap(t0, t1);
+
+        //NaN from 0 * inf (ray parallel and on the slab border) falls through as a hit here, which is fine for a conservative test
+        t_min = (t0 > t_min) ? t0 : t_min;
+        t_max = (t1 < t_max) ? t1 : t_max;
+
+        if (t_min > t_max)
+            return FLT_MAX;
+    }
+
+    return t_min;
+}
+
+OverlayRaycaster::OverlayRaycaster(float edge_margin) : m_EdgeMargin(edge_margin)
+{
+}
+
+void OverlayRaycaster::PrepareShape(const OverlayRaycastShape& shape, ShapeData& data) const
+{
+    data.TransformInverse = shape.Transform;
+    data.TransformInverse.invertAffine();
+
+    const float half_width = shape.Width / 2.0f;
+    data.HalfExtentY = (shape.Height / 2.0f) + m_EdgeMargin;
+
+    //Local space bounding box. Overlay is on the XY plane, curved ones bend towards +Z
+    Vector3 local_min, local_max;
+
+    if ( (shape.Curvature > 0.0f) && (shape.Width > 0.0f) )
+    {
+        //Arc length is the overlay width. A curvature of 1 is a closed cylinder
+        data.Radius      = shape.Width / (2.0f * k_fPi * std::min(shape.Curvature, 1.0f));
+        data.HalfExtentX = std::min((half_width + m_EdgeMargin) / data.Radius, k_fPi);
+
+        const float extent_x = (data.HalfExtentX >= k_fPi / 2.0f) ? data.Radius : data.Radius * sinf(data.HalfExtentX);
+        local_min = {-extent_x, -data.HalfExtentY, 0.0f};
+        local_max = { extent_x,  data.HalfExtentY, data.Radius * (1.0f - cosf(data.HalfExtentX))};
+    }
+    else
+    {
+        data.Radius      = 0.0f;
+        data.HalfExtentX = half_width + m_EdgeMargin;
+
+        local_min = {-data.HalfExtentX, -data.HalfExtentY, 0.0f};
+        local_max = { data.HalfExtentX,  data.HalfExtentY, 0.0f};
+    }
+
+    //World space bounding box from the transformed local box corners
+    data.BoundsMin = { FLT_MAX,  FLT_MAX,  FLT_MAX};
+    data.BoundsMax = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+    for (int i = 0; i < 8; ++i)
+    {
+        Vector4 corner((i & 1) ? local_max.x : local_min.x, (i & 2) ? local_max.y : local_min.y, (i & 4) ? local_max.z : local_min.z, 1.0f);
+        corner = shape.Transform * corner;
+
+        data.BoundsMin = {std::min(data.BoundsMin.x, corner.x), std::min(data.BoundsMin.y, corner.y), std::min(data.BoundsMin.z, corner.z)};
+        data.BoundsMax = {std::max(data.BoundsMax.x, corner.x), std::max(data.BoundsMax.y, corner.y), std::max(data.BoundsMax.z, corner.z)};
+    }
+
+    data.BoundsCenter = (data.BoundsMin + data.BoundsMax) * 0.5f;
+}
+
+void OverlayRaycaster::BuildNode(unsigned int node_id, unsigned int shape_first, unsigned int shape_count)
+{
+    Vector3 bmin = { FLT_MAX,  FLT_MAX,  FLT_MAX};
+    Vector3 bmax = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    Vector3 cmin = bmin, cmax = bmax;
+
+    for (unsigned int i = shape_first; i < shape_first + shape_count; ++i)
+    {
+        const ShapeData& data = m_ShapeData[m_ShapeOrder[i]];
+
+        bmin = {std::min(bmin.x, data.BoundsMin.x),    std::min(bmin.y, data.BoundsMin.y),    std::min(bmin.z, data.BoundsMin.z)};
+        bmax = {std::max(bmax.x, data.BoundsMax.x),    std::max(bmax.y, data.BoundsMax.y),    std::max(bmax.z, data.BoundsMax.z)};
+        cmin = {std::min(cmin.x, data.BoundsCenter.x), std::min(cmin.y, data.BoundsCenter.y), std::min(cmin.z, data.BoundsCenter.z)};
+        cmax = {std::max(cmax.x, data.BoundsCenter.x), std::max(cmax.y, data.BoundsCenter.y), std::max(cmax.z, data.BoundsCenter.z)};
+    }
+
+    m_Nodes[node_id].BoundsMin = bmin;
+    m_Nodes[node_id].BoundsMax = bmax;
+
+    if (shape_count <= k_ulMaxLeafShapes)
+    {
+        m_Nodes[node_id].FirstChild = 0;
+        m_Nodes[node_id].ShapeFirst = shape_first;
+        m_Nodes[node_id].ShapeCount = shape_count;
+        return;
+    }
+
+    //Median split along the axis with the largest spread of shape centers
+    const Vector3 spread = cmax - cmin;
+    const int axis = ( (spread.x >= spread.y) && (spread.x >= spread.z) ) ? 0 : (spread.y >= spread.z) ? 1 : 2;
+    const unsigned int shape_mid = shape_first + (shape_count / 2);
+
+    std::nth_element(m_ShapeOrder.begin() + shape_first, m_ShapeOrder.begin() + shape_mid, m_ShapeOrder.begin() + shape_first + shape_count,
+                     [&](unsigned int a, unsigned int b)
+                     {
+                         const Vector3& ca = m_ShapeData[a].BoundsCenter;
+                         const Vector3& cb = m_ShapeData[b].BoundsCenter;
+                         return (axis == 0) ? (ca.x < cb.x) : (axis == 1) ? (ca.y < cb.y) : (ca.z < cb.z);
+                     });
+
+    const unsigned int child_id = (unsigned int)m_Nodes.size();
+    m_Nodes.resize(m_Nodes.size() + 2);
+    m_Nodes[node_id].FirstChild = child_id;
+    m_Nodes[node_id].ShapeFirst = 0;
+    m_Nodes[node_id].ShapeCount = 0;
+
+    BuildNode(child_id,     shape_first, shape_mid - shape_first);
+    BuildNode(child_id + 1, shape_mid,   shape_first + shape_count - shape_mid);
+}
+
+bool OverlayRaycaster::IntersectShape(unsigned int shape_id, const Vector3& origin, const Vector3& direction, OverlayRaycastHit& hit) const
+{
+    const OverlayRaycastShape& shape = m_Shapes[shape_id];
+    const ShapeData& data = m_ShapeData[shape_id];
+
+    //Intersect in overlay space
+    const Vector3 o = data.TransformInverse.transformPoint(origin);
+    const Vector3 d = data.TransformInverse * direction;        //Only rotation, no translation
+
+    if (data.Radius == 0.0f)
+    {
+        if (d.z == 0.0f)
+            return false;
+
+        const float t = -o.z / d.z;
+        const float x = o.x + (t * d.x);
+        const float y = o.y + (t * d.y);
+
+        if ( (t < 0.0f) || (fabs(x) > data.HalfExtentX) || (fabs(y) > data.HalfExtentY) )
+            return false;
+
+        hit.OverlayID = shape.OverlayID;
+        hit.Distance  = t;
+        hit.UV        = {(x / shape.Width) + 0.5f, (y / shape.Height) + 0.5f};
+        return true;
+    }
+
+    //Curved, cylinder around the Y axis with its center at (0, 0, radius)
+    const float r  = data.Radius;
+    const float oz = o.z - r;
+    const float a  = (d.x * d.x) + (d.z * d.z);
+    const float b  = 2.0f * ((o.x * d.x) + (oz * d.z));
+    const float c  = (o.x * o.x) + (oz * oz) - (r * r);
+    const float discriminant = (b * b) - (4.0f * a * c);
+
+    if ( (a == 0.0f) || (discriminant < 0.0f) )
+        return false;
+
+    const float discriminant_sqrt = sqrtf(discriminant);
+    const float roots[2] = {(-b - discriminant_sqrt) / (2.0f * a), (-b + discriminant_sqrt) / (2.0f * a)};
+
+    for (float t : roots)   //Nearer root first
+    {
+        if (t < 0.0f)
+            continue;
+
+        const float x = o.x + (t * d.x);
+        const float y = o.y + (t * d.y);
+        const float z = o.z + (t * d.z);
+        const float angle = atan2f(x, r - z);
+
+        if ( (fabs(angle) > data.HalfExtentX) || (fabs(y) > data.HalfExtentY) )
+            continue;
+
+        hit.OverlayID = shape.OverlayID;
+        hit.Distance  = t;
+        hit.UV        = {((angle * r) / shape.Width) + 0.5f, (y / shape.Height) + 0.5f};
+        return true;
+    }
+
+    return false;
+}
+
+bool OverlayRaycaster::Update(const std::vector<OverlayRaycastShape>& shapes)
+{
+    if (shapes == m_Shapes)
+        return false;
+
+    m_Shapes = shapes;
+    m_ShapeData.resize(m_Shapes.size());
+    m_ShapeOrder.resize(m_Shapes.size());
+    m_Nodes.clear();
+
+    for (unsigned int i = 0; i < m_Shapes.size(); ++i)
+    {
+        PrepareShape(m_Shapes[i], m_ShapeData[i]);
+        m_ShapeOrder[i] = i;
+    }
+
+    if (!m_Shapes.empty())
+    {
+        m_Nodes.reserve(m_Shapes.size() * 2);
+        m_Nodes.resize(1);
+        BuildNode(0, 0, (unsigned int)m_Shapes.size());
+    }
+
+    return true;
+}
+
+void OverlayRaycaster::Raycast(const Vector3& origin, const Vector3& direction, float max_distance, std::vector<OverlayRaycastHit>& hits) const
+{
+    hits.clear();
+
+    if (m_Nodes.empty())
+        return;
+
+    //Division by 0 results in infinity, which the slab test handles fine
+    const Vector3 direction_inv(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+
+    //Depth is log2 of the shape count, so this is plenty
+    unsigned int node_stack[64];
+    int stack_size = 0;
+    node_stack[stack_size++] = 0;
+
+    while (stack_size > 0)
+    {
+        const Node& node = m_Nodes[node_stack[--stack_size]];
+
+        if (RayAABBDistance(origin, direction_inv, node.BoundsMin, node.BoundsMax, max_distance) == FLT_MAX)
+            continue;
+
+        if (node.ShapeCount != 0)
+        {
+            for (unsigned int i = node.ShapeFirst; i < node.ShapeFirst + node.ShapeCount; ++i)
+            {
+                OverlayRaycastHit hit;
+                if ( (IntersectShape(m_ShapeOrder[i], origin, direction, hit)) && (hit.Distance <= max_distance) )
+                {
+                    hits.push_back(hit);
+                }
+            }
+        }
+        else if (stack_size + 2 <= 64)
+        {
+            node_stack[stack_size++] = node.FirstChild;
+            node_stack[stack_size++] = node.FirstChild + 1;
+        }
+    }
+
+    std::sort(hits.begin(), hits.end(), [](const OverlayRaycastHit& a, const OverlayRaycastHit& b) { return (a.Distance < b.Distance); });
+}
+
+bool OverlayRaycaster::IsEmpty() const
+{
+    return m_Shapes.empty();
+}
+
+float OverlayRaycaster::GetOverlayAspectRatio(int crop_width, int crop_height, int mouse_scale_width, int mouse_scale_height, bool is_3d_full, bool is_3d_ou_converted)
+{
+    if ( (crop_width <= 0) || (crop_height <= 0) )
+        return 0.0f;
+
+    float aspect = (float)crop_height / crop_width;
+
+    if ( (mouse_scale_width > 0) && (mouse_scale_height > 0) )
+    {
+        aspect = std::max(aspect, (float)mouse_scale_height / mouse_scale_width);
+    }
+
+    //Converted Over-Under is twice as wide and half as tall
+    if (is_3d_ou_converted)
+        aspect /= 4.0f;
+
+    //Overlay is twice as tall when SBS3D/OU3D is active
+    if (is_3d_full)
+        aspect *= 2.0f;
+
+    return aspect;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+
+#include "Matrices.h"
+
+//CPU ray vs. overlay intersection test with a bounding volume hierarchy over all shapes
+//Used for the global HMD pointer to find the overlays a ray may hit without asking vrserver about every overlay each frame.
+//Flat and curved overlays are supported. Curved overlays are cylinder sections bending towards the viewer (+Z), like SteamVR draws them.
+//The geometry is an approximation of what SteamVR does (no intersection masks, aspect ratio from what we know), so callers should confirm hits
+//with vr::IVROverlay::ComputeOverlayIntersection() where exact results are needed. The edge margin can be used to make the test conservative.
+struct OverlayRaycastShape
+{
+    unsigned int OverlayID;
+    Matrix4 Transform;          //Absolute transform of the overlay center, in the same space as the rays
+    float Width;                //Meters
+    float Height;
+    float Curvature;            //Same as vr::IVROverlay::SetOverlayCurvature(), 0 for flat
+
+    bool operator==(const OverlayRaycastShape& rhs) const;
+    bool operator!=(const OverlayRaycastShape& rhs) const;
+};
+
+struct OverlayRaycastHit
+{
+    unsigned int OverlayID;
+    float Distance;             //Along the ray, in meters if the ray direction is normalized
+    Vector2 UV;                 //0.0 - 1.0, origin at the bottom left like vr::VROverlayIntersectionResults_t
+};
+
+class OverlayRaycaster
+{
+    private:
+        struct ShapeData
+        {
+            Matrix4 TransformInverse;
+            float Radius;       //Cylinder radius for curved shapes, 0 for flat
+            float HalfExtentX;  //Half width including edge margin (meters for flat, radians along the arc for curved)
+            float HalfExtentY;
+            Vector3 BoundsMin;
+            Vector3 BoundsMax;
+            Vector3 BoundsCenter;
+        };
+
+        struct Node
+        {
+            Vector3 BoundsMin;
+            Vector3 BoundsMax;
+            unsigned int FirstChild;    //Index of the first of both children for inner nodes. Second child follows directly
+            unsigned int ShapeFirst;    //Range in m_ShapeOrder for leaves
+            unsigned int ShapeCount;    //0 for inner nodes
+        };
+
+        float m_EdgeMargin;
+        std::vector<OverlayRaycastShape> m_Shapes;
+        std::vector<ShapeData> m_ShapeData;
+        std::vector<unsigned int> m_ShapeOrder;     //Shape indices, grouped by leaf node
+        std::vector<Node> m_Nodes;
+
+        void PrepareShape(const OverlayRaycastShape& shape, ShapeData& data) const;
+        void BuildNode(unsigned int node_id, unsigned int shape_first, unsigned int shape_count);
+        bool IntersectShape(unsigned int shape_id, const Vector3& origin, const Vector3& direction, OverlayRaycastHit& hit) const;
+
+    public:
+        OverlayRaycaster(float edge_margin = 0.0f);
+
+        //Sets the shapes and rebuilds the hierarchy if they differ from the previous ones. Returns true if a rebuild happened
+        bool Update(const std::vector<OverlayRaycastShape>& shapes);
+        //Fills hits with all intersections up to max_distance, sorted by distance
+        void Raycast(const Vector3& origin, const Vector3& direction, float max_distance, std::vector<OverlayRaycastHit>& hits) const;
+
+        bool IsEmpty() const;
+
+        //Returns overlay height / width the way OutputManager::ApplySettingTransform() sizes the overlay, or 0 if it can't be known
+        //crop_* is the size of the overlay's content. mouse_scale_* is the mouse scale if it's set independently of the content (desktop duplication sets it to
+        //the full desktop), 0 otherwise. SteamVR appears to use the mouse scale aspect ratio for the intersection surface when it's taller than the content.
+        //is_3d_full is true for full SBS/OU, which doubles the height. is_3d_ou_converted is true for full OU, which is converted to SBS before that
+        static float GetOverlayAspectRatio(int crop_width, int crop_height, int mouse_scale_width, int mouse_scale_height, bool is_3d_full, bool is_3d_ou_converted);
+};
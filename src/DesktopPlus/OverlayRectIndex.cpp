@@ -0,0 +1,110 @@
+#include "OverlayRectIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+OverlayRectIndex::OverlayRectIndex() : m_Bounds(-1, -1, -1, -1), m_GridWidth(0), m_GridHeight(0), m_CellWidth(1), m_CellHeight(1)
+{
+}
+
+void OverlayRectIndex::GetCellRange(const DPRect& rect, int& x_min, int& y_min, int& x_max, int& y_max) const
+{
+    //Max is exclusive, hence the -1
+    x_min = std::clamp((rect.GetTL().x     - m_Bounds.GetTL().x) / m_CellWidth,  0, m_GridWidth  - 1);
+    y_min = std::clamp((rect.GetTL().y     - m_Bounds.GetTL().y) / m_CellHeight, 0, m_GridHeight - 1);
+    x_max = std::clamp((rect.GetBR().x - 1 - m_Bounds.GetTL().x) / m_CellWidth,  0, m_GridWidth  - 1);
+    y_max = std::clamp((rect.GetBR().y - 1 - m_Bounds.GetTL().y) / m_CellHeight, 0, m_GridHeight - 1);
+}
+
+void OverlayRectIndex::Clear()
+{
+    m_Entries.clear();
+    m_CellOffsets.clear();
+    m_CellEntries.clear();
+    m_Bounds = {-1, -1, -1, -1};
+    m_GridWidth  = 0;
+    m_GridHeight = 0;
+}
+
+void OverlayRectIndex::AddRect(unsigned int id, const DPRect& rect)
+{
+    if ( (rect.GetWidth() <= 0) || (rect.GetHeight() <= 0) )
+        return;
+
+    m_Entries.push_back({id, rect, 0, 0});
+}
+
+void OverlayRectIndex::Build()
+{
+    m_CellOffsets.clear();
+    m_CellEntries.clear();
+
+    if (m_Entries.empty())
+    {
+        m_GridWidth  = 0;
+        m_GridHeight = 0;
+        return;
+    }
+
+    m_Bounds = m_Entries[0].Rect;
+
+    for (const Entry& entry : m_Entries)
+    {
+        m_Bounds.Add(entry.Rect);
+    }
+
+    //Scale grid with the entry count. A few overlays don't benefit from a fine grid, but it doesn't hurt much either
+    const int grid_size = std::clamp((int)std::ceil(std::sqrt((float)m_Entries.size())) * 2, 1, (int)k_lMaxGridSize);
+
+    m_GridWidth  = std::min(grid_size, m_Bounds.GetWidth());
+    m_GridHeight = std::min(grid_size, m_Bounds.GetHeight());
+    m_CellWidth  = (m_Bounds.GetWidth()  + m_GridWidth  - 1) / m_GridWidth;
+    m_CellHeight = (m_Bounds.GetHeight() + m_GridHeight - 1) / m_GridHeight;
+
+    //Count entries per cell first, then fill the flat array
+    m_CellOffsets.resize((m_GridWidth * m_GridHeight) + 1, 0);
+
+    for (Entry& entry : m_Entries)
+    {
+        int x_min, y_min, x_max, y_max;
+        GetCellRange(entry.Rect, x_min, y_min, x_max, y_max);
+
+        entry.CellMinX = x_min;
+        entry.CellMinY = y_min;
+
+        for (int y = y_min; y <= y_max; ++y)
+        {
+            for (int x = x_min; x <= x_max; ++x)
+            {
+                m_CellOffsets[(y * m_GridWidth) + x + 1]++;
+            }
+        }
+    }
+
+    for (size_t i = 1; i < m_CellOffsets.size(); ++i)
+    {
+        m_CellOffsets[i] += m_CellOffsets[i - 1];
+    }
+
+    m_CellEntries.resize(m_CellOffsets.back());
+    std::vector<unsigned int> cell_fill(m_CellOffsets.begin(), m_CellOffsets.end() - 1);
+
+    for (unsigned int i = 0; i < m_Entries.size(); ++i)
+    {
+        int x_min, y_min, x_max, y_max;
+        GetCellRange(m_Entries[i].Rect, x_min, y_min, x_max, y_max);
+
+        for (int y = y_min; y <= y_max; ++y)
+        {
+            for (int x = x_min; x <= x_max; ++x)
+            {
+                m_CellEntries[cell_fill[(y * m_GridWidth) + x]++] = i;
+            }
+        }
+    }
+}
+
+bool OverlayRectIndex::IsEmpty() const
+{
+    return m_Entries.empty();
+}
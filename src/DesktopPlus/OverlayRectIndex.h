@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include "DPRect.h"
+
+//Uniform grid over overlay cropping rectangles, used to find the overlays affected by desktop duplication dirty regions without testing every single one
+//The grid is rebuilt as a whole when the indexed rectangles change, which is rare compared to the queries happening on every frame.
+//Cell contents are stored in one flat array with an offset per cell, so queries don't allocate anything.
+class OverlayRectIndex
+{
+    private:
+        struct Entry
+        {
+            unsigned int ID;
+            DPRect Rect;
+            int CellMinX;                               //First cell column/row the rect is in, used to report rects spanning multiple cells only once
+            int CellMinY;
+        };
+
+        std::vector<Entry> m_Entries;
+        std::vector<unsigned int> m_CellOffsets;        //Entries of cell i are m_CellEntries[m_CellOffsets[i]] to m_CellEntries[m_CellOffsets[i + 1]]
+        std::vector<unsigned int> m_CellEntries;        //Indices into m_Entries
+        DPRect m_Bounds;
+        int m_GridWidth;
+        int m_GridHeight;
+        int m_CellWidth;
+        int m_CellHeight;
+
+        void GetCellRange(const DPRect& rect, int& x_min, int& y_min, int& x_max, int& y_max) const;
+
+    public:
+        static const int k_lMaxGridSize = 16;           //Per axis
+
+        OverlayRectIndex();
+
+        void Clear();
+        void AddRect(unsigned int id, const DPRect& rect);  //Rects without area are ignored. Build() needs to be called after adding rects
+        void Build();
+        bool IsEmpty() const;
+
+        //Calls func(id, rect) once for each indexed rect overlapping the given rect
+        template<typename F>
+        void ForEachOverlapping(const DPRect& rect, F func) const
+        {
+            if ( (m_Entries.empty()) || (!rect.Overlaps(m_Bounds)) )
+                return;
+
+            int x_min, y_min, x_max, y_max;
+            GetCellRange(rect, x_min, y_min, x_max, y_max);
+
+            for (int y = y_min; y <= y_max; ++y)
+            {
+                for (int x = x_min; x <= x_max; ++x)
+                {
+                    const int cell = (y * m_GridWidth) + x;
+
+                    for (unsigned int i = m_CellOffsets[cell]; i < m_CellOffsets[cell + 1]; ++i)
+                    {
+                        const Entry& entry = m_Entries[m_CellEntries[i]];
+
+                        //Only report from the first visited cell the entry is in
+                        if ( (x == std::max(entry.CellMinX, x_min)) && (y == std::max(entry.CellMinY, y_min)) && (entry.Rect.Overlaps(rect)) )
+                        {
+                            func(entry.ID, entry.Rect);
+                        }
+                    }
+                }
+            }
+        }
+};
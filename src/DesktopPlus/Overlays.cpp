@@ -4,6 +4,7 @@
 
 #include "CommonTypes.h"
 #include "OverlayManager.h"
+#include "OverlayPropertyWriter.h"
 #include "OutputManager.h"
 #include "DesktopPlusWinRT.h"
 
@@ -38,6 +39,7 @@ Overlay& Overlay::operator=(Overlay&& b)
                 DPWinRT_StopCapture(m_OvrlHandle);
             }
 
+            OverlayPropertyWriter::Get().UnregisterOverlay(m_OvrlHandle);
             vr::VROverlay()->DestroyOverlay(m_OvrlHandle);
         }
 
@@ -48,7 +50,6 @@ Overlay& Overlay::operator=(Overlay&& b)
         m_ValidatedCropRect = b.m_ValidatedCropRect;
         m_GlobalInteractive = b.m_GlobalInteractive;
         m_TextureSource = b.m_TextureSource;
-        //m_OUtoSBSConverter should just be left alone, it only holds cached state anyways
 
         b.m_OvrlHandle = vr::k_ulOverlayHandleInvalid;
     }
@@ -65,6 +66,7 @@ Overlay::~Overlay()
             DPWinRT_StopCapture(m_OvrlHandle);
         }
 
+        OverlayPropertyWriter::Get().UnregisterOverlay(m_OvrlHandle);
         vr::VROverlay()->DestroyOverlay(m_OvrlHandle);
     }
 }
@@ -79,12 +81,15 @@ void Overlay::InitOverlay()
 
     if (ovrl_error == vr::VROverlayError_None)
     {
-        vr::VROverlay()->SetOverlayAlpha(m_OvrlHandle, m_Opacity);
+        OverlayPropertyWriter::Get().RegisterOverlay(m_OvrlHandle);
+        OverlayPropertyWriter::Get().SetAlpha(m_OvrlHandle, m_Opacity);
     } 
     else //Creation failed, send error to UI so the user at least knows (typically this only happens when the overlay limit is exceeded)
     {
         IPCManager::Get().PostMessageToUIApp(ipcmsg_action, ipcact_overlay_creation_error, ovrl_error);
     }
+
+    OverlayManager::Get().UpdateHotState(m_ID);
 }
 
 void Overlay::AssignDesktopDuplicationTexture()
@@ -145,6 +150,7 @@ vr::VROverlayHandle_t Overlay::GetHandle() const
 void Overlay::SetHandle(vr::VROverlayHandle_t handle)
 {
     m_OvrlHandle = handle;
+    OverlayManager::Get().UpdateHotState(m_ID);
 }
 
 void Overlay::SetOpacity(float opacity)
@@ -156,7 +162,7 @@ void Overlay::SetOpacity(float opacity)
     if (outmgr == nullptr)
         return;
 
-    vr::VROverlay()->SetOverlayAlpha(m_OvrlHandle, opacity);
+    OverlayPropertyWriter::Get().SetAlpha(m_OvrlHandle, opacity);
 
     if (m_Opacity == 0.0f) //If it was previously 0%, show if needed
     {
@@ -184,6 +190,8 @@ void Overlay::SetVisible(bool visible)
 {
     m_Visible = visible;
     (visible) ? vr::VROverlay()->ShowOverlay(m_OvrlHandle) : vr::VROverlay()->HideOverlay(m_OvrlHandle);
+
+    OverlayManager::Get().UpdateHotState(m_ID);
 }
 
 bool Overlay::IsVisible() const
@@ -285,6 +293,7 @@ void Overlay::UpdateValidatedCropRect()
         height = std::min(height, height_max);
 
     m_ValidatedCropRect = DPRect(x, y, x + width, y + height);
+    OverlayManager::Get().UpdateHotState(m_ID);
 }
 
 const DPRect& Overlay::GetValidatedCropRect() const
@@ -301,8 +310,7 @@ void Overlay::SetTextureSource(OverlayTextureSource tex_source)
     //Cleanup old sources if needed
     switch (m_TextureSource)
     {
-        case ovrl_texsource_desktop_duplication_3dou_converted: m_OUtoSBSConverter.CleanRefs();    break;
-        case ovrl_texsource_winrt_capture:                      DPWinRT_StopCapture(m_OvrlHandle); break;
+        case ovrl_texsource_winrt_capture: DPWinRT_StopCapture(m_OvrlHandle); break;
         case ovrl_texsource_ui:
         {
             if (tex_source != ovrl_texsource_ui)
@@ -316,6 +324,7 @@ void Overlay::SetTextureSource(OverlayTextureSource tex_source)
     }
 
     m_TextureSource = tex_source;
+    OverlayManager::Get().UpdateHotState(m_ID);
 
     if (m_TextureSource == ovrl_texsource_none)
     {
@@ -339,10 +348,10 @@ OverlayTextureSource Overlay::GetTextureSource() const
     return m_TextureSource;
 }
 
-void Overlay::OnDesktopDuplicationUpdate()
+void Overlay::OnDesktopDuplicationUpdate(const DPRect* dirty_rect)
 {
     if ( (m_Visible) && (m_TextureSource == ovrl_texsource_desktop_duplication_3dou_converted) )
     {
-        OutputManager::Get()->ConvertOUtoSBS(*this, m_OUtoSBSConverter);
+        OutputManager::Get()->ConvertOUtoSBS(*this, dirty_rect);
     }
 }
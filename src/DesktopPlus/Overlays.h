@@ -2,7 +2,6 @@
 
 #include "openvr.h"
 #include "DPRect.h"
-#include "OUtoSBSConverter.h"
 
 //About the Overlay class:
 //Overlay 0 (k_ulOverlayID_Dashboard) is the dashboard overlay. It always exists and is safe to access/returned when trying to access an invalid overlay id.
@@ -33,7 +32,6 @@ class Overlay
         bool m_GlobalInteractive;             //True if VROverlayFlags_MakeOverlaysInteractiveIfVisible is set for this overlay
         DPRect m_ValidatedCropRect;           //Validated cropping rectangle used in OutputManager::Update() to check against dirty update regions
         OverlayTextureSource m_TextureSource;
-        OUtoSBSConverter m_OUtoSBSConverter;
 
     public:
         Overlay(unsigned int id);
@@ -63,5 +61,5 @@ class Overlay
 
         void SetTextureSource(OverlayTextureSource tex_source);
         OverlayTextureSource GetTextureSource() const;
-        void OnDesktopDuplicationUpdate();  //Called by OutputManager::RefreshOpenVROverlayTexture() for every overlay, but only if the texture has actually changed
+        void OnDesktopDuplicationUpdate(const DPRect* dirty_rect);  //Called by OutputManager::RefreshOpenVROverlayTexture() for every overlay, but only if the texture has actually changed. dirty_rect is nullptr on full updates
 };
\ No newline at end of file
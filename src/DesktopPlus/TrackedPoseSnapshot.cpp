@@ -0,0 +1,72 @@
+#include "TrackedPoseSnapshot.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Util.h"
+
+static TrackedPoseSnapshot g_TrackedPoseSnapshot;
+
+TrackedPoseSnapshot& TrackedPoseSnapshot::Get()
+{
+    return g_TrackedPoseSnapshot;
+}
+
+TrackedPoseSnapshot::TrackedPoseSnapshot() : m_Poses{}, m_PoseMatrixConverted{false}, m_IsValid(false), m_FrameStamp(0)
+{
+}
+
+void TrackedPoseSnapshot::Fetch()
+{
+    if (vr::VRSystem() != nullptr)
+    {
+        vr::VRSystem()->GetDeviceToAbsoluteTrackingPose(vr::TrackingUniverseStanding, GetTimeNowToPhotons(), m_Poses, vr::k_unMaxTrackedDeviceCount);
+    }
+    else
+    {
+        //Still provide something, all poses are invalid
+        memset(m_Poses, 0, sizeof(m_Poses));
+    }
+
+    std::fill(m_PoseMatrixConverted, m_PoseMatrixConverted + vr::k_unMaxTrackedDeviceCount, false);
+    m_IsValid = true;
+}
+
+void TrackedPoseSnapshot::Invalidate()
+{
+    m_IsValid = false;
+    m_FrameStamp++;
+}
+
+const vr::TrackedDevicePose_t* TrackedPoseSnapshot::GetPoses()
+{
+    if (!m_IsValid)
+    {
+        Fetch();
+    }
+
+    return m_Poses;
+}
+
+const vr::TrackedDevicePose_t& TrackedPoseSnapshot::GetPose(vr::TrackedDeviceIndex_t device_index)
+{
+    return GetPoses()[device_index];
+}
+
+const Matrix4& TrackedPoseSnapshot::GetPoseMatrix(vr::TrackedDeviceIndex_t device_index)
+{
+    const vr::TrackedDevicePose_t& pose = GetPose(device_index);
+
+    if (!m_PoseMatrixConverted[device_index])
+    {
+        m_PoseMatrices[device_index] = pose.mDeviceToAbsoluteTracking;
+        m_PoseMatrixConverted[device_index] = true;
+    }
+
+    return m_PoseMatrices[device_index];
+}
+
+unsigned int TrackedPoseSnapshot::GetFrameStamp() const
+{
+    return m_FrameStamp;
+}
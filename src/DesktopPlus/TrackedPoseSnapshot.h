@@ -0,0 +1,30 @@
+#pragma once
+
+#include "openvr.h"
+#include "Matrices.h"
+
+//Predicted standing tracked device poses, fetched once and shared by everything needing them until invalidated
+//Invalidate() is called once per main loop iteration, so all code running in the same frame (or for the same message) works with the same poses
+//instead of each doing its own RPC with slightly different prediction times.
+class TrackedPoseSnapshot
+{
+    private:
+        vr::TrackedDevicePose_t m_Poses[vr::k_unMaxTrackedDeviceCount];
+        Matrix4 m_PoseMatrices[vr::k_unMaxTrackedDeviceCount];
+        bool m_PoseMatrixConverted[vr::k_unMaxTrackedDeviceCount];
+        bool m_IsValid;
+        unsigned int m_FrameStamp;
+
+        void Fetch();
+
+    public:
+        static TrackedPoseSnapshot& Get();
+
+        TrackedPoseSnapshot();
+
+        void Invalidate();                                                      //Next access fetches new poses
+        const vr::TrackedDevicePose_t* GetPoses();                              //Array of k_unMaxTrackedDeviceCount poses
+        const vr::TrackedDevicePose_t& GetPose(vr::TrackedDeviceIndex_t device_index);
+        const Matrix4& GetPoseMatrix(vr::TrackedDeviceIndex_t device_index);    //mDeviceToAbsoluteTracking as Matrix4, converted once per snapshot
+        unsigned int GetFrameStamp() const;                                     //Incremented on every invalidation, can be used to check if results derived from a snapshot are still current
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+
+//Decodes the UTF-8 sequence at str and advances it. Invalid sequences result in U+FFFD, same as MultiByteToWideChar() does
+//Used by InputSimulator::KeyboardText(), kept free of Windows headers
+inline uint32_t DecodeUTF8(const unsigned char*& str, const unsigned char* str_end)
+{
+    const unsigned char lead = *str++;
+    int trail_count;
+    uint32_t codepoint;
+    uint32_t codepoint_min;
+
+    if      ((lead & 0xE0) == 0xC0) { trail_count = 1; codepoint = lead & 0x1F; codepoint_min = 0x80;    }
+    else if ((lead & 0xF0) == 0xE0) { trail_count = 2; codepoint = lead & 0x0F; codepoint_min = 0x800;   }
+    else if ((lead & 0xF8) == 0xF0) { trail_count = 3; codepoint = lead & 0x07; codepoint_min = 0x10000; }
+    else                            { return (lead < 0x80) ? lead : 0xFFFD; }   //Stray continuation or invalid lead byte
+
+    for (int i = 0; i < trail_count; ++i)
+    {
+        if ( (str == str_end) || ((*str & 0xC0) != 0x80) )  //Truncated, don't consume the byte that broke the sequence
+            return 0xFFFD;
+
+        codepoint = (codepoint << 6) | (*str++ & 0x3F);
+    }
+
+    //Overlong encodings, surrogates and values above the Unicode range are invalid
+    if ( (codepoint < codepoint_min) || ((codepoint >= 0xD800) && (codepoint <= 0xDFFF)) || (codepoint > 0x10FFFF) )
+        return 0xFFFD;
+
+    return codepoint;
+}
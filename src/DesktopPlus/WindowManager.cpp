@@ -9,8 +9,11 @@
 #include "InterprocessMessaging.h"
 #include "InputSimulator.h"
 #include "Util.h"
+#include "WindowList.h"
 
 WindowManager g_WindowManager;
+//Snapshot reader slot of the WindowManager thread. Thread-local as a quitting thread may briefly overlap with a newly created one
+static thread_local int g_ThreadReaderSlot = -1;
 
 #define WM_WINDOWMANAGER_UPDATE_DATA WM_APP //Sent to WindowManager thread to update the local thread data
 
@@ -30,31 +33,28 @@ void WindowManager::UpdateConfigState()
 
     if (m_IsActive)
     {
-		//Create WindowManager thread if there is none
-        if (m_ThreadHandle == nullptr)
-        {
-			m_ThreadData = thread_data_new; //No need to lock since no other thread exists to race with
-			m_ThreadHandle = ::CreateThread(nullptr, 0, WindowManagerThreadEntry, nullptr, 0, &m_ThreadID);
-        }
-		else if (m_ThreadData != thread_data_new) //If just data has changed, update existing thread
+		//Publish new data if it changed or there is no thread yet
+		if ( (m_ThreadHandle == nullptr) || (m_ThreadData.GetWriterCopy() != thread_data_new) )
 		{
+			//Store drag start mouse position and window rect now, since doing on actual drag start will be too late.
+			//This used to be done by the WindowManager thread while the main thread was waiting for it, but that's not needed when it's part of the snapshot
+			if (thread_data_new.TargetWindow != nullptr)
 			{
-				std::lock_guard<std::mutex> lock(m_ThreadMutex);
-				m_ThreadData = thread_data_new;
+				::GetCursorPos(&thread_data_new.DragStartMousePos);
+				::GetWindowRect(thread_data_new.TargetWindow, &thread_data_new.DragStartWindowRect);
 			}
 
-			//Reset done flag before sending update
+			m_ThreadData.Publish(thread_data_new);
+
+			//Create WindowManager thread if there is none, otherwise tell it to update event hooks. The thread sees the new data right away either way
+			//Hooks are installed or removed asynchronously by the thread, so drag blocking changes may take effect a few milliseconds after this returns
+			if (m_ThreadHandle == nullptr)
 			{
-				std::lock_guard<std::mutex> lock(m_UpdateDoneMutex);
-				m_UpdateDoneFlag = false;
+				m_ThreadHandle = ::CreateThread(nullptr, 0, WindowManagerThreadEntry, nullptr, 0, &m_ThreadID);
 			}
-
-			::PostThreadMessage(m_ThreadID, WM_WINDOWMANAGER_UPDATE_DATA, 0, 0);
-
-			//Wait for thread to be done with update before continuing (for 500ms in case the window message goes poof... shouldn't happen though)
+			else
 			{
-				std::unique_lock<std::mutex> lock(m_UpdateDoneMutex);
-				m_UpdateDoneCV.wait_for(lock, std::chrono::milliseconds(500), [&]{ return m_UpdateDoneFlag; });
+				::PostThreadMessage(m_ThreadID, WM_WINDOWMANAGER_UPDATE_DATA, 0, 0);
 			}
 		}
     }
@@ -126,6 +126,7 @@ void WindowManager::RaiseAndFocusWindow(HWND window, InputSimulator* input_sim_p
 			}
 
 			input_sim_ptr->KeyboardSetDown(VK_MENU);
+			input_sim_ptr->Flush(); //Input may be batched, but this needs to have happened before trying again
 			::Sleep(100); //Allow for a little bit of time for the system to register the key press
 
 			//Try again
@@ -207,6 +208,30 @@ void WindowManager::MoveWindowIntoWorkArea(HWND window)
 	::SetWindowPos(window, nullptr,  window_rect.left + offset_x, window_rect.top + offset_y, 0, 0, SWP_NOZORDER | SWP_NOSIZE | SWP_NOACTIVATE);
 }
 
+WindowManagerThreadData WindowManager::ReadThreadData()
+{
+	WindowManagerThreadData thread_data;
+	unsigned long long version;
+
+	//Copy out the data so the read guard is released before anything could dispatch another event callback on this thread
+	{
+		const auto snapshot = m_ThreadData.Read(g_ThreadReaderSlot);
+		thread_data = snapshot.Get();
+		version     = snapshot.GetVersion();
+	}
+
+	//Pick up drag start state as soon as a new target window is seen, as win events for the drag may arrive before the update message
+	if ( (version != m_ThreadDataVersion) && (thread_data.TargetWindow != nullptr) )
+	{
+		m_DragStartMousePos   = thread_data.DragStartMousePos;
+		m_DragStartWindowRect = thread_data.DragStartWindowRect;
+	}
+
+	m_ThreadDataVersion = version;
+
+	return thread_data;
+}
+
 void WindowManager::HandleWinEvent(DWORD win_event, HWND hwnd, LONG id_object, LONG id_child, DWORD event_thread, DWORD event_time)
 {
 	if (win_event == EVENT_OBJECT_FOCUS)
@@ -232,11 +257,13 @@ void WindowManager::HandleWinEvent(DWORD win_event, HWND hwnd, LONG id_object, L
         return;
 	}
 
-	if ( (m_ThreadLocalData.BlockDrag) || (m_ThreadLocalData.KeepOnScreen) )
+	const WindowManagerThreadData thread_data = ReadThreadData();
+
+	if ( (thread_data.BlockDrag) || (thread_data.KeepOnScreen) )
 	{
 		if (win_event == EVENT_SYSTEM_MOVESIZESTART)
 		{
-			if (hwnd == m_ThreadLocalData.TargetWindow)
+			if (hwnd == thread_data.TargetWindow)
 			{
 				m_DragWindow = hwnd;
 				m_DragOverlayMsgSent = false;
@@ -247,7 +274,7 @@ void WindowManager::HandleWinEvent(DWORD win_event, HWND hwnd, LONG id_object, L
 		{
 			if (hwnd == m_DragWindow)
 			{
-				if (m_ThreadLocalData.BlockDrag)
+				if (thread_data.BlockDrag)
 				{
 					RECT window_rect;
 					::GetWindowRect(hwnd, &window_rect);
@@ -265,7 +292,7 @@ void WindowManager::HandleWinEvent(DWORD win_event, HWND hwnd, LONG id_object, L
 						{
 							//Start the overlay drag or send overlay ID 0 to have the mouse button be released (so the desktop drag stops)
 							IPCManager::Get().PostMessageToDashboardApp(ipcmsg_action, ipcact_winmanager_drag_start, 
-																		(m_ThreadLocalData.DoOverlayDrag) ? m_ThreadLocalData.TargetOverlayID : 0);
+																		(thread_data.DoOverlayDrag) ? thread_data.TargetOverlayID : 0);
 							m_DragOverlayMsgSent = true;
 						}
 					}
@@ -275,12 +302,12 @@ void WindowManager::HandleWinEvent(DWORD win_event, HWND hwnd, LONG id_object, L
 						::GetWindowRect(hwnd, &m_DragStartWindowRect);
 					}
 				}
-				else if (m_ThreadLocalData.KeepOnScreen)
+				else if (thread_data.KeepOnScreen)
 				{
 					MoveWindowIntoWorkArea(hwnd);
 				}
 			}
-			else if (hwnd == m_ThreadLocalData.TargetWindow)
+			else if (hwnd == thread_data.TargetWindow)
 			{
 				//Fallback for windows that do their own dragging logic.
 				//This has the chance of picking up a programmatic position change, 
@@ -315,7 +342,7 @@ void WindowManager::HandleWinEvent(DWORD win_event, HWND hwnd, LONG id_object, L
 				::SetCursorPos(m_DragStartMousePos.x, m_DragStartMousePos.y);
 				::SetWindowPos(hwnd, nullptr, m_DragStartWindowRect.left, m_DragStartWindowRect.top, 0, 0, SWP_NOZORDER | SWP_NOSIZE | SWP_NOACTIVATE);
 
-				if (m_ThreadLocalData.KeepOnScreen)
+				if (thread_data.KeepOnScreen)
 				{
 					MoveWindowIntoWorkArea(hwnd);
 				}
@@ -332,16 +359,17 @@ void WindowManager::WindowManager::WinEventProc(HWINEVENTHOOK /*event_hook_handl
     Get().HandleWinEvent(win_event, hwnd, id_object, id_child, event_thread, event_time);
 }
 
-void WindowManager::ManageEventHooks(HWINEVENTHOOK& hook_handle_move_size, HWINEVENTHOOK& hook_handle_location_change, HWINEVENTHOOK& hook_handle_focus_change)
+void WindowManager::ManageEventHooks(const WindowManagerThreadData& thread_data, HWINEVENTHOOK& hook_handle_move_size, HWINEVENTHOOK& hook_handle_location_change, 
+									 HWINEVENTHOOK& hook_handle_focus_change)
 {
-	if ( (m_ThreadLocalData.BlockDrag) && (hook_handle_move_size == nullptr) )
+	if ( (thread_data.BlockDrag) && (hook_handle_move_size == nullptr) )
 	{
 		hook_handle_move_size       = SetWinEventHook(EVENT_SYSTEM_MOVESIZESTART, EVENT_SYSTEM_MOVESIZEEND, nullptr, WindowManager::WinEventProc, 0, 0, 
 													  WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
 		hook_handle_location_change = SetWinEventHook(EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_LOCATIONCHANGE, nullptr, WindowManager::WinEventProc, 0, 0,
 													  WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
 	}
-	else if ( (!m_ThreadLocalData.BlockDrag) && (hook_handle_move_size != nullptr) )
+	else if ( (!thread_data.BlockDrag) && (hook_handle_move_size != nullptr) )
 	{
 		UnhookWinEvent(hook_handle_move_size);
 		UnhookWinEvent(hook_handle_location_change);
@@ -363,27 +391,26 @@ void WindowManager::ManageEventHooks(HWINEVENTHOOK& hook_handle_move_size, HWINE
 		hook_handle_focus_change = SetWinEventHook(EVENT_OBJECT_FOCUS, EVENT_OBJECT_FOCUS, nullptr, WindowManager::WinEventProc, 0, 0, WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
 	}
 
-	//Reset drag window state when target window is nullptr
-	if (m_ThreadLocalData.TargetWindow == nullptr)
+	//Reset drag window state when target window is nullptr (drag start state is picked up in ReadThreadData() otherwise)
+	if (thread_data.TargetWindow == nullptr)
 	{
 		m_DragWindow = nullptr;
 		m_DragOverlayMsgSent = false;
 	}
-	else //Store drag start mouse position and window rect now, since doing on actual drag start will be too late
-	{
-		::GetCursorPos(&m_DragStartMousePos);
-		::GetWindowRect(m_ThreadLocalData.TargetWindow, &m_DragStartWindowRect);
-	}
 }
 
 DWORD WindowManager::WindowManagerThreadEntry(void* /*param*/)
 {
-	//Copy thread data for lock-free reads later
-	{
-		WindowManager& wman = Get();
-		std::lock_guard<std::mutex> lock(wman.m_ThreadMutex);
+	WindowManager& wman = Get();
 
-		wman.m_ThreadLocalData = wman.m_ThreadData;
+	//Register as reader for the thread data snapshots
+	g_ThreadReaderSlot = wman.m_ThreadData.RegisterReader();
+	wman.m_ThreadDataVersion = 0;
+
+	//Bail if there's no slot left. Shouldn't happen unless threads get restarted very rapidly, in which case the next restart will work again
+	if (g_ThreadReaderSlot == ConfigSnapshot<WindowManagerThreadData, 4>::k_lReaderSlotInvalid)
+	{
+		return 0;
 	}
 
 	//Create event hooks
@@ -391,7 +418,14 @@ DWORD WindowManager::WindowManagerThreadEntry(void* /*param*/)
 	HWINEVENTHOOK hook_handle_location_change = nullptr;
 	HWINEVENTHOOK hook_handle_focus_change	  = nullptr;
 	
-	Get().ManageEventHooks(hook_handle_move_size, hook_handle_location_change, hook_handle_focus_change);
+	wman.ManageEventHooks(wman.ReadThreadData(), hook_handle_move_size, hook_handle_location_change, hook_handle_focus_change);
+
+	//Keep the window registry up to date while this thread is running. Hooked before seeding it so no changes get lost in-between
+	//While this thread is stopped, the registry isn't tracking and CreateCapturableWindowList() falls back to enumerating windows on every call
+	WindowRegistryHooks hooks_registry;
+	hooks_registry.Install();
+
+	WindowRegistry::Get().StartTracking();
 
 	//Wait for callbacks, update or quit message
 	MSG msg;
@@ -399,38 +433,28 @@ DWORD WindowManager::WindowManagerThreadEntry(void* /*param*/)
 	{
 		if (msg.message == WM_WINDOWMANAGER_UPDATE_DATA)
 		{
-			WindowManager& wman = Get();
-
-			//Copy new thread data
+			//Event callbacks already use the new data, but hooks and drag state are only updated here
+			if (wman.ReadThreadData().TargetWindow == nullptr)
 			{
-				std::lock_guard<std::mutex> lock(wman.m_ThreadMutex);
-
-				if (wman.m_ThreadData.TargetWindow == nullptr)
-				{
-					//Give a potentially dragged window's process a little bit of time to realize the mouse release
-					::Sleep(20);
-				}
-
-				//Process all pending messages/callbacks before continuing
-				while (::PeekMessage(&msg, 0, 0, WM_APP, PM_REMOVE));
-
-				wman.m_ThreadLocalData = wman.m_ThreadData;
+				//Give a potentially dragged window's process a little bit of time to realize the mouse release
+				::Sleep(20);
 			}
 
-			wman.ManageEventHooks(hook_handle_move_size, hook_handle_location_change, hook_handle_focus_change);
+			//Process all pending messages/callbacks before continuing
+			while (::PeekMessage(&msg, 0, 0, WM_APP, PM_REMOVE));
 
-			//Notify main thread we're done
-			{
-				std::lock_guard<std::mutex> lock(wman.m_UpdateDoneMutex);
-				wman.m_UpdateDoneFlag = true;
-			}
-			wman.m_UpdateDoneCV.notify_one();
+			wman.ManageEventHooks(wman.ReadThreadData(), hook_handle_move_size, hook_handle_location_change, hook_handle_focus_change);
 		}
 	}
 
 	UnhookWinEvent(hook_handle_move_size);
 	UnhookWinEvent(hook_handle_location_change);
 	UnhookWinEvent(hook_handle_focus_change);
+	hooks_registry.Remove();
+
+	WindowRegistry::Get().StopTracking();
+
+	wman.m_ThreadData.UnregisterReader(g_ThreadReaderSlot);
 
 	return 0;
 }
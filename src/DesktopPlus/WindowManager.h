@@ -3,9 +3,8 @@
 #define NOMINMAX
 #include <windows.h>
 
-#include <mutex>
-
 #include "OverlayManager.h"
+#include "ConfigSnapshot.h"
 
 struct WindowManagerThreadData
 {
@@ -14,8 +13,10 @@ struct WindowManagerThreadData
     bool KeepOnScreen = false;
     HWND TargetWindow = nullptr;
     unsigned int TargetOverlayID = k_ulOverlayID_Dashboard;
+    POINT DragStartMousePos {0, 0};              //Captured by the main thread when the target window is set, since doing it on actual drag start will be too late
+    RECT DragStartWindowRect {0, 0, 0, 0};
 
-    bool operator==(const WindowManagerThreadData b)
+    bool operator==(const WindowManagerThreadData b) const
     {
         return ( (BlockDrag == b.BlockDrag) &&
                  (DoOverlayDrag == b.DoOverlayDrag) &&
@@ -23,7 +24,7 @@ struct WindowManagerThreadData
                  (TargetWindow == b.TargetWindow) &&
                  (TargetOverlayID == b.TargetOverlayID) );
     }
-    bool operator!=(const WindowManagerThreadData b)
+    bool operator!=(const WindowManagerThreadData b) const
     {
         return !(*this == b);
     }
@@ -32,6 +33,7 @@ struct WindowManagerThreadData
 class InputSimulator;
 
 //WindowManager uses a separate thread for win event hook callbacks in order to be able to react as soon as possible (needed for window drag blocking)
+//State for that thread is published as immutable snapshots, so neither the main thread publishing it nor the hook thread reading it ever wait on each other
 class WindowManager
 {
     public:
@@ -60,17 +62,11 @@ class WindowManager
         HWND m_LastFocusFailedWindow = nullptr;
         ULONGLONG m_LastFocusFailedTick = 0;
 
-        //- Protected by m_ThreadMutex
-        std::mutex m_ThreadMutex;
-        WindowManagerThreadData m_ThreadData;
-
-        //- Synchronization variables for UpdateConfigState(). m_TargetWindow is not something we can afford to have updated slightly delayed, so that function blocks
-        std::condition_variable m_UpdateDoneCV;
-        std::mutex m_UpdateDoneMutex;
-        bool m_UpdateDoneFlag = false;
+        //- Written by main thread, read by WindowManager thread
+        ConfigSnapshot<WindowManagerThreadData, 4> m_ThreadData;
 
         //- Only accessed in WindowManager thread
-        WindowManagerThreadData m_ThreadLocalData;
+        unsigned long long m_ThreadDataVersion = 0;     //Version of the snapshot the drag start state was last taken from
         POINT m_DragStartMousePos {0, 0};
         RECT m_DragStartWindowRect {0, 0, 0, 0};
         HWND m_DragWindow = nullptr;
@@ -78,9 +74,11 @@ class WindowManager
         DWORD m_FocusLastProcess = 0;
 
         //- Only called by WindowManager thread
+        WindowManagerThreadData ReadThreadData();       //Returns a copy of the current snapshot and picks up its drag start state if it's new
         void HandleWinEvent(DWORD win_event, HWND hwnd, LONG id_object, LONG id_child, DWORD event_thread, DWORD event_time);
         static void CALLBACK WinEventProc(HWINEVENTHOOK event_hook_handle, DWORD win_event, HWND hwnd, LONG id_object, LONG id_child, DWORD event_thread, DWORD event_time);
-        void ManageEventHooks(HWINEVENTHOOK& hook_handle_move_size, HWINEVENTHOOK& hook_handle_location_change, HWINEVENTHOOK& hook_handle_focus_change);
+        void ManageEventHooks(const WindowManagerThreadData& thread_data, HWINEVENTHOOK& hook_handle_move_size, HWINEVENTHOOK& hook_handle_location_change, 
+                              HWINEVENTHOOK& hook_handle_focus_change);
 
         static DWORD WindowManagerThreadEntry(void* param);
 };
\ No newline at end of file
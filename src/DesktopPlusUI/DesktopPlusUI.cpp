@@ -7,6 +7,7 @@
 #include "imgui_impl_dx11_openvr.h"
 #include "implot.h"
 #include <d3d11.h>
+#include <d3d11_1.h>
 #include <wrl/client.h>
 #define DIRECTINPUT_VERSION 0x0800
 #include <dinput.h>
@@ -22,6 +23,7 @@
 #include "WindowSideBar.h"
 #include "WindowSettings.h"
 #include "WindowKeyboardHelper.h"
+#include "WindowList.h"
 #include "Util.h"
 #include "ImGuiExt.h"
 
@@ -30,6 +32,7 @@
 // Data
 static ID3D11Device*            g_pd3dDevice = nullptr;
 static ID3D11DeviceContext*     g_pd3dDeviceContext = nullptr;
+static ID3D11DeviceContext1*    g_pd3dDeviceContext1 = nullptr;  //Only for ClearView(), may be nullptr if the D3D11.1 runtime isn't available
 static IDXGISwapChain*          g_pSwapChain = nullptr;
 static ID3D11RenderTargetView*  g_desktopRenderTargetView = nullptr;
 static ID3D11Texture2D*         g_vrTex = nullptr;
@@ -129,6 +132,9 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
     //Init WinRT DLL
     DPWinRT_Init();
 
+    //Keep a window list up to date for the window pickers and focus switching instead of enumerating all windows every time
+    WindowRegistry::Get().StartTrackingThread();
+
     //Init notification icon if OpenVR is running (no need for it in pure desktop mode without switching back)
     if ( (!ConfigManager::Get().GetConfigBool(configid_bool_interface_no_notification_icon)) && (ui_manager.IsOpenVRLoaded()) )
     {
@@ -138,6 +144,7 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
     //Main loop
     MSG msg;
     ZeroMemory(&msg, sizeof(msg));
+    int ui_visibility_last = -1;
     while (msg.message != WM_QUIT)
     {
         vr::VROverlayHandle_t ovrl_handle_dplus = vr::k_ulOverlayHandleInvalid;
@@ -184,6 +191,7 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
             while (vr::VROverlay()->PollNextOverlayEvent(ui_manager.GetOverlayHandle(), &vr_event, sizeof(vr_event)))
             {
                 ImGui_ImplOpenVR_InputEventHandler(vr_event);
+                ui_manager.RequestRedraw();
                 
                 switch (vr_event.eventType)
                 {
@@ -231,6 +239,8 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
             //Handle OpenVR events for the floating UI
             while (vr::VROverlay()->PollNextOverlayEvent(ui_manager.GetOverlayHandleFloatingUI(), &vr_event, sizeof(vr_event)))
             {
+                ui_manager.RequestRedraw();
+
                 if (!ImGui_ImplOpenVR_InputEventHandler(vr_event))
                 {
                     //Event was not handled by ImGui
@@ -244,6 +254,8 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
             //Handle OpenVR events for the keyboard helper
             while (vr::VROverlay()->PollNextOverlayEvent(ui_manager.GetOverlayHandleKeyboardHelper(), &vr_event, sizeof(vr_event)))
             {
+                ui_manager.RequestRedraw();
+
                 if (!ImGui_ImplOpenVR_InputEventHandler(vr_event))
                 {
                     //Event was not handled by ImGui
@@ -260,6 +272,22 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
             do_idle = ( (!ui_manager.IsOverlayVisible()) && (!ui_manager.IsOverlayKeyboardHelperVisible()) && (!ui_manager.GetFloatingUI().IsVisible()) && 
                         (!ui_manager.GetPerformanceWindow().IsVisible()) );
 
+            //Redraw when any of the UI overlays was shown or hidden, they may have been showing an outdated frame
+            const int ui_visibility = (ui_manager.IsOverlayVisible()) | (ui_manager.IsOverlayKeyboardHelperVisible() << 1) | (ui_manager.GetFloatingUI().IsVisible() << 2) | 
+                                      (ui_manager.GetPerformanceWindow().IsVisible() << 3);
+
+            if (ui_visibility != ui_visibility_last)
+            {
+                ui_manager.RequestRedraw();
+                ui_visibility_last = ui_visibility;
+            }
+
+            //Keyboard helper shows modifier key state, which is polled every frame
+            if (window_kbdhelper.IsVisible())
+            {
+                ui_manager.RequestRedraw();
+            }
+
             if (do_quit)
             {
                 break; //Breaks the message loop, causing clean shutdown
@@ -278,6 +306,8 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
             TextureManager::Get().LoadAllTexturesAndBuildFonts();
         }
 
+        TextureManager::Get().UpdateWindowIcons();
+
         //While we still need to poll, greatly reduce the rate and don't do any ImGui stuff to not waste resources (hopefully this does not mess up ImGui input state)
         if (do_idle)
         {
@@ -285,6 +315,15 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
             continue;
         }
 
+        //Skip the frame entirely if nothing requested a redraw, the overlays keep showing the last one
+        if (!ui_manager.IsRedrawNeeded())
+        {
+            ui_manager.CountFrame(false);
+
+            ::DwmFlush(); //Keep the same pacing as when rendering, some things are counted in loop iterations
+            continue;
+        }
+
         // Start the Dear ImGui frame
         ImGui_ImplDX11_NewFrame();
 
@@ -352,6 +391,7 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
         else
         {
             ImGui::Render();
+            ui_manager.CountFrame(true);
 
             if (desktop_mode)
             {
@@ -368,22 +408,60 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
             }
             else
             {
-                g_pd3dDeviceContext->OMSetRenderTargets(1, &g_vrRenderTargetView, nullptr);
-                g_pd3dDeviceContext->ClearRenderTargetView(g_vrRenderTargetView, (float*)&clear_color);
-                ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+                ImDrawData* draw_data = ImGui::GetDrawData();
 
-                //Set Overlay texture
-                if ((ui_manager.GetOverlayHandle() != vr::k_ulOverlayHandleInvalid) && (g_vrTex))
+                //Only clear and redraw the render spaces whose draw data changed since the last frame
+                if (g_pd3dDeviceContext1 == nullptr)
                 {
-                    vr::Texture_t vrtex;
-                    vrtex.handle = g_vrTex;
-                    vrtex.eType = vr::TextureType_DirectX;
-                    vrtex.eColorSpace = vr::ColorSpace_Gamma;
+                    ui_manager.InvalidateTextureRegions(); //Can't do scissored clears, so always redraw everything
+                }
+
+                ui_manager.UpdateTextureRegions(draw_data);
+
+                ImVec4 region_clip_rects[uitexreg_MAX];
+                D3D11_RECT region_clear_rects[uitexreg_MAX];
+                int region_count = 0;
 
-                    vr::VROverlay()->SetOverlayTexture(ui_manager.GetOverlayHandle(), &vrtex);
+                for (int i = 0; i < uitexreg_MAX; ++i)
+                {
+                    if (ui_manager.IsTextureRegionChanged((UITextureRegion)i))
+                    {
+                        const ImVec4 rect = ui_manager.GetTextureRegionRect((UITextureRegion)i);
+                        region_clip_rects[region_count]  = rect;
+                        region_clear_rects[region_count] = {(LONG)rect.x, (LONG)rect.y, (LONG)rect.z, (LONG)rect.w};
+                        region_count++;
+                    }
                 }
 
-                //Set overlay intersection mask... there doesn't seem to be much overhead from doing this every frame, even though we only need to update this sometimes
+                if (region_count != 0)
+                {
+                    g_pd3dDeviceContext->OMSetRenderTargets(1, &g_vrRenderTargetView, nullptr);
+
+                    if (g_pd3dDeviceContext1 != nullptr)
+                    {
+                        g_pd3dDeviceContext1->ClearView(g_vrRenderTargetView, (float*)&clear_color, region_clear_rects, region_count);
+                        ImGui_ImplDX11_RenderDrawDataClipped(draw_data, region_clip_rects, region_count);
+                    }
+                    else
+                    {
+                        g_pd3dDeviceContext->ClearRenderTargetView(g_vrRenderTargetView, (float*)&clear_color);
+                        ImGui_ImplDX11_RenderDrawData(draw_data);
+                    }
+
+                    //Set Overlay texture
+                    //The other UI overlays share the texture set on this one, so this updates them as well. Nothing is submitted if no region changed
+                    if ((ui_manager.GetOverlayHandle() != vr::k_ulOverlayHandleInvalid) && (g_vrTex))
+                    {
+                        vr::Texture_t vrtex;
+                        vrtex.handle = g_vrTex;
+                        vrtex.eType = vr::TextureType_DirectX;
+                        vrtex.eColorSpace = vr::ColorSpace_Gamma;
+
+                        vr::VROverlay()->SetOverlayTexture(ui_manager.GetOverlayHandle(), &vrtex);
+                    }
+                }
+
+                //Set overlay intersection mask, only sent to OpenVR when the window rects changed
                 ImGui_ImplOpenVR_SetIntersectionMaskFromWindows(ui_manager.GetOverlayHandle());
                 ImGui_ImplOpenVR_SetIntersectionMaskFromWindows(ui_manager.GetOverlayHandleFloatingUI());
                 ImGui_ImplOpenVR_SetIntersectionMaskFromWindows(ui_manager.GetOverlayHandleKeyboardHelper());
@@ -399,6 +477,7 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
 
     // Cleanup
     ui_manager.OnExit();
+    WindowRegistry::Get().StopTrackingThread();
     ImGui_ImplDX11_Shutdown();
     ImGui_ImplWin32_Shutdown();
     ImPlot::DestroyContext();
@@ -498,6 +577,9 @@ bool CreateDeviceD3D(HWND hWnd, bool desktop_mode)
         }
     }
 
+    //Optional, used for partial UI texture updates in VR mode
+    g_pd3dDeviceContext->QueryInterface(IID_PPV_ARGS(&g_pd3dDeviceContext1));
+
     CreateRenderTarget(desktop_mode);
     return true;
 }
@@ -512,6 +594,12 @@ void CleanupDeviceD3D()
         g_pSwapChain = nullptr;
     }
 
+    if (g_pd3dDeviceContext1) 
+    { 
+        g_pd3dDeviceContext1->Release(); 
+        g_pd3dDeviceContext1 = nullptr; 
+    }
+
     if (g_pd3dDeviceContext) 
     { 
         g_pd3dDeviceContext->Release(); 
@@ -552,6 +640,7 @@ void CreateRenderTarget(bool desktop_mode)
     }
 
     UIManager::Get()->SetSharedTextureRef(g_vrTex);
+    UIManager::Get()->InvalidateTextureRegions();
 
     // Create render target view for overlay texture
     D3D11_RENDER_TARGET_VIEW_DESC tex_rtv_desc;
@@ -309,3 +309,8 @@ bool FloatingUI::IsVisible() const
 {
     return ((m_Visible) || (m_Alpha != 0.0f));
 }
+
+bool FloatingUI::IsAnimating() const
+{
+    return (m_Alpha != ((m_Visible) ? 1.0f : 0.0f));
+}
@@ -26,4 +26,5 @@ class FloatingUI
         void Update();
         void UpdateUITargetState();
         bool IsVisible() const;
+        bool IsAnimating() const;   //Fading in or out
 };
\ No newline at end of file
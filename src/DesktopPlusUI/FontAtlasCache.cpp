@@ -0,0 +1,353 @@
+#include "FontAtlasCache.h"
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <memory>
+
+static const char k_CacheMagic[4] = {'D', 'P', 'A', 'C'};
+static const uint32_t k_ulCacheFormatVersion = 1;
+static const int k_lCacheTexSizeMax = 16384;
+static const uint32_t k_ulCacheFontCountMax = 64;
+static const uint32_t k_ulCacheRectCountMax = 65536;
+
+static void WriteU32(std::ostream& stream, uint32_t value)
+{
+    const char bytes[4] = {(char)(value & 0xFF), (char)((value >> 8) & 0xFF), (char)((value >> 16) & 0xFF), (char)((value >> 24) & 0xFF)};
+    stream.write(bytes, 4);
+}
+
+static void WriteU64(std::ostream& stream, uint64_t value)
+{
+    WriteU32(stream, (uint32_t)(value & 0xFFFFFFFF));
+    WriteU32(stream, (uint32_t)(value >> 32));
+}
+
+static void WriteI32(std::ostream& stream, int value)
+{
+    WriteU32(stream, (uint32_t)value);
+}
+
+static void WriteF32(std::ostream& stream, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    WriteU32(stream, bits);
+}
+
+static bool ReadU32(std::istream& stream, uint32_t& value)
+{
+    unsigned char bytes[4];
+    if (!stream.read((char*)bytes, 4))
+        return false;
+
+    value = (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+    return true;
+}
+
+static bool ReadU64(std::istream& stream, uint64_t& value)
+{
+    uint32_t low, high;
+    if ( (!ReadU32(stream, low)) || (!ReadU32(stream, high)) )
+        return false;
+
+    value = (uint64_t)low | ((uint64_t)high << 32);
+    return true;
+}
+
+static bool ReadI32(std::istream& stream, int& value)
+{
+    uint32_t bits;
+    if (!ReadU32(stream, bits))
+        return false;
+
+    value = (int)bits;
+    return true;
+}
+
+static bool ReadF32(std::istream& stream, float& value)
+{
+    uint32_t bits;
+    if (!ReadU32(stream, bits))
+        return false;
+
+    memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+
+FontAtlasCacheKey::FontAtlasCacheKey() : m_Hash(14695981039346656037ULL)
+{
+    //Anything changing the file format or the way ImGui builds atlases invalidates existing caches
+    AddInt(k_ulCacheFormatVersion);
+    AddInt(IMGUI_VERSION_NUM);
+    AddInt(sizeof(ImWchar));
+}
+
+void FontAtlasCacheKey::AddData(const void* data, size_t size)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        m_Hash ^= bytes[i];
+        m_Hash *= 1099511628211ULL;
+    }
+}
+
+void FontAtlasCacheKey::AddString(const std::string& str)
+{
+    AddInt((int64_t)str.size());
+    AddData(str.data(), str.size());
+}
+
+void FontAtlasCacheKey::AddInt(int64_t value)
+{
+    //Little-endian regardless of the platform
+    unsigned char bytes[8];
+    for (int i = 0; i < 8; ++i)
+    {
+        bytes[i] = (unsigned char)(((uint64_t)value >> (i * 8)) & 0xFF);
+    }
+
+    AddData(bytes, sizeof(bytes));
+}
+
+void FontAtlasCacheKey::AddFloat(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    AddInt(bits);
+}
+
+uint64_t FontAtlasCacheKey::GetValue() const
+{
+    return m_Hash;
+}
+
+
+bool FontAtlasCache::Save(std::ostream& stream, uint64_t key, const ImFontAtlas& atlas, const std::vector<FontAtlasCacheRect>& rects)
+{
+    if ( (atlas.TexPixelsRGBA32 == nullptr) || (atlas.TexWidth <= 0) || (atlas.TexHeight <= 0) )
+        return false;
+
+    stream.write(k_CacheMagic, sizeof(k_CacheMagic));
+    WriteU32(stream, k_ulCacheFormatVersion);
+    WriteU64(stream, key);
+
+    //Texture
+    WriteI32(stream, atlas.TexWidth);
+    WriteI32(stream, atlas.TexHeight);
+    WriteU32(stream, (atlas.TexPixelsUseColors) ? 1 : 0);
+    WriteF32(stream, atlas.TexUvWhitePixel.x);
+    WriteF32(stream, atlas.TexUvWhitePixel.y);
+
+    WriteU32(stream, (uint32_t)IM_ARRAYSIZE(atlas.TexUvLines));
+    for (const ImVec4& uv : atlas.TexUvLines)
+    {
+        WriteF32(stream, uv.x);
+        WriteF32(stream, uv.y);
+        WriteF32(stream, uv.z);
+        WriteF32(stream, uv.w);
+    }
+
+    //Pixels are stored as RGBA bytes, same as ImGui keeps them in memory on little-endian machines
+    const size_t pixel_count = (size_t)atlas.TexWidth * atlas.TexHeight;
+    std::unique_ptr<char[]> pixel_bytes(new char[pixel_count * 4]);
+
+    for (size_t i = 0; i < pixel_count; ++i)
+    {
+        const unsigned int col = atlas.TexPixelsRGBA32[i];
+        pixel_bytes[(i * 4)]     = (char)((col >> IM_COL32_R_SHIFT) & 0xFF);
+        pixel_bytes[(i * 4) + 1] = (char)((col >> IM_COL32_G_SHIFT) & 0xFF);
+        pixel_bytes[(i * 4) + 2] = (char)((col >> IM_COL32_B_SHIFT) & 0xFF);
+        pixel_bytes[(i * 4) + 3] = (char)((col >> IM_COL32_A_SHIFT) & 0xFF);
+    }
+
+    stream.write(pixel_bytes.get(), pixel_count * 4);
+
+    //Fonts
+    WriteU32(stream, (uint32_t)atlas.Fonts.Size);
+    for (const ImFont* font : atlas.Fonts)
+    {
+        WriteF32(stream, font->FontSize);
+        WriteF32(stream, font->Ascent);
+        WriteF32(stream, font->Descent);
+        WriteF32(stream, font->Scale);
+        WriteU32(stream, font->FallbackChar);
+        WriteU32(stream, font->EllipsisChar);
+        WriteI32(stream, font->MetricsTotalSurface);
+
+        WriteU32(stream, (uint32_t)font->Glyphs.Size);
+        for (const ImFontGlyph& glyph : font->Glyphs)
+        {
+            WriteU32(stream, glyph.Codepoint | (glyph.Colored << 30) | (glyph.Visible << 31));
+            WriteF32(stream, glyph.AdvanceX);
+            WriteF32(stream, glyph.X0);
+            WriteF32(stream, glyph.Y0);
+            WriteF32(stream, glyph.X1);
+            WriteF32(stream, glyph.Y1);
+            WriteF32(stream, glyph.U0);
+            WriteF32(stream, glyph.V0);
+            WriteF32(stream, glyph.U1);
+            WriteF32(stream, glyph.V1);
+        }
+    }
+
+    //Custom rects
+    WriteU32(stream, (uint32_t)rects.size());
+    for (const FontAtlasCacheRect& rect : rects)
+    {
+        WriteI32(stream, rect.ID);
+        WriteI32(stream, rect.X);
+        WriteI32(stream, rect.Y);
+        WriteI32(stream, rect.Width);
+        WriteI32(stream, rect.Height);
+    }
+
+    stream.write(k_CacheMagic, sizeof(k_CacheMagic)); //End marker, catches truncated files
+
+    return stream.good();
+}
+
+bool FontAtlasCache::Load(std::istream& stream, uint64_t key, ImFontAtlas& atlas, std::vector<FontAtlasCacheRect>& rects)
+{
+    struct CachedFont
+    {
+        float FontSize, Ascent, Descent, Scale;
+        uint32_t FallbackChar, EllipsisChar;
+        int MetricsTotalSurface;
+        ImVector<ImFontGlyph> Glyphs;
+    };
+
+    //Read everything first, the atlas is only touched once the whole file turned out to be valid
+    char magic[4];
+    uint32_t format_version;
+    uint64_t file_key;
+
+    if ( (!stream.read(magic, sizeof(magic))) || (memcmp(magic, k_CacheMagic, sizeof(magic)) != 0) )
+        return false;
+
+    if ( (!ReadU32(stream, format_version)) || (format_version != k_ulCacheFormatVersion) || (!ReadU64(stream, file_key)) || (file_key != key) )
+        return false;
+
+    //Texture
+    int tex_width, tex_height;
+    uint32_t tex_use_colors, uv_lines_count;
+    ImVec2 uv_white_pixel;
+    ImVec4 uv_lines[IM_ARRAYSIZE(atlas.TexUvLines)];
+
+    if ( (!ReadI32(stream, tex_width)) || (!ReadI32(stream, tex_height)) || (!ReadU32(stream, tex_use_colors)) ||
+         (!ReadF32(stream, uv_white_pixel.x)) || (!ReadF32(stream, uv_white_pixel.y)) || (!ReadU32(stream, uv_lines_count)) )
+        return false;
+
+    if ( (tex_width <= 0) || (tex_height <= 0) || (tex_width > k_lCacheTexSizeMax) || (tex_height > k_lCacheTexSizeMax) || (uv_lines_count != IM_ARRAYSIZE(uv_lines)) )
+        return false;
+
+    for (ImVec4& uv : uv_lines)
+    {
+        if ( (!ReadF32(stream, uv.x)) || (!ReadF32(stream, uv.y)) || (!ReadF32(stream, uv.z)) || (!ReadF32(stream, uv.w)) )
+            return false;
+    }
+
+    const size_t pixel_count = (size_t)tex_width * tex_height;
+    std::unique_ptr<unsigned char[]> pixel_bytes(new unsigned char[pixel_count * 4]);
+
+    if (!stream.read((char*)pixel_bytes.get(), pixel_count * 4))
+        return false;
+
+    //Fonts
+    uint32_t font_count;
+    if ( (!ReadU32(stream, font_count)) || (font_count == 0) || (font_count > k_ulCacheFontCountMax) )
+        return false;
+
+    std::vector<CachedFont> fonts(font_count);
+    for (CachedFont& font : fonts)
+    {
+        uint32_t glyph_count;
+
+        if ( (!ReadF32(stream, font.FontSize)) || (!ReadF32(stream, font.Ascent)) || (!ReadF32(stream, font.Descent)) || (!ReadF32(stream, font.Scale)) ||
+             (!ReadU32(stream, font.FallbackChar)) || (!ReadU32(stream, font.EllipsisChar)) || (!ReadI32(stream, font.MetricsTotalSurface)) ||
+             (!ReadU32(stream, glyph_count)) )
+            return false;
+
+        //Glyph indices are stored as ImWchar in the lookup table, with 0xFFFF being reserved
+        if (glyph_count >= 0xFFFF)
+            return false;
+
+        font.Glyphs.resize((int)glyph_count);
+        for (ImFontGlyph& glyph : font.Glyphs)
+        {
+            uint32_t glyph_flags;
+
+            if ( (!ReadU32(stream, glyph_flags)) || (!ReadF32(stream, glyph.AdvanceX)) || (!ReadF32(stream, glyph.X0)) || (!ReadF32(stream, glyph.Y0)) ||
+                 (!ReadF32(stream, glyph.X1)) || (!ReadF32(stream, glyph.Y1)) || (!ReadF32(stream, glyph.U0)) || (!ReadF32(stream, glyph.V0)) ||
+                 (!ReadF32(stream, glyph.U1)) || (!ReadF32(stream, glyph.V1)) )
+                return false;
+
+            glyph.Codepoint = glyph_flags & 0x3FFFFFFF;
+            glyph.Colored   = (glyph_flags >> 30) & 1;
+            glyph.Visible   = (glyph_flags >> 31) & 1;
+
+            if (glyph.Codepoint > IM_UNICODE_CODEPOINT_MAX)
+                return false;
+        }
+    }
+
+    //Custom rects
+    uint32_t rect_count;
+    if ( (!ReadU32(stream, rect_count)) || (rect_count > k_ulCacheRectCountMax) )
+        return false;
+
+    std::vector<FontAtlasCacheRect> cached_rects(rect_count);
+    for (FontAtlasCacheRect& rect : cached_rects)
+    {
+        if ( (!ReadI32(stream, rect.ID)) || (!ReadI32(stream, rect.X)) || (!ReadI32(stream, rect.Y)) || (!ReadI32(stream, rect.Width)) || (!ReadI32(stream, rect.Height)) )
+            return false;
+
+        if ( (rect.ID != -1) && ( (rect.X < 0) || (rect.Y < 0) || (rect.Width < 0) || (rect.Height < 0) ||
+                                  (rect.X + rect.Width > tex_width) || (rect.Y + rect.Height > tex_height) ) )
+            return false;
+    }
+
+    if ( (!stream.read(magic, sizeof(magic))) || (memcmp(magic, k_CacheMagic, sizeof(magic)) != 0) )
+        return false;
+
+    //All good, replace atlas content
+    atlas.Clear();
+
+    atlas.TexWidth           = tex_width;
+    atlas.TexHeight          = tex_height;
+    atlas.TexUvScale         = ImVec2(1.0f / tex_width, 1.0f / tex_height);
+    atlas.TexUvWhitePixel    = uv_white_pixel;
+    atlas.TexPixelsUseColors = (tex_use_colors != 0);
+    memcpy(atlas.TexUvLines, uv_lines, sizeof(uv_lines));
+
+    atlas.TexPixelsRGBA32 = (unsigned int*)IM_ALLOC(pixel_count * 4);
+    for (size_t i = 0; i < pixel_count; ++i)
+    {
+        const unsigned char* p = pixel_bytes.get() + (i * 4);
+        atlas.TexPixelsRGBA32[i] = IM_COL32(p[0], p[1], p[2], p[3]);
+    }
+
+    for (CachedFont& cached_font : fonts)
+    {
+        ImFont* font = IM_NEW(ImFont);
+        font->FontSize            = cached_font.FontSize;
+        font->Ascent              = cached_font.Ascent;
+        font->Descent             = cached_font.Descent;
+        font->Scale               = cached_font.Scale;
+        font->FallbackChar        = (ImWchar)cached_font.FallbackChar;
+        font->EllipsisChar        = (ImWchar)cached_font.EllipsisChar;
+        font->MetricsTotalSurface = cached_font.MetricsTotalSurface;
+        font->ContainerAtlas      = &atlas;
+        font->Glyphs.swap(cached_font.Glyphs);
+        font->BuildLookupTable();   //Also sets the fallback glyph
+
+        atlas.Fonts.push_back(font);
+    }
+
+    rects = std::move(cached_rects);
+
+    return true;
+}
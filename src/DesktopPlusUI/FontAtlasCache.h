@@ -0,0 +1,49 @@
+//Stores built ImGui font atlases on disk so they can be loaded again instead of being rebuilt
+//Building means rasterizing every glyph of every font and decoding all icons, which is noticeably slow with many glyphs. Reading the result back isn't
+//Nothing in here depends on the platform. Cache files are written with fixed-size little-endian values and the key hash doesn't rely on anything
+//implementation-defined, so results are the same everywhere
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <iosfwd>
+
+#include "imgui.h"
+
+//Custom rect of the atlas, as needed by the application after building it
+struct FontAtlasCacheRect
+{
+    int ID = -1;            //Custom rect ID at build time, -1 if the rect isn't in the atlas
+    int X = 0;
+    int Y = 0;
+    int Width  = 0;
+    int Height = 0;
+};
+
+//Hash of everything that went into building an atlas (FNV-1a, 64-bit)
+class FontAtlasCacheKey
+{
+    private:
+        uint64_t m_Hash;
+
+    public:
+        FontAtlasCacheKey();
+
+        void AddData(const void* data, size_t size);
+        void AddString(const std::string& str);     //Also adds the length, so consecutive strings can't blend into each other
+        void AddInt(int64_t value);
+        void AddFloat(float value);
+        uint64_t GetValue() const;
+};
+
+class FontAtlasCache
+{
+    public:
+        //Writes atlas texture, fonts and the given rects to stream. Atlas has to be built and have RGBA32 texture data
+        static bool Save(std::ostream& stream, uint64_t key, const ImFontAtlas& atlas, const std::vector<FontAtlasCacheRect>& rects);
+        //Replaces the content of atlas with the cached one if the stream holds a valid cache for key. Atlas is left untouched otherwise
+        //The restored atlas is in the same state as a built one after ImFontAtlas::ClearInputData()
+        static bool Load(std::istream& stream, uint64_t key, ImFontAtlas& atlas, std::vector<FontAtlasCacheRect>& rects);
+};
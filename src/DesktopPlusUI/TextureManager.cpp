@@ -4,6 +4,7 @@
 #include <windows.h>
 #include <algorithm>
 #include <vector>
+#include <fstream>
 
 //Make GDI+ header work with NOMINMAX
 namespace Gdiplus
@@ -20,6 +21,7 @@ namespace Gdiplus
 #include "UIManager.h"
 #include "OverlayManager.h"
 #include "imgui_impl_dx11_openvr.h"
+#include "FontAtlasCache.h"
 
 const wchar_t* TextureManager::s_TextureFilenames[] =
 {
@@ -54,8 +56,48 @@ const wchar_t* TextureManager::s_TextureFilenames[] =
 
 static TextureManager g_TextureManager;
 
-TextureManager::TextureManager() : m_ReloadLater(false)
+static const int k_lWindowIconSlotSize = 48;                //Larger icons are scaled down. Most are 32x32 at 100% DPI
+static const unsigned int k_ulWindowIconSlotCount = 40;
+static const ULONGLONG k_ullWindowIconCheckInterval = 3000;    //Only one message to the window if the icon handle didn't change
+
+//UI font, used by both LoadAllTexturesAndBuildFonts() and GetAtlasCacheKey()
+//The first font is the base, the others are merged into it in this order to fill in what it's missing
+static const wchar_t* const s_FontFilenames[] =
+{
+    L"C:\\Windows\\Fonts\\segoeui.ttf",
+    L"C:\\Windows\\Fonts\\msgothic.ttc",                   //Segoe UI doesn't have any CJK, use some fallbacks (loading this is actually pretty fast)
+    L"C:\\Windows\\Fonts\\malgun.ttf",
+    L"C:\\Windows\\Fonts\\msyh.ttc",
+    L"C:\\Windows\\Fonts\\seguisym.ttf"                    //Also add some symbol support at least... yeah this is far from comprehensive all in all but should cover most uses
+};
+static const float k_fFontBaseSize       = 32.0f;             //Scaled by the UI scale
+static const float k_fFontLargeSizeScale = 1.5f;              //Size of the large font relative to the base size
+static const float k_fFontGlyphOffsetY   = -1.0f;             //Set offset to make it not look so bad
+
+//Version of the way the atlas is put together here (fonts, icons, custom rect layout). Bump when changing any of it to invalidate cached atlases
+static const int k_lAtlasBuildVersion = 1;
+
+//Adds path, size and last write time of the file to the key, so the cache is invalidated when it changes
+static void AddFileToAtlasCacheKey(FontAtlasCacheKey& key, const std::wstring& path)
 {
+    key.AddString(StringConvertFromUTF16(path.c_str()));
+
+    WIN32_FILE_ATTRIBUTE_DATA attr_data;
+    if (::GetFileAttributesEx(path.c_str(), GetFileExInfoStandard, &attr_data) != 0)
+    {
+        key.AddInt(((int64_t)attr_data.nFileSizeHigh << 32) | attr_data.nFileSizeLow);
+        key.AddInt(((int64_t)attr_data.ftLastWriteTime.dwHighDateTime << 32) | attr_data.ftLastWriteTime.dwLowDateTime);
+    }
+    else
+    {
+        key.AddInt(-1);
+    }
+}
+
+TextureManager::TextureManager() : m_WindowIconLoader(k_lWindowIconSlotSize), m_ReloadLater(false)
+{
+    m_WindowIcons.resize(k_ulWindowIconSlotCount);
+
     std::fill(std::begin(m_ImGuiRectIDs), std::end(m_ImGuiRectIDs), -1);
     std::fill(std::begin(m_AtlasSizes), std::end(m_AtlasSizes), ImVec2(-1, -1));
     std::fill(std::begin(m_AtlasUVs), std::end(m_AtlasUVs), ImVec4(0, 0, 0, 0));
@@ -113,46 +155,64 @@ bool TextureManager::LoadAllTexturesAndBuildFonts()
     builder.AddRanges(io.Fonts->GetGlyphRangesDefault());
     builder.BuildRanges(&ranges);
 
+    bool load_large_font = ( (ConfigManager::Get().GetConfigBool(configid_bool_interface_large_style)) && (!UIManager::Get()->IsInDesktopMode()) );
+
+    //Window icon placeholder, loaded separately as it's not from a file
+    if (m_WindowIconPlaceholder.PixelData == nullptr)
+    {
+        WindowIconData icon_data;
+        if (WindowIconLoader::LoadIconData(::LoadIcon(nullptr, IDI_APPLICATION), k_lWindowIconSlotSize, icon_data))
+        {
+            m_WindowIconPlaceholder.PixelData = std::move(icon_data.PixelData);
+            m_WindowIconPlaceholder.Size      = {(float)icon_data.Width, (float)icon_data.Height};
+        }
+    }
+
+    //Skip building entirely if the atlas was built from the same input before
+    const uint64_t atlas_cache_key = GetAtlasCacheKey(ranges, load_large_font);
+
+    if (LoadAtlasFromCache(atlas_cache_key, load_large_font))
+    {
+        return true;
+    }
+
     ImFontConfig config_compact;
     ImFontConfig config_large;
-    config_compact.GlyphOffset.y = -1; //Set offset to make it not look so bad
-    config_large.GlyphOffset.y   = -1;
+    config_compact.GlyphOffset.y = k_fFontGlyphOffsetY;
+    config_large.GlyphOffset.y   = k_fFontGlyphOffsetY;
     ImFontConfig* config = &config_compact;
 
     //Try to load fonts
     ImFont* font = nullptr;
     ImFont* font_compact = nullptr;
     ImFont* font_large = nullptr;
-    float font_base_size = 32.0f;
-    bool load_large_font = ( (ConfigManager::Get().GetConfigBool(configid_bool_interface_large_style)) && (!UIManager::Get()->IsInDesktopMode()) );
+    float font_base_size = k_fFontBaseSize;
 
     //Loop to do the same for the large font if needed
     for (;;)
     {
-        //AddFontFromFileTTF asserts when failing to load, so check for existence, though it's not really an issue in release mode
-        if (FileExists(L"C:\\Windows\\Fonts\\segoeui.ttf"))
-        {
-            font = io.Fonts->AddFontFromFileTTF("C:\\Windows\\Fonts\\segoeui.ttf", font_base_size * UIManager::Get()->GetUIScale(), config, ranges.Data);
-        }
+        font = nullptr;
 
-        if (font != nullptr)
+        for (const wchar_t* font_filename : s_FontFilenames)
         {
-            config->MergeMode = true;
+            //Only merge fallbacks if the base font could be loaded
+            if ( (font == nullptr) && (font_filename != s_FontFilenames[0]) )
+                break;
 
-            //Segoe UI doesn't have any CJK, use some fallbacks (loading this is actually pretty fast)
-            if (FileExists(L"C:\\Windows\\Fonts\\msgothic.ttc"))
-                io.Fonts->AddFontFromFileTTF("C:\\Windows\\Fonts\\msgothic.ttc", font_base_size * UIManager::Get()->GetUIScale(), config, ranges.Data);
+            //AddFontFromFileTTF asserts when failing to load, so check for existence, though it's not really an issue in release mode
+            if (!FileExists(font_filename))
+                continue;
 
-            if (FileExists(L"C:\\Windows\\Fonts\\malgun.ttf"))
-                io.Fonts->AddFontFromFileTTF("C:\\Windows\\Fonts\\malgun.ttf", font_base_size * UIManager::Get()->GetUIScale(), config, ranges.Data);
+            ImFont* font_added = io.Fonts->AddFontFromFileTTF(StringConvertFromUTF16(font_filename).c_str(), font_base_size * UIManager::Get()->GetUIScale(), config, ranges.Data);
 
-            if (FileExists(L"C:\\Windows\\Fonts\\msyh.ttc"))
-                io.Fonts->AddFontFromFileTTF("C:\\Windows\\Fonts\\msyh.ttc", font_base_size * UIManager::Get()->GetUIScale(), config, ranges.Data);
-            //Also add some symbol support at least... yeah this is far from comprehensive all in all but should cover most uses
-            if (FileExists(L"C:\\Windows\\Fonts\\seguisym.ttf"))
-                io.Fonts->AddFontFromFileTTF("C:\\Windows\\Fonts\\seguisym.ttf", font_base_size * UIManager::Get()->GetUIScale(), config, ranges.Data);
+            if (font == nullptr)
+            {
+                font = font_added;
+                config->MergeMode = (font != nullptr);
+            }
         }
-        else
+
+        if (font == nullptr)
         {
             //Though we have the default as fallback if it isn't somehow
             font = io.Fonts->AddFontDefault();
@@ -169,7 +229,7 @@ bool TextureManager::LoadAllTexturesAndBuildFonts()
 
         if ( (load_large_font) && (font_large == nullptr) )
         {
-            font_base_size *= 1.5f;
+            font_base_size *= k_fFontLargeSizeScale;
             config = &config_large;
         }
         else
@@ -250,16 +310,11 @@ bool TextureManager::LoadAllTexturesAndBuildFonts()
         }
     }
 
-    //Set up already loaded window icons
-    for (auto& window_icon : m_WindowIcons)
+    //Reserve slots for the window icon placeholder and window icons. Icons are copied into them once loaded, without rebuilding the atlas
+    std::vector<int> window_icon_rect_ids;
+    for (unsigned int i = 0; i <= m_WindowIcons.size(); ++i)
     {
-        window_icon.ImGuiRectID = io.Fonts->AddCustomRectRegular((int)window_icon.Size.x, (int)window_icon.Size.y);
-
-        if (io.Fonts->TexDesiredWidth <= (int)window_icon.Size.x)
-        {
-            //See above
-            io.Fonts->TexDesiredWidth = (window_icon.Size.x >= 2048) ? 4096 : (window_icon.Size.x >= 1024) ? 2048 : (window_icon.Size.x >= 512) ? 1024 : 512;
-        }
+        window_icon_rect_ids.push_back(io.Fonts->AddCustomRectRegular(k_lWindowIconSlotSize, k_lWindowIconSlotSize));
     }
 
     //Build atlas
@@ -360,29 +415,28 @@ bool TextureManager::LoadAllTexturesAndBuildFonts()
         icon_id++;
     }
 
-    //Copy cached window icons into atlas
-    for (auto& window_icon : m_WindowIcons)
+    //Store the result while the window icon slots are still blank. Not done if anything failed, so it's tried again next time
+    if (all_ok)
+    {
+        SaveAtlasToCache(atlas_cache_key, window_icon_rect_ids);
+    }
+
+    //Copy window icon placeholder and cached window icons into their slots
+    for (unsigned int i = 0; i < window_icon_rect_ids.size(); ++i)
     {
-        if (const ImFontAtlasCustomRect* rect = io.Fonts->GetCustomRectByIndex(window_icon.ImGuiRectID))
+        TMNGRWindowIcon& window_icon = (i == 0) ? m_WindowIconPlaceholder : m_WindowIcons[i - 1];
+
+        if (const ImFontAtlasCustomRect* rect = io.Fonts->GetCustomRectByIndex(window_icon_rect_ids[i]))
         {
-            UINT8* psrc = (UINT8*)window_icon.PixelData.get();
-            size_t stride = rect->Width * 4;
-            //Copy RGBA pixels line-by-line
-            for (int y = 0; y < rect->Height; ++y, psrc += stride)
-            {
-                ImU32* p = (ImU32*)tex_pixels + (rect->Y + y) * tex_width + (rect->X);
-                memcpy(p, psrc, stride);
-            }
+            window_icon.AtlasX = rect->X;
+            window_icon.AtlasY = rect->Y;
 
-            //Store UVs
-            window_icon.AtlasUV.x = (float)rect->X * io.Fonts->TexUvScale.x;                  //Min U
-            window_icon.AtlasUV.y = (float)rect->Y * io.Fonts->TexUvScale.y;                  //Min V
-            window_icon.AtlasUV.z = (float)(rect->X + rect->Width)  * io.Fonts->TexUvScale.x; //Max U
-            window_icon.AtlasUV.w = (float)(rect->Y + rect->Height) * io.Fonts->TexUvScale.y; //Max V
+            CopyWindowIconToAtlas(window_icon);
         }
         else
         {
-            window_icon.ImGuiRectID = -1;
+            window_icon.AtlasX = -1;
+            window_icon.AtlasY = -1;
             all_ok = false;
         }
     }
@@ -398,10 +452,164 @@ bool TextureManager::LoadAllTexturesAndBuildFonts()
     io.Fonts->ClearInputData();
 
     UIManager::Get()->SetFonts(font_compact, font_large);
+    UIManager::Get()->RequestRedraw();
+    UIManager::Get()->InvalidateTextureRegions();
 
     return all_ok;
 }
 
+uint64_t TextureManager::GetAtlasCacheKey(const ImVector<ImWchar>& ranges, bool load_large_font) const
+{
+    FontAtlasCacheKey key;
+
+    key.AddData(ranges.Data, ranges.Size * sizeof(ImWchar));
+    key.AddInt(k_lAtlasBuildVersion);
+    key.AddFloat(UIManager::Get()->GetUIScale());
+    key.AddInt(load_large_font);
+
+    //Font setup, fonts are added in merge order
+    key.AddFloat(k_fFontBaseSize);
+    key.AddFloat(k_fFontLargeSizeScale);
+    key.AddFloat(k_fFontGlyphOffsetY);
+
+    for (const wchar_t* font_filename : s_FontFilenames)
+    {
+        AddFileToAtlasCacheKey(key, font_filename);
+    }
+
+    for (int icon_id = 0; icon_id < tmtex_MAX; ++icon_id)
+    {
+        AddFileToAtlasCacheKey(key, (icon_id == tmtex_icon_temp) ? m_TextureFilenameIconTemp : s_TextureFilenames[icon_id]);
+    }
+
+    for (const CustomAction& action : ConfigManager::Get().GetCustomActions())
+    {
+        AddFileToAtlasCacheKey(key, WStringConvertFromUTF8(action.IconFilename.c_str()));
+    }
+
+    key.AddInt(k_lWindowIconSlotSize);
+    key.AddInt((int64_t)m_WindowIcons.size());
+
+    return key.GetValue();
+}
+
+std::wstring TextureManager::GetAtlasCacheFilePath() const
+{
+    return WStringConvertFromUTF8(std::string(ConfigManager::Get().GetApplicationPath() + "/ui_atlas.cache").c_str());
+}
+
+bool TextureManager::LoadAtlasFromCache(uint64_t key, bool load_large_font)
+{
+    ImGuiIO& io = ImGui::GetIO();
+    std::vector<FontAtlasCacheRect> rects;
+
+    std::ifstream file(GetAtlasCacheFilePath(), std::ios::binary);
+
+    if ( (!file) || (!FontAtlasCache::Load(file, key, *io.Fonts, rects)) )
+        return false;
+
+    //Rects are application textures, then custom action icons, then window icon slots. The key covers all of these, so a mismatch here means a broken file
+    std::vector<CustomAction>& actions = ConfigManager::Get().GetCustomActions();
+    const size_t action_rect_offset      = tmtex_MAX;
+    const size_t window_icon_rect_offset = action_rect_offset + actions.size();
+
+    if ( (rects.size() != window_icon_rect_offset + m_WindowIcons.size() + 1) || (io.Fonts->Fonts.Size != ((load_large_font) ? 2 : 1)) )
+    {
+        io.Fonts->Clear();
+        return false;
+    }
+
+    for (size_t i = 0; i < window_icon_rect_offset; ++i)
+    {
+        const FontAtlasCacheRect& rect = rects[i];
+
+        int*    rect_id    = (i < action_rect_offset) ? &m_ImGuiRectIDs[i] : &actions[i - action_rect_offset].IconImGuiRectID;
+        ImVec2* atlas_size = (i < action_rect_offset) ? &m_AtlasSizes[i]   : &actions[i - action_rect_offset].IconAtlasSize;
+        ImVec4* atlas_uvs  = (i < action_rect_offset) ? &m_AtlasUVs[i]     : &actions[i - action_rect_offset].IconAtlasUV;
+
+        *rect_id = rect.ID;
+
+        if (rect.ID != -1)
+        {
+            atlas_size->x = rect.Width;
+            atlas_size->y = rect.Height;
+
+            atlas_uvs->x = (float)rect.X * io.Fonts->TexUvScale.x;                 //Min U
+            atlas_uvs->y = (float)rect.Y * io.Fonts->TexUvScale.y;                 //Min V
+            atlas_uvs->z = (float)(rect.X + rect.Width)  * io.Fonts->TexUvScale.x; //Max U
+            atlas_uvs->w = (float)(rect.Y + rect.Height) * io.Fonts->TexUvScale.y; //Max V
+        }
+    }
+
+    //Copy window icon placeholder and cached window icons into their slots
+    for (size_t i = 0; i <= m_WindowIcons.size(); ++i)
+    {
+        TMNGRWindowIcon& window_icon = (i == 0) ? m_WindowIconPlaceholder : m_WindowIcons[i - 1];
+        const FontAtlasCacheRect& rect = rects[window_icon_rect_offset + i];
+
+        window_icon.AtlasX = (rect.ID != -1) ? rect.X : -1;
+        window_icon.AtlasY = (rect.ID != -1) ? rect.Y : -1;
+
+        CopyWindowIconToAtlas(window_icon);
+    }
+
+    m_ReloadLater = false;
+
+    UIManager::Get()->SetFonts(io.Fonts->Fonts[0], (load_large_font) ? io.Fonts->Fonts[1] : nullptr);
+    UIManager::Get()->RequestRedraw();
+    UIManager::Get()->InvalidateTextureRegions();
+
+    return true;
+}
+
+void TextureManager::SaveAtlasToCache(uint64_t key, const std::vector<int>& window_icon_rect_ids) const
+{
+    ImGuiIO& io = ImGui::GetIO();
+    std::vector<FontAtlasCacheRect> rects;
+
+    auto add_rect = [&](int rect_id)
+    {
+        FontAtlasCacheRect cache_rect;
+
+        if (rect_id != -1)
+        {
+            const ImFontAtlasCustomRect* rect = io.Fonts->GetCustomRectByIndex(rect_id);
+
+            cache_rect.ID     = rect_id;
+            cache_rect.X      = rect->X;
+            cache_rect.Y      = rect->Y;
+            cache_rect.Width  = rect->Width;
+            cache_rect.Height = rect->Height;
+        }
+
+        rects.push_back(cache_rect);
+    };
+
+    //Same order as expected by LoadAtlasFromCache()
+    for (int rect_id : m_ImGuiRectIDs)
+    {
+        add_rect(rect_id);
+    }
+
+    for (const CustomAction& action : ConfigManager::Get().GetCustomActions())
+    {
+        add_rect(action.IconImGuiRectID);
+    }
+
+    for (int rect_id : window_icon_rect_ids)
+    {
+        add_rect(rect_id);
+    }
+
+    std::ofstream file(GetAtlasCacheFilePath(), std::ios::binary | std::ios::trunc);
+
+    if (file)
+    {
+        //A partially written file is rejected on load, so failure needs no further handling
+        FontAtlasCache::Save(file, key, *io.Fonts, rects);
+    }
+}
+
 void TextureManager::ReloadAllTexturesLater()
 {
     m_ReloadLater = true;
@@ -457,146 +665,153 @@ bool TextureManager::GetTextureInfo(const CustomAction& action, ImVec2& size, Im
     return false;
 }
 
-int TextureManager::GetWindowIconCacheID(HICON icon_handle)
+int TextureManager::GetWindowIconCacheID(HWND window_handle)
 {
-    //Look if the icon is already loaded
+    if (window_handle == nullptr)
+        return -1;
+
+    const int frame = ImGui::GetFrameCount();
+
+    //Look if the icon is already cached
     for (int i = 0; i < m_WindowIcons.size(); ++i)
     {
-        if (m_WindowIcons[i].IconHandle == icon_handle)
+        TMNGRWindowIcon& window_icon = m_WindowIcons[i];
+
+        if (window_icon.WindowHandle == window_handle)
         {
+            window_icon.LastUsedFrame = frame;
+
+            //Check if the icon is still current once in a while. The cached one is shown until the loader found it changed
+            if ( (window_icon.IsLoaded) && (!window_icon.IsCheckPending) && (::GetTickCount64() >= window_icon.LastCheckTick + k_ullWindowIconCheckInterval) )
+            {
+                window_icon.IsCheckPending = true;
+                m_WindowIconLoader.RequestIcon(window_handle, window_icon.IconHandle);
+            }
+
             return i;
         }
     }
 
-    //Icon not loaded yet, try to do that
-    int ret = -1;
-    ICONINFO icon_info = {0};
-    if (::GetIconInfo(icon_handle, &icon_info) != 0)
+    //Not cached, take the least recently used slot. Slots used in this frame can't be taken as their ID may still be in use
+    int slot_id = -1;
+    int slot_last_used_frame = frame;
+    for (int i = 0; i < m_WindowIcons.size(); ++i)
     {
-        HDC hdc, hdcMem;
+        if (m_WindowIcons[i].LastUsedFrame < slot_last_used_frame)
+        {
+            slot_id = i;
+            slot_last_used_frame = m_WindowIcons[i].LastUsedFrame;
+        }
+    }
 
-        hdc    = ::GetDC(nullptr);
-        hdcMem = ::CreateCompatibleDC(hdc);
+    if (slot_id == -1)
+        return -1;
 
-        //Get bitmap info from icon bitmap
-        BITMAPINFO bmp_info = {0};
-        bmp_info.bmiHeader.biSize = sizeof(bmp_info.bmiHeader);
-        if (::GetDIBits(hdcMem, icon_info.hbmColor, 0, 0, nullptr, &bmp_info, DIB_RGB_COLORS) != 0)
-        {
-            TMNGRWindowIcon window_icon;
-            int icon_width  = bmp_info.bmiHeader.biWidth;
-            int icon_height = abs(bmp_info.bmiHeader.biHeight);
-            const size_t icon_pixel_count = icon_width * icon_height;
+    //The slot's atlas area is only overwritten once the new icon is loaded, the placeholder is used until then
+    TMNGRWindowIcon& window_icon = m_WindowIcons[slot_id];
+    window_icon.WindowHandle   = window_handle;
+    window_icon.IconHandle     = nullptr;
+    window_icon.PixelData.reset();
+    window_icon.Size           = {0.0f, 0.0f};
+    window_icon.IsLoaded       = false;
+    window_icon.IsCheckPending = false;
+    window_icon.LastUsedFrame  = frame;
 
-            auto PixelData = std::unique_ptr<BYTE[]>{new BYTE[icon_pixel_count * 4]};
+    m_WindowIconLoader.RequestIcon(window_handle);
 
-            bmp_info.bmiHeader.biSize        = sizeof(bmp_info.bmiHeader);
-            bmp_info.bmiHeader.biBitCount    = 32;
-            bmp_info.bmiHeader.biCompression = BI_RGB;
-            bmp_info.bmiHeader.biHeight      = -icon_height; //Always use top-down order (negative height)
+    return slot_id;
+}
 
-            //Read the actual bitmap buffer into the pixel data array
-            if (::GetDIBits(hdc, icon_info.hbmColor, 0, bmp_info.bmiHeader.biHeight, (LPVOID)PixelData.get(), &bmp_info, DIB_RGB_COLORS) != 0)
-            {
-                //Even if we don't override biBitCount to 32, it's still returned as that for 24-bit and lower bit-depth icons (probably just the screen DC format)
-                //It seems the only way to check if the icon needs its mask applied is to see if the alpha channel is fully blank
-                //32-bit icons still come masks, but applying them means to override the alpha channel with a 1-bit one (and doing so is also wasteful)
-                bool needs_mask = true;
-                BYTE* psrc = PixelData.get() + 3; //BGRA alpha pixel
-                const BYTE* const psrc_end = PixelData.get() + (icon_pixel_count * 4);
-                for (; psrc < psrc_end; psrc += 4)
-                {
-                    if (*psrc != 0)
-                    {
-                        needs_mask = false;
-                        break;
-                    }
-                }
+bool TextureManager::GetWindowIconTextureInfo(int icon_cache_id, ImVec2& size, ImVec2& uv_min, ImVec2& uv_max) const
+{
+    if ( (icon_cache_id >= 0) && (icon_cache_id < m_WindowIcons.size()) )
+    {
+        const TMNGRWindowIcon& window_icon = (m_WindowIcons[icon_cache_id].PixelData != nullptr) ? m_WindowIcons[icon_cache_id] : m_WindowIconPlaceholder;
 
-                //Apply mask if we need to
-                if (needs_mask)
-                {
-                    //Get bitmap info for the mask this time
-                    BITMAPINFO bmp_info = {0};
-                    bmp_info.bmiHeader.biSize = sizeof(bmp_info.bmiHeader);
-                    if (::GetDIBits(hdcMem, icon_info.hbmMask, 0, 0, nullptr, &bmp_info, DIB_RGB_COLORS) != 0)
-                    {
-                        int mask_width  = bmp_info.bmiHeader.biWidth;
-                        int mask_height = abs(bmp_info.bmiHeader.biHeight);
+        if (window_icon.AtlasX == -1)
+            return false;
 
-                        //Only continue if icon and mask are really the same size (can be different for monochrome bitmap formats, which are not supported here)
-                        if ( (icon_width == mask_width) && (icon_height == mask_height) )
-                        {
-                            auto PixelDataMask = std::unique_ptr<BYTE[]>{new BYTE[icon_pixel_count * 4]};
+        const ImVec2& uv_scale = ImGui::GetIO().Fonts->TexUvScale;
 
-                            bmp_info.bmiHeader.biSize        = sizeof(bmp_info.bmiHeader);
-                            bmp_info.bmiHeader.biBitCount    = 32;
-                            bmp_info.bmiHeader.biCompression = BI_RGB;
-                            bmp_info.bmiHeader.biHeight      = -abs(bmp_info.bmiHeader.biHeight); //Always use top-down order (negative height)
+        size     = window_icon.Size;
+        uv_min.x = (float)window_icon.AtlasX * uv_scale.x;
+        uv_min.y = (float)window_icon.AtlasY * uv_scale.y;
+        uv_max.x = (float)(window_icon.AtlasX + window_icon.Size.x) * uv_scale.x;
+        uv_max.y = (float)(window_icon.AtlasY + window_icon.Size.y) * uv_scale.y;
 
-                            //Read the mask bitmap buffer
-                            if (::GetDIBits(hdc, icon_info.hbmMask, 0, bmp_info.bmiHeader.biHeight, (LPVOID)PixelDataMask.get(), &bmp_info, DIB_RGB_COLORS) != 0)
-                            {
-                                //Apply mask to color pixel data
-                                psrc       = PixelData.get() + 3; //BGRA alpha pixel
-                                BYTE* pmsk = PixelDataMask.get(); //BGRA blue pixel (alpha channel is blank for the mask)
-                                for (; psrc < psrc_end; psrc += 4, pmsk += 4)
-                                {
-                                    *psrc = ~(*pmsk);
-                                }
-                            }
-                        }
-                    }
-                }
+        return true;
+    }
 
-                //Convert BGRA to RGBA for ImGui's texture atlas
-                window_icon.PixelData = std::unique_ptr<BYTE[]>{new BYTE[icon_pixel_count * 4]};
-                psrc         = PixelData.get();
-                UINT32* pdst = (UINT32*)window_icon.PixelData.get();
-                for (; psrc < psrc_end; psrc += 4, ++pdst)
-                {
-                    *pdst = IM_COL32(*(psrc + 2), *(psrc + 1), *psrc, *(psrc + 3));
-                }
+    return false;
+}
 
-                //Fill out other data and move the icon to the cache
-                window_icon.IconHandle = icon_handle;
-                window_icon.Size = {(float)icon_width, (float)icon_height};
-                m_WindowIcons.push_back(std::move(window_icon));
+void TextureManager::UpdateWindowIcons()
+{
+    WindowIconData icon_data;
+    while (m_WindowIconLoader.PopResult(icon_data))
+    {
+        //Slot may have been given to another window while loading
+        auto it = std::find_if(m_WindowIcons.begin(), m_WindowIcons.end(), [&](const auto& window_icon){ return (window_icon.WindowHandle == icon_data.WindowHandle); });
 
-                //We succeeded, but the icon won't be ready until next frame, so schedule reload and skip rendering this frame
-                ReloadAllTexturesLater();
-                UIManager::Get()->RepeatFrame();
+        //Results are either for the initial load or a check of a loaded icon. Anything else is left over from before the slot was reused
+        if ( (it == m_WindowIcons.end()) || ( (it->IsLoaded) && (!it->IsCheckPending) ) )
+            continue;
 
-                ret = (int)m_WindowIcons.size() - 1;
-            }
-        }
+        const bool is_check = it->IsLoaded;
 
-        ::DeleteObject(icon_info.hbmColor);
-        ::DeleteObject(icon_info.hbmMask);
+        it->IsLoaded       = true;
+        it->IsCheckPending = false;
+        it->LastCheckTick  = ::GetTickCount64();
 
-        ::DeleteDC(hdcMem);
-        ::ReleaseDC(nullptr, hdc);
-    }
+        if (icon_data.IsUnchanged)
+            continue;
+
+        it->IconHandle = icon_data.IconHandle;
+        it->PixelData  = std::move(icon_data.PixelData);
+        it->Size       = {(float)icon_data.Width, (float)icon_data.Height};
+
+        //Placeholder stays if loading failed. A changed icon that failed to load goes back to the placeholder
+        if ( (it->PixelData == nullptr) && (!is_check) )
+            continue;
 
-    return ret;
+        CopyWindowIconToAtlas(*it);
+
+        if (it->AtlasX != -1)
+        {
+            ImGui_ImplDX11_UpdateFontsTextureRegion(it->AtlasX, it->AtlasY, k_lWindowIconSlotSize, k_lWindowIconSlotSize);
+            UIManager::Get()->RequestRedraw();
+            UIManager::Get()->InvalidateTextureRegions();   //Slot pixels changed without the draw data necessarily doing so
+        }
+    }
 }
 
-bool TextureManager::GetWindowIconTextureInfo(int icon_cache_id, ImVec2& size, ImVec2& uv_min, ImVec2& uv_max) const
+void TextureManager::CopyWindowIconToAtlas(const TMNGRWindowIcon& window_icon) const
 {
-    if ( (icon_cache_id >= 0) && (icon_cache_id < m_WindowIcons.size()) )
-    {
-        const TMNGRWindowIcon& window_icon = m_WindowIcons[icon_cache_id];
+    //Not using GetTexDataAsRGBA32() as that would build the atlas if there's no data
+    ImFontAtlas* atlas = ImGui::GetIO().Fonts;
 
-        size     = window_icon.Size;
-        uv_min.x = window_icon.AtlasUV.x;
-        uv_min.y = window_icon.AtlasUV.y;
-        uv_max.x = window_icon.AtlasUV.z;
-        uv_max.y = window_icon.AtlasUV.w;
+    if ( (window_icon.AtlasX == -1) || (atlas->TexPixelsRGBA32 == nullptr) )
+        return;
 
-        return true;
-    }
+    const int icon_width  = (window_icon.PixelData != nullptr) ? (int)window_icon.Size.x : 0;
+    const int icon_height = (window_icon.PixelData != nullptr) ? (int)window_icon.Size.y : 0;
+    const size_t stride   = icon_width * 4;
 
-    return false;
+    //Copy RGBA pixels line-by-line and clear the rest of the slot, as it may still contain a previous icon
+    for (int y = 0; y < k_lWindowIconSlotSize; ++y)
+    {
+        ImU32* p = (ImU32*)atlas->TexPixelsRGBA32 + (window_icon.AtlasY + y) * atlas->TexWidth + window_icon.AtlasX;
+
+        if (y < icon_height)
+        {
+            memcpy(p, window_icon.PixelData.get() + (y * stride), stride);
+            memset(p + icon_width, 0, (k_lWindowIconSlotSize - icon_width) * 4);
+        }
+        else
+        {
+            memset(p, 0, k_lWindowIconSlotSize * 4);
+        }
+    }
 }
 
 bool TextureManager::AddFontBuilderString(const char* str)
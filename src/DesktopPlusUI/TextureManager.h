@@ -6,9 +6,11 @@
 #pragma once
 
 #include <memory>
+#include <stdint.h>
 #include "imgui.h"
 
 #include "Actions.h"
+#include "WindowIconLoader.h"
 
 enum TMNGRTexID
 {
@@ -44,11 +46,16 @@ enum TMNGRTexID
 
 struct TMNGRWindowIcon
 {
-    HICON IconHandle = nullptr;
-    std::unique_ptr<BYTE[]> PixelData;  //RGBA
+    HWND WindowHandle = nullptr;        //nullptr if the slot is unused
+    HICON IconHandle = nullptr;         //Icon the pixel data was loaded from
+    std::unique_ptr<BYTE[]> PixelData;  //RGBA, nullptr while loading or if loading failed. Kept to restore the slot after the atlas was rebuilt
     ImVec2 Size = {0.0f, 0.0f};
-    int ImGuiRectID  = -1; //-1 when no icon loaded (ID on ImGui end is not valid after building the font)
-    ImVec4 AtlasUV = {0.0f, 0.0f, 0.0f, 0.0f};
+    bool IsLoaded = false;              //Loader finished, successful or not
+    bool IsCheckPending = false;        //Loader was asked if the window's icon handle changed
+    ULONGLONG LastCheckTick = 0;        //When the icon handle was last loaded or checked
+    int LastUsedFrame = -1;
+    int AtlasX = -1;                    //Position of the slot in the atlas, -1 when not in the atlas
+    int AtlasY = -1;
 };
 
 class TextureManager
@@ -60,10 +67,20 @@ class TextureManager
         ImVec4 m_AtlasUVs[tmtex_MAX];
         std::wstring m_TextureFilenameIconTemp;
         std::vector<std::string> m_FontBuilderExtraStrings; //Extra strings containing characters to be included when building the fonts. Might fill up over time but better than nothing
-        std::vector<TMNGRWindowIcon> m_WindowIcons;
+        std::vector<TMNGRWindowIcon> m_WindowIcons;         //Fixed amount of atlas slots, reused in least recently used order
+        TMNGRWindowIcon m_WindowIconPlaceholder;            //Shown while an icon is loading or if it failed to load
+        WindowIconLoader m_WindowIconLoader;
 
         bool m_ReloadLater;
 
+        void CopyWindowIconToAtlas(const TMNGRWindowIcon& window_icon) const;
+
+        //The built atlas is cached on disk, keyed by everything that goes into building it
+        uint64_t GetAtlasCacheKey(const ImVector<ImWchar>& ranges, bool load_large_font) const;
+        std::wstring GetAtlasCacheFilePath() const;
+        bool LoadAtlasFromCache(uint64_t key, bool load_large_font);   //Returns false if there's no valid cache for the key, atlas is left as-is then
+        void SaveAtlasToCache(uint64_t key, const std::vector<int>& window_icon_rect_ids) const;
+
     public:
         TextureManager();
         static TextureManager& Get();
@@ -77,8 +94,12 @@ class TextureManager
         bool GetTextureInfo(TMNGRTexID texid, ImVec2& size, ImVec2& uv_min, ImVec2& uv_max) const;
         bool GetTextureInfo(const CustomAction& action, ImVec2& size, ImVec2& uv_min, ImVec2& uv_max) const;
 
-        int  GetWindowIconCacheID(HICON icon_handle); //Returns -1 on error
+        //Icons are loaded asynchronously and put into reserved atlas slots without rebuilding it. Texture info is for a placeholder until then
+        //Cached icons in use are checked against the window's current icon handle every few seconds, also in the background
+        //This catches windows changing their icon as well as window handles getting reused by another window
+        int  GetWindowIconCacheID(HWND window_handle);  //Returns -1 on error or if all slots are in use this frame
         bool GetWindowIconTextureInfo(int icon_cache_id, ImVec2& size, ImVec2& uv_min, ImVec2& uv_max) const;
+        void UpdateWindowIcons();                       //Copies icons that finished loading into the atlas. Called once per frame
 
         bool AddFontBuilderString(const char* str);   //Returns true if string has been added (not already in extra string list)
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "UIManager.h"
 
 #include "imgui.h"
+#include "imgui_internal.h"
 #include "imgui_impl_win32_openvr.h"
 
 #include <windows.h>
@@ -13,6 +14,9 @@
 
 #include "WindowKeyboardHelper.h"
 
+static const ULONGLONG k_ulRedrawGracePeriod = 1000;   //ms to keep rendering after a redraw request
+static const ULONGLONG k_ulRedrawInterval    = 1000;   //ms between forced redraws, picks up values only polled during a frame (window lists, battery levels, etc.)
+
 //While this is a singleton like many other classes, we want to be careful about initializing it at global scope, so we leave that until a bit later in main()
 UIManager* g_UIManagerPtr = nullptr;
 
@@ -52,6 +56,23 @@ UIManager* UIManager::Get()
 UIManager::UIManager(bool desktop_mode) : m_WindowHandle(nullptr),
                                           m_SharedTextureRef(nullptr),
                                           m_RepeatFrame(false),
+                                          m_RedrawRequestTick(0),
+                                          m_RenderTickLast(0),
+                                          m_FrameCountTickLast(0),
+                                          m_FramesRendered(0),
+                                          m_FramesSkipped(0),
+                                          m_FramesRenderedLastSecond(0),
+                                          m_FramesSkippedLastSecond(0),
+                                          m_TextureRegionHashes{},
+                                          m_TextureRegionChanged{},
+                                          m_TextureRegionsInvalid(true),
+                                          m_TextureRegionsUIScale(1.0f),
+                                          m_TextureRegionUpdates(0),
+                                          m_TextureRegionUpdatesLastSecond(0),
+                                          m_IntersectionMaskSubmitCountLast(0),
+                                          m_IntersectionMaskSkipCountLast(0),
+                                          m_IntersectionMaskSubmitsLastSecond(0),
+                                          m_IntersectionMaskSkipsLastSecond(0),
                                           m_DesktopMode(desktop_mode),
                                           m_OpenVRLoaded(false),
                                           m_NoRestartOnExit(false),
@@ -222,6 +243,8 @@ vr::EVRInitError UIManager::InitOverlay()
 
 void UIManager::HandleIPCMessage(const MSG& msg)
 {
+    RequestRedraw();
+
     //Config strings come as WM_COPYDATA
     if (msg.message == WM_COPYDATA)
     {
@@ -405,6 +428,11 @@ void UIManager::OnExit()
         ::CoUninitialize();
     }
 
+    //Overlays are destroyed with the OpenVR shutdown
+    ImGui_ImplOpenVR_RemoveIntersectionMaskState(m_OvrlHandle);
+    ImGui_ImplOpenVR_RemoveIntersectionMaskState(m_OvrlHandleFloatingUI);
+    ImGui_ImplOpenVR_RemoveIntersectionMaskState(m_OvrlHandleKeyboardHelper);
+
     vr::VR_Shutdown();
 }
 
@@ -466,6 +494,7 @@ vr::VROverlayHandle_t UIManager::GetOverlayHandleKeyboardHelper() const
 void UIManager::RepeatFrame()
 {
     m_RepeatFrame = 2;
+    RequestRedraw();
 }
 
 bool UIManager::GetRepeatFrame() const
@@ -479,6 +508,178 @@ void UIManager::DecreaseRepeatFrameCount()
         m_RepeatFrame--;
 }
 
+void UIManager::RequestRedraw()
+{
+    m_RedrawRequestTick = ::GetTickCount64();
+}
+
+bool UIManager::IsRedrawNeeded() const
+{
+    //Desktop mode presents to a swapchain and is paced by it, so always render there
+    if (m_DesktopMode)
+        return true;
+
+    const ULONGLONG tick = ::GetTickCount64();
+
+    if ( (tick < m_RedrawRequestTick + k_ulRedrawGracePeriod) || (tick >= m_RenderTickLast + k_ulRedrawInterval) || (GetRepeatFrame()) )
+        return true;
+
+    //Things updating on their own
+    if ( (m_WindowPerformance.IsVisible()) || (m_FloatingUI.IsAnimating()) )
+        return true;
+
+    //Blinking text cursor or something being dragged around
+    if ( (ImGui::GetIO().WantTextInput) || (ImGui::IsAnyItemActive()) )
+        return true;
+
+    return false;
+}
+
+void UIManager::CountFrame(bool rendered)
+{
+    const ULONGLONG tick = ::GetTickCount64();
+
+    if (rendered)
+    {
+        m_FramesRendered++;
+        m_RenderTickLast = tick;
+    }
+    else
+    {
+        m_FramesSkipped++;
+    }
+
+    if (tick >= m_FrameCountTickLast + 1000)
+    {
+        m_FramesRenderedLastSecond = m_FramesRendered;
+        m_FramesSkippedLastSecond  = m_FramesSkipped;
+        m_TextureRegionUpdatesLastSecond = m_TextureRegionUpdates;
+        m_FramesRendered = 0;
+        m_FramesSkipped  = 0;
+        m_TextureRegionUpdates = 0;
+
+        unsigned int mask_submit_count, mask_skip_count;
+        ImGui_ImplOpenVR_GetIntersectionMaskCounts(&mask_submit_count, &mask_skip_count);
+
+        m_IntersectionMaskSubmitsLastSecond = mask_submit_count - m_IntersectionMaskSubmitCountLast;
+        m_IntersectionMaskSkipsLastSecond   = mask_skip_count   - m_IntersectionMaskSkipCountLast;
+        m_IntersectionMaskSubmitCountLast   = mask_submit_count;
+        m_IntersectionMaskSkipCountLast     = mask_skip_count;
+        m_FrameCountTickLast = tick;
+    }
+}
+
+unsigned int UIManager::GetFramesRenderedLastSecond() const
+{
+    return m_FramesRenderedLastSecond;
+}
+
+unsigned int UIManager::GetFramesSkippedLastSecond() const
+{
+    return m_FramesSkippedLastSecond;
+}
+
+void UIManager::UpdateTextureRegions(const ImDrawData* draw_data)
+{
+    //Render spaces move when the UI scale changes
+    if (m_TextureRegionsUIScale != m_UIScale)
+    {
+        m_TextureRegionsInvalid = true;
+        m_TextureRegionsUIScale = m_UIScale;
+    }
+
+    ImVec4 region_rects[uitexreg_MAX];
+    ImGuiID region_hashes[uitexreg_MAX] = {0};
+
+    for (int i = 0; i < uitexreg_MAX; ++i)
+    {
+        region_rects[i] = GetTextureRegionRect((UITextureRegion)i);
+    }
+
+    for (int n = 0; n < draw_data->CmdListsCount; ++n)
+    {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+
+        //Hash everything of the list that affects what ends up in the texture (ImDrawCmd zeroes its padding, so it can be hashed as a whole)
+        ImGuiID list_hash = ImHashData(cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+        list_hash = ImHashData(cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx), list_hash);
+        unsigned int region_mask = 0;
+
+        for (const ImDrawCmd& cmd : cmd_list->CmdBuffer)
+        {
+            list_hash = ImHashData(&cmd, sizeof(ImDrawCmd), list_hash);
+
+            //A list can touch more than one render space (popups, tooltips), it counts as part of all of them then
+            for (int i = 0; i < uitexreg_MAX; ++i)
+            {
+                if ( (cmd.ClipRect.y < region_rects[i].w) && (cmd.ClipRect.w > region_rects[i].y) )
+                {
+                    region_mask |= (1 << i);
+                }
+            }
+        }
+
+        for (int i = 0; i < uitexreg_MAX; ++i)
+        {
+            if (region_mask & (1 << i))
+            {
+                region_hashes[i] = ImHashData(&list_hash, sizeof(list_hash), region_hashes[i]);
+            }
+        }
+    }
+
+    for (int i = 0; i < uitexreg_MAX; ++i)
+    {
+        m_TextureRegionChanged[i] = ( (m_TextureRegionsInvalid) || (region_hashes[i] != m_TextureRegionHashes[i]) );
+        m_TextureRegionHashes[i]  = region_hashes[i];
+
+        if (m_TextureRegionChanged[i])
+        {
+            m_TextureRegionUpdates++;
+        }
+    }
+
+    m_TextureRegionsInvalid = false;
+}
+
+void UIManager::InvalidateTextureRegions()
+{
+    m_TextureRegionsInvalid = true;
+}
+
+bool UIManager::IsTextureRegionChanged(UITextureRegion region) const
+{
+    return m_TextureRegionChanged[region];
+}
+
+ImVec4 UIManager::GetTextureRegionRect(UITextureRegion region) const
+{
+    const int region_heights[uitexreg_MAX] = {TEXSPACE_DASHBOARD_UI_HEIGHT, TEXSPACE_FLOATING_UI_HEIGHT, TEXSPACE_KEYBOARD_HELPER_HEIGHT, TEXSPACE_PERFORMANCE_MONITOR_HEIGHT};
+
+    int region_top = 0;
+    for (int i = 0; i < region; ++i)
+    {
+        region_top += region_heights[i] + TEXSPACE_VERTICAL_SPACING;
+    }
+
+    return {0.0f, region_top * m_UIScale, (float)TEXSPACE_TOTAL_WIDTH, (region_top + region_heights[region]) * m_UIScale};
+}
+
+unsigned int UIManager::GetTextureRegionUpdatesLastSecond() const
+{
+    return m_TextureRegionUpdatesLastSecond;
+}
+
+unsigned int UIManager::GetIntersectionMaskSubmitsLastSecond() const
+{
+    return m_IntersectionMaskSubmitsLastSecond;
+}
+
+unsigned int UIManager::GetIntersectionMaskSkipsLastSecond() const
+{
+    return m_IntersectionMaskSkipsLastSecond;
+}
+
 bool UIManager::IsInDesktopMode() const
 {
     return m_DesktopMode;
@@ -29,6 +29,16 @@
                                TEXSPACE_VERTICAL_SPACING + TEXSPACE_PERFORMANCE_MONITOR_HEIGHT)
 #define OVERLAY_WIDTH_METERS_DASHBOARD_UI 2.75f
 
+//Render spaces of the shared texture, in the order they're laid out from top to bottom
+enum UITextureRegion
+{
+    uitexreg_dashboard_ui,
+    uitexreg_floating_ui,
+    uitexreg_keyboard_helper,
+    uitexreg_performance_monitor,
+    uitexreg_MAX
+};
+
 class WindowKeyboardHelper;
 
 class UIManager
@@ -43,6 +53,27 @@ class UIManager
         ID3D11Resource* m_SharedTextureRef; //Pointer to render target texture, should only be used for calls to SetSharedOverlayTexture()
         int m_RepeatFrame;
 
+        //Redraw on demand in VR mode. Frames are only rendered when something requested it, the overlays keep showing the last texture otherwise
+        ULONGLONG m_RedrawRequestTick;
+        ULONGLONG m_RenderTickLast;
+        ULONGLONG m_FrameCountTickLast;
+        unsigned int m_FramesRendered;
+        unsigned int m_FramesSkipped;
+        unsigned int m_FramesRenderedLastSecond;
+        unsigned int m_FramesSkippedLastSecond;
+
+        //Partial texture updates in VR mode. Hashes of the draw data touching each render space, so unchanged ones don't have to be redrawn
+        ImGuiID m_TextureRegionHashes[uitexreg_MAX];
+        bool m_TextureRegionChanged[uitexreg_MAX];
+        bool m_TextureRegionsInvalid;
+        float m_TextureRegionsUIScale;
+        unsigned int m_TextureRegionUpdates;
+        unsigned int m_TextureRegionUpdatesLastSecond;
+        unsigned int m_IntersectionMaskSubmitCountLast;     //Totals from the backend at the last per-second update
+        unsigned int m_IntersectionMaskSkipCountLast;
+        unsigned int m_IntersectionMaskSubmitsLastSecond;
+        unsigned int m_IntersectionMaskSkipsLastSecond;
+
         bool m_DesktopMode;
         bool m_OpenVRLoaded;         //Desktop mode can run with or without OpenVR and we want to avoid needlessly starting up SteamVR
         bool m_NoRestartOnExit;      //Prevent auto-restart when closing from desktop mode while dashboard app is running (i.e. when using troubleshooting buttons)
@@ -100,6 +131,23 @@ class UIManager
         bool GetRepeatFrame() const;
         void DecreaseRepeatFrameCount();
 
+        //Called for anything that may change what the UI looks like (input, IPC messages, texture updates, etc.)
+        //Keeps rendering frames for a short while after, so ImGui's hover and popup state as well as delayed tooltips can catch up
+        void RequestRedraw();
+        bool IsRedrawNeeded() const;                //Always true in desktop mode
+        void CountFrame(bool rendered);
+        unsigned int GetFramesRenderedLastSecond() const;
+        unsigned int GetFramesSkippedLastSecond() const;
+
+        //Compares the draw data against the one of the last call and marks the render spaces it changed in. Render spaces are matched by draw command clip rects
+        void UpdateTextureRegions(const ImDrawData* draw_data);
+        void InvalidateTextureRegions();            //Marks all render spaces as changed on the next update, for when the texture content was lost or can't be trusted
+        bool IsTextureRegionChanged(UITextureRegion region) const;
+        ImVec4 GetTextureRegionRect(UITextureRegion region) const;  //In display coordinates, same as set up for ImGui in the main loop
+        unsigned int GetTextureRegionUpdatesLastSecond() const;
+        unsigned int GetIntersectionMaskSubmitsLastSecond() const;  //Calls to IVROverlay::SetOverlayIntersectionMask() for the UI overlays
+        unsigned int GetIntersectionMaskSkipsLastSecond() const;    //Calls avoided since the mask didn't change
+
         bool IsInDesktopMode() const;
         bool IsOpenVRLoaded() const;
         void DisableRestartOnExit();
@@ -0,0 +1,247 @@
+#include "WindowIconLoader.h"
+
+#include <algorithm>
+
+#include "WindowList.h"
+
+//Box filter with premultiplied alpha, so fully transparent pixels don't bleed their color into the result
+static void ScaleDownRGBA(const BYTE* src, int src_width, int src_height, BYTE* dst, int dst_width, int dst_height)
+{
+    for (int y = 0; y < dst_height; ++y)
+    {
+        const int src_y_start = (y * src_height) / dst_height;
+        const int src_y_end   = (std::max)(((y + 1) * src_height) / dst_height, src_y_start + 1);
+
+        for (int x = 0; x < dst_width; ++x)
+        {
+            const int src_x_start = (x * src_width) / dst_width;
+            const int src_x_end   = (std::max)(((x + 1) * src_width) / dst_width, src_x_start + 1);
+
+            UINT64 r = 0, g = 0, b = 0, a = 0;
+            UINT64 count = 0;
+
+            for (int src_y = src_y_start; src_y < src_y_end; ++src_y)
+            {
+                const BYTE* psrc = src + ((src_y * src_width) + src_x_start) * 4;
+
+                for (int src_x = src_x_start; src_x < src_x_end; ++src_x, psrc += 4, ++count)
+                {
+                    r += psrc[0] * psrc[3];
+                    g += psrc[1] * psrc[3];
+                    b += psrc[2] * psrc[3];
+                    a += psrc[3];
+                }
+            }
+
+            BYTE* pdst = dst + ((y * dst_width) + x) * 4;
+            pdst[0] = (a != 0) ? (BYTE)(r / a) : 0;
+            pdst[1] = (a != 0) ? (BYTE)(g / a) : 0;
+            pdst[2] = (a != 0) ? (BYTE)(b / a) : 0;
+            pdst[3] = (BYTE)(a / count);
+        }
+    }
+}
+
+WindowIconLoader::WindowIconLoader(int max_size) : m_MaxSize(max_size), m_DoQuit(false)
+{
+}
+
+WindowIconLoader::~WindowIconLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_DoQuit = true;
+    }
+
+    m_ConditionVar.notify_one();
+
+    if (m_Thread.joinable())
+    {
+        m_Thread.join();
+    }
+}
+
+void WindowIconLoader::ThreadMain()
+{
+    for (;;)
+    {
+        WindowIconData icon_data;
+        HICON icon_handle_known = nullptr;
+
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_ConditionVar.wait(lock, [&](){ return ( (m_DoQuit) || (!m_Requests.empty()) ); });
+
+            if (m_DoQuit)
+                return;
+
+            icon_data.WindowHandle = m_Requests.front().first;
+            icon_handle_known      = m_Requests.front().second;
+            m_Requests.pop_front();
+        }
+
+        icon_data.IconHandle  = WindowInfo::GetIcon(icon_data.WindowHandle);
+        icon_data.IsUnchanged = ( (icon_handle_known != nullptr) && (icon_data.IconHandle == icon_handle_known) );
+
+        //Failures are passed on as well so the requester knows it's done
+        if (!icon_data.IsUnchanged)
+        {
+            LoadIconData(icon_data.IconHandle, m_MaxSize, icon_data);
+        }
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Results.push_back(std::move(icon_data));
+    }
+}
+
+void WindowIconLoader::RequestIcon(HWND window_handle, HICON icon_handle_known)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        if (std::find_if(m_Requests.begin(), m_Requests.end(), [&](const auto& request){ return (request.first == window_handle); }) != m_Requests.end())
+            return;
+
+        m_Requests.push_back({window_handle, icon_handle_known});
+    }
+
+    if (!m_Thread.joinable())
+    {
+        m_Thread = std::thread(&WindowIconLoader::ThreadMain, this);
+    }
+
+    m_ConditionVar.notify_one();
+}
+
+bool WindowIconLoader::PopResult(WindowIconData& icon_data)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    if (m_Results.empty())
+        return false;
+
+    icon_data = std::move(m_Results.back());
+    m_Results.pop_back();
+
+    return true;
+}
+
+bool WindowIconLoader::LoadIconData(HICON icon_handle, int max_size, WindowIconData& icon_data)
+{
+    icon_data.Width  = 0;
+    icon_data.Height = 0;
+    icon_data.PixelData.reset();
+
+    ICONINFO icon_info = {0};
+    if ( (icon_handle == nullptr) || (::GetIconInfo(icon_handle, &icon_info) == 0) )
+        return false;
+
+    HDC hdc, hdcMem;
+
+    hdc    = ::GetDC(nullptr);
+    hdcMem = ::CreateCompatibleDC(hdc);
+
+    //Get bitmap info from icon bitmap
+    BITMAPINFO bmp_info = {0};
+    bmp_info.bmiHeader.biSize = sizeof(bmp_info.bmiHeader);
+    if (::GetDIBits(hdcMem, icon_info.hbmColor, 0, 0, nullptr, &bmp_info, DIB_RGB_COLORS) != 0)
+    {
+        int icon_width  = bmp_info.bmiHeader.biWidth;
+        int icon_height = abs(bmp_info.bmiHeader.biHeight);
+        const size_t icon_pixel_count = icon_width * icon_height;
+
+        auto PixelData = std::unique_ptr<BYTE[]>{new BYTE[icon_pixel_count * 4]};
+
+        bmp_info.bmiHeader.biSize        = sizeof(bmp_info.bmiHeader);
+        bmp_info.bmiHeader.biBitCount    = 32;
+        bmp_info.bmiHeader.biCompression = BI_RGB;
+        bmp_info.bmiHeader.biHeight      = -icon_height; //Always use top-down order (negative height)
+
+        //Read the actual bitmap buffer into the pixel data array
+        if (::GetDIBits(hdc, icon_info.hbmColor, 0, bmp_info.bmiHeader.biHeight, (LPVOID)PixelData.get(), &bmp_info, DIB_RGB_COLORS) != 0)
+        {
+            //Even if we don't override biBitCount to 32, it's still returned as that for 24-bit and lower bit-depth icons (probably just the screen DC format)
+            //It seems the only way to check if the icon needs its mask applied is to see if the alpha channel is fully blank
+            //32-bit icons still come masks, but applying them means to override the alpha channel with a 1-bit one (and doing so is also wasteful)
+            bool needs_mask = true;
+            BYTE* psrc = PixelData.get() + 3; //BGRA alpha pixel
+            const BYTE* const psrc_end = PixelData.get() + (icon_pixel_count * 4);
+            for (; psrc < psrc_end; psrc += 4)
+            {
+                if (*psrc != 0)
+                {
+                    needs_mask = false;
+                    break;
+                }
+            }
+
+            //Apply mask if we need to
+            if (needs_mask)
+            {
+                //Get bitmap info for the mask this time
+                BITMAPINFO bmp_info = {0};
+                bmp_info.bmiHeader.biSize = sizeof(bmp_info.bmiHeader);
+                if (::GetDIBits(hdcMem, icon_info.hbmMask, 0, 0, nullptr, &bmp_info, DIB_RGB_COLORS) != 0)
+                {
+                    int mask_width  = bmp_info.bmiHeader.biWidth;
+                    int mask_height = abs(bmp_info.bmiHeader.biHeight);
+
+                    //Only continue if icon and mask are really the same size (can be different for monochrome bitmap formats, which are not supported here)
+                    if ( (icon_width == mask_width) && (icon_height == mask_height) )
+                    {
+                        auto PixelDataMask = std::unique_ptr<BYTE[]>{new BYTE[icon_pixel_count * 4]};
+
+                        bmp_info.bmiHeader.biSize        = sizeof(bmp_info.bmiHeader);
+                        bmp_info.bmiHeader.biBitCount    = 32;
+                        bmp_info.bmiHeader.biCompression = BI_RGB;
+                        bmp_info.bmiHeader.biHeight      = -abs(bmp_info.bmiHeader.biHeight); //Always use top-down order (negative height)
+
+                        //Read the mask bitmap buffer
+                        if (::GetDIBits(hdc, icon_info.hbmMask, 0, bmp_info.bmiHeader.biHeight, (LPVOID)PixelDataMask.get(), &bmp_info, DIB_RGB_COLORS) != 0)
+                        {
+                            //Apply mask to color pixel data
+                            psrc       = PixelData.get() + 3; //BGRA alpha pixel
+                            BYTE* pmsk = PixelDataMask.get(); //BGRA blue pixel (alpha channel is blank for the mask)
+                            for (; psrc < psrc_end; psrc += 4, pmsk += 4)
+                            {
+                                *psrc = ~(*pmsk);
+                            }
+                        }
+                    }
+                }
+            }
+
+            //Convert BGRA to RGBA for ImGui's texture atlas, in-place
+            for (psrc = PixelData.get(); psrc < psrc_end; psrc += 4)
+            {
+                std::swap(psrc[0], psrc[2]);
+            }
+
+            //Scale down if it doesn't fit, keeping the aspect ratio
+            if ( (icon_width > max_size) || (icon_height > max_size) )
+            {
+                const int scaled_width  = (std::max)((icon_width  * max_size) / (std::max)(icon_width, icon_height), 1);
+                const int scaled_height = (std::max)((icon_height * max_size) / (std::max)(icon_width, icon_height), 1);
+
+                auto PixelDataScaled = std::unique_ptr<BYTE[]>{new BYTE[(size_t)scaled_width * scaled_height * 4]};
+                ScaleDownRGBA(PixelData.get(), icon_width, icon_height, PixelDataScaled.get(), scaled_width, scaled_height);
+
+                PixelData   = std::move(PixelDataScaled);
+                icon_width  = scaled_width;
+                icon_height = scaled_height;
+            }
+
+            icon_data.Width     = icon_width;
+            icon_data.Height    = icon_height;
+            icon_data.PixelData = std::move(PixelData);
+        }
+    }
+
+    ::DeleteObject(icon_info.hbmColor);
+    ::DeleteObject(icon_info.hbmMask);
+
+    ::DeleteDC(hdcMem);
+    ::ReleaseDC(nullptr, hdc);
+
+    return (icon_data.PixelData != nullptr);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#define NOMINMAX
+#include <windows.h>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+//Pixel data of a window icon, as loaded by WindowIconLoader
+struct WindowIconData
+{
+    HWND WindowHandle = nullptr;
+    HICON IconHandle  = nullptr;        //Icon the data was loaded from
+    bool IsUnchanged  = false;          //Icon handle matched the known one passed with the request, no pixel data was loaded
+    int Width  = 0;
+    int Height = 0;
+    std::unique_ptr<BYTE[]> PixelData;  //RGBA, nullptr if loading failed
+};
+
+//Loads window icons on a worker thread
+//Getting a window's icon means sending it a message, which can take a while or not return at all for unresponsive applications
+//Converting the icon to pixel data isn't free either, so none of this is done on the UI thread. Icons larger than the maximum size are scaled down
+class WindowIconLoader
+{
+    private:
+        std::thread m_Thread;
+        std::mutex m_Mutex;
+        std::condition_variable m_ConditionVar;
+        std::deque<std::pair<HWND, HICON>> m_Requests;  //Window and known icon handle
+        std::vector<WindowIconData> m_Results;
+        int m_MaxSize;
+        bool m_DoQuit;
+
+        void ThreadMain();
+
+    public:
+        WindowIconLoader(int max_size);
+        ~WindowIconLoader();
+
+        //Starts the thread on first use. Requests for windows already waiting in the queue are ignored
+        //If the window's icon handle is still icon_handle_known, the result is flagged as unchanged and the icon isn't converted again
+        void RequestIcon(HWND window_handle, HICON icon_handle_known = nullptr);
+        bool PopResult(WindowIconData& icon_data);      //Returns false if there are no results waiting
+
+        //Converts icon to RGBA pixel data, scaled down to fit into max_size if needed. Can be called from any thread
+        static bool LoadIconData(HICON icon_handle, int max_size, WindowIconData& icon_data);
+};
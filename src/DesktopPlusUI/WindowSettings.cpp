@@ -1258,7 +1258,8 @@ void WindowSettings::UpdateCatOverlayTabCapture()
 
                     ImGui::SameLine(0.0f, 0.0f);
 
-                    int icon_id = TextureManager::Get().GetWindowIconCacheID(window.GetIcon());
+                    //Only lookup icon if it's gonna be visible, so long lists don't use up the icon cache
+                    int icon_id = (ImGui::IsRectVisible(img_size_line_height)) ? TextureManager::Get().GetWindowIconCacheID(window.WindowHandle) : -1;
 
                     if (icon_id != -1)
                     {
@@ -2565,6 +2566,14 @@ void WindowSettings::UpdateCatInput()
         ImGui::SameLine(0.0f, ImGui::GetStyle().ItemInnerSpacing.x);
         ImGui::FixedHelpMarker("Disables the laser pointer when the physical mouse is moved rapidly after the dashboard was opened with the HMD button.\nRe-open or click the overlay to get the laser pointer back.");
 
+        bool& pointer_smoothing = ConfigManager::Get().GetConfigBoolRef(configid_bool_input_mouse_laser_pointer_smoothing);
+        if (ImGui::Checkbox("Smooth Laser Pointer Movement", &pointer_smoothing))
+        {
+            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_bool_input_mouse_laser_pointer_smoothing), pointer_smoothing);
+        }
+        ImGui::SameLine(0.0f, ImGui::GetStyle().ItemInnerSpacing.x);
+        ImGui::FixedHelpMarker("Filters out small jitter of the laser pointer while keeping fast movements responsive");
+
         ImGui::NextColumn();
         ImGui::NextColumn();
 
@@ -2807,6 +2816,55 @@ void WindowSettings::UpdateCatPerformance()
         ImGui::Columns(1);
     }
 
+    //Graphics Capture
+    if (DPWinRT_IsCaptureSupported())
+    {
+        ImGui::TextColored(ImGui::GetStyleColorVec4(ImGuiCol_ButtonHovered), "Graphics Capture");
+
+        ImGui::Columns(2, "ColumnPerformanceGraphicsCapture", false);
+        ImGui::SetColumnWidth(0, column_width_0);
+
+        bool& skip_unchanged = ConfigManager::Get().GetConfigBoolRef(configid_bool_performance_winrt_skip_unchanged_frames);
+        if (ImGui::Checkbox("Skip Unchanged Frames", &skip_unchanged))
+        {
+            IPCManager::Get().PostMessageToDashboardApp(ipcmsg_set_config, ConfigManager::GetWParamForConfigID(configid_bool_performance_winrt_skip_unchanged_frames), skip_unchanged);
+        }
+        ImGui::SameLine(0.0f, ImGui::GetStyle().ItemInnerSpacing.x);
+        ImGui::FixedHelpMarker("Compare captured frames against the previous one and don't update the overlay when nothing changed.\nReduces GPU load for mostly static windows, but very small changes may occasionally be missed.");
+
+        ImGui::Columns(1);
+    }
+
+    //Interface (only rendered on demand in VR mode)
+    if (!UIManager::Get()->IsInDesktopMode())
+    {
+        ImGui::TextColored(ImGui::GetStyleColorVec4(ImGuiCol_ButtonHovered), "Interface");
+
+        ImGui::Columns(2, "ColumnPerformanceInterface", false);
+        ImGui::SetColumnWidth(0, column_width_0);
+
+        ImGui::Text("Frames Rendered");
+        ImGui::NextColumn();
+        ImGui::Text("%u per second", UIManager::Get()->GetFramesRenderedLastSecond());
+        ImGui::NextColumn();
+
+        ImGui::Text("Frames Skipped");
+        ImGui::NextColumn();
+        ImGui::Text("%u per second", UIManager::Get()->GetFramesSkippedLastSecond());
+        ImGui::NextColumn();
+
+        ImGui::Text("Render Spaces Updated");
+        ImGui::NextColumn();
+        ImGui::Text("%u per second", UIManager::Get()->GetTextureRegionUpdatesLastSecond());
+        ImGui::NextColumn();
+
+        ImGui::Text("Intersection Masks Sent");
+        ImGui::NextColumn();
+        ImGui::Text("%u per second (%u unchanged)", UIManager::Get()->GetIntersectionMaskSubmitsLastSecond(), UIManager::Get()->GetIntersectionMaskSkipsLastSecond());
+
+        ImGui::Columns(1);
+    }
+
     //Performance Monitor
     {
         ImGui::TextColored(ImGui::GetStyleColorVec4(ImGuiCol_ButtonHovered), "Performance Monitor");
@@ -3756,6 +3814,22 @@ void WindowSettings::ProfileSelector(bool multi_overlay)
                 delete_confirm_state = false;
             }
 
+            //Preview profile contents from the cached profile metadata
+            if (ImGui::IsItemHovered())
+            {
+                if (const OverlayProfileInfo* profile_info = ConfigManager::Get().GetOverlayProfileInfo(str, multi_overlay))
+                {
+                    if (multi_overlay)
+                    {
+                        ImGui::SetTooltip("%u overlay%s", profile_info->OverlayCount, (profile_info->OverlayCount != 1) ? "s" : "");
+                    }
+                    else if (!profile_info->OverlayName.empty())
+                    {
+                        ImGui::SetTooltip("%s", profile_info->OverlayName.c_str());
+                    }
+                }
+            }
+
             index++;
         }
         ImGui::EndCombo();
@@ -5816,17 +5890,7 @@ int WindowSettings::GetOverlayIcon(unsigned int overlay_id, TMNGRTexID& texture_
             {
                 if (data.ConfigIntPtr[configid_intptr_overlay_state_winrt_hwnd] != 0)
                 {
-                    //Find HWND in the capturable window list to use cached HICON if possible
-                    auto it = std::find_if(m_CaptureWindowList.begin(), m_CaptureWindowList.end(), 
-                                           [&](const auto& window) { return (window.WindowHandle == (HWND)data.ConfigIntPtr[configid_intptr_overlay_state_winrt_hwnd]); });
-
-                    if (it != m_CaptureWindowList.end())
-                    {
-                        return TextureManager::Get().GetWindowIconCacheID(it->GetIcon());
-                    }
-
-                    //If not get icon directly
-                    return TextureManager::Get().GetWindowIconCacheID(WindowInfo::GetIcon( (HWND)data.ConfigIntPtr[configid_intptr_overlay_state_winrt_hwnd] ));
+                    return TextureManager::Get().GetWindowIconCacheID((HWND)data.ConfigIntPtr[configid_intptr_overlay_state_winrt_hwnd]);
                 }
                 else if (data.ConfigInt[configid_int_overlay_winrt_desktop_id] != -2)
                 {
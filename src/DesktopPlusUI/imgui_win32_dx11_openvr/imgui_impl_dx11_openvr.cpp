@@ -97,6 +97,12 @@ static void ImGui_ImplDX11_SetupRenderState(ImDrawData* draw_data, ID3D11DeviceC
 // Render function
 // (this used to be set in io.RenderDrawListsFn and called by ImGui::Render(), but you can now call this directly from your main loop)
 void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
+{
+    ImGui_ImplDX11_RenderDrawDataClipped(draw_data, NULL, 0);
+}
+
+// Desktop+UI: Variant limiting all commands to the given clip rects, see header
+void ImGui_ImplDX11_RenderDrawDataClipped(ImDrawData* draw_data, const ImVec4* clip_rects, int clip_rect_count)
 {
     // Avoid rendering when minimized
     if (draw_data->DisplaySize.x <= 0.0f || draw_data->DisplaySize.y <= 0.0f)
@@ -244,14 +250,35 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
             }
             else
             {
-                // Apply scissor/clipping rectangle
-                const D3D11_RECT r = { (LONG)(pcmd->ClipRect.x - clip_off.x), (LONG)(pcmd->ClipRect.y - clip_off.y), (LONG)(pcmd->ClipRect.z - clip_off.x), (LONG)(pcmd->ClipRect.w - clip_off.y) };
-                ctx->RSSetScissorRects(1, &r);
-
-                // Bind texture, Draw
+                // Bind texture
                 ID3D11ShaderResourceView* texture_srv = (ID3D11ShaderResourceView*)pcmd->TextureId;
                 ctx->PSSetShaderResources(0, 1, &texture_srv);
-                ctx->DrawIndexed(pcmd->ElemCount, pcmd->IdxOffset + global_idx_offset, pcmd->VtxOffset + global_vtx_offset);
+
+                // Desktop+UI: Draw once per extra clip rect the command overlaps, or once as usual if there are none
+                const int draw_count = (clip_rect_count > 0) ? clip_rect_count : 1;
+                for (int clip_i = 0; clip_i < draw_count; clip_i++)
+                {
+                    ImVec4 clip_rect = pcmd->ClipRect;
+
+                    if (clip_rect_count > 0)
+                    {
+                        const ImVec4& clip_rect_extra = clip_rects[clip_i];
+                        if (clip_rect.x < clip_rect_extra.x) clip_rect.x = clip_rect_extra.x;
+                        if (clip_rect.y < clip_rect_extra.y) clip_rect.y = clip_rect_extra.y;
+                        if (clip_rect.z > clip_rect_extra.z) clip_rect.z = clip_rect_extra.z;
+                        if (clip_rect.w > clip_rect_extra.w) clip_rect.w = clip_rect_extra.w;
+
+                        if (clip_rect.x >= clip_rect.z || clip_rect.y >= clip_rect.w)
+                            continue;
+                    }
+
+                    // Apply scissor/clipping rectangle
+                    const D3D11_RECT r = { (LONG)(clip_rect.x - clip_off.x), (LONG)(clip_rect.y - clip_off.y), (LONG)(clip_rect.z - clip_off.x), (LONG)(clip_rect.w - clip_off.y) };
+                    ctx->RSSetScissorRects(1, &r);
+
+                    // Draw
+                    ctx->DrawIndexed(pcmd->ElemCount, pcmd->IdxOffset + global_idx_offset, pcmd->VtxOffset + global_vtx_offset);
+                }
             }
         }
         global_idx_offset += cmd_list->IdxBuffer.Size;
@@ -337,6 +364,35 @@ static void ImGui_ImplDX11_CreateFontsTexture()
     }
 }
 
+void    ImGui_ImplDX11_UpdateFontsTextureRegion(int x, int y, int width, int height)
+{
+    if (!g_pFontTextureView)
+        return;
+
+    // Not using GetTexDataAsRGBA32() as that would build the atlas if there's no data
+    ImGuiIO& io = ImGui::GetIO();
+    unsigned char* pixels = (unsigned char*)io.Fonts->TexPixelsRGBA32;
+    int tex_width  = io.Fonts->TexWidth;
+    int tex_height = io.Fonts->TexHeight;
+
+    if ( (pixels == NULL) || (x < 0) || (y < 0) || (width <= 0) || (height <= 0) || (x + width > tex_width) || (y + height > tex_height) )
+        return;
+
+    ID3D11Resource* pTexture = NULL;
+    g_pFontTextureView->GetResource(&pTexture);
+
+    D3D11_BOX box;
+    box.left   = x;
+    box.right  = x + width;
+    box.top    = y;
+    box.bottom = y + height;
+    box.front  = 0;
+    box.back   = 1;
+
+    g_pd3dDeviceContext->UpdateSubresource(pTexture, 0, &box, pixels + ((y * tex_width) + x) * 4, tex_width * 4, 0);
+    pTexture->Release();
+}
+
 bool    ImGui_ImplDX11_CreateDeviceObjects()
 {
     if (!g_pd3dDevice)
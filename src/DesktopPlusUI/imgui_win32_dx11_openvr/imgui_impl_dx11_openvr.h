@@ -21,7 +21,13 @@ IMGUI_IMPL_API bool     ImGui_ImplDX11_Init(ID3D11Device* device, ID3D11DeviceCo
 IMGUI_IMPL_API void     ImGui_ImplDX11_Shutdown();
 IMGUI_IMPL_API void     ImGui_ImplDX11_NewFrame();
 IMGUI_IMPL_API void     ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data);
+// Desktop+UI: Same as above, but every command is additionally clipped to each of the given rects (in display coordinates) and skipped where it doesn't overlap them
+//             Used to only redraw the parts of the render target which changed. With a clip_rect_count of 0 this is the same as ImGui_ImplDX11_RenderDrawData()
+IMGUI_IMPL_API void     ImGui_ImplDX11_RenderDrawDataClipped(ImDrawData* draw_data, const ImVec4* clip_rects, int clip_rect_count);
 
 // Use if you want to reset your rendering device without losing Dear ImGui state.
 IMGUI_IMPL_API void     ImGui_ImplDX11_InvalidateDeviceObjects();
 IMGUI_IMPL_API bool     ImGui_ImplDX11_CreateDeviceObjects();
+
+// Desktop+UI: Re-uploads a region of the font atlas texture from the atlas' RGBA32 pixel data, for changes made after building it
+IMGUI_IMPL_API void     ImGui_ImplDX11_UpdateFontsTextureRegion(int x, int y, int width, int height);
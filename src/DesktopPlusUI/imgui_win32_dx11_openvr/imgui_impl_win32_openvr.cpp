@@ -33,8 +33,10 @@ typedef DWORD (WINAPI *PFN_XInputGetCapabilities)(DWORD, DWORD, XINPUT_CAPABILIT
 typedef DWORD (WINAPI *PFN_XInputGetState)(DWORD, XINPUT_STATE*);
 #endif
 
+#include <algorithm>
 #include <queue>
 #include <vector>
+#include <string.h>
 
 // CHANGELOG (imgui_impl_win32)
 // (minor and older changes stripped away, please see git history for details)
@@ -87,6 +89,21 @@ static int                     g_OnScreenKeyboardQueueDelay = 0;
 static bool                    g_OnScreenKeyboardShown = false;
 static bool                    g_OnScreenKeyboardDismissedLastFrame = false;
 
+// Intersection mask primitives of the current frame, shared by all overlays getting their mask from the windows
+// Masks are only sent to the overlays when they differ from the last one submitted for it, which is kept per overlay to compare against
+// States are removed with ImGui_ImplOpenVR_RemoveIntersectionMaskState() or when OpenVR reports the overlay as unknown
+struct ImGui_ImplOpenVR_IntersectionMaskState
+{
+    vr::VROverlayHandle_t                                 OverlayHandle;
+    std::vector<vr::VROverlayIntersectionMaskPrimitive_t> Primitives;         // Last submitted
+    bool                                                  IsSubmitted;        // false if nothing was submitted yet or the last submit failed
+};
+static std::vector<vr::VROverlayIntersectionMaskPrimitive_t> g_IntersectionMaskPrimitives;
+static int                                                   g_IntersectionMaskPrimitivesFrame = -1;
+static std::vector<ImGui_ImplOpenVR_IntersectionMaskState>  g_IntersectionMaskStates;
+static unsigned int                                          g_IntersectionMaskSubmitCount = 0;
+static unsigned int                                          g_IntersectionMaskSkipCount = 0;
+
 // Functions
 bool    ImGui_ImplWin32_Init(void* hwnd)
 {
@@ -710,31 +727,89 @@ IMGUI_IMPL_API void ImGui_ImplOpenVR_InputOnVRKeyboardClosed()
 
 IMGUI_IMPL_API void ImGui_ImplOpenVR_SetIntersectionMaskFromWindows(vr::VROverlayHandle_t overlay_handle)
 {
-    ImGuiContext& g = *ImGui::GetCurrentContext();
+    if (overlay_handle == vr::k_ulOverlayHandleInvalid)
+        return;
 
-    std::vector<vr::VROverlayIntersectionMaskPrimitive_t> primitives;
-    primitives.reserve(g.Windows.Size); //Avoid resizing in the loop
+    ImGuiContext& g = *ImGui::GetCurrentContext();
 
-    for (int n = 0; n < g.Windows.Size; n++)
+    //Primitives are the same for every overlay, so only collect them once per frame. The buffer is kept around to not allocate each time
+    if (g_IntersectionMaskPrimitivesFrame != g.FrameCount)
     {
-        ImGuiWindow* window = g.Windows[n];
-        if (!window->WasActive)
-            continue;
+        g_IntersectionMaskPrimitives.clear();
 
-        if (!(window->Flags & ImGuiWindowFlags_ChildWindow))
+        for (int n = 0; n < g.Windows.Size; n++)
         {
-            vr::VROverlayIntersectionMaskPrimitive_t primitive;
-            primitive.m_nPrimitiveType = vr::OverlayIntersectionPrimitiveType_Rectangle;
-            primitive.m_Primitive.m_Rectangle.m_flTopLeftX = window->OuterRectClipped.GetTL().x;
-            primitive.m_Primitive.m_Rectangle.m_flTopLeftY = window->OuterRectClipped.GetTL().y;
-            primitive.m_Primitive.m_Rectangle.m_flWidth    = window->OuterRectClipped.GetWidth();
-            primitive.m_Primitive.m_Rectangle.m_flHeight   = window->OuterRectClipped.GetHeight();
-
-            primitives.push_back(primitive);
+            ImGuiWindow* window = g.Windows[n];
+            if (!window->WasActive)
+                continue;
+
+            if (!(window->Flags & ImGuiWindowFlags_ChildWindow))
+            {
+                vr::VROverlayIntersectionMaskPrimitive_t primitive;
+                primitive.m_nPrimitiveType = vr::OverlayIntersectionPrimitiveType_Rectangle;
+                primitive.m_Primitive.m_Rectangle.m_flTopLeftX = window->OuterRectClipped.GetTL().x;
+                primitive.m_Primitive.m_Rectangle.m_flTopLeftY = window->OuterRectClipped.GetTL().y;
+                primitive.m_Primitive.m_Rectangle.m_flWidth    = window->OuterRectClipped.GetWidth();
+                primitive.m_Primitive.m_Rectangle.m_flHeight   = window->OuterRectClipped.GetHeight();
+
+                g_IntersectionMaskPrimitives.push_back(primitive);
+            }
         }
+
+        g_IntersectionMaskPrimitivesFrame = g.FrameCount;
     }
 
-    vr::VROverlay()->SetOverlayIntersectionMask(overlay_handle, primitives.data(), (uint32_t)primitives.size());
+    ImGui_ImplOpenVR_IntersectionMaskState* state = NULL;
+    for (ImGui_ImplOpenVR_IntersectionMaskState& state_it : g_IntersectionMaskStates)
+    {
+        if (state_it.OverlayHandle == overlay_handle)
+        {
+            state = &state_it;
+            break;
+        }
+    }
+
+    if (state == NULL)
+    {
+        g_IntersectionMaskStates.push_back({overlay_handle, {}, false});
+        state = &g_IntersectionMaskStates.back();
+    }
+    else if ( (state->IsSubmitted) && (state->Primitives.size() == g_IntersectionMaskPrimitives.size()) &&
+              ( (g_IntersectionMaskPrimitives.empty()) ||
+                (memcmp(state->Primitives.data(), g_IntersectionMaskPrimitives.data(), g_IntersectionMaskPrimitives.size() * sizeof(vr::VROverlayIntersectionMaskPrimitive_t)) == 0) ) )
+    {
+        //Rectangles fill the whole primitive union, so there's no uninitialized data in there to throw off the comparison
+        g_IntersectionMaskSkipCount++;
+        return;
+    }
+
+    //Try again next time if it failed
+    vr::EVROverlayError overlay_error = vr::VROverlay()->SetOverlayIntersectionMask(overlay_handle, g_IntersectionMaskPrimitives.data(), (uint32_t)g_IntersectionMaskPrimitives.size());
+    state->IsSubmitted = (overlay_error == vr::VROverlayError_None);
+
+    if (state->IsSubmitted)
+    {
+        state->Primitives = g_IntersectionMaskPrimitives;   //Assigning reuses the state's buffer once it's large enough
+    }
+    else if (overlay_error == vr::VROverlayError_UnknownOverlay) //Overlay is gone, don't keep its state around
+    {
+        ImGui_ImplOpenVR_RemoveIntersectionMaskState(overlay_handle);
+    }
+
+    g_IntersectionMaskSubmitCount++;
+}
+
+IMGUI_IMPL_API void ImGui_ImplOpenVR_RemoveIntersectionMaskState(vr::VROverlayHandle_t overlay_handle)
+{
+    g_IntersectionMaskStates.erase(std::remove_if(g_IntersectionMaskStates.begin(), g_IntersectionMaskStates.end(),
+                                                  [&](const ImGui_ImplOpenVR_IntersectionMaskState& state){ return (state.OverlayHandle == overlay_handle); }),
+                                   g_IntersectionMaskStates.end());
+}
+
+IMGUI_IMPL_API void ImGui_ImplOpenVR_GetIntersectionMaskCounts(unsigned int* submit_count, unsigned int* skip_count)
+{
+    *submit_count = g_IntersectionMaskSubmitCount;
+    *skip_count   = g_IntersectionMaskSkipCount;
 }
 
 void ImGui_ImplOpenVR_AddInputFromOSK(const char* input)
@@ -69,4 +69,11 @@ IMGUI_IMPL_API void ImGui_ImplOpenVR_InputOnVRKeyboardClosed();
 IMGUI_IMPL_API void ImGui_ImplOpenVR_AddInputFromOSK(const char* input);
 
 // Set overlay intersection mask from current top-level window outer rects
+// The mask is only sent to the overlay if it differs from the last one sent to it, so this is cheap to call every frame
 IMGUI_IMPL_API void ImGui_ImplOpenVR_SetIntersectionMaskFromWindows(vr::VROverlayHandle_t overlay_handle);
+
+// Forget the last intersection mask sent to the overlay. Call when destroying it, as overlay handles may get reused afterwards
+IMGUI_IMPL_API void ImGui_ImplOpenVR_RemoveIntersectionMaskState(vr::VROverlayHandle_t overlay_handle);
+
+// Total number of intersection masks sent to OpenVR and skipped due to being unchanged by ImGui_ImplOpenVR_SetIntersectionMaskFromWindows()
+IMGUI_IMPL_API void ImGui_ImplOpenVR_GetIntersectionMaskCounts(unsigned int* submit_count, unsigned int* skip_count);
@@ -18,6 +18,7 @@ namespace winrt
     using namespace Windows::UI::Popups;
     using namespace Windows::Graphics::Capture;
     using namespace Windows::Graphics::DirectX;
+    using namespace Windows::Graphics::DirectX::Direct3D11;
 }
 
 namespace util
@@ -25,12 +26,19 @@ namespace util
     using namespace desktop;
 }
 
-CaptureManager::CaptureManager(DPWinRTThreadData& thread_data, DWORD global_main_thread_id) : m_ThreadData(thread_data)
+//Set by the main thread, read by capture threads
+static std::atomic<DPWinRTWindowTitleLookupFunc> g_WindowTitleLookup;
+
+CaptureManager::CaptureManager(DPWinRTCaptureData& capture_data, DWORD global_main_thread_id, winrt::IDirect3DDevice const& device) : m_CaptureData(capture_data)
 {
     m_CaptureMainThread = winrt::DispatcherQueue::GetForCurrentThread();
     m_GlobalMainThreadID = global_main_thread_id;
+    m_Device = device;
     WINRT_VERIFY(m_CaptureMainThread != nullptr);
+}
 
+winrt::IDirect3DDevice CaptureManager::CreateDevice()
+{
     //Get the adapter recommended by OpenVR
     winrt::com_ptr<ID3D11Device> d3d_device;
     winrt::com_ptr<IDXGIFactory1> factory_ptr;
@@ -73,7 +81,7 @@ CaptureManager::CaptureManager(DPWinRTThreadData& thread_data, DWORD global_main
 
     //Get it as WinRT D3D11 device
     auto dxgi_device = d3d_device.try_as<IDXGIDevice>();
-    m_Device = CreateDirect3DDevice(dxgi_device.get());
+    return CreateDirect3DDevice(dxgi_device.get());
 }
 
 winrt::GraphicsCaptureItem CaptureManager::StartCaptureFromWindowHandle(HWND hwnd)
@@ -118,16 +126,16 @@ winrt::IAsyncOperation<winrt::GraphicsCaptureItem> CaptureManager::StartCaptureW
 
         if (window_handle != nullptr)
         {
-            m_ThreadData.SourceWindow = window_handle;
+            m_CaptureData.SourceWindow = window_handle;
 
-            for (const auto& overlay : m_ThreadData.Overlays)
+            for (const auto& overlay : m_CaptureData.Overlays)
             {
                 ::PostThreadMessage(m_GlobalMainThreadID, WM_DPLUSWINRT_SET_HWND, overlay.Handle, (LPARAM)window_handle);
             }
         }
         else if (desktop_id != -2)
         {
-            for (const auto& overlay : m_ThreadData.Overlays)
+            for (const auto& overlay : m_CaptureData.Overlays)
             {
                 ::PostThreadMessage(m_GlobalMainThreadID, WM_DPLUSWINRT_SET_DESKTOP, overlay.Handle, desktop_id);
             }
@@ -138,7 +146,7 @@ winrt::IAsyncOperation<winrt::GraphicsCaptureItem> CaptureManager::StartCaptureW
     else //Picker was canceled, send status updates for overlays
     {
         co_await m_CaptureMainThread;
-        for (const auto& overlay : m_ThreadData.Overlays)
+        for (const auto& overlay : m_CaptureData.Overlays)
         {
             ::PostThreadMessage(m_GlobalMainThreadID, WM_DPLUSWINRT_CAPTURE_LOST, overlay.Handle, 0);
         }
@@ -149,14 +157,15 @@ winrt::IAsyncOperation<winrt::GraphicsCaptureItem> CaptureManager::StartCaptureW
 
 void CaptureManager::StartCaptureFromItem(winrt::GraphicsCaptureItem item)
 {
-    m_Capture = std::make_unique<OverlayCapture>(m_Device, item, m_PixelFormat, m_GlobalMainThreadID, m_ThreadData.Overlays, m_ThreadData.SourceWindow);
+    m_Capture = std::make_unique<OverlayCapture>(m_Device, item, m_PixelFormat, m_GlobalMainThreadID, m_CaptureData.Overlays, m_CaptureData.SourceWindow);
+    m_Capture->IsChangeDetectionEnabled(m_ChangeDetectionEnabled);
 
     m_Capture->StartCapture();
     m_ItemClosedRevoker = item.Closed(winrt::auto_revoke, { this, &CaptureManager::OnCaptureItemClosed });
 
     //Check if all overlays of this capture are already paused and pause the capture as well then
     bool all_paused = true;
-    for (DPWinRTOverlayData& overlay_data : m_ThreadData.Overlays)
+    for (DPWinRTOverlayData& overlay_data : m_CaptureData.Overlays)
     {
         if (!overlay_data.IsPaused)
         {
@@ -176,7 +185,7 @@ void CaptureManager::OnCaptureItemClosed(winrt::GraphicsCaptureItem const&, winr
     StopCapture();
 
     //Send overlay status updates
-    for (const auto& overlay : m_ThreadData.Overlays)
+    for (const auto& overlay : m_CaptureData.Overlays)
     {
         ::PostThreadMessage(m_GlobalMainThreadID, WM_DPLUSWINRT_CAPTURE_LOST, overlay.Handle, 0);
     }
@@ -199,6 +208,17 @@ void CaptureManager::IsCursorEnabled(bool value)
     }
 }
 
+void CaptureManager::IsChangeDetectionEnabled(bool value)
+{
+    //Kept here as well since the capture may not have started yet (picker) or gets recreated
+    m_ChangeDetectionEnabled = value;
+
+    if (m_Capture != nullptr)
+    {
+        m_Capture->IsChangeDetectionEnabled(value);
+    }
+}
+
 bool CaptureManager::IsCapturePaused()
 {
     return ( (m_Capture) && (m_Capture->IsPaused()) );
@@ -228,21 +248,27 @@ void CaptureManager::StopCapture()
     }
 }
 
+void CaptureManager::SetWindowTitleLookup(DPWinRTWindowTitleLookupFunc lookup_func)
+{
+    g_WindowTitleLookup = lookup_func;
+}
+
 HWND CaptureManager::FindWindowFromCaptureItem(winrt::Windows::Graphics::Capture::GraphicsCaptureItem item, int& desktop_id)
 {
     //This is a guess that will only return the first match of a window title, so conflicts are possible
-    std::vector<WindowInfo> window_list = WindowInfo::CreateCapturableWindowList();
-
-    auto it = std::find_if(window_list.begin(), window_list.end(), [&](const auto& info){ return (info.Title == item.DisplayName()); });
+    //The caller's lookup goes through its WindowRegistry. This DLL has a registry of its own, but nothing is feeding it, so that would enumerate all windows
+    const DPWinRTWindowTitleLookupFunc lookup_func = g_WindowTitleLookup;
+    const winrt::hstring display_name = item.DisplayName();
+    HWND window_handle = (lookup_func != nullptr) ? lookup_func(display_name.c_str()) : WindowInfo::FindWindowWithTitle(display_name.c_str());
 
-    if (it != window_list.end())
+    if (window_handle != nullptr)
     {
-        return it->WindowHandle;
+        return window_handle;
     }
 
     //Not a window from our list, so assume desktop
     //However, the title is localized so we guess the desktop assuming the string ends with the desktop number, which is probably wrong for some languages, but this is just a fallback so whatever
-    std::string displayname_utf8 = winrt::to_string(item.DisplayName());
+    std::string displayname_utf8 = winrt::to_string(display_name);
     size_t pos = displayname_utf8.find_last_of(' ');
 
     if ( (pos != std::string::npos) && (pos != displayname_utf8.length()) )
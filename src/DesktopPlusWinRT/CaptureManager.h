@@ -4,9 +4,13 @@
 class CaptureManager
 {
     public:
-        CaptureManager(DPWinRTThreadData& thread_data, DWORD global_main_thread_id);
+        CaptureManager(DPWinRTCaptureData& capture_data, DWORD global_main_thread_id, winrt::Windows::Graphics::DirectX::Direct3D11::IDirect3DDevice const& device);
         ~CaptureManager() {}
 
+        //Creates a device on the adapter used by OpenVR. One is shared by all captures of a worker thread
+        static winrt::Windows::Graphics::DirectX::Direct3D11::IDirect3DDevice CreateDevice();
+        static void SetWindowTitleLookup(DPWinRTWindowTitleLookupFunc lookup_func);
+
         winrt::Windows::Graphics::Capture::GraphicsCaptureItem StartCaptureFromWindowHandle(HWND hwnd);
         winrt::Windows::Graphics::Capture::GraphicsCaptureItem StartCaptureFromMonitorHandle(HMONITOR hmon);
         winrt::Windows::Foundation::IAsyncOperation<winrt::Windows::Graphics::Capture::GraphicsCaptureItem> StartCaptureWithPickerAsync();
@@ -15,6 +19,7 @@ class CaptureManager
 
         bool IsCursorEnabled();
         void IsCursorEnabled(bool value);
+        void IsChangeDetectionEnabled(bool value);
         bool IsCapturePaused();
 
         void OnOverlayDataRefresh();
@@ -34,7 +39,8 @@ class CaptureManager
         std::unique_ptr<OverlayCapture> m_Capture { nullptr };
         winrt::Windows::Graphics::Capture::GraphicsCaptureItem::Closed_revoker m_ItemClosedRevoker;
         winrt::Windows::Graphics::DirectX::DirectXPixelFormat m_PixelFormat = winrt::Windows::Graphics::DirectX::DirectXPixelFormat::B8G8R8A8UIntNormalized;
+        bool m_ChangeDetectionEnabled = false;
 
-        DPWinRTThreadData& m_ThreadData;
+        DPWinRTCaptureData& m_CaptureData;
         DWORD m_GlobalMainThreadID;
 };
\ No newline at end of file
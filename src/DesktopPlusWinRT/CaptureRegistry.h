@@ -0,0 +1,179 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "openvr.h"
+
+//Capture worker thread as tracked by CaptureRegistry. Any number of captures can be hosted on one
+struct CaptureWorkerData
+{
+    void* ThreadHandle = nullptr;       //Platform handle, only used by the CaptureWorkerHost
+    unsigned long ThreadID = 0;         //Same type as DWORD
+    unsigned int CaptureCount = 0;
+};
+
+//Starts and quits the worker threads for CaptureRegistry
+class CaptureWorkerHost
+{
+    public:
+        virtual ~CaptureWorkerHost() = default;
+
+        //Starts a worker thread and fills in ThreadHandle and ThreadID. Returns false if it couldn't be started
+        virtual bool StartWorker(CaptureWorkerData& worker) = 0;
+        //Tells the worker thread to quit once it's done with the messages already sent to it and releases its handle
+        virtual void QuitWorker(const CaptureWorkerData& worker) = 0;
+};
+
+//Book-keeping of captures and the worker threads hosting them, kept free of WinRT and Windows headers
+//CaptureDataT needs the members CaptureID, ThreadID and Overlays, the latter being a vector of a type with a Handle member (see DPWinRTCaptureData)
+//Not thread-safe, callers have to synchronize access
+template<typename CaptureDataT>
+class CaptureRegistry
+{
+    public:
+        typedef typename decltype(CaptureDataT::Overlays)::value_type OverlayDataT;
+
+    private:
+        std::unique_ptr<CaptureWorkerHost> m_Host;
+        unsigned int m_WorkerCountMax;
+        unsigned int m_CaptureIDNext;
+        std::vector<CaptureDataT> m_Captures;
+        std::vector<CaptureWorkerData> m_Workers;
+
+        //Returns the worker thread a new capture should be hosted on. Starts a new one while below the limit, otherwise picks the least busy one
+        CaptureWorkerData* AcquireWorker()
+        {
+            auto it = std::min_element(m_Workers.begin(), m_Workers.end(), [](const auto& a, const auto& b){ return (a.CaptureCount < b.CaptureCount); });
+
+            if ( (it == m_Workers.end()) || ( (it->CaptureCount != 0) && (m_Workers.size() < m_WorkerCountMax) ) )
+            {
+                CaptureWorkerData worker;
+
+                if (m_Host->StartWorker(worker))
+                {
+                    m_Workers.push_back(worker);
+                    it = m_Workers.end() - 1;
+                }
+                else if (it == m_Workers.end()) //Couldn't start a thread and there's no other one to fall back to
+                {
+                    return nullptr;
+                }
+            }
+
+            it->CaptureCount++;
+            return &*it;
+        }
+
+        //Counterpart to AcquireWorker(). Quits the worker thread when no captures are left on it
+        void ReleaseWorker(unsigned long thread_id)
+        {
+            auto it = std::find_if(m_Workers.begin(), m_Workers.end(), [&](const auto& worker){ return (worker.ThreadID == thread_id); });
+
+            if (it == m_Workers.end())
+                return;
+
+            if (--it->CaptureCount == 0)
+            {
+                m_Host->QuitWorker(*it);
+                m_Workers.erase(it);
+            }
+        }
+
+    public:
+        CaptureRegistry(std::unique_ptr<CaptureWorkerHost> host, unsigned int worker_count_max = 1) :
+            m_Host(std::move(host)),
+            m_WorkerCountMax(worker_count_max),
+            m_CaptureIDNext(1)
+        {
+        }
+
+        CaptureRegistry(const CaptureRegistry&) = delete;
+        CaptureRegistry& operator=(const CaptureRegistry&) = delete;
+
+        void SetWorkerCountMax(unsigned int worker_count_max)
+        {
+            m_WorkerCountMax = std::max(worker_count_max, 1u);
+        }
+
+        //Adds a copy of data as new capture, assigning it an ID and a worker thread. Returns nullptr if there's no worker thread to host it
+        //The returned pointer is only valid until the next capture is added or removed
+        CaptureDataT* AddCapture(const CaptureDataT& data)
+        {
+            const CaptureWorkerData* worker = AcquireWorker();
+
+            if (worker == nullptr)
+                return nullptr;
+
+            m_Captures.push_back(data);
+            CaptureDataT& capture = m_Captures.back();
+            capture.CaptureID = m_CaptureIDNext++;
+            capture.ThreadID  = worker->ThreadID;
+
+            return &capture;
+        }
+
+        //Removes the capture and releases its worker thread
+        void RemoveCapture(unsigned int capture_id)
+        {
+            auto it = std::find_if(m_Captures.begin(), m_Captures.end(), [&](const auto& capture){ return (capture.CaptureID == capture_id); });
+
+            if (it == m_Captures.end())
+                return;
+
+            ReleaseWorker(it->ThreadID);
+            m_Captures.erase(it);
+        }
+
+        //Returns nullptr if there's no capture with the ID (i.e. it was already removed)
+        CaptureDataT* FindCapture(unsigned int capture_id)
+        {
+            auto it = std::find_if(m_Captures.begin(), m_Captures.end(), [&](const auto& capture){ return (capture.CaptureID == capture_id); });
+
+            return (it != m_Captures.end()) ? &*it : nullptr;
+        }
+
+        //Returns the overlay data for the overlay handle and sets capture to the capture it belongs to. Both are nullptr if the overlay isn't used by any capture
+        OverlayDataT* FindOverlay(vr::VROverlayHandle_t overlay_handle, CaptureDataT*& capture)
+        {
+            for (auto& capture_data : m_Captures)
+            {
+                auto it = std::find_if(capture_data.Overlays.begin(), capture_data.Overlays.end(), [&](const auto& data){ return (data.Handle == overlay_handle); });
+
+                if (it != capture_data.Overlays.end())
+                {
+                    capture = &capture_data;
+                    return &*it;
+                }
+            }
+
+            capture = nullptr;
+            return nullptr;
+        }
+
+        //Removes the overlay from its capture and returns the capture, or nullptr if the overlay isn't used by any capture
+        //The capture is kept even if it has no overlays left, call RemoveCapture() after stopping it
+        CaptureDataT* RemoveOverlay(vr::VROverlayHandle_t overlay_handle)
+        {
+            CaptureDataT* capture = nullptr;
+            const OverlayDataT* overlay_data = FindOverlay(overlay_handle, capture);
+
+            if (overlay_data != nullptr)
+            {
+                capture->Overlays.erase(capture->Overlays.begin() + (overlay_data - capture->Overlays.data()));
+            }
+
+            return capture;
+        }
+
+        std::vector<CaptureDataT>& GetCaptures()
+        {
+            return m_Captures;
+        }
+
+        const std::vector<CaptureWorkerData>& GetWorkers() const
+        {
+            return m_Workers;
+        }
+};
@@ -5,6 +5,7 @@
 #pragma comment (lib, "windowsapp.lib")
 
 #include <mutex>
+#include <thread>
 #include <utility>
 #include <limits.h>
 
@@ -13,6 +14,7 @@
 #include "PickerDummyWindow.h"
 
 #include "ThreadData.h"
+#include "CaptureRegistry.h"
 
 #include "Util.h"
 
@@ -25,11 +27,14 @@ static bool g_IsCaptureSupported;
 static int  g_APIContractPresent;
 
 //- Protected by g_ThreadsMutex
+//  Worker threads only take the mutex once to copy a capture when it starts, so nothing references the registry's captures.
+//  Later overlay data changes reach them through the capture's OverlaySnapshot instead
+//  g_CaptureRegistry is defined further below, after the worker host it's using
 static std::mutex g_ThreadsMutex;
-static std::vector<DPWinRTThreadData> g_Threads;
 
 //- Only accessed by main thread
 static bool g_IsCursorEnabled;
+static bool g_IsChangeDetectionEnabled;
 
 //- Rarely accessed atomics
 static std::atomic<bool> g_DesktopEnumFlagIgnoreWMRScreens;
@@ -39,6 +44,7 @@ namespace winrt
     using namespace Windows::Foundation;
     using namespace Windows::Foundation::Metadata;
     using namespace Windows::Graphics::Capture;
+    using namespace Windows::Graphics::DirectX::Direct3D11;
 }
 
 namespace util
@@ -65,9 +71,61 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD  ul_reason_for_call, LPVOID lpReser
 
 DWORD WINAPI WinRTCaptureThreadEntry(_In_ void* Param);
 
-bool DPWinRT_Internal_StartCapture(vr::VROverlayHandle_t overlay_handle, const DPWinRTThreadData& data)
+//Starts and quits the capture worker threads for g_CaptureRegistry. Called with g_ThreadsMutex held
+class DPWinRTWorkerHost : public CaptureWorkerHost
 {
-    //Make sure this overlay handle is not already used by a thread
+    public:
+        bool StartWorker(CaptureWorkerData& worker) override
+        {
+            //Wait for the thread to have its message queue set up, as messages posted before that are lost
+            HANDLE ready_event = ::CreateEvent(nullptr, TRUE, FALSE, nullptr);
+            worker.ThreadHandle = ::CreateThread(nullptr, 0, WinRTCaptureThreadEntry, ready_event, 0, &worker.ThreadID);
+
+            if (worker.ThreadHandle != nullptr)
+            {
+                ::WaitForSingleObject(ready_event, INFINITE);
+            }
+
+            ::CloseHandle(ready_event);
+
+            if (worker.ThreadHandle == nullptr)
+                return false;
+
+            //If the cursor is disabled, send a message to disable it right away (non-default state)
+            if (!g_IsCursorEnabled)
+            {
+                ::PostThreadMessage(worker.ThreadID, WM_DPLUSWINRT_ENABLE_CURSOR, g_IsCursorEnabled, 0);
+            }
+
+            if (g_IsChangeDetectionEnabled)
+            {
+                ::PostThreadMessage(worker.ThreadID, WM_DPLUSWINRT_ENABLE_CHANGE_DETECTION, g_IsChangeDetectionEnabled, 0);
+            }
+
+            return true;
+        }
+
+        void QuitWorker(const CaptureWorkerData& worker) override
+        {
+            ::PostThreadMessage(worker.ThreadID, WM_DPLUSWINRT_THREAD_QUIT, 0, 0);
+            ::CloseHandle(worker.ThreadHandle);
+        }
+};
+
+//- Protected by g_ThreadsMutex
+static CaptureRegistry<DPWinRTCaptureData> g_CaptureRegistry(std::make_unique<DPWinRTWorkerHost>());
+
+//Publishes the capture's overlay data to its worker thread and tells it to pick it up. Doesn't wait on the worker
+//g_ThreadsMutex needs to be held
+void DPWinRT_Internal_PublishOverlayData(DPWinRTCaptureData& capture)
+{
+    capture.OverlaySnapshot->Publish(capture.Overlays);
+    ::PostThreadMessage(capture.ThreadID, WM_DPLUSWINRT_UPDATE_DATA, capture.CaptureID, 0);
+}
+
+bool DPWinRT_Internal_StartCapture(vr::VROverlayHandle_t overlay_handle, const DPWinRTCaptureData& data)
+{
+    //Make sure this overlay handle is not already used by a capture
     DPWinRT_StopCapture(overlay_handle);
 
     std::lock_guard<std::mutex> lock(g_ThreadsMutex);
@@ -75,33 +133,33 @@ bool DPWinRT_Internal_StartCapture(vr::VROverlayHandle_t overlay_handle, const D
     DPWinRTOverlayData overlay_data;
     overlay_data.Handle = overlay_handle;
 
-    //If not using picker, try to find a thread already capturing this item
+    //If not using picker, try to find an existing capture of this item
     if (!data.UsePicker)
     {
-        for (auto& thread : g_Threads)
+        for (auto& capture : g_CaptureRegistry.GetCaptures())
         {
-            if ( (thread.DesktopID == data.DesktopID) && (thread.SourceWindow == data.SourceWindow) )
+            if ( (capture.DesktopID == data.DesktopID) && (capture.SourceWindow == data.SourceWindow) )
             {
-                thread.Overlays.push_back(overlay_data);
+                capture.Overlays.push_back(overlay_data);
                 
-                ::PostThreadMessage(thread.ThreadID, WM_DPLUSWINRT_UPDATE_DATA, 0, 0);
+                DPWinRT_Internal_PublishOverlayData(capture);
                 return true;
             }
         }
     }
 
-    //Create new thread if no existing one was found or using picker
-    g_Threads.push_back(data);
-    g_Threads.back().Overlays.push_back(overlay_data);
+    //Create new capture if no existing one was found or using picker and hand it to a worker thread
+    DPWinRTCaptureData* capture_new = g_CaptureRegistry.AddCapture(data);
 
-    //Thread may run before CreateThread() returns, but the thread will have to wait on the mutex so it's fine
-    g_Threads.back().ThreadHandle = ::CreateThread(nullptr, 0, WinRTCaptureThreadEntry, &g_Threads.back(), 0, &g_Threads.back().ThreadID);
+    if (capture_new == nullptr)
+        return false;
 
-    //If the cursor is disabled, send a message to disable it right away (non-default state)
-    if (!g_IsCursorEnabled)
-    {
-        ::PostThreadMessage(g_Threads.back().ThreadID, WM_DPLUSWINRT_ENABLE_CURSOR, g_IsCursorEnabled, 0);
-    }
+    DPWinRTCaptureData& capture = *capture_new;
+    capture.Overlays.push_back(overlay_data);
+    capture.OverlaySnapshot = std::make_shared<DPWinRTOverlaySnapshot>();
+    capture.OverlaySnapshot->Publish(capture.Overlays);
+
+    ::PostThreadMessage(capture.ThreadID, WM_DPLUSWINRT_CAPTURE_START, capture.CaptureID, 0);
 
     return true;
 }
@@ -113,9 +171,8 @@ void DPWinRT_Init()
     #ifndef DPLUSWINRT_STUB
 
     g_MainThreadID = ::GetCurrentThreadId();
-    //Reserve thread data vector size to avoid potential race condition between resize and thread creation when many overlays are created back-to-back (while also avoiding explicit syncing there).
-    //100 should be pretty safe as a limit, considering k_unMaxOverlayCount (128) with system overlays and Desktop+ UI overlays... also 100 captures are insane either way
-    g_Threads.reserve(100);
+    //Captures mostly wait on the GPU and Graphics Capture, so half the logical cores is plenty. Captures beyond that share threads
+    g_CaptureRegistry.SetWorkerCountMax(clamp(std::thread::hardware_concurrency() / 2, 1u, 8u));
 
     //Init results of capability query functions so we don't need an apartment on the main thread
     winrt::init_apartment(winrt::apartment_type::multi_threaded);
@@ -152,6 +209,7 @@ void DPWinRT_Init()
     winrt::uninit_apartment();
 
     g_IsCursorEnabled = true;
+    g_IsChangeDetectionEnabled = false;
     g_DesktopEnumFlagIgnoreWMRScreens = true;
 
     #endif
@@ -196,7 +254,7 @@ bool DPWinRT_IsCaptureCursorEnabledPropertySupported()
 bool DPWinRT_StartCaptureFromPicker(vr::VROverlayHandle_t overlay_handle)
 {
     #ifndef DPLUSWINRT_STUB
-        DPWinRTThreadData data;
+        DPWinRTCaptureData data;
         data.UsePicker = true;
 
         return DPWinRT_Internal_StartCapture(overlay_handle, data);
@@ -208,7 +266,7 @@ bool DPWinRT_StartCaptureFromPicker(vr::VROverlayHandle_t overlay_handle)
 bool DPWinRT_StartCaptureFromHWND(vr::VROverlayHandle_t overlay_handle, HWND handle)
 {
     #ifndef DPLUSWINRT_STUB
-        DPWinRTThreadData data;
+        DPWinRTCaptureData data;
         data.SourceWindow = handle;
 
         return DPWinRT_Internal_StartCapture(overlay_handle, data);
@@ -220,7 +278,7 @@ bool DPWinRT_StartCaptureFromHWND(vr::VROverlayHandle_t overlay_handle, HWND han
 bool DPWinRT_StartCaptureFromDesktop(vr::VROverlayHandle_t overlay_handle, int desktop_id)
 {
     #ifndef DPLUSWINRT_STUB
-        DPWinRTThreadData data;
+        DPWinRTCaptureData data;
         data.DesktopID = desktop_id;
 
         return DPWinRT_Internal_StartCapture(overlay_handle, data);
@@ -235,22 +293,20 @@ bool DPWinRT_StartCaptureFromOverlay(vr::VROverlayHandle_t overlay_handle, vr::V
 
     std::lock_guard<std::mutex> lock(g_ThreadsMutex);
 
-    //Find thread with the source overlay assigned and add the other overlay to it with duplicated state
+    //Find capture with the source overlay assigned and add the other overlay to it with duplicated state
     //This means this function is only good for adding capture after an overlay was duplicated, otherwise some state needs to be adjusted right after
-    for (auto& thread : g_Threads)
-    {
-        auto it = std::find_if(thread.Overlays.begin(), thread.Overlays.end(), [&](const auto& data){ return (data.Handle == overlay_handle_source); });
+    DPWinRTCaptureData* capture = nullptr;
+    const DPWinRTOverlayData* overlay_data_source = g_CaptureRegistry.FindOverlay(overlay_handle_source, capture);
 
-        if (it != thread.Overlays.end())
-        {
-            DPWinRTOverlayData overlay_data = *it;
-            overlay_data.Handle = overlay_handle;
+    if (overlay_data_source != nullptr)
+    {
+        DPWinRTOverlayData overlay_data = *overlay_data_source;
+        overlay_data.Handle = overlay_handle;
 
-            thread.Overlays.push_back(overlay_data);
+        capture->Overlays.push_back(overlay_data);
 
-            ::PostThreadMessage(thread.ThreadID, WM_DPLUSWINRT_UPDATE_DATA, 0, 0);
-            return true;
-        }
+        DPWinRT_Internal_PublishOverlayData(*capture);
+        return true;
     }
 
     #endif //DPLUSWINRT_STUB
@@ -264,17 +320,20 @@ bool DPWinRT_PauseCapture(vr::VROverlayHandle_t overlay_handle, bool pause)
 
     std::lock_guard<std::mutex> lock(g_ThreadsMutex);
 
-    //Find thread with the overlay assigned and tell it to set pause state
-    for (auto& thread : g_Threads)
-    {
-        auto it = std::find_if(thread.Overlays.begin(), thread.Overlays.end(), [&](const auto& data){ return (data.Handle == overlay_handle); });
+    //Find capture with the overlay assigned and update the capture data. The worker pauses the capture once all of its overlays are paused
+    DPWinRTCaptureData* capture = nullptr;
+    DPWinRTOverlayData* overlay_data = g_CaptureRegistry.FindOverlay(overlay_handle, capture);
 
-        if (it != thread.Overlays.end())
-        {
-            it->IsPaused = pause;
-            ::PostThreadMessage(thread.ThreadID, WM_DPLUSWINRT_CAPTURE_PAUSE, overlay_handle, pause);
+    if (overlay_data != nullptr)
+    {
+        //If no change, back out
+        if (overlay_data->IsPaused == pause)
             return true;
-        }
+
+        overlay_data->IsPaused = pause;
+
+        DPWinRT_Internal_PublishOverlayData(*capture);
+        return true;
     }
 
     #endif //DPLUSWINRT_STUB
@@ -291,34 +350,26 @@ bool DPWinRT_StopCapture(vr::VROverlayHandle_t overlay_handle)
     MSG msg;
     while (PeekMessage(&msg, nullptr, WM_DPLUSWINRT_THREAD_ACK, WM_DPLUSWINRT_THREAD_ACK, PM_REMOVE));
 
-    //Find thread with overlay and remove overlay from it
+    //Find capture with overlay and remove overlay from it
     {
         std::lock_guard<std::mutex> lock(g_ThreadsMutex);
 
-        for (auto thread_it = g_Threads.begin(); thread_it != g_Threads.end(); ++thread_it)
-        {
-            auto& thread = *thread_it;
-            auto it = std::find_if(thread.Overlays.begin(), thread.Overlays.end(), [&](const auto& data) { return (data.Handle == overlay_handle); });
+        DPWinRTCaptureData* capture = g_CaptureRegistry.RemoveOverlay(overlay_handle);
 
-            if (it != thread.Overlays.end())
+        if (capture != nullptr)
+        {
+            if (capture->Overlays.empty()) //Stop and remove capture when no overlays left
             {
-                thread.Overlays.erase(it);
-
-                if (thread.Overlays.empty()) //Quit and remove thread when no overlays left
-                {
-                    ::PostThreadMessage(thread.ThreadID, WM_DPLUSWINRT_THREAD_QUIT, 0, 0);
+                ::PostThreadMessage(capture->ThreadID, WM_DPLUSWINRT_CAPTURE_STOP, capture->CaptureID, 0);
 
-                    ::CloseHandle(thread.ThreadHandle);
-                    g_Threads.erase(thread_it);
-                }
-                else //otherwise, update data
-                {
-                    ::PostThreadMessage(thread.ThreadID, WM_DPLUSWINRT_UPDATE_DATA, 0, 0);
-                }
-
-                wait_for_ack = true;
-                break;
+                g_CaptureRegistry.RemoveCapture(capture->CaptureID);
+            }
+            else //otherwise, update data
+            {
+                DPWinRT_Internal_PublishOverlayData(*capture);
             }
+
+            wait_for_ack = true;
         }
     }
 
@@ -346,48 +397,24 @@ void DPWinRT_SwapCaptureTargetOverlays(vr::VROverlayHandle_t overlay_handle, vr:
     std::lock_guard<std::mutex> lock(g_ThreadsMutex);
 
     //Find overlay data for the given overlay handles
-    std::vector<DPWinRTOverlayData>::iterator ovrl_data_it, ovrl_data_it_2;
-    DWORD ovrl_data_thread_id = 0, ovrl_data_thread_id_2 = 0;
+    DPWinRTCaptureData* capture_1 = nullptr;
+    DPWinRTCaptureData* capture_2 = nullptr;
+    DPWinRTOverlayData* overlay_data_1 = g_CaptureRegistry.FindOverlay(overlay_handle,   capture_1);
+    DPWinRTOverlayData* overlay_data_2 = g_CaptureRegistry.FindOverlay(overlay_handle_2, capture_2);
 
-    for (auto thread_it = g_Threads.begin(); thread_it != g_Threads.end(); ++thread_it)
+    //Swap overlay handles if we can and send update messages to affected threads (unless same capture, which would be no-op)
+    if (capture_1 != capture_2)
     {
-        auto& thread = *thread_it;
-
-        //Look for first handle
-        if (ovrl_data_thread_id == 0)
+        if (overlay_data_1 != nullptr)
         {
-            ovrl_data_it = std::find_if(thread.Overlays.begin(), thread.Overlays.end(), [&](const auto& data) { return (data.Handle == overlay_handle); });
-            
-            if (ovrl_data_it != thread.Overlays.end())
-            {
-                ovrl_data_thread_id = thread.ThreadID;
-            }
+            overlay_data_1->Handle = overlay_handle_2;
+            DPWinRT_Internal_PublishOverlayData(*capture_1);
         }
-        //Look for second handle
-        if (ovrl_data_thread_id_2 == 0)
-        {
-            ovrl_data_it_2 = std::find_if(thread.Overlays.begin(), thread.Overlays.end(), [&](const auto& data) { return (data.Handle == overlay_handle_2); });
 
-            if (ovrl_data_it_2 != thread.Overlays.end())
-            {
-                ovrl_data_thread_id_2 = thread.ThreadID;
-            }
-        }
-    }
-
-    //Swap overlay handles if we can and send update messages to affected threads (unless same thread, which would be no-op)
-    if (ovrl_data_thread_id != ovrl_data_thread_id_2)
-    {
-        if (ovrl_data_thread_id != 0)
+        if (overlay_data_2 != nullptr)
         {
-            ovrl_data_it->Handle = overlay_handle_2;
-            ::PostThreadMessage(ovrl_data_thread_id, WM_DPLUSWINRT_UPDATE_DATA, 0, 0);
-        }
-
-        if (ovrl_data_thread_id_2 != 0)
-        {
-            ovrl_data_it_2->Handle = overlay_handle;
-            ::PostThreadMessage(ovrl_data_thread_id_2, WM_DPLUSWINRT_UPDATE_DATA, 0, 0);
+            overlay_data_2->Handle = overlay_handle;
+            DPWinRT_Internal_PublishOverlayData(*capture_2);
         }
     }
 
@@ -400,22 +427,20 @@ bool DPWinRT_SetOverlayUpdateLimitDelay(vr::VROverlayHandle_t overlay_handle, LO
 
     std::lock_guard<std::mutex> lock(g_ThreadsMutex);
 
-    //Find thread with the overlay assigned and update the thread data
-    for (auto& thread : g_Threads)
-    {
-        auto it = std::find_if(thread.Overlays.begin(), thread.Overlays.end(), [&](const auto& data){ return (data.Handle == overlay_handle); });
+    //Find capture with the overlay assigned and update the capture data
+    DPWinRTCaptureData* capture = nullptr;
+    DPWinRTOverlayData* overlay_data = g_CaptureRegistry.FindOverlay(overlay_handle, capture);
 
-        if (it != thread.Overlays.end())
-        {
-            //If no change, back out
-            if (it->UpdateLimiterDelay.QuadPart == delay_quadpart)
-                return true;
+    if (overlay_data != nullptr)
+    {
+        //If no change, back out
+        if (overlay_data->UpdateLimiterDelay.QuadPart == delay_quadpart)
+            return true;
 
-            it->UpdateLimiterDelay.QuadPart = delay_quadpart;
+        overlay_data->UpdateLimiterDelay.QuadPart = delay_quadpart;
 
-            ::PostThreadMessage(thread.ThreadID, WM_DPLUSWINRT_UPDATE_DATA, 0, 0);
-            return true;
-        }
+        DPWinRT_Internal_PublishOverlayData(*capture);
+        return true;
     }
 
     #endif //DPLUSWINRT_STUB
@@ -429,32 +454,31 @@ bool DPWinRT_SetOverlayOverUnder3D(vr::VROverlayHandle_t overlay_handle, bool is
 
     std::lock_guard<std::mutex> lock(g_ThreadsMutex);
 
-    //Find thread with the overlay assigned and update the thread data
-    for (auto& thread : g_Threads)
-    {
-        auto it = std::find_if(thread.Overlays.begin(), thread.Overlays.end(), [&](const auto& data){ return (data.Handle == overlay_handle); });
+    //Find capture with the overlay assigned and update the capture data
+    DPWinRTCaptureData* capture = nullptr;
+    DPWinRTOverlayData* overlay_data = g_CaptureRegistry.FindOverlay(overlay_handle, capture);
 
-        if (it != thread.Overlays.end())
+    if (overlay_data != nullptr)
+    {
+        //If no change, back out
+        if (overlay_data->IsOverUnder3D == is_over_under_3D)
         {
-            //If no change, back out
-            if (it->IsOverUnder3D == is_over_under_3D)
+            //Only check if crop matches if OU3D is on
+            if ( (!is_over_under_3D) || ( (overlay_data->OU3D_crop_x == crop_x) && (overlay_data->OU3D_crop_y == crop_y) && 
+                                          (overlay_data->OU3D_crop_width == crop_width) && (overlay_data->OU3D_crop_height == crop_height) ) )
             {
-                //Only check if crop matches if OU3D is on
-                if ( (!is_over_under_3D) || ( (it->OU3D_crop_x == crop_x) && (it->OU3D_crop_y == crop_y) && (it->OU3D_crop_width == crop_width) && (it->OU3D_crop_height == crop_height) ) )
-                {
-                    return true;
-                }
+                return true;
             }
+        }
 
-            it->IsOverUnder3D    = is_over_under_3D;
-            it->OU3D_crop_x      = crop_x;
-            it->OU3D_crop_y      = crop_y;
-            it->OU3D_crop_width  = crop_width;
-            it->OU3D_crop_height = crop_height;
+        overlay_data->IsOverUnder3D    = is_over_under_3D;
+        overlay_data->OU3D_crop_x      = crop_x;
+        overlay_data->OU3D_crop_y      = crop_y;
+        overlay_data->OU3D_crop_width  = crop_width;
+        overlay_data->OU3D_crop_height = crop_height;
 
-            ::PostThreadMessage(thread.ThreadID, WM_DPLUSWINRT_UPDATE_DATA, 0, 0);
-            return true;
-        }
+        DPWinRT_Internal_PublishOverlayData(*capture);
+        return true;
     }
 
     #endif //DPLUSWINRT_STUB
@@ -471,9 +495,9 @@ void DPWinRT_SetCaptureCursorEnabled(bool is_cursor_enabled)
     {
         std::lock_guard<std::mutex> lock(g_ThreadsMutex);
 
-        for (const auto& thread : g_Threads)
+        for (const auto& worker : g_CaptureRegistry.GetWorkers())
         {
-            ::PostThreadMessage(thread.ThreadID, WM_DPLUSWINRT_ENABLE_CURSOR, is_cursor_enabled, 0);
+            ::PostThreadMessage(worker.ThreadID, WM_DPLUSWINRT_ENABLE_CURSOR, is_cursor_enabled, 0);
         }
 
         g_IsCursorEnabled = is_cursor_enabled;
@@ -481,6 +505,32 @@ void DPWinRT_SetCaptureCursorEnabled(bool is_cursor_enabled)
     #endif //DPLUSWINRT_STUB
 }
 
+void DPWinRT_SetCaptureChangeDetectionEnabled(bool is_enabled)
+{
+    #ifndef DPLUSWINRT_STUB
+
+    //Send message to all threads if the value changed
+    if (g_IsChangeDetectionEnabled != is_enabled)
+    {
+        std::lock_guard<std::mutex> lock(g_ThreadsMutex);
+
+        for (const auto& worker : g_CaptureRegistry.GetWorkers())
+        {
+            ::PostThreadMessage(worker.ThreadID, WM_DPLUSWINRT_ENABLE_CHANGE_DETECTION, is_enabled, 0);
+        }
+
+        g_IsChangeDetectionEnabled = is_enabled;
+    }
+    #endif //DPLUSWINRT_STUB
+}
+
+void DPWinRT_SetWindowTitleLookup(DPWinRTWindowTitleLookupFunc lookup_func)
+{
+    #ifndef DPLUSWINRT_STUB
+        CaptureManager::SetWindowTitleLookup(lookup_func);
+    #endif
+}
+
 void DPWinRT_SetDesktopEnumerationFlags(bool ignore_wmr_screens)
 {
     //This really is just a flag that could be hard coded to true in theory, but we keep our options open down the line even if it means carrying this everywhere
@@ -491,198 +541,301 @@ void DPWinRT_SetDesktopEnumerationFlags(bool ignore_wmr_screens)
 
 #ifndef DPLUSWINRT_STUB
 
-DWORD WINAPI WinRTCaptureThreadEntry(_In_ void* Param)
+//Capture hosted on a worker thread
+struct DPWinRTWorkerCapture
 {
-    //The thread shouldn't have been created in the first place then, but exit if it really happens
-    if (!DPWinRT_IsCaptureSupported())
+    DPWinRTCaptureData Data;                //Local copy, referenced by Manager
+    int OverlaySnapshotReaderSlot = DPWinRTOverlaySnapshot::k_lReaderSlotInvalid;
+    std::unique_ptr<CaptureManager> Manager;
+    winrt::IAsyncOperation<winrt::GraphicsCaptureItem> PickerOperation = nullptr;
+};
+
+//State of a worker thread, only accessed by the worker itself
+struct DPWinRTWorkerState
+{
+    winrt::Windows::System::DispatcherQueueController Controller = nullptr;
+    winrt::IDirect3DDevice Device = nullptr;                                    //Shared by all captures of the thread
+    std::vector<std::unique_ptr<DPWinRTWorkerCapture>> Captures;
+    unsigned int ActiveCaptureID = 0;                                           //Capture a message is currently being handled for, 0 if none. Used to find the one at fault on errors
+    bool IsCursorEnabled = true;
+    bool IsChangeDetectionEnabled = false;
+};
+
+void WinRTCaptureThreadCancelPicker(DPWinRTWorkerCapture& capture)
+{
+    //If there's still a pending picker operation, cancel it
+    if ( (capture.PickerOperation != nullptr) && (capture.PickerOperation.Status() == winrt::AsyncStatus::Started) )
     {
-        return 0;
+        capture.PickerOperation.Cancel();
     }
+}
 
-    //Keep own copy of thread data
-    DPWinRTThreadData data;
+void WinRTCaptureThreadStartCapture(DPWinRTWorkerState& worker, unsigned int capture_id)
+{
+    auto capture_ptr = std::make_unique<DPWinRTWorkerCapture>();
 
+    //Get a copy of the capture data, unless it was already stopped again
     {
         std::lock_guard<std::mutex> lock(g_ThreadsMutex);
-        data = *(DPWinRTThreadData*)Param;
+
+        const DPWinRTCaptureData* capture_data = g_CaptureRegistry.FindCapture(capture_id);
+
+        if (capture_data == nullptr)
+            return;
+
+        capture_ptr->Data = *capture_data;
     }
 
-    // Initialize WinRT and scope the rest of the code so it's cleaned up before unloading WinRT again
-    winrt::init_apartment(winrt::apartment_type::multi_threaded);
+    //Overlay data changes are read from the snapshot from here on. This thread is the only one hosting the capture, so this can't fail
+    capture_ptr->OverlaySnapshotReaderSlot = capture_ptr->Data.OverlaySnapshot->RegisterReader();
 
-    //Catch all unhandled WinRT exceptions in release builds so we can get rid of the thread instead of crashing the entire app
-    //This assumes that doing so is alright (i.e. no process-irrecoverable exceptions occur)
-    #ifndef _DEBUG
-    try
-    #endif
+    //Add it to the list before anything can throw so error handling knows about its overlays
+    worker.Captures.push_back(std::move(capture_ptr));
+    DPWinRTWorkerCapture& capture = *worker.Captures.back();
+    const DPWinRTCaptureData& data = capture.Data;
+
+    //Create the DispatcherQueue that the compositor needs to run and the device on the first capture
+    if (worker.Controller == nullptr)
     {
-        // Create the DispatcherQueue that the compositor needs to run
-        auto controller = util::CreateDispatcherQueueControllerForCurrentThread();
+        worker.Controller = util::CreateDispatcherQueueControllerForCurrentThread();
+    }
 
-        // Create the capture manager
-        auto capture_manager = std::make_unique<CaptureManager>(data, g_MainThreadID);
+    if (worker.Device == nullptr)
+    {
+        worker.Device = CaptureManager::CreateDevice();
+    }
+
+    capture.Manager = std::make_unique<CaptureManager>(capture.Data, g_MainThreadID, worker.Device);
+    capture.Manager->IsChangeDetectionEnabled(worker.IsChangeDetectionEnabled);
 
-        //Start capture
-        winrt::IAsyncOperation<winrt::GraphicsCaptureItem> picker_operation = nullptr;
-        if (data.UsePicker)
+    //Start capture
+    if (data.UsePicker)
+    {
+        capture.PickerOperation = capture.Manager->StartCaptureWithPickerAsync();
+    }
+    else if (DPWinRT_IsCaptureFromHandleSupported())
+    {
+        if (data.SourceWindow != nullptr)
         {
-            picker_operation = capture_manager->StartCaptureWithPickerAsync();
+            capture.Manager->StartCaptureFromWindowHandle(data.SourceWindow);
         }
-        else if (DPWinRT_IsCaptureFromHandleSupported())
+        else if (data.DesktopID != -2)
         {
-            if (data.SourceWindow != nullptr)
+            if (data.DesktopID != -1)
             {
-                capture_manager->StartCaptureFromWindowHandle(data.SourceWindow);
-            }
-            else if (data.DesktopID != -2)
-            {
-                if (data.DesktopID != -1)
-                {
-                    HMONITOR monitor_handle = nullptr;
-                    GetDevmodeForDisplayID(data.DesktopID, g_DesktopEnumFlagIgnoreWMRScreens, &monitor_handle);
+                HMONITOR monitor_handle = nullptr;
+                GetDevmodeForDisplayID(data.DesktopID, g_DesktopEnumFlagIgnoreWMRScreens, &monitor_handle);
 
-                    if (monitor_handle != nullptr)
-                    {
-                        capture_manager->StartCaptureFromMonitorHandle(monitor_handle);
-                    }
-                    else
-                    {
-                        //Failed to get monitor handle, drop the capture
-                        for (const auto& overlay : data.Overlays)
-                        {
-                            ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_CAPTURE_LOST, overlay.Handle, 0);
-                            //Thread will be quit by the response to the capture lost message
-                        }
-                    }
+                if (monitor_handle != nullptr)
+                {
+                    capture.Manager->StartCaptureFromMonitorHandle(monitor_handle);
                 }
-                else if (DPWinRT_IsCaptureFromCombinedDesktopSupported())
+                else
                 {
-                    capture_manager->StartCaptureFromMonitorHandle(nullptr);
+                    //Failed to get monitor handle, drop the capture
+                    for (const auto& overlay : data.Overlays)
+                    {
+                        ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_CAPTURE_LOST, overlay.Handle, 0);
+                        //Capture will be removed by the response to the capture lost message
+                    }
                 }
             }
+            else if (DPWinRT_IsCaptureFromCombinedDesktopSupported())
+            {
+                capture.Manager->StartCaptureFromMonitorHandle(nullptr);
+            }
         }
+    }
 
-        //Ideally, capabilities are checked by before creating the thread, but if not and no capture starts, there will just be an idling thread until StopCapture is called
+    //Ideally, capabilities are checked before starting the capture, but if not there will just be an idling capture until StopCapture is called
 
-        // Message pump
-        MSG msg;
-        while (GetMessageW(&msg, nullptr, 0, 0))
+    //Apply non-default cursor state
+    if (!worker.IsCursorEnabled)
+    {
+        capture.Manager->IsCursorEnabled(false);
+    }
+}
+
+void WinRTCaptureThreadMessageLoop(DPWinRTWorkerState& worker)
+{
+    MSG msg;
+    while (GetMessageW(&msg, nullptr, 0, 0))
+    {
+        worker.ActiveCaptureID = 0;
+
+        if ((msg.message >= WM_DPLUSWINRT) && (msg.message <= 0xBFFF))
         {
-            if ((msg.message >= WM_DPLUSWINRT) && (msg.message <= 0xBFFF))
+            switch (msg.message)
             {
-                switch (msg.message)
+                case WM_DPLUSWINRT_CAPTURE_START:
+                {
+                    worker.ActiveCaptureID = (unsigned int)msg.wParam;
+                    WinRTCaptureThreadStartCapture(worker, (unsigned int)msg.wParam);
+                    break;
+                }
+                case WM_DPLUSWINRT_CAPTURE_STOP:
                 {
-                    case WM_DPLUSWINRT_UPDATE_DATA:
+                    worker.ActiveCaptureID = (unsigned int)msg.wParam;
+                    auto it = std::find_if(worker.Captures.begin(), worker.Captures.end(), [&](const auto& capture){ return (capture->Data.CaptureID == msg.wParam); });
+
+                    //Clear overlays here so they won't receive any more updates before the capture is actually gone
+                    if (it != worker.Captures.end())
                     {
-                        //Look for thread data and update local copy
-                        std::lock_guard<std::mutex> lock(g_ThreadsMutex);
-
-                        for (const auto& thread : g_Threads)
-                        {
-                            if (thread.ThreadID == data.ThreadID)
-                            {
-                                data = thread;
-                                capture_manager->OnOverlayDataRefresh();
-                                break;
-                            }
-                        }
-
-                        ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_THREAD_ACK, 0, 0);
-
-                        break;
+                        (*it)->Data.Overlays.clear();
                     }
-                    case WM_DPLUSWINRT_CAPTURE_PAUSE:
+
+                    ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_THREAD_ACK, 0, 0);
+
+                    if (it != worker.Captures.end())
                     {
-                        const bool do_pause = msg.lParam;
-
-                        bool is_unchanged = false;
-                        bool all_paused = true;
-                        for (DPWinRTOverlayData& overlay_data : data.Overlays)
-                        {
-                            if (overlay_data.Handle == msg.wParam)
-                            {
-                                //No change, back out
-                                if (overlay_data.IsPaused == do_pause)
-                                {
-                                    is_unchanged = true;
-                                    break;
-                                }
-
-                                overlay_data.IsPaused = do_pause;
-                            }
-
-                            if (!overlay_data.IsPaused)
-                            {
-                                all_paused = false;
-                            }
-                        }
-
-                        if (!is_unchanged)
-                        {
-                            capture_manager->PauseCapture(all_paused);
-                        }
-                        break;
+                        WinRTCaptureThreadCancelPicker(**it);
+                        worker.Captures.erase(it);
                     }
-                    case WM_DPLUSWINRT_ENABLE_CURSOR:
+                    break;
+                }
+                case WM_DPLUSWINRT_UPDATE_DATA:
+                {
+                    worker.ActiveCaptureID = (unsigned int)msg.wParam;
+
+                    //Look for capture and update the local copy of its overlay data from the latest snapshot
+                    auto it = std::find_if(worker.Captures.begin(), worker.Captures.end(), [&](const auto& capture){ return (capture->Data.CaptureID == msg.wParam); });
+
+                    if ( (it != worker.Captures.end()) && ((*it)->OverlaySnapshotReaderSlot != DPWinRTOverlaySnapshot::k_lReaderSlotInvalid) )
                     {
-                        capture_manager->IsCursorEnabled(msg.wParam);
-                        break;
+                        DPWinRTWorkerCapture& capture = **it;
+
+                        capture.Data.Overlays = capture.Data.OverlaySnapshot->Read(capture.OverlaySnapshotReaderSlot).Get();
+                        capture.Manager->OnOverlayDataRefresh();
                     }
-                    case WM_DPLUSWINRT_THREAD_QUIT:
-                    {
-                        //Clear overlays here so they won't receive any more updates before the actually thread exits
-                        data.Overlays.clear();
-                        ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_THREAD_ACK, 0, 0);
 
-                        ::PostQuitMessage(0);
-                        break;
+                    ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_THREAD_ACK, 0, 0);
+
+                    break;
+                }
+                case WM_DPLUSWINRT_ENABLE_CURSOR:
+                {
+                    worker.IsCursorEnabled = msg.wParam;
+
+                    for (auto& capture : worker.Captures)
+                    {
+                        worker.ActiveCaptureID = capture->Data.CaptureID;
+                        capture->Manager->IsCursorEnabled(worker.IsCursorEnabled);
                     }
+                    break;
+                }
+                case WM_DPLUSWINRT_ENABLE_CHANGE_DETECTION:
+                {
+                    worker.IsChangeDetectionEnabled = msg.wParam;
 
+                    for (auto& capture : worker.Captures)
+                    {
+                        worker.ActiveCaptureID = capture->Data.CaptureID;
+                        capture->Manager->IsChangeDetectionEnabled(worker.IsChangeDetectionEnabled);
+                    }
+                    break;
+                }
+                case WM_DPLUSWINRT_THREAD_QUIT:
+                {
+                    ::PostQuitMessage(0);
+                    break;
                 }
-            }
-            else
-            {
-                TranslateMessage(&msg);
-                DispatchMessageW(&msg);
             }
         }
-
-        //If there's still a pending picker operation, cancel it
-        if ( (picker_operation != nullptr) && (picker_operation.Status() == winrt::AsyncStatus::Started) )
+        else
         {
-            picker_operation.Cancel();
+            TranslateMessage(&msg);
+            DispatchMessageW(&msg);
         }
+    }
+}
+
+DWORD WINAPI WinRTCaptureThreadEntry(_In_ void* Param)
+{
+    //Create the message queue and let the creating thread know it can post messages now
+    MSG msg;
+    ::PeekMessage(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+    ::SetEvent((HANDLE)Param);
 
-        capture_manager = nullptr;
-        controller = nullptr;
+    //The thread shouldn't have been created in the first place then, but exit if it really happens
+    if (!DPWinRT_IsCaptureSupported())
+    {
+        return 0;
     }
-    #ifndef _DEBUG
 
-    catch (const winrt::hresult_error& e)
+    // Initialize WinRT and scope the rest of the code so it's cleaned up before unloading WinRT again
+    winrt::init_apartment(winrt::apartment_type::multi_threaded);
     {
-        //It's worth noting that exceptions from WinRT are not supposed to get thrown on regular errors and only things that are coding mistakes
-        //But we know things will go wrong when they can, let's be honest. What can go wrong isn't really well documented either, so if something
-        //comes up, handle it somewhat gracefully
+        DPWinRTWorkerState worker;
 
-        //Send capture lost messages for all overlays
-        //Resulting StopCapture() calls will cause cleanup of the thread book-keeping, even if this target thread is already gone
-        for (const auto& overlay : data.Overlays)
+        bool do_quit = false;
+        while (!do_quit)
         {
-            ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_CAPTURE_LOST, overlay.Handle, 0);
+            //Catch all unhandled WinRT exceptions in release builds so we can get rid of the thread's captures instead of crashing the entire app
+            //This assumes that doing so is alright (i.e. no process-irrecoverable exceptions occur)
+            #ifndef _DEBUG
+            try
+            #endif
+            {
+                WinRTCaptureThreadMessageLoop(worker);
+                do_quit = true;
+            }
+            #ifndef _DEBUG
+
+            catch (const winrt::hresult_error& e)
+            {
+                //It's worth noting that exceptions from WinRT are not supposed to get thrown on regular errors and only things that are coding mistakes
+                //But we know things will go wrong when they can, let's be honest. What can go wrong isn't really well documented either, so if something
+                //comes up, handle it somewhat gracefully
+
+                //If the error happened while handling a message for a specific capture, only that one is dropped and the thread keeps serving the others.
+                //Otherwise (i.e. thrown from a dispatched callback) the capture at fault isn't known and all captures hosted on this thread are dropped.
+                //Either way, capture lost messages are sent for all overlays of the dropped captures. Resulting StopCapture() calls will cause cleanup of
+                //the capture book-keeping, even if the captures are already gone here
+                auto it_end = worker.Captures.end();
+                auto it_begin = std::find_if(worker.Captures.begin(), it_end, [&](const auto& capture){ return (capture->Data.CaptureID == worker.ActiveCaptureID); });
+
+                if (it_begin == it_end)
+                {
+                    it_begin = worker.Captures.begin();
+                }
+                else
+                {
+                    it_end = it_begin + 1;
+                }
+
+                for (auto it = it_begin; it != it_end; ++it)
+                {
+                    for (const auto& overlay : (*it)->Data.Overlays)
+                    {
+                        ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_CAPTURE_LOST, overlay.Handle, 0);
+                    }
+                }
+
+                //Send thread error message
+                ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_THREAD_ERROR, ::GetCurrentThreadId(), e.code());
+
+                //...and then drop the captures
+                worker.Captures.erase(it_begin, it_end);
+                worker.ActiveCaptureID = 0;
+            }
+
+            #endif
         }
 
-        //Send thread error message
-        ::PostThreadMessage(g_MainThreadID, WM_DPLUSWINRT_THREAD_ERROR, data.ThreadID, e.code());
+        for (auto& capture : worker.Captures)
+        {
+            WinRTCaptureThreadCancelPicker(*capture);
+        }
 
-        //...and then get out of this thread
+        worker.Captures.clear();
+        worker.Device = nullptr;
+        worker.Controller = nullptr;
     }
 
-    #endif
-
     winrt::clear_factory_cache();
     winrt::uninit_apartment();
 
     return 0;
 }
 
-#endif //DPLUSWINRT_STUB
\ No newline at end of file
+#endif //DPLUSWINRT_STUB
@@ -12,7 +12,9 @@
 //handled by OutputManager as usual, however.
 
 //As a general rule, the callee of the library functions is responsible to check for support first, otherwise it may throw or crash
-//In release builds, capture thread exceptions are caught and handled as unexpected errors, trying to just stop the thread. Ideally it never comes to that, of course.
+//Captures run on a small pool of worker threads sized to the CPU core count. Each worker has its own apartment, message loop and D3D device, shared by all
+//captures it hosts. Workers are created on demand and quit once they have no captures left.
+//In release builds, capture thread exceptions are caught and handled as unexpected errors, dropping the captures of that thread. Ideally it never comes to that, of course.
 //The library relies on delay loading CoreMessaging and D3D11 in order to support running on Windows 8, so keep that in mind if ever using a different compiler.
 
 #define WIN32_LEAN_AND_MEAN
@@ -32,19 +34,26 @@
 #define WM_DPLUSWINRT_SIZE          WM_DPLUSWINRT    //Sent to main thread on size change. wParam = overlay handle, lParam = width & height (in low/high word order, signed)
 #define WM_DPLUSWINRT_SET_HWND      WM_DPLUSWINRT+1  //Sent to main thread on HWND guess after picker use. wParam = overlay handle, lParam = HWND
 #define WM_DPLUSWINRT_SET_DESKTOP   WM_DPLUSWINRT+2  //Sent to main thread on desktop ID guess after picker use. wParam = overlay handle, lParam = desktop ID
-#define WM_DPLUSWINRT_UPDATE_DATA   WM_DPLUSWINRT+3  //Sent to capture thread to update its local data
-#define WM_DPLUSWINRT_CAPTURE_PAUSE WM_DPLUSWINRT+4  //Sent to capture thread to pause/resume capture. wParam = overlay handle, lParam = pause bool
+#define WM_DPLUSWINRT_UPDATE_DATA   WM_DPLUSWINRT+3  //Sent to capture thread to update its local data. wParam = capture ID
 #define WM_DPLUSWINRT_CAPTURE_LOST  WM_DPLUSWINRT+5  //Sent to main thread when capture item was closed, should call StopCapture() in response. wParam = overlay handle
 #define WM_DPLUSWINRT_ENABLE_CURSOR WM_DPLUSWINRT+6  //Sent to capture thread to change cursor enabled state, wParam = cursor enabled bool
-#define WM_DPLUSWINRT_THREAD_QUIT   WM_DPLUSWINRT+7  //Sent to capture thread to quit when no overlays are left to capture
+#define WM_DPLUSWINRT_THREAD_QUIT   WM_DPLUSWINRT+7  //Sent to capture thread to quit when no captures are left on it
 #define WM_DPLUSWINRT_THREAD_ERROR  WM_DPLUSWINRT+8  //Sent to main thread when an unexpected error occured in the capture thread. wParam = thread ID, lParam = hresult
 #define WM_DPLUSWINRT_THREAD_ACK    WM_DPLUSWINRT+9  //Sent to main thread to acknowledge thread messages from StopCapture() (main thread is blocked until this is received)
+#define WM_DPLUSWINRT_CAPTURE_START WM_DPLUSWINRT+10 //Sent to capture thread to start hosting a capture. wParam = capture ID
+#define WM_DPLUSWINRT_CAPTURE_STOP  WM_DPLUSWINRT+11 //Sent to capture thread to stop and remove a capture when no overlays are left for it. wParam = capture ID
+#define WM_DPLUSWINRT_ENABLE_CHANGE_DETECTION WM_DPLUSWINRT+12 //Sent to capture thread to change frame change detection enabled state, wParam = enabled bool
+
+//Returns the window for the title of a window picked by the user, or nullptr. Called from capture threads
+typedef HWND (*DPWinRTWindowTitleLookupFunc)(const wchar_t* title);
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 DPLUSWINRT_API void DPWinRT_Init();
+//Lets picker captures find their window through the caller's window list (WindowRegistry) instead of enumerating all windows. Enumerates if not set
+DPLUSWINRT_API void DPWinRT_SetWindowTitleLookup(DPWinRTWindowTitleLookupFunc lookup_func);
 
 DPLUSWINRT_API bool DPWinRT_IsCaptureSupported();                      //Build 1803
 DPLUSWINRT_API bool DPWinRT_IsCaptureFromHandleSupported();            //Build 1903
@@ -62,6 +71,7 @@ DPLUSWINRT_API void DPWinRT_SwapCaptureTargetOverlays(vr::VROverlayHandle_t over
 DPLUSWINRT_API bool DPWinRT_SetOverlayUpdateLimitDelay(vr::VROverlayHandle_t overlay_handle, LONGLONG delay_quadpart);
 DPLUSWINRT_API bool DPWinRT_SetOverlayOverUnder3D(vr::VROverlayHandle_t overlay_handle, bool is_over_under_3D, int crop_x, int crop_y, int crop_width, int crop_height);
 DPLUSWINRT_API void DPWinRT_SetCaptureCursorEnabled(bool is_cursor_enabled);
+DPLUSWINRT_API void DPWinRT_SetCaptureChangeDetectionEnabled(bool is_enabled);    //Skips submitting frames with unchanged content. Off by default
 DPLUSWINRT_API void DPWinRT_SetDesktopEnumerationFlags(bool ignore_wmr_screens);
 
 
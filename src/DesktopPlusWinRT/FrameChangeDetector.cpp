@@ -0,0 +1,227 @@
+#ifndef DPLUSWINRT_STUB
+
+#include "CommonHeaders.h"
+#include "FrameChangeDetector.h"
+
+#include "FrameTileHash.h"
+
+FrameChangeDetector::FrameChangeDetector() : m_ReadbackNext(0),
+                                             m_ReadbackPendingCount(0),
+                                             m_TexWidth(0),
+                                             m_TexHeight(0),
+                                             m_TexFormat(DXGI_FORMAT_UNKNOWN),
+                                             m_ReadbackMipLevel(0),
+                                             m_ReadbackWidth(0),
+                                             m_ReadbackHeight(0),
+                                             m_HasReference(false),
+                                             m_IsLatestValid(false),
+                                             m_IsChangePending(false),
+                                             m_LastSubmitTick(0)
+{
+}
+
+bool FrameChangeDetector::CreateResources(ID3D11Device* device, const D3D11_TEXTURE2D_DESC& source_desc)
+{
+    m_TexMipped    = nullptr;
+    m_TexMippedSRV = nullptr;
+    m_Readbacks.clear();
+    m_TexWidth     = source_desc.Width;
+    m_TexHeight    = source_desc.Height;
+    m_TexFormat    = source_desc.Format;
+    Reset();
+
+    //Pick the first mip level fitting into the readback size
+    m_ReadbackMipLevel = 0;
+    m_ReadbackWidth    = m_TexWidth;
+    m_ReadbackHeight   = m_TexHeight;
+
+    while ( (m_ReadbackWidth > s_ReadbackSizeMax) || (m_ReadbackHeight > s_ReadbackSizeMax) )
+    {
+        m_ReadbackMipLevel++;
+        m_ReadbackWidth  = (std::max)(m_ReadbackWidth  / 2, 1u);
+        m_ReadbackHeight = (std::max)(m_ReadbackHeight / 2, 1u);
+    }
+
+    D3D11_TEXTURE2D_DESC desc = {0};
+    desc.Width            = m_TexWidth;
+    desc.Height           = m_TexHeight;
+    desc.MipLevels        = m_ReadbackMipLevel + 1;
+    desc.ArraySize        = 1;
+    desc.Format           = m_TexFormat;
+    desc.SampleDesc.Count = 1;
+    desc.Usage            = D3D11_USAGE_DEFAULT;
+    desc.BindFlags        = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+    desc.MiscFlags        = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+
+    if (FAILED(device->CreateTexture2D(&desc, nullptr, m_TexMipped.put())))
+        return false;
+
+    if (FAILED(device->CreateShaderResourceView(m_TexMipped.get(), nullptr, m_TexMippedSRV.put())))
+        return false;
+
+    desc.Width          = m_ReadbackWidth;
+    desc.Height         = m_ReadbackHeight;
+    desc.MipLevels      = 1;
+    desc.Usage          = D3D11_USAGE_STAGING;
+    desc.BindFlags      = 0;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+    desc.MiscFlags      = 0;
+
+    m_Readbacks.resize(s_ReadbackCount);
+
+    for (Readback& readback : m_Readbacks)
+    {
+        if (FAILED(device->CreateTexture2D(&desc, nullptr, readback.Texture.put())))
+            return false;
+    }
+
+    const UINT tile_count = ((m_ReadbackWidth + s_TileSize - 1) / s_TileSize) * ((m_ReadbackHeight + s_TileSize - 1) / s_TileSize);
+    m_TileHashes.assign(tile_count, 0);
+    m_TileHashesLatest.assign(tile_count, 0);
+
+    return true;
+}
+
+bool FrameChangeDetector::IsSubmittedReadbackPending() const
+{
+    for (UINT i = 0; i < m_ReadbackPendingCount; ++i)
+    {
+        if (m_Readbacks[(m_ReadbackNext + s_ReadbackCount - 1 - i) % s_ReadbackCount].IsSubmitted)
+            return true;
+    }
+
+    return false;
+}
+
+bool FrameChangeDetector::Update(ID3D11Device* device, ID3D11DeviceContext* device_context, ID3D11Texture2D* texture, bool force_submit)
+{
+    D3D11_TEXTURE2D_DESC source_desc;
+    texture->GetDesc(&source_desc);
+
+    if ( (m_TexMipped == nullptr) || (source_desc.Width != m_TexWidth) || (source_desc.Height != m_TexHeight) || (source_desc.Format != m_TexFormat) )
+    {
+        if (!CreateResources(device, source_desc))
+        {
+            m_TexMipped = nullptr;
+            return true;
+        }
+    }
+
+    Poll(device_context);
+
+    bool do_submit = ( (force_submit) || (!m_HasReference) || (m_IsChangePending) || (::GetTickCount64() >= m_LastSubmitTick + s_ForcedSubmitInterval) );
+
+    //If the GPU is that far behind, give up on the oldest readback. Submitting this frame covers whatever it would have found
+    if (m_ReadbackPendingCount == s_ReadbackCount)
+    {
+        m_ReadbackPendingCount--;
+        do_submit = true;
+    }
+
+    //Downsample on the GPU and queue the copy of the small mip. It's mapped by a later Poll() once the GPU got to it
+    Readback& readback = m_Readbacks[m_ReadbackNext];
+
+    device_context->CopySubresourceRegion(m_TexMipped.get(), 0, 0, 0, 0, texture, 0, nullptr);
+    device_context->GenerateMips(m_TexMippedSRV.get());
+    device_context->CopySubresourceRegion(readback.Texture.get(), 0, 0, 0, 0, m_TexMipped.get(), m_ReadbackMipLevel, nullptr);
+    device_context->Flush();
+
+    readback.IsSubmitted = do_submit;
+    m_ReadbackNext = (m_ReadbackNext + 1) % s_ReadbackCount;
+    m_ReadbackPendingCount++;
+
+    if (do_submit)
+    {
+        //Anything seen before is covered by this frame
+        m_IsChangePending = false;
+        m_LastSubmitTick = ::GetTickCount64();
+    }
+
+    return do_submit;
+}
+
+void FrameChangeDetector::Poll(ID3D11DeviceContext* device_context)
+{
+    //Resolve in queue order and stop at the first one the GPU isn't done with, later ones won't be either
+    while (m_ReadbackPendingCount != 0)
+    {
+        const Readback& readback = m_Readbacks[(m_ReadbackNext + s_ReadbackCount - m_ReadbackPendingCount) % s_ReadbackCount];
+
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        HRESULT hr = device_context->Map(readback.Texture.get(), 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+
+        if (hr == DXGI_ERROR_WAS_STILL_DRAWING)
+            break;
+
+        m_ReadbackPendingCount--;
+
+        if (FAILED(hr))
+        {
+            //Can't tell what the frame looked like, so treat it as changed unless something newer was submitted already
+            m_IsLatestValid = false;
+
+            if ( (!readback.IsSubmitted) && (!IsSubmittedReadbackPending()) )
+            {
+                m_IsChangePending = true;
+            }
+            continue;
+        }
+
+        HashFrameTiles((const uint8_t*)mapped.pData, mapped.RowPitch, m_ReadbackWidth, m_ReadbackHeight, s_TileSize, m_TileHashesLatest.data());
+
+        device_context->Unmap(readback.Texture.get(), 0);
+
+        m_IsLatestValid = true;
+
+        if (readback.IsSubmitted)
+        {
+            m_TileHashes   = m_TileHashesLatest;
+            m_HasReference = true;
+        }
+        else if ( (!IsSubmittedReadbackPending()) && ( (!m_HasReference) || (m_TileHashes != m_TileHashesLatest) ) )
+        {
+            m_IsChangePending = true;
+        }
+    }
+}
+
+bool FrameChangeDetector::IsSubmitNeeded() const
+{
+    return ( (m_IsChangePending) || (::GetTickCount64() >= m_LastSubmitTick + s_ForcedSubmitInterval) );
+}
+
+bool FrameChangeDetector::IsPending() const
+{
+    return (m_ReadbackPendingCount != 0);
+}
+
+void FrameChangeDetector::OnLatestSubmitted()
+{
+    m_IsChangePending = false;
+    m_LastSubmitTick  = ::GetTickCount64();
+
+    if (m_ReadbackPendingCount != 0)
+    {
+        m_Readbacks[(m_ReadbackNext + s_ReadbackCount - 1) % s_ReadbackCount].IsSubmitted = true;
+    }
+    else if (m_IsLatestValid)
+    {
+        m_TileHashes   = m_TileHashesLatest;
+        m_HasReference = true;
+    }
+    else
+    {
+        m_HasReference = false;
+    }
+}
+
+void FrameChangeDetector::Reset()
+{
+    //Queued copies are simply overwritten by later ones, mapping waits for the newest
+    m_ReadbackPendingCount = 0;
+    m_HasReference    = false;
+    m_IsLatestValid   = false;
+    m_IsChangePending = false;
+}
+
+#endif //DPLUSWINRT_STUB
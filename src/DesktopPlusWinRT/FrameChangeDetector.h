@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+
+//Detects whether captured frames' content differs from the last submitted frame
+//Graphics Capture delivers frames on cursor-only updates or DWM recomposition as well, which would otherwise all be submitted to the overlays.
+//The frame is downsampled on the GPU through a mip chain, read back at a size of at most 512x512 and hashed in 16x16 tiles on the CPU.
+//Readbacks go through a small ring of staging textures which are only mapped once the GPU is done with them, so the capture thread never waits on the GPU.
+//This means the result for a frame is only known one or more frames later. Update() decides based on what has been resolved so far and a skipped frame has to be
+//kept around by the caller until Poll() resolved it and IsSubmitNeeded() returns false, or submitted when it returns true.
+//Changes small enough to vanish in the downsample can go undetected, so a frame is submitted at least every s_ForcedSubmitInterval ms regardless.
+class FrameChangeDetector
+{
+    private:
+        struct Readback
+        {
+            winrt::com_ptr<ID3D11Texture2D> Texture;
+            bool IsSubmitted = false;
+        };
+
+        winrt::com_ptr<ID3D11Texture2D> m_TexMipped;
+        winrt::com_ptr<ID3D11ShaderResourceView> m_TexMippedSRV;
+        std::vector<Readback> m_Readbacks;  //Ring of s_ReadbackCount
+        UINT m_ReadbackNext;                //Ring index the next frame is copied to
+        UINT m_ReadbackPendingCount;        //Readbacks queued but not mapped yet, the oldest one is at m_ReadbackNext - m_ReadbackPendingCount
+        UINT m_TexWidth;
+        UINT m_TexHeight;
+        DXGI_FORMAT m_TexFormat;
+        UINT m_ReadbackMipLevel;
+        UINT m_ReadbackWidth;
+        UINT m_ReadbackHeight;
+
+        std::vector<uint64_t> m_TileHashes;         //Last submitted frame
+        std::vector<uint64_t> m_TileHashesLatest;   //Last resolved frame
+        bool m_HasReference;                        //m_TileHashes is valid
+        bool m_IsLatestValid;                       //m_TileHashesLatest is valid
+        bool m_IsChangePending;                     //A resolved frame differs from the last submitted one and nothing newer has been submitted yet
+        ULONGLONG m_LastSubmitTick;
+
+        bool CreateResources(ID3D11Device* device, const D3D11_TEXTURE2D_DESC& source_desc);
+        bool IsSubmittedReadbackPending() const;
+
+    public:
+        static const UINT s_ReadbackSizeMax = 512;
+        static const UINT s_ReadbackCount = 3;
+        static const UINT s_TileSize = 16;              //In readback pixels
+        static const ULONGLONG s_ForcedSubmitInterval = 500;
+
+        FrameChangeDetector();
+
+        //Queues the frame's readback and returns true if it should be submitted, which is the case if a change has been seen since the last submit,
+        //there's nothing to compare against yet, the forced submit interval has passed or force_submit is set
+        //Errors are treated as changes, so frames are never dropped because of them
+        bool Update(ID3D11Device* device, ID3D11DeviceContext* device_context, ID3D11Texture2D* texture, bool force_submit);
+        //Maps and compares readbacks the GPU is done with, without waiting on the others
+        void Poll(ID3D11DeviceContext* device_context);
+        //True if the most recent frame passed to Update() should be submitted after all. Call Poll() first
+        bool IsSubmitNeeded() const;
+        //True if there are readbacks not resolved by Poll() yet
+        bool IsPending() const;
+        //The most recent frame passed to Update() was submitted late after IsSubmitNeeded() returned true
+        void OnLatestSubmitted();
+        void Reset();   //Next Update() returns true
+};
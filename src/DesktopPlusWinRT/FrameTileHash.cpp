@@ -0,0 +1,98 @@
+#include "FrameTileHash.h"
+
+#include <string.h>
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__)
+    #define FRAMETILEHASH_USE_SSE
+    #include <emmintrin.h>
+#endif
+
+//Final mix of the tile sums (finalizer from MurmurHash3)
+static uint64_t MixHash(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+
+    return h;
+}
+
+void HashFrameTiles(const uint8_t* data, unsigned int row_pitch, unsigned int width, unsigned int height, unsigned int tile_size, uint64_t* hashes)
+{
+    //Fletcher-style pair of running sums per tile. The second sum makes it position-sensitive, so moved content is detected too
+    //Sums are kept in four 32-bit lanes and only combined at the end, which makes this trivial to vectorize
+    const unsigned int tiles_x = (width  + tile_size - 1) / tile_size;
+    const unsigned int tiles_y = (height + tile_size - 1) / tile_size;
+
+    for (unsigned int tile_y = 0; tile_y < tiles_y; ++tile_y)
+    {
+        const unsigned int row_begin = tile_y * tile_size;
+        const unsigned int row_end   = (std::min)(row_begin + tile_size, height);
+
+        for (unsigned int tile_x = 0; tile_x < tiles_x; ++tile_x)
+        {
+            const unsigned int column_begin = tile_x * tile_size;
+            const unsigned int byte_count   = ((std::min)(column_begin + tile_size, width) - column_begin) * 4;
+
+            #ifdef FRAMETILEHASH_USE_SSE
+                __m128i sum_1 = _mm_setzero_si128();
+                __m128i sum_2 = _mm_setzero_si128();
+
+                for (unsigned int row = row_begin; row < row_end; ++row)
+                {
+                    const uint8_t* row_data = data + (row * row_pitch) + (column_begin * 4);
+                    unsigned int i = 0;
+
+                    for (; i + 16 <= byte_count; i += 16)
+                    {
+                        sum_1 = _mm_add_epi32(sum_1, _mm_loadu_si128((const __m128i*)(row_data + i)));
+                        sum_2 = _mm_add_epi32(sum_2, sum_1);
+                    }
+
+                    if (i < byte_count) //Partial tile at the right edge
+                    {
+                        alignas(16) uint8_t tail[16] = {0};
+                        memcpy(tail, row_data + i, byte_count - i);
+
+                        sum_1 = _mm_add_epi32(sum_1, _mm_load_si128((const __m128i*)tail));
+                        sum_2 = _mm_add_epi32(sum_2, sum_1);
+                    }
+                }
+
+                alignas(16) uint32_t lanes_1[4], lanes_2[4];
+                _mm_store_si128((__m128i*)lanes_1, sum_1);
+                _mm_store_si128((__m128i*)lanes_2, sum_2);
+            #else
+                uint32_t lanes_1[4] = {0}, lanes_2[4] = {0};
+
+                for (unsigned int row = row_begin; row < row_end; ++row)
+                {
+                    const uint8_t* row_data = data + (row * row_pitch) + (column_begin * 4);
+
+                    for (unsigned int i = 0; i < byte_count; i += 16)
+                    {
+                        uint32_t chunk[4] = {0};
+                        memcpy(chunk, row_data + i, (std::min)(byte_count - i, 16u));
+
+                        for (int lane = 0; lane < 4; ++lane)
+                        {
+                            lanes_1[lane] += chunk[lane];
+                            lanes_2[lane] += lanes_1[lane];
+                        }
+                    }
+                }
+            #endif
+
+            uint64_t hash = 0;
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                hash = MixHash(hash ^ ( ((uint64_t)lanes_2[lane] << 32) | lanes_1[lane] ));
+            }
+
+            hashes[(tile_y * tiles_x) + tile_x] = hash;
+        }
+    }
+}
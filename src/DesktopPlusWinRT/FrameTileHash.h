@@ -0,0 +1,7 @@
+#pragma once
+
+#include <stdint.h>
+
+//Tile hashing used by FrameChangeDetector, kept free of Windows headers
+//Hashes 32-bit pixels in tiles of tile_size x tile_size, written row by row into hashes (needs ceil(width/tile_size) * ceil(height/tile_size) elements)
+void HashFrameTiles(const uint8_t* data, unsigned int row_pitch, unsigned int width, unsigned int height, unsigned int tile_size, uint64_t* hashes);
@@ -40,6 +40,10 @@ OverlayCapture::OverlayCapture(winrt::IDirect3DDevice const& device, winrt::Grap
     m_Session = m_FramePool.CreateCaptureSession(m_Item);
     m_FramePool.FrameArrived({ this, &OverlayCapture::OnFrameArrived });
 
+    m_ChangeDetectionTimer = winrt::DispatcherQueue::GetForCurrentThread().CreateTimer();
+    m_ChangeDetectionTimer.Interval(std::chrono::milliseconds(5));
+    m_ChangeDetectionTimer.Tick({ this, &OverlayCapture::OnChangeDetectionTick });
+
     //Disable yellow capture border if possible (Windows SDK 10.0.20348.0 or newer + running on Windows 11)
     #if WINDOWS_FOUNDATION_UNIVERSALAPICONTRACT_VERSION >= 0xc0000
         if (winrt::Metadata::ApiInformation::IsPropertyPresent(L"Windows.Graphics.Capture.GraphicsCaptureSession", L"IsBorderRequired"))
@@ -77,6 +81,7 @@ void OverlayCapture::StartCapture()
 
 void OverlayCapture::RestartCapture()
 {
+    m_FrameHeld = nullptr;
     m_Session.Close();
     m_FramePool.Close();
 
@@ -105,6 +110,18 @@ void OverlayCapture::IsCursorEnabled(bool value)
     }
 }
 
+void OverlayCapture::IsChangeDetectionEnabled(bool value)
+{
+    m_ChangeDetectionEnabled = value;
+    m_ChangeDetector.Reset();
+
+    if (!m_ChangeDetectionEnabled)
+    {
+        m_ChangeDetectionTimer.Stop();
+        m_FrameHeld = nullptr;
+    }
+}
+
 void OverlayCapture::OnOverlayDataRefresh()
 {
     //Find the smallest update limiter delay, count Over-Under & paused overlays
@@ -140,8 +157,11 @@ void OverlayCapture::OnOverlayDataRefresh()
         }
     }
 
-    //Adjust OUConverter cache size as needed
-    m_OUConverters.resize(ou_count);
+    //Free OU converters right away if none are needed anymore. Otherwise the cache drops unused ones on its own
+    if (ou_count == 0)
+    {
+        m_OUConverters.CleanRefs();
+    }
 
     //Make sure the shared textures are set up again on the next update
     m_OverlaySharedTextureSetupsNeeded = 2;
@@ -155,6 +175,9 @@ void OverlayCapture::Close()
     auto expected = false;
     if (m_Closed.compare_exchange_strong(expected, true))
     {
+        m_ChangeDetectionTimer.Stop();
+        m_FrameHeld = nullptr;
+
         m_Session.Close();
 
         //Wait for GraphicsCapture.dll thread to finish up
@@ -173,6 +196,82 @@ void OverlayCapture::Close()
     }
 }
 
+void OverlayCapture::SubmitFrame(ID3D11Device* d3d_device, ID3D11Texture2D* surface_texture, const D3D11_TEXTURE2D_DESC& texture_desc)
+{
+    //Set overlay textures
+    vr::Texture_t vrtex;
+    vrtex.eType = vr::TextureType_DirectX;
+    vrtex.eColorSpace = vr::ColorSpace_Gamma;
+    vrtex.handle = surface_texture;
+
+    m_OUConverters.BeginUpdate();
+
+    vr::VROverlayHandle_t ovrl_shared_source = vr::k_ulOverlayHandleInvalid;
+    for (const auto& overlay : m_Overlays)
+    {
+        if (overlay.IsOverUnder3D)
+        {
+            //Graphics Capture has no dirty rects, so the full texture is converted every time
+            ID3D11Texture2D* tex_sbs = nullptr;
+            HRESULT hr = m_OUConverters.Convert(d3d_device, m_D3DContext.get(), nullptr, nullptr, surface_texture, texture_desc.Width, texture_desc.Height,
+                                                overlay.OU3D_crop_x, overlay.OU3D_crop_y, overlay.OU3D_crop_width, overlay.OU3D_crop_height, nullptr, &tex_sbs);
+
+            if (hr == S_OK)
+            {
+                vr::Texture_t vrtex_ou;
+                vrtex_ou.eType = vr::TextureType_DirectX;
+                vrtex_ou.eColorSpace = vr::ColorSpace_Gamma;
+                vrtex_ou.handle = tex_sbs;
+
+                vr::VROverlay()->SetOverlayTexture(overlay.Handle, &vrtex_ou);
+            }
+        }
+        else if (ovrl_shared_source == vr::k_ulOverlayHandleInvalid) //For the first non-OU3D overlay, set the texture as normal
+        {
+            vr::VROverlay()->SetOverlayTexture(overlay.Handle, &vrtex);
+            ovrl_shared_source = overlay.Handle;
+        }
+        else if (m_OverlaySharedTextureSetupsNeeded > 0) //For all others, set it shared from the normal overlay if an update is needed
+        {
+            SetSharedOverlayTexture(ovrl_shared_source, overlay.Handle, surface_texture);
+        }
+    }
+
+    m_OUConverters.EndUpdate();
+}
+
+void OverlayCapture::OnChangeDetectionTick(winrt::DispatcherQueueTimer const& sender, winrt::IInspectable const&)
+{
+    if ( (m_FrameHeld == nullptr) || (m_Paused) || (!m_ChangeDetectionEnabled) || (m_Closed.load()) )
+    {
+        m_FrameHeld = nullptr;
+        sender.Stop();
+        return;
+    }
+
+    //Keep the held frame until it's either submitted or the forced submit interval passed without changes, so there's nothing left to catch up on
+    m_ChangeDetector.Poll(m_D3DContext.get());
+
+    if (m_ChangeDetector.IsSubmitNeeded())
+    {
+        auto surface_texture = GetDXGIInterfaceFromObject<ID3D11Texture2D>(m_FrameHeld.Surface());
+        auto d3d_device = GetDXGIInterfaceFromObject<ID3D11Device>(m_Device);
+
+        D3D11_TEXTURE2D_DESC texture_desc;
+        surface_texture->GetDesc(&texture_desc);
+
+        //Only submit if the size still matches what the overlays were set up for, otherwise the next frame takes care of it
+        if ( ((int)texture_desc.Width == m_LastTextureSize.Width) && ((int)texture_desc.Height == m_LastTextureSize.Height) )
+        {
+            SubmitFrame(d3d_device.get(), surface_texture.get(), texture_desc);
+            m_ChangeDetector.OnLatestSubmitted();
+        }
+
+        m_FrameHeld = nullptr;
+        sender.Stop();
+    }
+}
+
 void OverlayCapture::OnFrameArrived(winrt::Direct3D11CaptureFramePool const& sender, winrt::IInspectable const&)
 {
     auto frame = sender.TryGetNextFrame();
@@ -197,6 +296,9 @@ void OverlayCapture::OnFrameArrived(winrt::Direct3D11CaptureFramePool const& sen
             return; //Skip frame
     }
 
+    //A frame held back by change detection is superseded by this one
+    m_FrameHeld = nullptr;
+
     bool recreate_frame_pool = false;
 
     //Scope surface texture to release it earlier
@@ -246,45 +348,24 @@ void OverlayCapture::OnFrameArrived(winrt::Direct3D11CaptureFramePool const& sen
             }
         }
 
-        //Set overlay textures
-        vr::Texture_t vrtex;
-        vrtex.eType = vr::TextureType_DirectX;
-        vrtex.eColorSpace = vr::ColorSpace_Gamma;
-        vrtex.handle = surface_texture.get();
-
-        size_t ou_count = 0;
-        vr::VROverlayHandle_t ovrl_shared_source = vr::k_ulOverlayHandleInvalid;
-        for (const auto& overlay : m_Overlays)
+        //Skip submitting frames with unchanged content. The detector compares against the last submitted frame, but only knows about a frame a bit later.
+        //A skipped frame is kept until then and submitted from OnChangeDetectionTick() if it turns out to have changed after all
+        bool is_frame_unchanged = false;
+        if (m_ChangeDetectionEnabled)
         {
-            if (overlay.IsOverUnder3D)
-            {
-                if (ou_count < m_OUConverters.size())
-                {
-                    HRESULT hr = m_OUConverters[ou_count].Convert(d3d_device.get(), m_D3DContext.get(), nullptr, nullptr, surface_texture.get(), texture_desc.Width, texture_desc.Height,
-                                                                  overlay.OU3D_crop_x, overlay.OU3D_crop_y, overlay.OU3D_crop_width, overlay.OU3D_crop_height);
-
-                    if (hr == S_OK)
-                    {
-                        vr::Texture_t vrtex_ou;
-                        vrtex_ou.eType = vr::TextureType_DirectX;
-                        vrtex_ou.eColorSpace = vr::ColorSpace_Gamma;
-                        vrtex_ou.handle = m_OUConverters[ou_count].GetTexture();
-
-                        vr::VROverlay()->SetOverlayTexture(overlay.Handle, &vrtex_ou);
-                    }
+            //Frames are only skipped once shared texture setup is done
+            const bool force_submit = ( (m_OverlaySharedTextureSetupsNeeded != 0) || (recreate_frame_pool) );
+            is_frame_unchanged = !m_ChangeDetector.Update(d3d_device.get(), m_D3DContext.get(), surface_texture.get(), force_submit);
+        }
 
-                    ou_count++;
-                }
-            }
-            else if (ovrl_shared_source == vr::k_ulOverlayHandleInvalid) //For the first non-OU3D overlay, set the texture as normal
-            {
-                vr::VROverlay()->SetOverlayTexture(overlay.Handle, &vrtex);
-                ovrl_shared_source = overlay.Handle;
-            }
-            else if (m_OverlaySharedTextureSetupsNeeded > 0) //For all others, set it shared from the normal overlay if an update is needed
-            {
-                SetSharedOverlayTexture(ovrl_shared_source, overlay.Handle, surface_texture.get());
-            }
+        if (!is_frame_unchanged)
+        {
+            SubmitFrame(d3d_device.get(), surface_texture.get(), texture_desc);
+        }
+        else
+        {
+            m_FrameHeld = frame;
+            m_ChangeDetectionTimer.Start();
         }
     }
 
@@ -4,6 +4,7 @@
 
 #include "ThreadData.h"
 #include "OUtoSBSConverter.h"
+#include "FrameChangeDetector.h"
 
 class OverlayCapture
 {
@@ -17,6 +18,8 @@ public:
 
     bool IsCursorEnabled()                                               { return m_CursorEnabled; }
 	void IsCursorEnabled(bool value);
+    bool IsChangeDetectionEnabled()                                      { return m_ChangeDetectionEnabled; }
+    void IsChangeDetectionEnabled(bool value);
     winrt::Windows::Graphics::Capture::GraphicsCaptureItem CaptureItem() { return m_Item; }
 
     void PauseCapture(bool pause)  { m_Paused = pause; OnOverlayDataRefresh(); }
@@ -28,6 +31,8 @@ public:
 
 private:
     void OnFrameArrived(winrt::Windows::Graphics::Capture::Direct3D11CaptureFramePool const& sender, winrt::Windows::Foundation::IInspectable const& args);
+    void OnChangeDetectionTick(winrt::Windows::System::DispatcherQueueTimer const& sender, winrt::Windows::Foundation::IInspectable const& args);
+    void SubmitFrame(ID3D11Device* d3d_device, ID3D11Texture2D* surface_texture, const D3D11_TEXTURE2D_DESC& texture_desc);
 
     inline void CheckClosed()
     {
@@ -67,5 +72,10 @@ private:
     LARGE_INTEGER m_UpdateLimiterFrequency = {0, 0};
     LARGE_INTEGER m_UpdateLimiterDelay = {0, 0};
 
-    std::vector<OUtoSBSConverter> m_OUConverters; //Rarely used, so the cache is kept here instead of directly as part of the overlay data
+    OUtoSBSConverterCache m_OUConverters;   //Rarely used, so the cache is kept here instead of directly as part of the overlay data. Keyed by crop
+
+    bool m_ChangeDetectionEnabled = false;  //Skip submitting frames with unchanged content
+    FrameChangeDetector m_ChangeDetector;
+    winrt::Windows::Graphics::Capture::Direct3D11CaptureFrame m_FrameHeld { nullptr };         //Latest frame if skipped, until the detector resolved it
+    winrt::Windows::System::DispatcherQueueTimer m_ChangeDetectionTimer { nullptr };            //Resolves the held frame when no new ones arrive
 };
\ No newline at end of file
@@ -4,9 +4,12 @@
 #define NOMINMAX
 #include <windows.h>
 
+#include <memory>
 #include <vector>
 #include "openvr.h"
 
+#include "ConfigSnapshot.h"
+
 struct DPWinRTOverlayData
 {
     vr::VROverlayHandle_t Handle = vr::k_ulOverlayHandleInvalid;
@@ -19,12 +22,19 @@ struct DPWinRTOverlayData
     int OU3D_crop_height = 1;
 };
 
-struct DPWinRTThreadData
+//Overlay data of a capture, published by the main thread and read by the hosting worker thread (the only reader)
+typedef ConfigSnapshot<std::vector<DPWinRTOverlayData>, 1> DPWinRTOverlaySnapshot;
+
+//A single capture item and the overlays it's captured to. Worker threads keep a local copy taken when the capture starts.
+//Overlays are refreshed from OverlaySnapshot on WM_DPLUSWINRT_UPDATE_DATA without locking, so the main thread never waits on workers to change them
+//Tracked by CaptureRegistry on the main thread
+struct DPWinRTCaptureData
 {
-    HANDLE ThreadHandle = nullptr;
-    DWORD ThreadID = 0;
+    unsigned int CaptureID = 0;
+    DWORD ThreadID = 0;                 //Worker thread hosting the capture
     std::vector<DPWinRTOverlayData> Overlays;
+    std::shared_ptr<DPWinRTOverlaySnapshot> OverlaySnapshot;
     HWND SourceWindow = nullptr;
     int DesktopID = -2;
     bool UsePicker = false;
-};
\ No newline at end of file
+};
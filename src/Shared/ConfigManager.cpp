@@ -7,6 +7,7 @@
 #include "Util.h"
 #include "OverlayManager.h"
 #include "InterprocessMessaging.h"
+#include "OverlayProfileCatalogWin32.h"
 #include "WindowList.h"
 #include "DesktopPlusWinRT.h"
 
@@ -31,7 +32,9 @@ OverlayConfigData::OverlayConfigData()
     std::fill(std::begin(ConfigDetachedTransform), std::end(ConfigDetachedTransform), matrix_zero);
 }
 
-ConfigManager::ConfigManager() : m_IsSteamInstall(false)
+ConfigManager::ConfigManager() : m_IsSteamInstall(false),
+                                 m_OverlayProfileCatalogSingle(std::make_unique<OverlayProfileCatalogBackendWin32>(), std::make_unique<DirectoryWatcherWin32>()),
+                                 m_OverlayProfileCatalogMulti( std::make_unique<OverlayProfileCatalogBackendWin32>(), std::make_unique<DirectoryWatcherWin32>())
 {
     std::fill(std::begin(m_ConfigBool),  std::end(m_ConfigBool),  false);
     std::fill(std::begin(m_ConfigInt),   std::end(m_ConfigInt),   -1);
@@ -81,6 +84,10 @@ ConfigManager::ConfigManager() : m_IsSteamInstall(false)
         m_IsSteamInstall = (path_wstr.find(L"\\steamapps\\common\\desktopplus\\desktopplus") != std::wstring::npos); 
     }
 
+    //Set up profile catalogs. They don't touch the file system until first accessed
+    m_OverlayProfileCatalogSingle.SetDirectory(m_ApplicationPath + "profiles/overlays/",       false);
+    m_OverlayProfileCatalogMulti.SetDirectory( m_ApplicationPath + "profiles/multi-overlays/", true);
+
     delete[] buffer;
 
     //Check if UIAccess is enabled
@@ -337,6 +344,8 @@ void ConfigManager::LoadOverlayProfile(const Ini& config, unsigned int overlay_i
     {
         OverlayManager::Get().SetCurrentOverlayNameAuto();
     }
+    #else
+    OverlayManager::Get().UpdateHotState(current_id);
     #endif
 }
 
@@ -528,6 +537,10 @@ bool ConfigManager::LoadConfigFromFile()
     m_ConfigBool[configid_bool_input_mouse_render_intersection_blob]   = config.ReadBool("Mouse", "RenderIntersectionBlob", false);
 	m_ConfigInt[configid_int_input_mouse_dbl_click_assist_duration_ms] = config.ReadInt( "Mouse", "DoubleClickAssistDuration", -1);
 	m_ConfigBool[configid_bool_input_mouse_hmd_pointer_override]       = config.ReadBool("Mouse", "HMDPointerOverride", true);
+    m_ConfigBool[configid_bool_input_mouse_laser_pointer_smoothing]    = config.ReadBool("Mouse", "LaserPointerSmoothing", false);
+    m_ConfigFloat[configid_float_input_mouse_laser_pointer_smoothing_min_cutoff]    = config.ReadInt( "Mouse", "LaserPointerSmoothingMinCutoff",     150) / 100.0f;
+    m_ConfigFloat[configid_float_input_mouse_laser_pointer_smoothing_beta]          = config.ReadInt( "Mouse", "LaserPointerSmoothingBeta",         3000) / 100.0f;
+    m_ConfigFloat[configid_float_input_mouse_laser_pointer_smoothing_prediction_ms] = (float)config.ReadInt( "Mouse", "LaserPointerSmoothingPredictionMS", 0);
 
     m_ConfigBool[configid_bool_input_keyboard_helper_enabled]          = config.ReadBool("Keyboard", "EnableKeyboardHelper", true);
 
@@ -543,6 +556,7 @@ bool ConfigManager::LoadConfigFromFile()
     m_ConfigInt[configid_int_performance_update_limit_fps]               = config.ReadInt( "Performance", "UpdateLimitFPS", update_limit_fps_30);
     m_ConfigBool[configid_bool_performance_rapid_laser_pointer_updates]  = config.ReadBool("Performance", "RapidLaserPointerUpdates", false);
     m_ConfigBool[configid_bool_performance_single_desktop_mirroring]     = config.ReadBool("Performance", "SingleDesktopMirroring", false);
+    m_ConfigBool[configid_bool_performance_winrt_skip_unchanged_frames]  = config.ReadBool("Performance", "WinRTSkipUnchangedFrames", false);
     m_ConfigBool[configid_bool_performance_monitor_large_style]          = config.ReadBool("Performance", "PerformanceMonitorStyleLarge", true);
     m_ConfigBool[configid_bool_performance_monitor_show_graphs]          = config.ReadBool("Performance", "PerformanceMonitorShowGraphs", true);
     m_ConfigBool[configid_bool_performance_monitor_show_time]            = config.ReadBool("Performance", "PerformanceMonitorShowTime", false);
@@ -681,6 +695,8 @@ bool ConfigManager::LoadConfigFromFile()
     #ifndef DPLUS_UI
         if (DPWinRT_IsCaptureCursorEnabledPropertySupported())
             DPWinRT_SetCaptureCursorEnabled(m_ConfigBool[configid_bool_input_mouse_render_cursor]);
+
+        DPWinRT_SetCaptureChangeDetectionEnabled(m_ConfigBool[configid_bool_performance_winrt_skip_unchanged_frames]);
     #endif
 
     #ifndef DPLUS_UI
@@ -898,6 +914,10 @@ void ConfigManager::SaveConfigToFile()
     config.WriteBool("Mouse", "RenderCursor",              m_ConfigBool[configid_bool_input_mouse_render_cursor]);
     config.WriteBool("Mouse", "RenderIntersectionBlob",    m_ConfigBool[configid_bool_input_mouse_render_intersection_blob]);
     config.WriteBool("Mouse", "HMDPointerOverride",        m_ConfigBool[configid_bool_input_mouse_hmd_pointer_override]);
+    config.WriteBool("Mouse", "LaserPointerSmoothing",     m_ConfigBool[configid_bool_input_mouse_laser_pointer_smoothing]);
+    config.WriteInt( "Mouse", "LaserPointerSmoothingMinCutoff",    int(m_ConfigFloat[configid_float_input_mouse_laser_pointer_smoothing_min_cutoff]    * 100.0f));
+    config.WriteInt( "Mouse", "LaserPointerSmoothingBeta",         int(m_ConfigFloat[configid_float_input_mouse_laser_pointer_smoothing_beta]          * 100.0f));
+    config.WriteInt( "Mouse", "LaserPointerSmoothingPredictionMS", int(m_ConfigFloat[configid_float_input_mouse_laser_pointer_smoothing_prediction_ms]));
     config.WriteInt( "Mouse", "DoubleClickAssistDuration", m_ConfigInt[configid_int_input_mouse_dbl_click_assist_duration_ms]);
 
     config.WriteBool("Keyboard", "EnableKeyboardHelper",        m_ConfigBool[configid_bool_input_keyboard_helper_enabled]);
@@ -914,6 +934,7 @@ void ConfigManager::SaveConfigToFile()
     config.WriteInt( "Performance", "UpdateLimitFPS",                       m_ConfigInt[configid_int_performance_update_limit_fps]);
     config.WriteBool("Performance", "RapidLaserPointerUpdates",             m_ConfigBool[configid_bool_performance_rapid_laser_pointer_updates]);
     config.WriteBool("Performance", "SingleDesktopMirroring",               m_ConfigBool[configid_bool_performance_single_desktop_mirroring]);
+    config.WriteBool("Performance", "WinRTSkipUnchangedFrames",             m_ConfigBool[configid_bool_performance_winrt_skip_unchanged_frames]);
     config.WriteBool("Performance", "PerformanceMonitorStyleLarge",         m_ConfigBool[configid_bool_performance_monitor_large_style]);
     config.WriteBool("Performance", "PerformanceMonitorShowGraphs",         m_ConfigBool[configid_bool_performance_monitor_show_graphs]);
     config.WriteBool("Performance", "PerformanceMonitorShowTime",           m_ConfigBool[configid_bool_performance_monitor_show_time]);
@@ -1030,6 +1051,8 @@ void ConfigManager::SaveOverlayProfileToFile(const std::string filename)
 
     SaveOverlayProfile(config);
     config.Save();
+
+    m_OverlayProfileCatalogSingle.Invalidate();
 }
 
 bool ConfigManager::LoadMultiOverlayProfileFromFile(const std::string filename, bool clear_existing_overlays)
@@ -1053,40 +1076,31 @@ void ConfigManager::SaveMultiOverlayProfileToFile(const std::string filename)
 
     SaveMultiOverlayProfile(config);
     config.Save();
+
+    m_OverlayProfileCatalogMulti.Invalidate();
 }
 
 bool ConfigManager::DeleteOverlayProfile(const std::string filename, bool multi_overlay)
 {
     std::string path = m_ApplicationPath + "profiles/" + ((multi_overlay) ? "multi-overlays/" : "overlays/") + filename;
-    return (::DeleteFileW(WStringConvertFromUTF8(path.c_str()).c_str()) != 0);
-}
-
-std::vector<std::string> ConfigManager::GetOverlayProfileList(bool multi_overlay)
-{
-    std::vector<std::string> list;
-    list.emplace_back("Default");
+    bool ret = (::DeleteFileW(WStringConvertFromUTF8(path.c_str()).c_str()) != 0);
 
-    const std::wstring wpath = WStringConvertFromUTF8(std::string(m_ApplicationPath + "profiles/" + ((multi_overlay) ? "multi-overlays" : "overlays") + "/*.ini").c_str());
-    WIN32_FIND_DATA find_data;
-    HANDLE handle_find = ::FindFirstFileW(wpath.c_str(), &find_data);
-
-    if (handle_find != INVALID_HANDLE_VALUE)
-    {
-        do
-        {
-            std::string name = StringConvertFromUTF16(find_data.cFileName);
-            name = name.substr(0, name.length() - 4);   //Remove extension
-
-            list.push_back(name);
-        }
-        while (::FindNextFileW(handle_find, &find_data) != 0);
+    if (multi_overlay)
+        m_OverlayProfileCatalogMulti.Invalidate();
+    else
+        m_OverlayProfileCatalogSingle.Invalidate();
 
-        ::FindClose(handle_find);
-    }
+    return ret;
+}
 
-    list.emplace_back("[New Profile]");
+const std::vector<std::string>& ConfigManager::GetOverlayProfileList(bool multi_overlay)
+{
+    return (multi_overlay) ? m_OverlayProfileCatalogMulti.GetNameList() : m_OverlayProfileCatalogSingle.GetNameList();
+}
 
-    return list;
+const OverlayProfileInfo* ConfigManager::GetOverlayProfileInfo(const std::string& name, bool multi_overlay)
+{
+    return (multi_overlay) ? m_OverlayProfileCatalogMulti.GetProfileInfo(name) : m_OverlayProfileCatalogSingle.GetProfileInfo(name);
 }
 
 WPARAM ConfigManager::GetWParamForConfigID(ConfigID_Bool id)    //This is a no-op, but for consistencies' sake and in case anything changes there, it still exists
@@ -1120,7 +1134,16 @@ void ConfigManager::SetConfigBool(ConfigID_Bool id, bool value)
 void ConfigManager::SetConfigInt(ConfigID_Int id, int value)
 {
     if (id < configid_int_overlay_MAX)
+    {
         OverlayManager::Get().GetCurrentConfigData().ConfigInt[id] = value;
+
+        #ifndef DPLUS_UI
+        if ( (id == configid_int_overlay_capture_source) || (id == configid_int_overlay_update_limit_override_mode) )
+        {
+            OverlayManager::Get().UpdateHotState(OverlayManager::Get().GetCurrentOverlayID());
+        }
+        #endif
+    }
     else if (id < configid_int_MAX)
         m_ConfigInt[id] = value;
 }
@@ -1216,12 +1239,18 @@ std::vector<ActionMainBarOrderData>& ConfigManager::GetActionMainBarOrder()
 
 Matrix4& ConfigManager::GetOverlayDetachedTransform()
 {
-    int origin = GetConfigInt(configid_int_overlay_detached_origin);
+    return GetOverlayDetachedTransform(OverlayManager::Get().GetCurrentOverlayID());
+}
+
+Matrix4& ConfigManager::GetOverlayDetachedTransform(unsigned int overlay_id)
+{
+    OverlayConfigData& data = OverlayManager::Get().GetConfigData(overlay_id);
+    int origin = data.ConfigInt[configid_int_overlay_detached_origin];
 
     if (origin < ovrl_origin_MAX)
-        return OverlayManager::Get().GetCurrentConfigData().ConfigDetachedTransform[origin];
+        return data.ConfigDetachedTransform[origin];
     else
-        return OverlayManager::Get().GetCurrentConfigData().ConfigDetachedTransform[ovrl_origin_room];
+        return data.ConfigDetachedTransform[ovrl_origin_room];
 }
 
 const std::string& ConfigManager::GetApplicationPath() const
@@ -13,6 +13,7 @@
 #include "Matrices.h"
 #include "Actions.h"
 #include "Ini.h"
+#include "OverlayProfileCatalog.h"
 
 //Settings enums
 //These IDs are also passed via IPC
@@ -45,6 +46,7 @@ enum ConfigID_Bool
     configid_bool_interface_warning_welcome_hidden,
     configid_bool_performance_rapid_laser_pointer_updates,
     configid_bool_performance_single_desktop_mirroring,
+    configid_bool_performance_winrt_skip_unchanged_frames,
     configid_bool_performance_monitor_large_style,
     configid_bool_performance_monitor_show_graphs,
     configid_bool_performance_monitor_show_time,
@@ -59,6 +61,7 @@ enum ConfigID_Bool
     configid_bool_input_mouse_render_cursor,
     configid_bool_input_mouse_render_intersection_blob,
     configid_bool_input_mouse_hmd_pointer_override,
+    configid_bool_input_mouse_laser_pointer_smoothing,
     configid_bool_input_keyboard_helper_enabled,
     configid_bool_windows_auto_focus_scene_app_dashboard,
     configid_bool_windows_winrt_auto_focus,
@@ -151,6 +154,9 @@ enum ConfigID_Float
     configid_float_overlay_MAX,
     configid_float_input_detached_interaction_max_distance,
     configid_float_input_global_hmd_pointer_max_distance,
+    configid_float_input_mouse_laser_pointer_smoothing_min_cutoff,  //Hz
+    configid_float_input_mouse_laser_pointer_smoothing_beta,        //Cutoff increase in Hz per 1000 pixels/second of pointer speed
+    configid_float_input_mouse_laser_pointer_smoothing_prediction_ms,
     configid_float_interface_last_vr_ui_scale,
     configid_float_performance_update_limit_ms,
     configid_float_MAX
@@ -286,6 +292,9 @@ class ConfigManager
         std::string m_ExecutableName;
         bool m_IsSteamInstall;
 
+        OverlayProfileCatalog m_OverlayProfileCatalogSingle;
+        OverlayProfileCatalog m_OverlayProfileCatalogMulti;
+
         void LoadOverlayProfile(const Ini& config, unsigned int overlay_id = UINT_MAX);
         void SaveOverlayProfile(Ini& config, unsigned int overlay_id = UINT_MAX);
         void LoadMultiOverlayProfile(const Ini& config, bool clear_existing_overlays = true);
@@ -308,7 +317,8 @@ class ConfigManager
         bool LoadMultiOverlayProfileFromFile(const std::string filename, bool clear_existing_overlays = true);
         void SaveMultiOverlayProfileToFile(const std::string filename);
         bool DeleteOverlayProfile(const std::string filename, bool multi_overlay = false);
-        std::vector<std::string> GetOverlayProfileList(bool multi_overlay = false);
+        const std::vector<std::string>& GetOverlayProfileList(bool multi_overlay = false);          //Cached, only rescans the profile directory after it changed
+        const OverlayProfileInfo* GetOverlayProfileInfo(const std::string& name, bool multi_overlay = false); //Returns nullptr if profile doesn't exist
 
         static WPARAM GetWParamForConfigID(ConfigID_Bool id);
         static WPARAM GetWParamForConfigID(ConfigID_Int id);
@@ -335,7 +345,8 @@ class ConfigManager
         ActionManager& GetActionManager();
         std::vector<CustomAction>& GetCustomActions();
         std::vector<ActionMainBarOrderData>& GetActionMainBarOrder();
-        Matrix4& GetOverlayDetachedTransform();
+        Matrix4& GetOverlayDetachedTransform();                         //Of current overlay
+        Matrix4& GetOverlayDetachedTransform(unsigned int overlay_id);
 
 		const std::string& GetApplicationPath() const;
 		const std::string& GetExecutableName() const;
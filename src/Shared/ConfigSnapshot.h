@@ -0,0 +1,169 @@
+//Immutable, versioned snapshots of data owned by one writer thread and read by any number of worker threads
+//
+//The writer publishes a complete new copy of the data, which is swapped in with a single atomic pointer store. It never waits on readers.
+//Readers grab the current snapshot through a ReadGuard, which costs two atomic stores and one atomic load with no loops or locks (wait-free).
+//Snapshots are never modified after publishing, so a reader can keep using the one it got for the lifetime of its guard.
+//
+//Old snapshots are reclaimed with a simple epoch scheme: each reader slot announces the epoch it started reading in, and the writer
+//only frees retired snapshots once no active reader could still hold them. Reclamation happens on Publish() and never blocks either.
+//
+//Each reader thread needs its own slot, acquired once with RegisterReader(). Slot count is fixed at compile time.
+
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <vector>
+#include <utility>
+
+template<typename T, int ReaderSlotCount = 8>
+class ConfigSnapshot
+{
+    public:
+        static const int k_lReaderSlotInvalid = -1;
+
+        class ReadGuard
+        {
+            private:
+                std::atomic<unsigned long long>* m_SlotEpoch;
+                const T* m_Data;
+                unsigned long long m_Version;
+
+            public:
+                ReadGuard(std::atomic<unsigned long long>* slot_epoch, const T* data, unsigned long long version) : m_SlotEpoch(slot_epoch), m_Data(data), m_Version(version) {}
+                ReadGuard(ReadGuard&& b) : m_SlotEpoch(b.m_SlotEpoch), m_Data(b.m_Data), m_Version(b.m_Version) { b.m_SlotEpoch = nullptr; }
+                ReadGuard(const ReadGuard&) = delete;
+                ReadGuard& operator=(const ReadGuard&) = delete;
+                ~ReadGuard() { if (m_SlotEpoch != nullptr) m_SlotEpoch->store(0); }
+
+                const T& Get() const                { return *m_Data; }
+                const T* operator->() const         { return m_Data; }
+                const T& operator*() const          { return *m_Data; }
+                unsigned long long GetVersion() const { return m_Version; } //Increases with every published snapshot
+        };
+
+    private:
+        struct Node
+        {
+            T Data;
+            unsigned long long Version;
+
+            Node(T&& data, unsigned long long version) : Data(std::move(data)), Version(version) {}
+        };
+
+        std::atomic<const Node*> m_Current;
+        std::atomic<unsigned long long> m_Epoch;                        //Starts at 1, 0 in a reader slot means inactive
+        std::atomic<unsigned long long> m_ReaderEpochs[ReaderSlotCount];
+        std::atomic<bool> m_ReaderSlotUsed[ReaderSlotCount];
+
+        //- Only accessed by writer thread
+        std::vector< std::pair<unsigned long long, const Node*> > m_Retired;   //Epoch at which the node stopped being current, node
+        unsigned long long m_VersionLast;
+
+        void ReclaimRetired()
+        {
+            //Find oldest epoch any reader could currently be reading in
+            unsigned long long epoch_min = ULLONG_MAX;
+            for (const auto& reader_epoch : m_ReaderEpochs)
+            {
+                const unsigned long long epoch = reader_epoch.load();
+
+                if ( (epoch != 0) && (epoch < epoch_min) )
+                {
+                    epoch_min = epoch;
+                }
+            }
+
+            //A node retired at epoch e can only be held by readers that announced an epoch older than e
+            auto it = m_Retired.begin();
+            while (it != m_Retired.end())
+            {
+                if (it->first <= epoch_min)
+                {
+                    delete it->second;
+                    it = m_Retired.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+    public:
+        ConfigSnapshot() : m_Current(new Node(T(), 0)), m_Epoch(1), m_VersionLast(0)
+        {
+            for (int i = 0; i < ReaderSlotCount; ++i)
+            {
+                m_ReaderEpochs[i].store(0);
+                m_ReaderSlotUsed[i].store(false);
+            }
+        }
+
+        ~ConfigSnapshot()
+        {
+            //No readers are expected to exist anymore at this point
+            for (const auto& retired : m_Retired)
+            {
+                delete retired.second;
+            }
+
+            delete m_Current.load();
+        }
+
+        ConfigSnapshot(const ConfigSnapshot&) = delete;
+        ConfigSnapshot& operator=(const ConfigSnapshot&) = delete;
+
+        //- Writer thread only
+        unsigned long long Publish(T data)  //Returns version of the published snapshot
+        {
+            const Node* node_new = new Node(std::move(data), ++m_VersionLast);
+            const Node* node_old = m_Current.exchange(node_new);
+
+            //Readers that announce an epoch after this increment are guaranteed to see the new node
+            m_Retired.emplace_back(m_Epoch.fetch_add(1) + 1, node_old);
+            ReclaimRetired();
+
+            return m_VersionLast;
+        }
+
+        const T& GetWriterCopy() const      //The writer can read the current snapshot without a guard since it's the only one replacing it
+        {
+            return m_Current.load()->Data;
+        }
+
+        //- Any thread
+        int RegisterReader()                //Returns k_lReaderSlotInvalid if all slots are in use
+        {
+            for (int i = 0; i < ReaderSlotCount; ++i)
+            {
+                bool expected = false;
+                if (m_ReaderSlotUsed[i].compare_exchange_strong(expected, true))
+                {
+                    return i;
+                }
+            }
+
+            return k_lReaderSlotInvalid;
+        }
+
+        void UnregisterReader(int reader_slot)
+        {
+            if ( (reader_slot >= 0) && (reader_slot < ReaderSlotCount) )
+            {
+                m_ReaderEpochs[reader_slot].store(0);
+                m_ReaderSlotUsed[reader_slot].store(false);
+            }
+        }
+
+        //- Reader threads, with the slot acquired by RegisterReader(). Guards of the same slot must not overlap
+        ReadGuard Read(int reader_slot)
+        {
+            std::atomic<unsigned long long>& slot_epoch = m_ReaderEpochs[reader_slot];
+
+            slot_epoch.store(m_Epoch.load());
+            const Node* node = m_Current.load();
+
+            return ReadGuard(&slot_epoch, &node->Data, node->Version);
+        }
+};
@@ -2,7 +2,6 @@
 
 #pragma once
 
-#include "Util.h"
 #include "Vectors.h"
 
 // 2D axis aligned bounding-box
@@ -0,0 +1,113 @@
+#include "DirectoryWatcherInotify.h"
+
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <errno.h>
+
+DirectoryWatcherInotify::DirectoryWatcherInotify() : m_FD(-1), m_WatchDescriptor(-1), m_IsSubdirectoriesOnly(false)
+{
+}
+
+DirectoryWatcherInotify::~DirectoryWatcherInotify()
+{
+    if (m_FD != -1)
+    {
+        ::close(m_FD);
+    }
+}
+
+bool DirectoryWatcherInotify::Watch(const std::string& path, bool subdirectories_only)
+{
+    Close();
+
+    if (m_FD == -1)
+    {
+        m_FD = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+        if (m_FD == -1)
+            return false;
+    }
+
+    //Same as the Win32 filters: names and writes of files, or only names of directories. Events for the wrong kind are filtered in PollChanges()
+    const uint32_t mask = (subdirectories_only) ? IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR :
+                                                  IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_MODIFY | IN_CLOSE_WRITE | IN_ONLYDIR;
+
+    m_WatchDescriptor      = ::inotify_add_watch(m_FD, path.c_str(), mask | IN_DELETE_SELF | IN_MOVE_SELF);
+    m_IsSubdirectoriesOnly = subdirectories_only;
+
+    return (m_WatchDescriptor != -1);
+}
+
+void DirectoryWatcherInotify::Close()
+{
+    if (m_WatchDescriptor != -1)
+    {
+        ::inotify_rm_watch(m_FD, m_WatchDescriptor);
+        m_WatchDescriptor = -1;
+    }
+
+    //Drop events still queued for the old watch
+    if (m_FD != -1)
+    {
+        alignas(inotify_event) char buffer[4096];
+        while (::read(m_FD, buffer, sizeof(buffer)) > 0) {}
+    }
+}
+
+bool DirectoryWatcherInotify::IsWatching() const
+{
+    return (m_WatchDescriptor != -1);
+}
+
+bool DirectoryWatcherInotify::PollChanges()
+{
+    if (m_WatchDescriptor == -1)
+        return false;
+
+    bool has_changed   = false;
+    bool is_watch_lost = false;
+    alignas(inotify_event) char buffer[4096];
+
+    for (;;)
+    {
+        const ssize_t length = ::read(m_FD, buffer, sizeof(buffer));
+
+        if (length <= 0)
+            break;
+
+        for (ssize_t pos = 0; pos < length; )
+        {
+            const inotify_event* event = (const inotify_event*)(buffer + pos);
+            pos += sizeof(inotify_event) + event->len;
+
+            //Events were dropped, anything may have changed
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                has_changed = true;
+                continue;
+            }
+
+            if (event->wd != m_WatchDescriptor)
+                continue;
+
+            if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED))
+            {
+                has_changed   = true;
+                is_watch_lost = true;
+            }
+            else if ( (!m_IsSubdirectoriesOnly) || (event->mask & IN_ISDIR) )
+            {
+                has_changed = true;
+            }
+        }
+    }
+
+    //Directory itself is gone, a new watch has to be set up
+    if (is_watch_lost)
+    {
+        ::inotify_rm_watch(m_FD, m_WatchDescriptor);
+        m_WatchDescriptor = -1;
+    }
+
+    return has_changed;
+}
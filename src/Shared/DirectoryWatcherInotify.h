@@ -0,0 +1,25 @@
+//Linux implementation of DirectoryWatcher using inotify
+//Not part of the Windows application, it's built by the tests (see tests/CMakeLists.txt) to check the catalog against real file system changes
+
+#pragma once
+
+#include "OverlayProfileCatalog.h"
+
+class DirectoryWatcherInotify : public DirectoryWatcher
+{
+    private:
+        int m_FD;                       //inotify instance, non-blocking. Kept open between watches
+        int m_WatchDescriptor;          //-1 when not watching
+        bool m_IsSubdirectoriesOnly;
+
+    public:
+        DirectoryWatcherInotify();
+        ~DirectoryWatcherInotify();
+        DirectoryWatcherInotify(const DirectoryWatcherInotify&) = delete;
+        DirectoryWatcherInotify& operator=(const DirectoryWatcherInotify&) = delete;
+
+        bool Watch(const std::string& path, bool subdirectories_only) override;
+        void Close() override;
+        bool IsWatching() const override;
+        bool PollChanges() override;
+};
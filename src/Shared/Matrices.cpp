@@ -272,6 +272,56 @@ Matrix4& Matrix4::invertEuclidean()
 ///////////////////////////////////////////////////////////////////////////////
 Matrix4& Matrix4::invertAffine()
 {
+#ifdef MATRICES_USE_SSE
+    // Desktop+: SSE version of the code below
+    // Rows of R^-1 are the cross products of the columns of R divided by det(R)
+    {
+        const __m128 c0 = _mm_loadu_ps(&m[0]);
+        const __m128 c1 = _mm_loadu_ps(&m[4]);
+        const __m128 c2 = _mm_loadu_ps(&m[8]);
+
+        // cross(a, b) = a.yzx * b.zxy - a.zxy * b.yzx
+        #define MATRICES_SSE_CROSS(a, b) _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2))), \
+                                                    _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1))))
+        __m128 r0 = MATRICES_SSE_CROSS(c1, c2);
+        __m128 r1 = MATRICES_SSE_CROSS(c2, c0);
+        __m128 r2 = MATRICES_SSE_CROSS(c0, c1);
+        #undef MATRICES_SSE_CROSS
+
+        // det = dot(c0, r0), summed in the same order as Matrix3::invert()
+        float prod[4];
+        _mm_storeu_ps(prod, _mm_mul_ps(c0, r0));
+        const float determinant = prod[0] + prod[1] + prod[2];
+
+        // Singular matrices are left to the scalar path, which deals with them the same way as before
+        if (fabs(determinant) > EPSILON)
+        {
+            const __m128 inv_det = _mm_set1_ps(1.0f / determinant);
+            r0 = _mm_mul_ps(inv_det, r0);
+            r1 = _mm_mul_ps(inv_det, r1);
+            r2 = _mm_mul_ps(inv_det, r2);
+            __m128 r3 = _mm_setzero_ps();
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+            // -R^-1 * T
+            __m128 t = _mm_mul_ps(r0, _mm_set1_ps(m[12]));
+            t = _mm_add_ps(t, _mm_mul_ps(r1, _mm_set1_ps(m[13])));
+            t = _mm_add_ps(t, _mm_mul_ps(r2, _mm_set1_ps(m[14])));
+            t = _mm_xor_ps(t, _mm_set1_ps(-0.0f));
+
+            // Keep last row unchanged (0,0,0,1), same as the scalar code
+            const float m3 = m[3], m7 = m[7], m11 = m[11], m15 = m[15];
+            _mm_storeu_ps(&m[0],  r0);
+            _mm_storeu_ps(&m[4],  r1);
+            _mm_storeu_ps(&m[8],  r2);
+            _mm_storeu_ps(&m[12], t);
+            m[3] = m3; m[7] = m7; m[11] = m11; m[15] = m15;
+
+            return *this;
+        }
+    }
+#endif
+
     // R^-1
     Matrix3 r(m[0],m[1],m[2], m[4],m[5],m[6], m[8],m[9],m[10]);
     r.invert();
@@ -442,6 +492,19 @@ float Matrix4::getDeterminant()
 vr::HmdMatrix34_t Matrix4::toOpenVR34()
 {
     vr::HmdMatrix34_t matrixObj;
+
+#ifdef MATRICES_USE_SSE
+    // Transpose columns into rows and drop the last one
+    __m128 col0 = _mm_loadu_ps(&m[0]);
+    __m128 col1 = _mm_loadu_ps(&m[4]);
+    __m128 col2 = _mm_loadu_ps(&m[8]);
+    __m128 col3 = _mm_loadu_ps(&m[12]);
+    _MM_TRANSPOSE4_PS(col0, col1, col2, col3);
+
+    _mm_storeu_ps(matrixObj.m[0], col0);
+    _mm_storeu_ps(matrixObj.m[1], col1);
+    _mm_storeu_ps(matrixObj.m[2], col2);
+#else
 	matrixObj.m[0][0] = m[0];
 	matrixObj.m[1][0] = m[1];
 	matrixObj.m[2][0] = m[2];
@@ -454,6 +517,7 @@ vr::HmdMatrix34_t Matrix4::toOpenVR34()
 	matrixObj.m[0][3] = m[12];
 	matrixObj.m[1][3] = m[13];
 	matrixObj.m[2][3] = m[14];
+#endif
 
     //return {m[0], m[1], m[2],m[4],m[5],m[6],m[8],m[9],m[10],m[12], m[13], m[14]};
     return matrixObj;
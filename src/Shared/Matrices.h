@@ -26,6 +26,14 @@
 #include "Vectors.h"
 #include "openvr.h"
 
+//Desktop+: SSE implementations of the Matrix4 functions used in per-frame transform math
+//Used whenever SSE2 is guaranteed to be available at compile time (always the case on x64). Define MATRICES_NO_SIMD to force the scalar versions.
+//Operations are done in the same order as the scalar code, so results match it (no FMA contraction in either)
+#if !defined(MATRICES_NO_SIMD) && ( defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)) || defined(__SSE2__) )
+    #define MATRICES_USE_SSE
+    #include <emmintrin.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////
 // 2x2 matrix
 ///////////////////////////////////////////////////////////////////////////
@@ -177,6 +185,7 @@ public:
 
 
     Vector3 getTranslation() const;
+    Vector3 transformPoint(const Vector3& point) const;    // Desktop+: M * (x,y,z,1) without the projective row, for affine transforms
     bool    isZero() const;                             // return if the matrix is a zero matrix
 
     Matrix4&    identity();
@@ -679,12 +688,26 @@ inline Matrix4::Matrix4(float m00, float m01, float m02, float m03,
 
 inline Matrix4::Matrix4(const vr::HmdMatrix34_t& src)
 {
+#ifdef MATRICES_USE_SSE
+    //Rows of the 3x4 matrix plus the implicit last row, transposed into columns
+    __m128 row0 = _mm_loadu_ps(src.m[0]);
+    __m128 row1 = _mm_loadu_ps(src.m[1]);
+    __m128 row2 = _mm_loadu_ps(src.m[2]);
+    __m128 row3 = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+    _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+    _mm_storeu_ps(&m[0],  row0);
+    _mm_storeu_ps(&m[4],  row1);
+    _mm_storeu_ps(&m[8],  row2);
+    _mm_storeu_ps(&m[12], row3);
+#else
 	set(
 		src.m[0][0], src.m[1][0], src.m[2][0], 0.0f,
 		src.m[0][1], src.m[1][1], src.m[2][1], 0.0f,
 		src.m[0][2], src.m[1][2], src.m[2][2], 0.0f,
 		src.m[0][3], src.m[1][3], src.m[2][3], 1.0f
 		);
+#endif
 }
 
 inline Matrix4::Matrix4(const Vector3& left, const Vector3& up, const Vector3& forward)
@@ -795,6 +818,24 @@ inline Vector3 Matrix4::getTranslation() const
     return Vector3(m[12], m[13], m[14]);
 }
 
+inline Vector3 Matrix4::transformPoint(const Vector3& point) const
+{
+#ifdef MATRICES_USE_SSE
+    __m128 res = _mm_mul_ps(_mm_loadu_ps(&m[0]), _mm_set1_ps(point.x));
+    res = _mm_add_ps(res, _mm_mul_ps(_mm_loadu_ps(&m[4]), _mm_set1_ps(point.y)));
+    res = _mm_add_ps(res, _mm_mul_ps(_mm_loadu_ps(&m[8]), _mm_set1_ps(point.z)));
+    res = _mm_add_ps(res, _mm_loadu_ps(&m[12]));
+
+    float v[4];
+    _mm_storeu_ps(v, res);
+    return Vector3(v[0], v[1], v[2]);
+#else
+    return Vector3(m[0]*point.x + m[4]*point.y + m[8]*point.z  + m[12],
+                   m[1]*point.x + m[5]*point.y + m[9]*point.z  + m[13],
+                   m[2]*point.x + m[6]*point.y + m[10]*point.z + m[14]);
+#endif
+}
+
 inline Matrix4& Matrix4::identity()
 {
     m[0] = m[5] = m[10] = m[15] = 1.0f;
@@ -848,25 +889,47 @@ inline Matrix4& Matrix4::operator-=(const Matrix4& rhs)
 
 inline Vector4 Matrix4::operator*(const Vector4& rhs) const
 {
+#ifdef MATRICES_USE_SSE
+    __m128 res = _mm_mul_ps(_mm_loadu_ps(&m[0]), _mm_set1_ps(rhs.x));
+    res = _mm_add_ps(res, _mm_mul_ps(_mm_loadu_ps(&m[4]),  _mm_set1_ps(rhs.y)));
+    res = _mm_add_ps(res, _mm_mul_ps(_mm_loadu_ps(&m[8]),  _mm_set1_ps(rhs.z)));
+    res = _mm_add_ps(res, _mm_mul_ps(_mm_loadu_ps(&m[12]), _mm_set1_ps(rhs.w)));
+
+    float v[4];
+    _mm_storeu_ps(v, res);
+    return Vector4(v[0], v[1], v[2], v[3]);
+#else
     return Vector4(m[0]*rhs.x + m[4]*rhs.y + m[8]*rhs.z  + m[12]*rhs.w,
                    m[1]*rhs.x + m[5]*rhs.y + m[9]*rhs.z  + m[13]*rhs.w,
                    m[2]*rhs.x + m[6]*rhs.y + m[10]*rhs.z + m[14]*rhs.w,
                    m[3]*rhs.x + m[7]*rhs.y + m[11]*rhs.z + m[15]*rhs.w);
+#endif
 }
 
 
 
 inline Vector3 Matrix4::operator*(const Vector3& rhs) const
 {
+#ifdef MATRICES_USE_SSE
+    __m128 res = _mm_mul_ps(_mm_loadu_ps(&m[0]), _mm_set1_ps(rhs.x));
+    res = _mm_add_ps(res, _mm_mul_ps(_mm_loadu_ps(&m[4]), _mm_set1_ps(rhs.y)));
+    res = _mm_add_ps(res, _mm_mul_ps(_mm_loadu_ps(&m[8]), _mm_set1_ps(rhs.z)));
+
+    float v[4];
+    _mm_storeu_ps(v, res);
+    return Vector3(v[0], v[1], v[2]);
+#else
     return Vector3(m[0]*rhs.x + m[4]*rhs.y + m[8]*rhs.z,
                    m[1]*rhs.x + m[5]*rhs.y + m[9]*rhs.z,
                    m[2]*rhs.x + m[6]*rhs.y + m[10]*rhs.z);
+#endif
 }
 
 
 
 inline Matrix4 Matrix4::operator*(const Matrix4& n) const
 {
+    //No SSE version here, it measured slower than the scalar code
     return Matrix4(m[0]*n[0]  + m[4]*n[1]  + m[8]*n[2]  + m[12]*n[3],   m[1]*n[0]  + m[5]*n[1]  + m[9]*n[2]  + m[13]*n[3],   m[2]*n[0]  + m[6]*n[1]  + m[10]*n[2]  + m[14]*n[3],   m[3]*n[0]  + m[7]*n[1]  + m[11]*n[2]  + m[15]*n[3],
                    m[0]*n[4]  + m[4]*n[5]  + m[8]*n[6]  + m[12]*n[7],   m[1]*n[4]  + m[5]*n[5]  + m[9]*n[6]  + m[13]*n[7],   m[2]*n[4]  + m[6]*n[5]  + m[10]*n[6]  + m[14]*n[7],   m[3]*n[4]  + m[7]*n[5]  + m[11]*n[6]  + m[15]*n[7],
                    m[0]*n[8]  + m[4]*n[9]  + m[8]*n[10] + m[12]*n[11],  m[1]*n[8]  + m[5]*n[9]  + m[9]*n[10] + m[13]*n[11],  m[2]*n[8]  + m[6]*n[9]  + m[10]*n[10] + m[14]*n[11],  m[3]*n[8]  + m[7]*n[9]  + m[11]*n[10] + m[15]*n[11],
@@ -1,9 +1,14 @@
 #include "OUtoSBSConverter.h"
 
 #include "Util.h"
+#include "OUtoSBSDirtyRect.h"
 
 OUtoSBSConverter::OUtoSBSConverter() : m_TexSBSWidth(0),
-                                       m_TexSBSHeight(0)
+                                       m_TexSBSHeight(0),
+                                       m_LastCropRect(-1, -1, -1, -1),
+                                       m_LastSourceWidth(0),
+                                       m_LastSourceHeight(0),
+                                       m_IsContentValid(false)
 {
 
 }
@@ -18,21 +23,22 @@ ID3D11Texture2D* OUtoSBSConverter::GetTexture() const
     return (m_MultiGPUTexSBSTarget != nullptr) ? m_MultiGPUTexSBSTarget.Get() : m_TexSBS.Get();
 }
 
-HRESULT OUtoSBSConverter::Convert(ID3D11Device* device, ID3D11DeviceContext* device_context, ID3D11Device* multi_gpu_device, ID3D11DeviceContext* multi_gpu_device_context, 
-                                  ID3D11Texture2D* tex_source, int tex_source_width, int tex_source_height, int crop_x, int crop_y, int crop_width, int crop_height)
+HRESULT OUtoSBSConverter::Convert(ID3D11Device* device, ID3D11DeviceContext* device_context, ID3D11Device* multi_gpu_device, ID3D11DeviceContext* multi_gpu_device_context,
+                                  ID3D11Texture2D* tex_source, int tex_source_width, int tex_source_height, int crop_x, int crop_y, int crop_width, int crop_height,
+                                  const DPRect* dirty_rect)
 {
     int sbs_width  = crop_width  * 2;
     int sbs_height = crop_height / 2;
 
     //Resource setup on first time or when dimensions changed
-    if ( (m_TexSBS == nullptr) || (sbs_width != m_TexSBSWidth) || (sbs_height != m_TexSBSHeight) )
+    if ( (m_TexSBS == nullptr) || (sbs_width != m_TexSBSWidth) || (sbs_height != m_TexSBSHeight) || ((multi_gpu_device != nullptr) != (m_MultiGPUTexSBSTarget != nullptr)) )
     {
-        m_TexSBSWidth  = sbs_width;
-        m_TexSBSHeight = sbs_height;
-
         //Delete old resources if they exist
         CleanRefs();
 
+        m_TexSBSWidth  = sbs_width;
+        m_TexSBSHeight = sbs_height;
+
         //Create texture
         D3D11_TEXTURE2D_DESC TexD;
         RtlZeroMemory(&TexD, sizeof(D3D11_TEXTURE2D_DESC));
@@ -53,7 +59,7 @@ HRESULT OUtoSBSConverter::Convert(ID3D11Device* device, ID3D11DeviceContext* dev
             return hr;
 
         //Create textures for multi-gpu processing if needed
-        if (multi_gpu_device != nullptr) 
+        if (multi_gpu_device != nullptr)
         {
             //Staging texture
             TexD.Usage = D3D11_USAGE_STAGING;
@@ -66,10 +72,10 @@ HRESULT OUtoSBSConverter::Convert(ID3D11Device* device, ID3D11DeviceContext* dev
             if (FAILED(hr))
                 return hr;
 
-            //Copy-target texture
-            TexD.Usage = D3D11_USAGE_DYNAMIC;
+            //Copy-target texture. Not dynamic since partial updates need to keep the rest of the content
+            TexD.Usage = D3D11_USAGE_DEFAULT;
             TexD.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-            TexD.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+            TexD.CPUAccessFlags = 0;
             TexD.MiscFlags = 0;
 
             hr = multi_gpu_device->CreateTexture2D(&TexD, nullptr, &m_MultiGPUTexSBSTarget);
@@ -79,27 +85,77 @@ HRESULT OUtoSBSConverter::Convert(ID3D11Device* device, ID3D11DeviceContext* dev
         }
     }
 
-    //Copy top and bottom half of the cropped region into the left and right halves of SBS texture
-    D3D11_BOX source_region;
-    source_region.left   = clamp(crop_x, 0, tex_source_width);
-    source_region.right  = clamp(crop_x + crop_width, 0, tex_source_width);
-    source_region.top    = clamp(crop_y, 0, tex_source_height);
-    source_region.bottom = clamp(crop_y + sbs_height, 0, tex_source_height);
-    source_region.front  = 0;
-    source_region.back   = 1;
+    //Only do a partial update if the existing content matches the source apart from the dirty rect
+    const DPRect crop_rect(crop_x, crop_y, crop_x + crop_width, crop_y + crop_height);
+    const bool is_partial = ( (dirty_rect != nullptr) && (m_IsContentValid) && (crop_rect == m_LastCropRect) && (tex_source_width == m_LastSourceWidth) &&
+                              (tex_source_height == m_LastSourceHeight) );
+
+    //Invalidate until this conversion succeeded
+    m_IsContentValid   = false;
+    m_LastCropRect     = crop_rect;
+    m_LastSourceWidth  = tex_source_width;
+    m_LastSourceHeight = tex_source_height;
+
+    DPRect sbs_rects[2];
+    int sbs_rect_count = 2;
+
+    if (is_partial)
+    {
+        sbs_rect_count = OUtoSBSRemapDirtyRect(*dirty_rect, tex_source_width, tex_source_height, crop_x, crop_y, crop_width, crop_height, sbs_rects);
+    }
+    else
+    {
+        sbs_rects[0] = {0,          0, crop_width, sbs_height};
+        sbs_rects[1] = {crop_width, 0, sbs_width,  sbs_height};
+    }
+
+    //Copy top and bottom half of the cropped region into the left and right halves of SBS texture (limited to what changed)
+    //Rects are in SBS space, source_region is offset back into the respective half and clamped to the source texture
+    DPRect sbs_rect_total(-1, -1, -1, -1);
+
+    for (int i = 0; i < sbs_rect_count; ++i)
+    {
+        const DPRect& sbs_rect = sbs_rects[i];
+        const bool is_right = (sbs_rect.GetTL().x >= crop_width);
+        const int offset_x = crop_x - ((is_right) ? crop_width : 0);
+        const int offset_y = crop_y + ((is_right) ? sbs_height : 0);
 
-    device_context->CopySubresourceRegion(m_TexSBS.Get(), 0, 0, 0, 0, tex_source, 0, &source_region);          //Top -> Left
+        D3D11_BOX source_region;
+        source_region.left   = clamp(sbs_rect.GetTL().x + offset_x, 0, tex_source_width);
+        source_region.right  = clamp(sbs_rect.GetBR().x + offset_x, 0, tex_source_width);
+        source_region.top    = clamp(sbs_rect.GetTL().y + offset_y, 0, tex_source_height);
+        source_region.bottom = clamp(sbs_rect.GetBR().y + offset_y, 0, tex_source_height);
+        source_region.front  = 0;
+        source_region.back   = 1;
 
-    source_region.top    = source_region.bottom;
-    source_region.bottom = clamp((int)source_region.top + sbs_height, 0, tex_source_height);
+        if ( (source_region.left >= source_region.right) || (source_region.top >= source_region.bottom) )
+            continue;
 
-    device_context->CopySubresourceRegion(m_TexSBS.Get(), 0, crop_width, 0, 0, tex_source, 0, &source_region); //Bottom -> Right
+        device_context->CopySubresourceRegion(m_TexSBS.Get(), 0, source_region.left - offset_x, source_region.top - offset_y, 0, tex_source, 0, &source_region);
 
-    //If set up for multi-gpu processing, copy the texture over
-    if (m_MultiGPUTexSBSTarget != nullptr)
+        if (sbs_rect_total.GetTL().x != -1)
+        {
+            sbs_rect_total.Add(sbs_rect);
+        }
+        else
+        {
+            sbs_rect_total = sbs_rect;
+        }
+    }
+
+    //If set up for multi-gpu processing, copy the changed rows over
+    if ( (m_MultiGPUTexSBSTarget != nullptr) && (sbs_rect_total.GetTL().x != -1) )
     {
-        //Same as in OutputManager::RefreshOpenVROverlayTexture
-        device_context->CopyResource(m_MultiGPUTexSBSStaging.Get(), m_TexSBS.Get());
+        //Same as in OutputManager::RefreshOpenVROverlayTexture, but limited to the changed region
+        D3D11_BOX box;
+        box.left   = sbs_rect_total.GetTL().x;
+        box.right  = sbs_rect_total.GetBR().x;
+        box.top    = sbs_rect_total.GetTL().y;
+        box.bottom = sbs_rect_total.GetBR().y;
+        box.front  = 0;
+        box.back   = 1;
+
+        device_context->CopySubresourceRegion(m_MultiGPUTexSBSStaging.Get(), 0, box.left, box.top, 0, m_TexSBS.Get(), 0, &box);
 
         D3D11_MAPPED_SUBRESOURCE mapped_resource_staging;
         RtlZeroMemory(&mapped_resource_staging, sizeof(D3D11_MAPPED_SUBRESOURCE));
@@ -108,19 +164,14 @@ HRESULT OUtoSBSConverter::Convert(ID3D11Device* device, ID3D11DeviceContext* dev
         if (FAILED(hr))
             return hr;
 
-        D3D11_MAPPED_SUBRESOURCE mapped_resource_target;
-        RtlZeroMemory(&mapped_resource_target, sizeof(D3D11_MAPPED_SUBRESOURCE));
-        hr = multi_gpu_device_context->Map(m_MultiGPUTexSBSTarget.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped_resource_target);
-
-        if (FAILED(hr))
-            return hr;
-
-        memcpy(mapped_resource_target.pData, mapped_resource_staging.pData, (size_t)sbs_height * mapped_resource_staging.RowPitch);
+        const BYTE* data_staging = (const BYTE*)mapped_resource_staging.pData + ((size_t)box.top * mapped_resource_staging.RowPitch) + ((size_t)box.left * 4);
+        multi_gpu_device_context->UpdateSubresource(m_MultiGPUTexSBSTarget.Get(), 0, &box, data_staging, mapped_resource_staging.RowPitch, 0);
 
         device_context->Unmap(m_MultiGPUTexSBSStaging.Get(), 0);
-        multi_gpu_device_context->Unmap(m_MultiGPUTexSBSTarget.Get(), 0);
     }
 
+    m_IsContentValid = true;
+
     return S_OK;
 }
 
@@ -129,4 +180,50 @@ void OUtoSBSConverter::CleanRefs()
     m_TexSBS.Reset();
     m_MultiGPUTexSBSStaging.Reset();
     m_MultiGPUTexSBSTarget.Reset();
+    m_IsContentValid = false;
+}
+
+void OUtoSBSConverterCache::BeginUpdate()
+{
+    for (CacheEntry& entry : m_Entries)
+    {
+        entry.IsUsed = false;
+    }
+}
+
+HRESULT OUtoSBSConverterCache::Convert(ID3D11Device* device, ID3D11DeviceContext* device_context, ID3D11Device* multi_gpu_device, ID3D11DeviceContext* multi_gpu_device_context,
+                                       ID3D11Texture2D* tex_source, int tex_source_width, int tex_source_height, int crop_x, int crop_y, int crop_width, int crop_height,
+                                       const DPRect* dirty_rect, ID3D11Texture2D** out_tex)
+{
+    const DPRect crop_rect(crop_x, crop_y, crop_x + crop_width, crop_y + crop_height);
+
+    auto it = std::find_if(m_Entries.begin(), m_Entries.end(), [&](const CacheEntry& entry){ return (entry.CropRect == crop_rect); });
+
+    if (it == m_Entries.end())
+    {
+        m_Entries.emplace_back();
+        it = m_Entries.end() - 1;
+        it->CropRect = crop_rect;
+    }
+
+    if (!it->IsUsed)
+    {
+        it->Result = it->Converter.Convert(device, device_context, multi_gpu_device, multi_gpu_device_context, tex_source, tex_source_width, tex_source_height,
+                                           crop_x, crop_y, crop_width, crop_height, dirty_rect);
+        it->IsUsed = true;
+    }
+
+    *out_tex = (it->Result == S_OK) ? it->Converter.GetTexture() : nullptr;
+
+    return it->Result;
+}
+
+void OUtoSBSConverterCache::EndUpdate()
+{
+    m_Entries.erase(std::remove_if(m_Entries.begin(), m_Entries.end(), [](const CacheEntry& entry){ return !entry.IsUsed; }), m_Entries.end());
+}
+
+void OUtoSBSConverterCache::CleanRefs()
+{
+    m_Entries.clear();
 }
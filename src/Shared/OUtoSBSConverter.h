@@ -3,8 +3,13 @@
 #define NOMINMAX
 #include <d3d11.h>
 #include <wrl/client.h>
+#include <vector>
+
+#include "Util.h"
+#include "DPRect.h"
 
 //This class rearranges an OU 3D texture to a SBS 3D texture
+//The SBS texture is kept between conversions, so only the regions covered by the source's dirty rect need to be copied again
 class OUtoSBSConverter
 {
     private:
@@ -14,13 +19,46 @@ class OUtoSBSConverter
         int m_TexSBSWidth;
         int m_TexSBSHeight;
 
+        //State of the last successful conversion. Partial updates are only possible if these stay the same
+        DPRect m_LastCropRect;
+        int m_LastSourceWidth;
+        int m_LastSourceHeight;
+        bool m_IsContentValid;
+
     public:
         OUtoSBSConverter();
         ~OUtoSBSConverter();
 
         ID3D11Texture2D* GetTexture() const; //Does not add a reference
-        HRESULT Convert(ID3D11Device* device, ID3D11DeviceContext* device_context, ID3D11Device* multi_gpu_device, ID3D11DeviceContext* multi_gpu_device_context, 
-                        ID3D11Texture2D* tex_source, int tex_source_width, int tex_source_height, int crop_x, int crop_y, int crop_width, int crop_height);
+        //dirty_rect is the region of tex_source that changed since the last call, in source texture coordinates. nullptr does a full conversion
+        //It has to be exact (like Desktop Duplication's), anything changed outside of it stays stale in the SBS texture until the next full conversion
+        HRESULT Convert(ID3D11Device* device, ID3D11DeviceContext* device_context, ID3D11Device* multi_gpu_device, ID3D11DeviceContext* multi_gpu_device_context,
+                        ID3D11Texture2D* tex_source, int tex_source_width, int tex_source_height, int crop_x, int crop_y, int crop_width, int crop_height,
+                        const DPRect* dirty_rect = nullptr);
         void CleanRefs();
+};
 
-};
\ No newline at end of file
+//Converters keyed by crop, so overlays sharing the same crop also share a single conversion and output texture
+//Converters not used during an update are dropped at the end of it, as they missed the dirty rect and their content can't be trusted anymore
+class OUtoSBSConverterCache
+{
+    private:
+        struct CacheEntry
+        {
+            DPRect CropRect;
+            bool IsUsed = false;          //Converted during the current update
+            HRESULT Result = S_OK;        //Result of that conversion
+            OUtoSBSConverter Converter;
+        };
+
+        std::vector<CacheEntry> m_Entries;
+
+    public:
+        void BeginUpdate();
+        //Converts with the converter for the crop, unless it already was during this update. out_tex is set to the SBS texture on success
+        HRESULT Convert(ID3D11Device* device, ID3D11DeviceContext* device_context, ID3D11Device* multi_gpu_device, ID3D11DeviceContext* multi_gpu_device_context,
+                        ID3D11Texture2D* tex_source, int tex_source_width, int tex_source_height, int crop_x, int crop_y, int crop_width, int crop_height,
+                        const DPRect* dirty_rect, ID3D11Texture2D** out_tex);
+        void EndUpdate();
+        void CleanRefs();   //Drops all converters
+};
@@ -0,0 +1,31 @@
+#include "OUtoSBSDirtyRect.h"
+
+int OUtoSBSRemapDirtyRect(const DPRect& dirty_rect, int tex_source_width, int tex_source_height, int crop_x, int crop_y, int crop_width, int crop_height,
+                          DPRect out_sbs_rects[2])
+{
+    //Dirty rects can reach outside of the source texture (mouse cursor), so clip them first
+    DPRect dirty_rect_clipped = dirty_rect;
+    dirty_rect_clipped.ClipWithFull({0, 0, tex_source_width, tex_source_height});
+
+    const int sbs_height = crop_height / 2;
+    int rect_count = 0;
+
+    //Top half goes to the left, bottom half to the right. A dirty rect crossing the middle of the crop ends up in both
+    for (int half = 0; half < 2; ++half)
+    {
+        const DPRect half_rect(crop_x, crop_y + (half * sbs_height), crop_x + crop_width, crop_y + ((half + 1) * sbs_height));
+
+        DPRect sbs_rect = dirty_rect_clipped;
+        sbs_rect.ClipWithFull(half_rect);
+
+        //Not using Overlaps() as that's also true for empty rects inside of the half (or any rect against an empty half with a crop height of 1)
+        if ( (sbs_rect.GetWidth() <= 0) || (sbs_rect.GetHeight() <= 0) )
+            continue;
+
+        sbs_rect.Translate({(half * crop_width) - crop_x, -half_rect.GetTL().y});
+
+        out_sbs_rects[rect_count++] = sbs_rect;
+    }
+
+    return rect_count;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "DPRect.h"
+
+//Dirty rect remapping for OUtoSBSConverter's partial updates, kept free of Windows headers
+//Clips a dirty rect in source texture coordinates to the source texture and maps it to the regions of the SBS texture it affects (top half -> left, bottom half -> right)
+//Writes up to 2 rects to out_sbs_rects and returns how many were written
+int OUtoSBSRemapDirtyRect(const DPRect& dirty_rect, int tex_source_width, int tex_source_height, int crop_x, int crop_y, int crop_width, int crop_height,
+                          DPRect out_sbs_rects[2]);
@@ -18,7 +18,11 @@ OverlayManager& OverlayManager::Get()
     return g_OverlayManager;
 }
 
+#ifndef DPLUS_UI
+OverlayManager::OverlayManager() : m_CurrentOverlayID(0), m_DesktopDuplicationRectIndexDirty(true), m_HandleMapDirty(true)
+#else
 OverlayManager::OverlayManager() : m_CurrentOverlayID(0)
+#endif
 {
     //Add a dashboard overlay placeholder so there's always one overlay set up
     AddOverlay(OverlayConfigData());
@@ -49,6 +53,11 @@ unsigned int OverlayManager::AddOverlay(const OverlayConfigData& data, bool is_b
         }
     }
 
+    #ifndef DPLUS_UI
+        ResizeHotState();
+        UpdateHotState(id);
+    #endif
+
     return id;
 }
 
@@ -92,6 +101,10 @@ unsigned int OverlayManager::AddUIOverlay()
     }
     #endif
 
+    #ifndef DPLUS_UI
+        UpdateHotState(id);
+    #endif
+
     return id;
 }
 
@@ -112,9 +125,83 @@ Overlay& OverlayManager::GetCurrentOverlay()
 
 unsigned int OverlayManager::FindOverlayID(vr::VROverlayHandle_t handle)
 {
-    const auto it = std::find_if(m_Overlays.begin(), m_Overlays.end(), [&](const auto& overlay){ return (overlay.GetHandle() == handle); });
+    static_assert(OverlayHandleMap::k_ulIDNone == k_ulOverlayID_None, "OverlayHandleMap not found value needs to match k_ulOverlayID_None");
+
+    if (m_HandleMapDirty)
+    {
+        m_HandleMap.Build(m_HotState.Handle);
+        m_HandleMapDirty = false;
+    }
+
+    return m_HandleMap.Find(handle);
+}
+
+const OverlayHotState& OverlayManager::GetHotState() const
+{
+    return m_HotState;
+}
+
+void OverlayManager::UpdateHotState(unsigned int id)
+{
+    //Overlays can call this while they're being added or removed, so check against all sizes (hot state size is checked by Update())
+    if ( (id >= m_Overlays.size()) || (id >= m_OverlayConfigData.size()) )
+        return;
+
+    const OverlayConfigData& data = m_OverlayConfigData[id];
+    const int changes = m_HotState.Update(id, m_Overlays[id], data.ConfigInt[configid_int_overlay_capture_source], data.ConfigInt[configid_int_overlay_update_limit_override_mode]);
+
+    //Rect index and handle map only need to be rebuilt if anything they depend on changed
+    if (changes & ovrl_hotstate_change_rect_index)
+    {
+        m_DesktopDuplicationRectIndexDirty = true;
+    }
+
+    if (changes & ovrl_hotstate_change_handle)
+    {
+        m_HandleMapDirty = true;
+    }
+}
+
+void OverlayManager::ResizeHotState()
+{
+    static_assert( (ovrl_capsource_desktop_duplication == 0) && (update_limit_mode_off == 0), "OverlayHotState::Resize() defaults need to match config defaults");
+
+    m_HotState.Resize(m_Overlays.size());
+
+    m_DesktopDuplicationRectIndexDirty = true;
+    m_HandleMapDirty = true;
+}
+
+const OverlayRectIndex& OverlayManager::GetDesktopDuplicationRectIndex()
+{
+    if (m_DesktopDuplicationRectIndexDirty)
+    {
+        m_DesktopDuplicationRectIndex.Clear();
+
+        for (unsigned int i = 0; i < m_HotState.Visible.size(); ++i)
+        {
+            if ( (m_HotState.Visible[i]) && 
+                 ( (m_HotState.TextureSource[i] == ovrl_texsource_desktop_duplication) || (m_HotState.TextureSource[i] == ovrl_texsource_desktop_duplication_3dou_converted) ) )
+            {
+                m_DesktopDuplicationRectIndex.AddRect(i, m_HotState.CropRect[i]);
+            }
+        }
+
+        m_DesktopDuplicationRectIndex.Build();
+        m_DesktopDuplicationRectIndexDirty = false;
+    }
+
+    return m_DesktopDuplicationRectIndex;
+}
+
+void OverlayManager::RebuildHotState()
+{
+    ResizeHotState();
 
-    return (it != m_Overlays.end()) ? it->GetID() : k_ulOverlayID_None;
+    for (unsigned int i = 0; i < m_Overlays.size(); ++i)
+    {
+        UpdateHotState(i);
+    }
 }
 
 #endif
@@ -165,6 +252,9 @@ void OverlayManager::SwapOverlays(unsigned int id, unsigned int id2)
     std::iter_swap(m_OverlayConfigData.begin() + id, m_OverlayConfigData.begin() + id2);
 
     #ifndef DPLUS_UI
+        UpdateHotState(id);
+        UpdateHotState(id2);
+
         Overlay& overlay   = GetOverlay(id);
         Overlay& overlay_2 = GetOverlay(id2);
 
@@ -264,6 +354,8 @@ void OverlayManager::RemoveOverlay(unsigned int id)
                 //After swapping around overlay handles, the previously highest ID has been abandonned, so get rid of it manually
                 vr::VROverlay()->DestroyOverlay(FindOverlayHandle(m_Overlays.size()));
 
+                RebuildHotState();
+
                 //After swapping, the states also need to be applied again to the new handles
                 if (OutputManager* outmgr = OutputManager::Get())
                 {
@@ -273,6 +365,7 @@ void OverlayManager::RemoveOverlay(unsigned int id)
             else //It's the last overlay so it can just be straight up erased and everything will be fine
             {
                 m_Overlays.erase(m_Overlays.begin() + id);
+                ResizeHotState();
             }
         #endif
 
@@ -299,6 +392,8 @@ void OverlayManager::RemoveAllOverlays()
     m_CurrentOverlayID = 0;
 
     #ifndef DPLUS_UI
+        ResizeHotState();
+
         //Fixup active overlay counts after we just removed everything that might've been considered active
         if (OutputManager* outmgr = OutputManager::Get())
         {
@@ -3,7 +3,11 @@
 #include "ConfigManager.h"
 
 #ifndef DPLUS_UI
+    #include "Util.h"
     #include "Overlays.h"   //UI app only deals with overlay config data
+    #include "OverlayHotState.h"
+    #include "OverlayRectIndex.h"
+    #include "OverlayHandleMap.h"
 #endif
 
 static const unsigned int k_ulOverlayID_Dashboard = 0;
@@ -19,6 +23,16 @@ class OverlayManager
         #endif
         std::vector<OverlayConfigData> m_OverlayConfigData;
         unsigned int m_CurrentOverlayID;
+        #ifndef DPLUS_UI
+            OverlayHotState m_HotState;
+            OverlayRectIndex m_DesktopDuplicationRectIndex;
+            bool m_DesktopDuplicationRectIndexDirty;
+            OverlayHandleMap m_HandleMap;
+            bool m_HandleMapDirty;
+
+            void ResizeHotState();
+            void RebuildHotState();
+        #endif
 
     public:
         static OverlayManager& Get();
@@ -30,6 +44,9 @@ class OverlayManager
             Overlay& GetOverlay(unsigned int id);
             Overlay& GetCurrentOverlay();
             unsigned int FindOverlayID(vr::VROverlayHandle_t handle);   //Returns k_ulOverlayID_None on error instead of falling back to dashboard
+            const OverlayHotState& GetHotState() const;
+            void UpdateHotState(unsigned int id);                       //Called after state mirrored in OverlayHotState changed for the given overlay
+            const OverlayRectIndex& GetDesktopDuplicationRectIndex();   //Crop rects of visible desktop duplication overlays, rebuilt on access if they changed
         #endif
         OverlayConfigData& GetConfigData(unsigned int id);
         OverlayConfigData& GetCurrentConfigData();
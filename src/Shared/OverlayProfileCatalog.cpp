@@ -0,0 +1,186 @@
+#include "OverlayProfileCatalog.h"
+
+OverlayProfileCatalog::OverlayProfileCatalog(std::unique_ptr<OverlayProfileCatalogBackend> backend, std::unique_ptr<DirectoryWatcher> watcher) :
+    m_Backend(std::move(backend)),
+    m_Watcher(std::move(watcher)),
+    m_IsMultiOverlay(false),
+    m_IsWatchingParent(false),
+    m_NeedsRescan(true)
+{
+}
+
+void OverlayProfileCatalog::SetDirectory(const std::string& path, bool multi_overlay)
+{
+    CloseWatch();
+
+    m_DirectoryPath  = path;
+    m_IsMultiOverlay = multi_overlay;
+    m_NeedsRescan    = true;
+    m_Profiles.clear();
+    m_ProfileIndex.clear();
+}
+
+bool OverlayProfileCatalog::Update()
+{
+    if (m_Watcher->IsWatching())
+    {
+        if (m_Watcher->PollChanges())
+        {
+            m_NeedsRescan = true;
+
+            //A directory was created or removed in the watched parent. Drop the watch so the rescan can watch the profile directory itself or the new closest parent
+            if (m_IsWatchingParent)
+            {
+                CloseWatch();
+            }
+        }
+    }
+    else
+    {
+        //No change notification available at all (not even for a parent directory), so we have to rescan every time like before
+        m_NeedsRescan = true;
+    }
+
+    if (m_NeedsRescan)
+    {
+        Rescan();
+        return true;
+    }
+
+    return false;
+}
+
+void OverlayProfileCatalog::Invalidate()
+{
+    m_NeedsRescan = true;
+
+    //Changes done by this process may have created the directory, so don't stay on the parent
+    if (m_IsWatchingParent)
+    {
+        CloseWatch();
+    }
+}
+
+void OverlayProfileCatalog::CloseWatch()
+{
+    m_Watcher->Close();
+    m_IsWatchingParent = false;
+}
+
+void OverlayProfileCatalog::SetUpWatch()
+{
+    if (m_Watcher->IsWatching())
+        return;
+
+    m_IsWatchingParent = false;
+
+    if (m_Backend->DirectoryExists(m_DirectoryPath))
+    {
+        m_Watcher->Watch(m_DirectoryPath, false);
+        return;
+    }
+
+    //Directory doesn't exist, so there are no profiles until it's created. Watch the closest existing parent for that instead of rescanning on every call.
+    //Intermediate directories being created just move the watch one level closer on the following rescan
+    std::string parent_path = m_DirectoryPath;
+
+    while (!parent_path.empty())
+    {
+        //Strip trailing slashes and the last path component
+        const size_t last_char = parent_path.find_last_not_of("/\\");
+        const size_t slash_pos = (last_char != std::string::npos) ? parent_path.find_last_of("/\\", last_char) : std::string::npos;
+
+        if (slash_pos == std::string::npos)
+            break;
+
+        parent_path.resize(slash_pos + 1);
+
+        if (m_Backend->DirectoryExists(parent_path))
+        {
+            m_IsWatchingParent = m_Watcher->Watch(parent_path, true);
+            break;
+        }
+    }
+
+    //Directory may have been created right before the parent watch was set up
+    if ( (m_IsWatchingParent) && (m_Backend->DirectoryExists(m_DirectoryPath)) )
+    {
+        CloseWatch();
+        SetUpWatch();
+    }
+}
+
+void OverlayProfileCatalog::Rescan()
+{
+    m_NeedsRescan = false;
+
+    //Set up change notification before enumerating so changes happening during the scan aren't missed
+    SetUpWatch();
+
+    std::vector<OverlayProfileInfo> profiles_new;
+    std::unordered_map<std::string, size_t> profile_index_new;
+
+    //Nothing to enumerate while only the parent is watched
+    m_Files.clear();
+
+    if (!m_IsWatchingParent)
+    {
+        m_Backend->ListProfileFiles(m_DirectoryPath, m_Files);
+    }
+
+    profiles_new.reserve(m_Files.size());
+
+    for (OverlayProfileFileInfo& file : m_Files)
+    {
+        //Reuse already parsed metadata if the file looks unchanged
+        const auto it = m_ProfileIndex.find(file.Name);
+        OverlayProfileInfo* profile_old = (it != m_ProfileIndex.end()) ? &m_Profiles[it->second] : nullptr;
+
+        OverlayProfileInfo info;
+
+        if ( (profile_old != nullptr) && (profile_old->FileSize == file.FileSize) && (profile_old->LastWriteTime == file.LastWriteTime) )
+        {
+            info = std::move(*profile_old);
+        }
+        else
+        {
+            info.Name          = std::move(file.Name);
+            info.FileSize      = file.FileSize;
+            info.LastWriteTime = file.LastWriteTime;
+            m_Backend->ReadProfileInfo(m_DirectoryPath, m_IsMultiOverlay, info);
+        }
+
+        profile_index_new[info.Name] = profiles_new.size();
+        profiles_new.push_back(std::move(info));
+    }
+
+    m_Profiles     = std::move(profiles_new);
+    m_ProfileIndex = std::move(profile_index_new);
+
+    //Rebuild name list
+    m_NameList.clear();
+    m_NameList.reserve(m_Profiles.size() + 2);
+    m_NameList.emplace_back("Default");
+
+    for (const auto& profile : m_Profiles)
+    {
+        m_NameList.push_back(profile.Name);
+    }
+
+    m_NameList.emplace_back("[New Profile]");
+}
+
+const std::vector<std::string>& OverlayProfileCatalog::GetNameList()
+{
+    Update();
+    return m_NameList;
+}
+
+const OverlayProfileInfo* OverlayProfileCatalog::GetProfileInfo(const std::string& name)
+{
+    Update();
+
+    const auto it = m_ProfileIndex.find(name);
+
+    return (it != m_ProfileIndex.end()) ? &m_Profiles[it->second] : nullptr;
+}
@@ -0,0 +1,91 @@
+//Cached listing of overlay profiles in one of the profile directories, including basic metadata read from each profile
+//The directory is watched for changes and only rescanned after something in it changed.
+//If the directory doesn't exist, its closest existing parent is watched for created directories instead.
+//Listing profiles therefore doesn't touch the file system in the common case
+//The catalog itself is platform-independent. File system access and change notifications go through OverlayProfileCatalogBackend and DirectoryWatcher,
+//see OverlayProfileCatalogWin32.h for the implementations used by the application and DirectoryWatcherInotify.h for a Linux watcher
+
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+struct OverlayProfileInfo
+{
+    std::string Name;                       //Profile name (file name without extension)
+    std::string OverlayName;                //Name of the first overlay stored in the profile
+    unsigned int OverlayCount = 0;
+    uint64_t FileSize = 0;
+    uint64_t LastWriteTime = 0;             //Used to skip parsing profiles that didn't change on rescan. Only compared for equality
+};
+
+//Change notifications for a single directory
+class DirectoryWatcher
+{
+    public:
+        virtual ~DirectoryWatcher() = default;
+
+        //Starts watching path for files being added, removed or written to, or only for subdirectories being created or removed if subdirectories_only is set
+        //Replaces any previous watch. Returns false if the directory can't be watched
+        virtual bool Watch(const std::string& path, bool subdirectories_only) = 0;
+        virtual void Close() = 0;
+        virtual bool IsWatching() const = 0;
+        //Returns true if anything changed since the watch was set up or the last call. Doesn't block
+        //A watch that can't be kept up after this is closed, so callers have to check IsWatching() again
+        virtual bool PollChanges() = 0;
+};
+
+//Profile file as listed by OverlayProfileCatalogBackend
+struct OverlayProfileFileInfo
+{
+    std::string Name;                       //File name without extension
+    uint64_t FileSize = 0;
+    uint64_t LastWriteTime = 0;
+};
+
+//File system access of the catalog
+class OverlayProfileCatalogBackend
+{
+    public:
+        virtual ~OverlayProfileCatalogBackend() = default;
+
+        virtual bool DirectoryExists(const std::string& path) const = 0;
+        //Lists all profile files (*.ini) in the directory. Leaves files empty if there are none or the directory doesn't exist
+        virtual void ListProfileFiles(const std::string& path, std::vector<OverlayProfileFileInfo>& files) const = 0;
+        //Fills in OverlayName and OverlayCount of the profile named info.Name in the directory
+        virtual void ReadProfileInfo(const std::string& path, bool multi_overlay, OverlayProfileInfo& info) const = 0;
+};
+
+class OverlayProfileCatalog
+{
+    private:
+        std::unique_ptr<OverlayProfileCatalogBackend> m_Backend;
+        std::unique_ptr<DirectoryWatcher> m_Watcher;
+        std::string m_DirectoryPath;            //UTF-8, includes trailing slash
+        bool m_IsMultiOverlay;
+        bool m_IsWatchingParent;                //Watch is for a parent directory as m_DirectoryPath doesn't exist
+        bool m_NeedsRescan;
+        std::vector<OverlayProfileInfo> m_Profiles;
+        std::unordered_map<std::string, size_t> m_ProfileIndex; //Profile name -> index in m_Profiles
+        std::vector<std::string> m_NameList;    //List in the format returned by ConfigManager::GetOverlayProfileList()
+        std::vector<OverlayProfileFileInfo> m_Files;            //Scratch space for Rescan()
+
+        void CloseWatch();
+        void SetUpWatch();
+        void Rescan();
+
+    public:
+        OverlayProfileCatalog(std::unique_ptr<OverlayProfileCatalogBackend> backend, std::unique_ptr<DirectoryWatcher> watcher);
+        OverlayProfileCatalog(const OverlayProfileCatalog&) = delete;
+        OverlayProfileCatalog& operator=(const OverlayProfileCatalog&) = delete;
+
+        void SetDirectory(const std::string& path, bool multi_overlay);
+        bool Update();                          //Checks for changes and rescans if needed. Returns true if the catalog was rescanned
+        void Invalidate();                      //Forces a rescan on next access. Used after changes done by this process to not depend on notification timing
+
+        const std::vector<std::string>& GetNameList();
+        const OverlayProfileInfo* GetProfileInfo(const std::string& name);  //Returns nullptr if the profile doesn't exist
+};
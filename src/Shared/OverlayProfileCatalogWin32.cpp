@@ -0,0 +1,115 @@
+#include "OverlayProfileCatalogWin32.h"
+
+#include <sstream>
+
+#include "Ini.h"
+#include "Util.h"
+
+DirectoryWatcherWin32::DirectoryWatcherWin32() : m_ChangeHandle(INVALID_HANDLE_VALUE)
+{
+}
+
+DirectoryWatcherWin32::~DirectoryWatcherWin32()
+{
+    Close();
+}
+
+bool DirectoryWatcherWin32::Watch(const std::string& path, bool subdirectories_only)
+{
+    Close();
+
+    const DWORD filter = (subdirectories_only) ? FILE_NOTIFY_CHANGE_DIR_NAME : FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+    m_ChangeHandle = ::FindFirstChangeNotificationW(WStringConvertFromUTF8(path.c_str()).c_str(), FALSE, filter);
+
+    return (m_ChangeHandle != INVALID_HANDLE_VALUE);
+}
+
+void DirectoryWatcherWin32::Close()
+{
+    if (m_ChangeHandle != INVALID_HANDLE_VALUE)
+    {
+        ::FindCloseChangeNotification(m_ChangeHandle);
+        m_ChangeHandle = INVALID_HANDLE_VALUE;
+    }
+}
+
+bool DirectoryWatcherWin32::IsWatching() const
+{
+    return (m_ChangeHandle != INVALID_HANDLE_VALUE);
+}
+
+bool DirectoryWatcherWin32::PollChanges()
+{
+    if ( (m_ChangeHandle == INVALID_HANDLE_VALUE) || (::WaitForSingleObject(m_ChangeHandle, 0) != WAIT_OBJECT_0) )
+        return false;
+
+    //Re-arm the notification. If this fails, close the handle and let the next rescan try to get a new one
+    if (::FindNextChangeNotification(m_ChangeHandle) == FALSE)
+    {
+        Close();
+    }
+
+    return true;
+}
+
+bool OverlayProfileCatalogBackendWin32::DirectoryExists(const std::string& path) const
+{
+    return ::DirectoryExists(WStringConvertFromUTF8(path.c_str()).c_str());
+}
+
+void OverlayProfileCatalogBackendWin32::ListProfileFiles(const std::string& path, std::vector<OverlayProfileFileInfo>& files) const
+{
+    const std::wstring wpath = WStringConvertFromUTF8(path.c_str()) + L"*.ini";
+    WIN32_FIND_DATA find_data;
+    HANDLE handle_find = ::FindFirstFileW(wpath.c_str(), &find_data);
+
+    if (handle_find == INVALID_HANDLE_VALUE)
+        return;
+
+    do
+    {
+        OverlayProfileFileInfo file;
+        file.Name = StringConvertFromUTF16(find_data.cFileName);
+        file.Name = file.Name.substr(0, file.Name.length() - 4);   //Remove extension
+        file.FileSize      = ((uint64_t)find_data.nFileSizeHigh << 32) | find_data.nFileSizeLow;
+        file.LastWriteTime = ((uint64_t)find_data.ftLastWriteTime.dwHighDateTime << 32) | find_data.ftLastWriteTime.dwLowDateTime;
+
+        files.push_back(std::move(file));
+    }
+    while (::FindNextFileW(handle_find, &find_data) != 0);
+
+    ::FindClose(handle_find);
+}
+
+void OverlayProfileCatalogBackendWin32::ReadProfileInfo(const std::string& path, bool multi_overlay, OverlayProfileInfo& info) const
+{
+    Ini config(WStringConvertFromUTF8(std::string(path + info.Name + ".ini").c_str()));
+
+    if (multi_overlay)
+    {
+        //Count sequential overlay sections the same way ConfigManager::LoadMultiOverlayProfile() loads them
+        unsigned int overlay_id = 0;
+        std::stringstream ss;
+        ss << "Overlay" << overlay_id;
+
+        while (config.SectionExists(ss.str().c_str()))
+        {
+            if (overlay_id == 0)
+            {
+                info.OverlayName = config.ReadString(ss.str().c_str(), "Name");
+            }
+
+            overlay_id++;
+
+            ss = std::stringstream();
+            ss << "Overlay" << overlay_id;
+        }
+
+        info.OverlayCount = overlay_id;
+    }
+    else
+    {
+        info.OverlayName  = config.ReadString("Overlay", "Name");
+        info.OverlayCount = (config.SectionExists("Overlay")) ? 1 : 0;
+    }
+}
@@ -0,0 +1,34 @@
+//Win32 implementations of the file system access and change notifications used by OverlayProfileCatalog
+
+#pragma once
+
+#include "OverlayProfileCatalog.h"
+
+#define NOMINMAX
+#include <windows.h>
+
+//Uses a change notification handle (FindFirstChangeNotification()), which is re-armed after each signaled poll
+class DirectoryWatcherWin32 : public DirectoryWatcher
+{
+    private:
+        HANDLE m_ChangeHandle;
+
+    public:
+        DirectoryWatcherWin32();
+        ~DirectoryWatcherWin32();
+        DirectoryWatcherWin32(const DirectoryWatcherWin32&) = delete;
+        DirectoryWatcherWin32& operator=(const DirectoryWatcherWin32&) = delete;
+
+        bool Watch(const std::string& path, bool subdirectories_only) override;
+        void Close() override;
+        bool IsWatching() const override;
+        bool PollChanges() override;
+};
+
+class OverlayProfileCatalogBackendWin32 : public OverlayProfileCatalogBackend
+{
+    public:
+        bool DirectoryExists(const std::string& path) const override;
+        void ListProfileFiles(const std::string& path, std::vector<OverlayProfileFileInfo>& files) const override;
+        void ReadProfileInfo(const std::string& path, bool multi_overlay, OverlayProfileInfo& info) const override;
+};
@@ -2,8 +2,10 @@
 
 #include <dwmapi.h>
 #include <Psapi.h>
+#include <algorithm>
 
 #include "Util.h"
+#include "WindowTitleMatcher.h"
 
 bool inline MatchTitleAndClassName(WindowInfo const& window, std::wstring const& title, std::wstring const& className)
 {
@@ -107,9 +109,15 @@ HICON WindowInfo::GetIcon()
     return (Icon == nullptr) ? Icon = GetIcon(WindowHandle) : Icon;
 }
 
-std::vector<WindowInfo> WindowInfo::CreateCapturableWindowList()
+//Enumerates all capturable windows. Optionally also returns the process IDs of the windows
+static std::vector<WindowInfo> EnumerateCapturableWindows(std::vector<DWORD>* process_ids = nullptr)
 {
-    std::vector<WindowInfo> window_list;
+    struct EnumData
+    {
+        std::vector<WindowInfo> WindowList;
+        std::vector<DWORD> ProcessIDs;
+        std::unordered_map<DWORD, std::string> ExeNames;    //Only for this enumeration, processes often have multiple windows
+    } enum_data;
 
     EnumWindows([](HWND hwnd, LPARAM lParam)
                 {
@@ -122,16 +130,45 @@ std::vector<WindowInfo> WindowInfo::CreateCapturableWindowList()
                             return TRUE;
                         }
 
+                        EnumData& enum_data = *(EnumData*)lParam;
+
                         //Since it's capturable, create title for window listing as UTF8, and get the executable name too
-                        window.ExeName = WindowInfo::GetExeName(hwnd);
+                        DWORD process_id = 0;
+                        ::GetWindowThreadProcessId(hwnd, &process_id);
+
+                        auto it = enum_data.ExeNames.find(process_id);
+                        if (it == enum_data.ExeNames.end())
+                        {
+                            it = enum_data.ExeNames.emplace(process_id, WindowInfo::GetExeName(hwnd)).first;
+                        }
+
+                        window.ExeName = it->second;
                         window.ListTitle = "[" + window.ExeName + "]: " + StringConvertFromUTF16(window.Title.c_str());
 
-                        ((std::vector<WindowInfo>*)lParam)->push_back(window);
+                        enum_data.WindowList.push_back(window);
+                        enum_data.ProcessIDs.push_back(process_id);
                     }
 
                     return TRUE;
                 },
-                (LPARAM)&window_list);
+                (LPARAM)&enum_data);
+
+    if (process_ids != nullptr)
+    {
+        *process_ids = std::move(enum_data.ProcessIDs);
+    }
+
+    return enum_data.WindowList;
+}
+
+std::vector<WindowInfo> WindowInfo::CreateCapturableWindowList()
+{
+    std::vector<WindowInfo> window_list;
+
+    if (!WindowRegistry::Get().GetWindowList(window_list))
+    {
+        window_list = EnumerateCapturableWindows();
+    }
 
     return window_list;
 }
@@ -171,7 +208,13 @@ std::string WindowInfo::GetExeName(HWND window_handle)
 HICON WindowInfo::GetIcon(HWND window_handle)
 {
     HICON icon_handle = nullptr;
-    icon_handle = (HICON)::SendMessage(window_handle, WM_GETICON, ICON_BIG, 0);
+
+    //Don't wait long on unresponsive applications, the class icon is good enough then
+    DWORD_PTR result = 0;
+    if (::SendMessageTimeout(window_handle, WM_GETICON, ICON_BIG, 0, SMTO_ABORTIFHUNG | SMTO_BLOCK, 100, &result) != 0)
+    {
+        icon_handle = (HICON)result;
+    }
 
     if (icon_handle == nullptr)
     {
@@ -192,63 +235,292 @@ HWND WindowInfo::FindClosestWindowForTitle(const std::string title_str, const st
     //Apart from that, we try to find matches by removing one space-separated chunk in each iteration (first one is 1:1 match, last just the app-name)
     //This still creates matches for apps that don't have their name after a dash but appended something to the previously known name
     //As a last resort we just match up the first window with the same executable name
+    //See WindowTitleMatcher for the details
 
     std::vector<WindowInfo> window_list = CreateCapturableWindowList();
-    std::wstring title_wstr = WStringConvertFromUTF8(title_str.c_str());
+    WindowTitleMatcher matcher;
+
+    for (const WindowInfo& info : window_list)
+    {
+        matcher.AddWindow(info.Title, info.ExeName);
+    }
+
+    int window_id = matcher.FindClosestWindow(WStringConvertFromUTF8(title_str.c_str()), exe_str);
+
+    return (window_id != -1) ? window_list[window_id].WindowHandle : nullptr;
+}
+
+HWND WindowInfo::FindWindowWithTitle(const wchar_t* title)
+{
+    for (const WindowInfo& info : CreateCapturableWindowList())
+    {
+        if (info.Title == title)
+        {
+            return info.WindowHandle;
+        }
+    }
 
-    //Look for a complete match first
-    auto it = std::find_if(window_list.begin(), window_list.end(), [&](const auto& info){ return ( (info.ExeName == exe_str) && (info.Title == title_wstr) ); });
-    if (it != window_list.end())
+    return nullptr;
+}
+
+void WindowRegistryHooks::Install()
+{
+    ObjectEvents = ::SetWinEventHook(EVENT_OBJECT_CREATE, EVENT_OBJECT_REORDER, nullptr, WinEventProc, 0, 0, WINEVENT_OUTOFCONTEXT);
+    NameChange   = ::SetWinEventHook(EVENT_OBJECT_NAMECHANGE, EVENT_OBJECT_NAMECHANGE, nullptr, WinEventProc, 0, 0, WINEVENT_OUTOFCONTEXT);
+    Cloak        = ::SetWinEventHook(EVENT_OBJECT_CLOAKED, EVENT_OBJECT_UNCLOAKED, nullptr, WinEventProc, 0, 0, WINEVENT_OUTOFCONTEXT);
+    Foreground   = ::SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, nullptr, WinEventProc, 0, 0, WINEVENT_OUTOFCONTEXT);
+}
+
+void WindowRegistryHooks::Remove()
+{
+    for (HWINEVENTHOOK* hook : {&ObjectEvents, &NameChange, &Cloak, &Foreground})
     {
-        return it->WindowHandle;
+        if (*hook != nullptr)
+        {
+            ::UnhookWinEvent(*hook);
+            *hook = nullptr;
+        }
     }
+}
 
-    //Cut off document part of title if it there is one
-    std::wstring title_search = title_wstr;
-    std::wstring app_name;
-    size_t search_pos = title_wstr.rfind(L" - ");
+void WindowRegistryHooks::WinEventProc(HWINEVENTHOOK /*event_hook_handle*/, DWORD win_event, HWND hwnd, LONG id_object, LONG id_child, DWORD /*event_thread*/, 
+                                       DWORD /*event_time*/)
+{
+    //These hooks get events for every UI object in the system (carets, cursors, menu items...), so drop everything that isn't a whole window right away
+    //Reorder events are sent for the container, which isn't necessarily OBJID_WINDOW
+    if ( (hwnd == nullptr) || (id_child != CHILDID_SELF) || ( (id_object != OBJID_WINDOW) && (win_event != EVENT_OBJECT_REORDER) ) )
+        return;
+
+    WindowRegistry::Get().HandleWinEvent(win_event, hwnd);
+}
+
+
+static WindowRegistry g_WindowRegistry;
+
+WindowRegistry& WindowRegistry::Get()
+{
+    return g_WindowRegistry;
+}
 
-    if (search_pos != std::wstring::npos)
+void WindowRegistry::UpdateWindow(HWND window, bool place_window)
+{
+    //Query window state without holding the lock, readers shouldn't have to wait on this
+    WindowInfo info(window);
+
+    if (!IsCapturableWindow(info))
     {
-        app_name = title_wstr.substr(search_pos);
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_List.Remove(window);
+        return;
     }
 
-    //Try to find a partial match by removing the last word from the title string and appending the application name
-    for (;;)
+    DWORD process_id = 0;
+    ::GetWindowThreadProcessId(window, &process_id);
+
+    bool is_process_known = false;
     {
-        if (search_pos == 0)
-            break;
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        is_process_known = m_List.FindExeName(process_id, info.ExeName);
+    }
+
+    if (!is_process_known)
+    {
+        info.ExeName = WindowInfo::GetExeName(window);
+    }
+
+    info.ListTitle = "[" + info.ExeName + "]: " + StringConvertFromUTF16(info.Title.c_str());
 
-        search_pos--;
-        search_pos = title_wstr.find_last_of(L' ', search_pos);
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    if (m_TrackingCount == 0)
+        return;
+
+    //New windows are listed at the bottom, so they need to be placed as well
+    const bool is_new = !m_List.IsListed(window);
+
+    m_List.Set(window, process_id, info.ExeName, info);
+
+    if ( (is_new) || (place_window) )
+    {
+        PlaceWindow(window);
+    }
+}
 
-        if (search_pos != std::wstring::npos)
+void WindowRegistry::PlaceWindow(HWND window)
+{
+    if (!m_List.IsListed(window))
+        return;
+
+    //Walk up the z-order to the next listed window. Only looks at handles, no window is queried
+    HWND window_above = ::GetWindow(window, GW_HWNDPREV);
+
+    while ( (window_above != nullptr) && (!m_List.IsListed(window_above)) )
+    {
+        window_above = ::GetWindow(window_above, GW_HWNDPREV);
+    }
+
+    m_List.MoveBehind(window, window_above);
+}
+
+DWORD WINAPI WindowRegistry::TrackingThreadEntry(void* param)
+{
+    //Make sure the thread has a message queue before signaling that it's running, or the quit message could get lost
+    MSG msg;
+    ::PeekMessage(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+    ::SetEvent((HANDLE)param);
+
+    WindowRegistryHooks hooks;
+    hooks.Install();
+    Get().StartTracking();
+
+    //Event callbacks are called from in here
+    while (::GetMessage(&msg, 0, 0, 0));
+
+    hooks.Remove();
+    Get().StopTracking();
+
+    return 0;
+}
+
+void WindowRegistry::StartTracking()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    if (m_TrackingCount++ != 0)
+        return;
+
+    //Seed with a full enumeration. Events that come in while this is running are handled afterwards and simply re-check the window
+    //The lock is held during this so readers don't see a half-empty list. It only happens once per activation
+    std::vector<DWORD> process_ids;
+    std::vector<WindowInfo> window_list = EnumerateCapturableWindows(&process_ids);
+
+    m_List.Clear();
+    m_IsOrderStale = false;
+
+    for (size_t i = 0; i < window_list.size(); ++i)
+    {
+        m_List.Set(window_list[i].WindowHandle, process_ids[i], window_list[i].ExeName, window_list[i]);
+    }
+}
+
+void WindowRegistry::StopTracking()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    if ( (m_TrackingCount == 0) || (--m_TrackingCount != 0) )
+        return;
+
+    //CreateCapturableWindowList() goes back to enumerating until tracking starts again
+    m_List.Clear();
+}
+
+void WindowRegistry::HandleWinEvent(DWORD win_event, HWND hwnd)
+{
+    switch (win_event)
+    {
+        case EVENT_OBJECT_DESTROY:
         {
-            title_search = title_wstr.substr(0, search_pos) + app_name;
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_List.Remove(hwnd);
+            return;
         }
-        else if (!app_name.empty()) //Last attempt, just the app-name
+        case EVENT_SYSTEM_FOREGROUND:
         {
-            title_search = app_name;
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            PlaceWindow(hwnd);
+            return;
         }
+        case EVENT_OBJECT_REORDER:
+        {
+            //Top-level windows are children of the desktop window, so there's no telling which of them moved
+            const bool is_desktop = (hwnd == ::GetDesktopWindow());
 
-        auto it = std::find_if(window_list.begin(), window_list.end(), [&](const auto& info){ return ( (info.ExeName == exe_str) && (info.Title.find(title_search) != std::wstring::npos) ); });
+            std::lock_guard<std::mutex> lock(m_Mutex);
 
-        if (it != window_list.end())
-        {
-            return it->WindowHandle;
+            if (is_desktop)
+            {
+                m_IsOrderStale = true;
+            }
+            else
+            {
+                PlaceWindow(hwnd);
+            }
+            return;
         }
+        default: break;
+    }
+
+    //Name changes are sent for all kinds of child windows, filter those out cheaply before querying anything else
+    if (::GetAncestor(hwnd, GA_ROOT) != hwnd)
+        return;
+
+    UpdateWindow(hwnd, (win_event == EVENT_OBJECT_SHOW));
+}
+
+void WindowRegistry::StartTrackingThread()
+{
+    if (m_TrackingThread != nullptr)
+        return;
+
+    HANDLE ready_event = ::CreateEvent(nullptr, FALSE, FALSE, nullptr);
+
+    if (ready_event == nullptr)
+        return;
+
+    m_TrackingThread = ::CreateThread(nullptr, 0, TrackingThreadEntry, ready_event, 0, &m_TrackingThreadID);
 
-        if (search_pos == std::wstring::npos)
-            break;
+    if (m_TrackingThread != nullptr)
+    {
+        ::WaitForSingleObject(ready_event, INFINITE);
     }
 
-    //Nothing found, try to get a window from the same exe name at least
-    it = std::find_if(window_list.begin(), window_list.end(), [&](const auto& info){ return (info.ExeName == exe_str); });
+    ::CloseHandle(ready_event);
+}
+
+void WindowRegistry::StopTrackingThread()
+{
+    if (m_TrackingThread == nullptr)
+        return;
 
-    if (it != window_list.end())
+    ::PostThreadMessage(m_TrackingThreadID, WM_QUIT, 0, 0);
+    ::WaitForSingleObject(m_TrackingThread, INFINITE);
+    ::CloseHandle(m_TrackingThread);
+
+    m_TrackingThread   = nullptr;
+    m_TrackingThreadID = 0;
+}
+
+bool WindowRegistry::IsTracking() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return (m_TrackingCount != 0);
+}
+
+bool WindowRegistry::GetWindowList(std::vector<WindowInfo>& window_list)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    if (m_TrackingCount == 0)
+        return false;
+
+    if (m_IsOrderStale)
     {
-        return it->WindowHandle;
+        //Resync the z-order after the desktop's windows got reordered. Only collects handles, which is cheap compared to querying every window
+        std::vector<HWND> window_order;
+        window_order.reserve(512);
+
+        ::EnumWindows([](HWND hwnd, LPARAM lParam)
+                      {
+                          ((std::vector<HWND>*)lParam)->push_back(hwnd);
+                          return TRUE;
+                      },
+                      (LPARAM)&window_order);
+
+        m_List.SetOrder(window_order);
+        m_IsOrderStale = false;
     }
 
-    return nullptr; //We tried
+    m_List.GetData(window_list);
+
+    return true;
 }
@@ -2,10 +2,14 @@
 
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <mutex>
 
 #define NOMINMAX
 #include <windows.h>
 
+#include "WindowRegistryList.h"
+
 struct WindowInfo
 {
     HWND WindowHandle;
@@ -26,4 +30,61 @@ struct WindowInfo
     static std::string GetExeName(HWND window_handle);
     static HICON GetIcon(HWND window_handle);
     static HWND FindClosestWindowForTitle(const std::string title_str, const std::string exe_str);
+    static HWND FindWindowWithTitle(const wchar_t* title);      //Returns the topmost capturable window with exactly that title, or nullptr
+};
+
+//Window event hooks feeding WindowRegistry::Get(), set up for the calling thread. The thread has to process messages for the callbacks to be called
+//Not skipping own process to match window enumeration
+struct WindowRegistryHooks
+{
+    HWINEVENTHOOK ObjectEvents = nullptr;       //EVENT_OBJECT_CREATE to EVENT_OBJECT_REORDER
+    HWINEVENTHOOK NameChange   = nullptr;
+    HWINEVENTHOOK Cloak        = nullptr;
+    HWINEVENTHOOK Foreground   = nullptr;
+
+    void Install();
+    void Remove();
+
+    static void CALLBACK WinEventProc(HWINEVENTHOOK event_hook_handle, DWORD win_event, HWND hwnd, LONG id_object, LONG id_child, DWORD event_thread, DWORD event_time);
+};
+
+//Persistent list of capturable windows, updated incrementally from window events instead of enumerating all windows every time it's needed
+//It's only tracking while something feeds it events (WindowManager's hook thread in the dashboard app, the tracking thread in the UI app),
+//CreateCapturableWindowList() enumerates windows otherwise
+//This includes any time the WindowManager thread is stopped, which happens while no overlays are active. The list is cleared then and seeded again on restart
+//Exe names are cached per process ID for as long as a window of that process is tracked, so new windows of known processes don't need to open the process again
+//Changes to window styles are only picked up on the next show/hide/name change event of the window
+//The list is kept in z-order like enumeration's. Windows are placed on show and EVENT_SYSTEM_FOREGROUND by walking up the z-order from them to the next listed window
+//EVENT_OBJECT_REORDER of a listed window places it the same way. For the desktop window it marks the whole order as stale instead,
+//which is resynced from a handle-only EnumWindows() pass on the next GetWindowList() call
+class WindowRegistry
+{
+    private:
+        mutable std::mutex m_Mutex;
+        WindowRegistryList<HWND, WindowInfo> m_List;
+        unsigned int m_TrackingCount = 0;                           //Threads feeding events, can briefly be more than 1 when they get restarted. Guarded by m_Mutex
+        bool m_IsOrderStale = false;                                //Guarded by m_Mutex
+        HANDLE m_TrackingThread = nullptr;
+        DWORD m_TrackingThreadID = 0;
+
+        void UpdateWindow(HWND window, bool place_window);
+        void PlaceWindow(HWND window);                              //Expects m_Mutex to be locked by the caller
+        static DWORD WINAPI TrackingThreadEntry(void* param);
+
+    public:
+        static WindowRegistry& Get();
+
+        //- Only called by the thread receiving the events. WindowRegistryHooks need to be installed before calling StartTracking() so no events are missed
+        void StartTracking();
+        void StopTracking();
+        //Expects events already filtered to whole windows (OBJID_WINDOW and CHILDID_SELF)
+        void HandleWinEvent(DWORD win_event, HWND hwnd);
+
+        //- Tracking on a thread of its own, for processes without a thread of their own to feed the registry (UI app). Only called by the main thread
+        void StartTrackingThread();
+        void StopTrackingThread();
+
+        //- Can be called from any thread
+        bool IsTracking() const;
+        bool GetWindowList(std::vector<WindowInfo>& window_list);          //Returns false without touching window_list if not tracking
 };
\ No newline at end of file
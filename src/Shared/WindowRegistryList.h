@@ -0,0 +1,154 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <stdint.h>
+
+//Bookkeeping behind WindowRegistry, free of any window queries so it can be fed synthetic events in tests
+//Window data is stored per handle along with the owning process ID. Exe names are cached per process for as long as at least one of its windows is listed,
+//as the process ID may get reused after that
+//Listed windows are kept in z-order, top first. New windows are added at the bottom and moved into place with MoveBehind() as z-order events come in,
+//so seeding the list in enumeration order results in the right order as well. SetOrder() resyncs the whole order from a handle list
+//Not thread-safe, WindowRegistry guards it with its mutex
+template<typename WindowHandle, typename WindowData>
+class WindowRegistryList
+{
+    private:
+        struct WindowEntry
+        {
+            uint32_t ProcessID;
+            WindowData Data;
+            typename std::list<WindowHandle>::iterator OrderIt;
+        };
+
+        struct ProcessEntry
+        {
+            std::string ExeName;
+            unsigned int WindowCount;
+        };
+
+        std::unordered_map<WindowHandle, WindowEntry> m_Windows;
+        std::unordered_map<uint32_t, ProcessEntry> m_Processes;
+        std::list<WindowHandle> m_Order;                            //Listed windows in z-order, top first
+
+    public:
+        void Clear()
+        {
+            m_Windows.clear();
+            m_Processes.clear();
+            m_Order.clear();
+        }
+
+        size_t GetWindowCount() const  { return m_Windows.size(); }
+        size_t GetProcessCount() const { return m_Processes.size(); }
+        bool IsListed(WindowHandle window) const { return (m_Windows.find(window) != m_Windows.end()); }
+
+        //Returns false if no window of the process is listed
+        bool FindExeName(uint32_t process_id, std::string& exe_name) const
+        {
+            auto it = m_Processes.find(process_id);
+
+            if (it == m_Processes.end())
+                return false;
+
+            exe_name = it->second.ExeName;
+            return true;
+        }
+
+        //Adds the window at the bottom of the z-order or replaces its data. A window listed with a different process ID is treated as a new window, as handles can get reused
+        //exe_name is only used if no other window of the process is listed
+        void Set(WindowHandle window, uint32_t process_id, const std::string& exe_name, const WindowData& data)
+        {
+            auto it = m_Windows.find(window);
+
+            if ( (it != m_Windows.end()) && (it->second.ProcessID == process_id) )
+            {
+                it->second.Data = data;
+                return;
+            }
+
+            Remove(window);
+
+            auto it_process = m_Processes.find(process_id);
+            if (it_process != m_Processes.end())
+            {
+                it_process->second.WindowCount++;
+            }
+            else
+            {
+                m_Processes.emplace(process_id, ProcessEntry{exe_name, 1});
+            }
+
+            m_Windows.emplace(window, WindowEntry{process_id, data, m_Order.insert(m_Order.end(), window)});
+        }
+
+        void Remove(WindowHandle window)
+        {
+            auto it = m_Windows.find(window);
+
+            if (it == m_Windows.end())
+                return;
+
+            //Forget the process' exe name once its last window is gone
+            auto it_process = m_Processes.find(it->second.ProcessID);
+            if ( (it_process != m_Processes.end()) && (--it_process->second.WindowCount == 0) )
+            {
+                m_Processes.erase(it_process);
+            }
+
+            m_Order.erase(it->second.OrderIt);
+            m_Windows.erase(it);
+        }
+
+        //Moves the window directly behind window_above in the z-order, or to the top if window_above isn't listed. Does nothing if the window isn't listed
+        void MoveBehind(WindowHandle window, WindowHandle window_above)
+        {
+            auto it = m_Windows.find(window);
+
+            if ( (it == m_Windows.end()) || (window == window_above) )
+                return;
+
+            auto it_above = m_Windows.find(window_above);
+            auto pos = (it_above != m_Windows.end()) ? std::next(it_above->second.OrderIt) : m_Order.begin();
+
+            //Splicing within the list keeps all iterators valid
+            m_Order.splice(pos, m_Order, it->second.OrderIt);
+        }
+
+        //Orders listed windows like window_order (z-order from enumerating window handles). Listed windows missing from window_order end up at the bottom
+        void SetOrder(const std::vector<WindowHandle>& window_order)
+        {
+            auto pos = m_Order.begin();
+
+            for (const WindowHandle& window : window_order)
+            {
+                auto it = m_Windows.find(window);
+
+                if (it == m_Windows.end())
+                    continue;
+
+                if (it->second.OrderIt == pos)
+                {
+                    ++pos;
+                }
+                else
+                {
+                    m_Order.splice(pos, m_Order, it->second.OrderIt);
+                }
+            }
+        }
+
+        //Replaces data with the data of listed windows in z-order
+        void GetData(std::vector<WindowData>& data) const
+        {
+            data.clear();
+            data.reserve(m_Windows.size());
+
+            for (const WindowHandle& window : m_Order)
+            {
+                data.push_back(m_Windows.find(window)->second.Data);
+            }
+        }
+};
@@ -0,0 +1,68 @@
+#include "WindowTitleMatcher.h"
+
+void WindowTitleMatcher::AddWindow(const std::wstring& title, const std::string& exe_name)
+{
+    m_Windows.push_back({&title, &exe_name});
+}
+
+int WindowTitleMatcher::FindClosestWindow(const std::wstring& title, const std::string& exe_name) const
+{
+    //Only windows of the same exe are candidates, collect them once instead of checking on every search
+    std::vector<unsigned int> exe_window_ids;
+
+    for (unsigned int window_id = 0; window_id < (unsigned int)m_Windows.size(); ++window_id)
+    {
+        if (*m_Windows[window_id].ExeName == exe_name)
+        {
+            //Look for a complete match first, nothing can beat it
+            if (*m_Windows[window_id].Title == title)
+                return window_id;
+
+            exe_window_ids.push_back(window_id);
+        }
+    }
+
+    if (exe_window_ids.empty())
+        return -1;
+
+    //Cut off document part of title if it there is one
+    std::wstring title_search = title;
+    std::wstring app_name;
+    size_t search_pos = title.rfind(L" - ");
+
+    if (search_pos != std::wstring::npos)
+    {
+        app_name = title.substr(search_pos);
+    }
+
+    //Try to find a partial match by removing the last word from the title string and appending the application name
+    for (;;)
+    {
+        if (search_pos == 0)
+            break;
+
+        search_pos--;
+        search_pos = title.find_last_of(L' ', search_pos);
+
+        if (search_pos != std::wstring::npos)
+        {
+            title_search = title.substr(0, search_pos) + app_name;
+        }
+        else if (!app_name.empty()) //Last attempt, just the app-name
+        {
+            title_search = app_name;
+        }
+
+        for (unsigned int window_id : exe_window_ids)
+        {
+            if (m_Windows[window_id].Title->find(title_search) != std::wstring::npos)
+                return window_id;
+        }
+
+        if (search_pos == std::wstring::npos)
+            break;
+    }
+
+    //Nothing found, the first window with the same exe name is the match
+    return exe_window_ids.front();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+//Finds the closest match for a previously known window title in a window list, used to re-acquire windows after restarts
+//Windows of the same exe are collected in a single pass that also looks for a complete match, so the search for each shortened title only goes over those
+//Adding windows only stores references, as the matcher is typically used for a single lookup
+//Free of any window types, windows are identified by the order they were added in
+class WindowTitleMatcher
+{
+    private:
+        struct WindowEntry
+        {
+            const std::wstring* Title;
+            const std::string* ExeName;
+        };
+
+        std::vector<WindowEntry> m_Windows;
+
+    public:
+        //Adds a window with the next window ID, starting at 0. Title and exe name are referenced and need to stay valid and unchanged for the lifetime of the matcher
+        void AddWindow(const std::wstring& title, const std::string& exe_name);
+
+        //Returns ID of the best matching window or -1 if there's no window with the same exe name
+        //Match classes in order of preference are complete match, title with trailing words removed (fewer removed is better) and same exe name only
+        //Ties go to the window added first
+        int FindClosestWindow(const std::wstring& title, const std::string& exe_name) const;
+};
@@ -0,0 +1,204 @@
+#include "TestFramework.h"
+
+#include <string>
+
+#include "CaptureRegistry.h"
+
+struct FakeOverlayData
+{
+    vr::VROverlayHandle_t Handle = vr::k_ulOverlayHandleInvalid;
+    bool IsPaused = false;
+};
+
+//Capture of a fake source, identified by name
+struct FakeCaptureData
+{
+    unsigned int CaptureID = 0;
+    unsigned long ThreadID = 0;
+    std::vector<FakeOverlayData> Overlays;
+    std::string Source;
+};
+
+struct FakeWorkerState
+{
+    unsigned long ThreadIDNext = 100;
+    unsigned int StartCount = 0;
+    std::vector<unsigned long> QuitThreadIDs;
+    bool CanStart = true;
+};
+
+class FakeWorkerHost : public CaptureWorkerHost
+{
+    private:
+        FakeWorkerState& m_State;
+
+    public:
+        FakeWorkerHost(FakeWorkerState& state) : m_State(state) {}
+
+        bool StartWorker(CaptureWorkerData& worker) override
+        {
+            if (!m_State.CanStart)
+                return false;
+
+            worker.ThreadID = m_State.ThreadIDNext++;
+            m_State.StartCount++;
+            return true;
+        }
+
+        void QuitWorker(const CaptureWorkerData& worker) override
+        {
+            m_State.QuitThreadIDs.push_back(worker.ThreadID);
+        }
+};
+
+struct FakeRegistry
+{
+    FakeWorkerState Workers;
+    CaptureRegistry<FakeCaptureData> Registry;
+
+    FakeRegistry(unsigned int worker_count_max) : Registry(std::make_unique<FakeWorkerHost>(Workers), worker_count_max) {}
+
+    //Starts a capture of the source for a single overlay, returns its ID or 0 on failure
+    unsigned int StartCapture(const char* source, vr::VROverlayHandle_t overlay_handle)
+    {
+        FakeCaptureData data;
+        data.Source = source;
+        data.Overlays.push_back({overlay_handle});
+
+        const FakeCaptureData* capture = Registry.AddCapture(data);
+        return (capture != nullptr) ? capture->CaptureID : 0;
+    }
+
+    //Same as DPWinRT_StopCapture() does it
+    bool StopCapture(vr::VROverlayHandle_t overlay_handle)
+    {
+        FakeCaptureData* capture = Registry.RemoveOverlay(overlay_handle);
+
+        if (capture == nullptr)
+            return false;
+
+        if (capture->Overlays.empty())
+        {
+            Registry.RemoveCapture(capture->CaptureID);
+        }
+
+        return true;
+    }
+
+    unsigned long GetThreadID(unsigned int capture_id)
+    {
+        const FakeCaptureData* capture = Registry.FindCapture(capture_id);
+        return (capture != nullptr) ? capture->ThreadID : 0;
+    }
+
+    unsigned int GetCaptureCount(unsigned long thread_id)
+    {
+        for (const auto& worker : Registry.GetWorkers())
+        {
+            if (worker.ThreadID == thread_id)
+                return worker.CaptureCount;
+        }
+
+        return 0;
+    }
+};
+
+TEST_CASE(CaptureRegistry_WorkerScheduling)
+{
+    FakeRegistry test(2);
+
+    //New workers are started up to the limit
+    const unsigned int capture_1 = test.StartCapture("Desktop 1", 1);
+    const unsigned int capture_2 = test.StartCapture("Desktop 2", 2);
+    CHECK( (capture_1 != 0) && (capture_2 != 0) && (capture_1 != capture_2) );
+    CHECK(test.Workers.StartCount == 2);
+    CHECK(test.GetThreadID(capture_1) != test.GetThreadID(capture_2));
+
+    //Beyond that, captures share the least busy worker
+    const unsigned int capture_3 = test.StartCapture("Window A", 3);
+    const unsigned int capture_4 = test.StartCapture("Window B", 4);
+    CHECK(test.Workers.StartCount == 2);
+    CHECK(test.GetThreadID(capture_3) != test.GetThreadID(capture_4));
+    CHECK(test.GetCaptureCount(test.GetThreadID(capture_1)) == 2);
+    CHECK(test.GetCaptureCount(test.GetThreadID(capture_2)) == 2);
+
+    //Worker with fewer captures left is picked next
+    const unsigned long thread_id_1 = test.GetThreadID(capture_1);
+    CHECK(test.StopCapture(1));
+    const unsigned int capture_5 = test.StartCapture("Window C", 5);
+    CHECK(test.GetThreadID(capture_5) == thread_id_1);
+
+    //Workers quit once their last capture is gone
+    const unsigned long thread_id_2 = test.GetThreadID(capture_2);
+    CHECK(test.StopCapture(2));
+    const vr::VROverlayHandle_t overlay_handle_other = (test.GetThreadID(capture_3) == thread_id_2) ? 3 : 4;
+    CHECK(test.StopCapture(overlay_handle_other));
+    CHECK(test.Workers.QuitThreadIDs.size() == 1);
+    CHECK(test.Workers.QuitThreadIDs.back() == thread_id_2);
+    CHECK(test.Registry.GetWorkers().size() == 1);
+
+    //...and are started again when needed
+    test.StartCapture("Desktop 2", 2);
+    CHECK(test.Workers.StartCount == 3);
+    CHECK(test.Registry.GetWorkers().size() == 2);
+}
+
+TEST_CASE(CaptureRegistry_WorkerStartFailure)
+{
+    FakeRegistry test(4);
+
+    //No worker to fall back to, nothing is added
+    test.Workers.CanStart = false;
+    CHECK(test.StartCapture("Desktop 1", 1) == 0);
+    CHECK(test.Registry.GetCaptures().empty());
+    CHECK(test.Registry.GetWorkers().empty());
+
+    //Existing worker is used when another one can't be started
+    test.Workers.CanStart = true;
+    const unsigned int capture_1 = test.StartCapture("Desktop 1", 1);
+    test.Workers.CanStart = false;
+    const unsigned int capture_2 = test.StartCapture("Desktop 2", 2);
+    CHECK(capture_2 != 0);
+    CHECK(test.GetThreadID(capture_1) == test.GetThreadID(capture_2));
+    CHECK(test.GetCaptureCount(test.GetThreadID(capture_1)) == 2);
+}
+
+TEST_CASE(CaptureRegistry_OverlayLookup)
+{
+    FakeRegistry test(2);
+
+    const unsigned int capture_1 = test.StartCapture("Desktop 1", 1);
+    const unsigned int capture_2 = test.StartCapture("Window A", 2);
+
+    //Second overlay on the same capture, like DPWinRT_StartCaptureFromOverlay() does
+    FakeCaptureData* capture = nullptr;
+    CHECK(test.Registry.FindOverlay(1, capture) != nullptr);
+    CHECK( (capture != nullptr) && (capture->CaptureID == capture_1) );
+    capture->Overlays.push_back({3});
+
+    FakeOverlayData* overlay_data = test.Registry.FindOverlay(3, capture);
+    CHECK( (overlay_data != nullptr) && (overlay_data->Handle == 3) && (capture->CaptureID == capture_1) );
+    overlay_data->IsPaused = true;
+    CHECK(test.Registry.FindCapture(capture_1)->Overlays[1].IsPaused);
+
+    CHECK(test.Registry.FindOverlay(2, capture) != nullptr);
+    CHECK(capture->CaptureID == capture_2);
+
+    //Unknown handle
+    CHECK(test.Registry.FindOverlay(42, capture) == nullptr);
+    CHECK(capture == nullptr);
+    CHECK(!test.StopCapture(42));
+
+    //Removing one overlay keeps the capture while others are left
+    CHECK(test.StopCapture(1));
+    CHECK(test.Registry.FindCapture(capture_1) != nullptr);
+    CHECK(test.Registry.FindOverlay(1, capture) == nullptr);
+    CHECK(test.Registry.FindOverlay(3, capture) != nullptr);
+
+    CHECK(test.StopCapture(3));
+    CHECK(test.Registry.FindCapture(capture_1) == nullptr);
+    CHECK(test.Registry.GetCaptures().size() == 1);
+
+    //Capture IDs aren't reused
+    CHECK(test.StartCapture("Desktop 1", 1) > capture_2);
+}
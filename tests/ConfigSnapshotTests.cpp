@@ -0,0 +1,259 @@
+#include "TestFramework.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "ConfigSnapshot.h"
+
+//Snapshot payload that makes torn reads and use-after-free visible: all values match the version and the magic is wiped on destruction
+struct SnapshotTestData
+{
+    static const unsigned int k_Magic = 0x5EED1234;
+    static std::atomic<int> s_LiveCount;
+
+    unsigned int Magic = k_Magic;
+    unsigned long long Values[16] = {0};
+
+    SnapshotTestData()                                  { s_LiveCount++; }
+    SnapshotTestData(const SnapshotTestData& b)         { s_LiveCount++; *this = b; }
+    SnapshotTestData(SnapshotTestData&& b)              { s_LiveCount++; *this = b; }
+    SnapshotTestData& operator=(const SnapshotTestData& b)
+    {
+        Magic = b.Magic;
+        for (int i = 0; i < 16; ++i)
+            Values[i] = b.Values[i];
+        return *this;
+    }
+    ~SnapshotTestData()                                 { Magic = 0; s_LiveCount--; }
+
+    bool IsConsistent(unsigned long long version) const
+    {
+        if (Magic != k_Magic)
+            return false;
+
+        for (unsigned long long value : Values)
+        {
+            if (value != version)
+                return false;
+        }
+
+        return true;
+    }
+};
+
+std::atomic<int> SnapshotTestData::s_LiveCount(0);
+
+TEST_CASE(ConfigSnapshot_PublishAndRead)
+{
+    ConfigSnapshot<SnapshotTestData, 2> snapshot;
+    const int slot = snapshot.RegisterReader();
+    CHECK(slot != snapshot.k_lReaderSlotInvalid);
+
+    {
+        const auto guard = snapshot.Read(slot);
+        CHECK(guard.GetVersion() == 0);
+        CHECK(guard->IsConsistent(0));
+    }
+
+    SnapshotTestData data;
+    for (auto& value : data.Values)
+        value = 1;
+
+    CHECK(snapshot.Publish(data) == 1);
+    CHECK(snapshot.GetWriterCopy().IsConsistent(1));
+
+    {
+        const auto guard = snapshot.Read(slot);
+        CHECK(guard.GetVersion() == 1);
+        CHECK(guard->IsConsistent(1));
+    }
+
+    snapshot.UnregisterReader(slot);
+}
+
+TEST_CASE(ConfigSnapshot_ReaderSlots)
+{
+    ConfigSnapshot<int, 2> snapshot;
+
+    const int slot_a = snapshot.RegisterReader();
+    const int slot_b = snapshot.RegisterReader();
+    CHECK( (slot_a != snapshot.k_lReaderSlotInvalid) && (slot_b != snapshot.k_lReaderSlotInvalid) && (slot_a != slot_b) );
+    CHECK(snapshot.RegisterReader() == snapshot.k_lReaderSlotInvalid);
+
+    snapshot.UnregisterReader(slot_a);
+    CHECK(snapshot.RegisterReader() == slot_a);
+}
+
+TEST_CASE(ConfigSnapshot_HeldGuardKeepsSnapshotAlive)
+{
+    const int live_count_start = SnapshotTestData::s_LiveCount;
+
+    {
+        ConfigSnapshot<SnapshotTestData, 2> snapshot;
+        const int slot = snapshot.RegisterReader();
+
+        SnapshotTestData data;
+        for (auto& value : data.Values)
+            value = 1;
+
+        snapshot.Publish(data);
+
+        {
+            const auto guard = snapshot.Read(slot);
+
+            //Publish a bunch of newer versions while the old one is still held
+            for (unsigned long long version = 2; version < 100; ++version)
+            {
+                for (auto& value : data.Values)
+                    value = version;
+
+                snapshot.Publish(data);
+            }
+
+            CHECK(guard.GetVersion() == 1);
+            CHECK(guard->IsConsistent(1));
+        }
+
+        //Once released, the next publish reclaims everything but the current snapshot
+        snapshot.Publish(data);
+        CHECK(SnapshotTestData::s_LiveCount == live_count_start + 2);   //data + current snapshot
+
+        snapshot.UnregisterReader(slot);
+    }
+
+    CHECK(SnapshotTestData::s_LiveCount == live_count_start);
+}
+
+//One writer publishing as fast as it can while several readers verify every snapshot they see
+TEST_CASE(ConfigSnapshot_ConcurrencyStress)
+{
+    const int k_ReaderCount = 6;
+    const unsigned long long k_PublishCount = (TestRegistry::IsQuickMode()) ? 20000 : 200000;
+    const int live_count_start = SnapshotTestData::s_LiveCount;
+
+    {
+        ConfigSnapshot<SnapshotTestData, 8> snapshot;
+        std::atomic<bool> writer_done(false);
+        std::atomic<int> failure_count(0);
+        std::atomic<unsigned long long> read_count(0);
+        std::vector<std::thread> readers;
+
+        for (int i = 0; i < k_ReaderCount; ++i)
+        {
+            readers.emplace_back([&]()
+            {
+                const int slot = snapshot.RegisterReader();
+
+                if (slot == snapshot.k_lReaderSlotInvalid)
+                {
+                    failure_count++;
+                    return;
+                }
+
+                unsigned long long version_last = 0;
+                unsigned long long reads = 0;
+
+                while (!writer_done.load())
+                {
+                    const auto guard = snapshot.Read(slot);
+
+                    //Versions never go backwards for a reader and the data always matches the version it came with
+                    if ( (guard.GetVersion() < version_last) || (!guard->IsConsistent(guard.GetVersion())) )
+                    {
+                        failure_count++;
+                    }
+
+                    version_last = guard.GetVersion();
+                    reads++;
+                }
+
+                read_count += reads;
+                snapshot.UnregisterReader(slot);
+            });
+        }
+
+        SnapshotTestData data;
+
+        for (unsigned long long version = 1; version <= k_PublishCount; ++version)
+        {
+            for (auto& value : data.Values)
+                value = version;
+
+            if (snapshot.Publish(data) != version)
+            {
+                failure_count++;
+            }
+        }
+
+        writer_done = true;
+
+        for (auto& reader : readers)
+        {
+            reader.join();
+        }
+
+        CHECK(failure_count == 0);
+        CHECK(read_count > 0);
+        CHECK(snapshot.GetWriterCopy().IsConsistent(k_PublishCount));
+    }
+
+    //Every snapshot got freed in the end, either by reclamation or by the destructor
+    CHECK(SnapshotTestData::s_LiveCount == live_count_start);
+}
+
+//Single reader copying out a variable-size list, like the WinRT capture workers do with their overlay data
+TEST_CASE(ConfigSnapshot_SingleReaderListCopy)
+{
+    const unsigned long long k_PublishCount = (TestRegistry::IsQuickMode()) ? 20000 : 200000;
+
+    ConfigSnapshot<std::vector<unsigned long long>, 1> snapshot;
+    std::atomic<bool> writer_done(false);
+    std::atomic<int> failure_count(0);
+
+    std::thread reader([&]()
+    {
+        const int slot = snapshot.RegisterReader();
+        std::vector<unsigned long long> local_copy;
+
+        if (slot == snapshot.k_lReaderSlotInvalid)
+        {
+            failure_count++;
+            return;
+        }
+
+        while (!writer_done.load())
+        {
+            unsigned long long version;
+            {
+                const auto guard = snapshot.Read(slot);
+                local_copy = guard.Get();
+                version    = guard.GetVersion();
+            }
+
+            //Size and contents both derive from the version, so a torn or freed list shows up here
+            if (local_copy.size() != version % 7)
+            {
+                failure_count++;
+            }
+
+            for (unsigned long long value : local_copy)
+            {
+                if (value != version)
+                    failure_count++;
+            }
+        }
+
+        snapshot.UnregisterReader(slot);
+    });
+
+    for (unsigned long long version = 1; version <= k_PublishCount; ++version)
+    {
+        snapshot.Publish(std::vector<unsigned long long>(version % 7, version));
+    }
+
+    writer_done = true;
+    reader.join();
+
+    CHECK(failure_count == 0);
+}
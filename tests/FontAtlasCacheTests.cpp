@@ -0,0 +1,207 @@
+#include "TestFramework.h"
+
+#include <cfloat>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include "FontAtlasCache.h"
+#include "imgui_internal.h"
+
+//Built atlas like TextureManager creates it: two fonts and custom rects, one of them not making it into the cache
+struct TestAtlas
+{
+    ImFontAtlas Atlas;
+    std::vector<FontAtlasCacheRect> Rects;
+    uint64_t Key;
+
+    TestAtlas()
+    {
+        Atlas.AddFontDefault();
+
+        ImFontConfig config;
+        config.SizePixels = 26.0f;
+        Atlas.AddFontDefault(&config);
+
+        const int rect_id = Atlas.AddCustomRectRegular(30, 20);
+        Atlas.Build();
+
+        unsigned char* pixels;
+        int width, height;
+        Atlas.GetTexDataAsRGBA32(&pixels, &width, &height);
+
+        const ImFontAtlasCustomRect* rect = Atlas.GetCustomRectByIndex(rect_id);
+        Rects.push_back({rect_id, rect->X, rect->Y, rect->Width, rect->Height});
+        Rects.push_back({});
+
+        //Something that isn't a glyph in the custom rect's area, like a window icon would be
+        for (int y = 0; y < rect->Height; ++y)
+        {
+            for (int x = 0; x < rect->Width; ++x)
+            {
+                Atlas.TexPixelsRGBA32[((rect->Y + y) * Atlas.TexWidth) + rect->X + x] = 0x12345678u * (x + 1) + y;
+            }
+        }
+
+        Atlas.ClearInputData();
+
+        FontAtlasCacheKey key;
+        key.AddString("fonts/default.ttf");
+        key.AddFloat(26.0f);
+        key.AddInt(rect_id);
+        Key = key.GetValue();
+    }
+
+    std::string Save() const
+    {
+        std::stringstream stream;
+        CHECK(FontAtlasCache::Save(stream, Key, Atlas, Rects));
+        return stream.str();
+    }
+};
+
+static bool Load(const std::string& data, uint64_t key, ImFontAtlas& atlas, std::vector<FontAtlasCacheRect>& rects)
+{
+    std::istringstream stream(data);
+    return FontAtlasCache::Load(stream, key, atlas, rects);
+}
+
+TEST_CASE(FontAtlasCache_RoundTrip)
+{
+    const TestAtlas source;
+    const ImFontAtlas& atlas = source.Atlas;
+
+    ImFontAtlas loaded;
+    std::vector<FontAtlasCacheRect> rects;
+    CHECK(Load(source.Save(), source.Key, loaded, rects));
+
+    //Texture
+    CHECK(loaded.IsBuilt());
+    CHECK( (loaded.TexWidth == atlas.TexWidth) && (loaded.TexHeight == atlas.TexHeight) );
+    CHECK( (loaded.TexPixelsRGBA32 != nullptr) && (memcmp(loaded.TexPixelsRGBA32, atlas.TexPixelsRGBA32, atlas.TexWidth * atlas.TexHeight * 4) == 0) );
+    CHECK( (loaded.TexUvScale.x == atlas.TexUvScale.x) && (loaded.TexUvScale.y == atlas.TexUvScale.y) );
+    CHECK(memcmp(loaded.TexUvLines, atlas.TexUvLines, sizeof(atlas.TexUvLines)) == 0);
+
+    //Rects, including the one that isn't in the atlas
+    CHECK(rects.size() == 2);
+    if (rects.size() == 2)
+    {
+        const FontAtlasCacheRect& rect = source.Rects[0];
+        CHECK( (rects[0].ID == rect.ID) && (rects[0].X == rect.X) && (rects[0].Y == rect.Y) && (rects[0].Width == rect.Width) && (rects[0].Height == rect.Height) );
+        CHECK(rects[1].ID == -1);
+    }
+
+    //Glyphs and lookup tables of each font
+    CHECK(loaded.Fonts.Size == atlas.Fonts.Size);
+    for (int i = 0; (i < atlas.Fonts.Size) && (i < loaded.Fonts.Size); ++i)
+    {
+        const ImFont* font        = atlas.Fonts[i];
+        const ImFont* font_loaded = loaded.Fonts[i];
+
+        CHECK(font_loaded->FontSize == font->FontSize);
+        CHECK(font_loaded->ContainerAtlas == &loaded);
+        CHECK( (font_loaded->Glyphs.Size == font->Glyphs.Size) && (memcmp(font_loaded->Glyphs.Data, font->Glyphs.Data, font->Glyphs.Size * sizeof(ImFontGlyph)) == 0) );
+        CHECK( (font_loaded->IndexLookup.Size == font->IndexLookup.Size) &&
+               (memcmp(font_loaded->IndexLookup.Data, font->IndexLookup.Data, font->IndexLookup.Size * sizeof(ImWchar)) == 0) );
+        CHECK( (font_loaded->IndexAdvanceX.Size == font->IndexAdvanceX.Size) &&
+               (memcmp(font_loaded->IndexAdvanceX.Data, font->IndexAdvanceX.Data, font->IndexAdvanceX.Size * sizeof(float)) == 0) );
+        CHECK(memcmp(font_loaded->Used4kPagesMap, font->Used4kPagesMap, sizeof(font->Used4kPagesMap)) == 0);
+        CHECK(font_loaded->FallbackAdvanceX == font->FallbackAdvanceX);
+        CHECK(font_loaded->EllipsisChar == font->EllipsisChar);
+        CHECK( (font_loaded->FallbackGlyph - font_loaded->Glyphs.Data) == (font->FallbackGlyph - font->Glyphs.Data) );
+
+        //Text layout ends up the same, including tabs, a missing glyph and the ellipsis
+        const char* text = "Hello\tWorld?\xE2\x80\xA6\xE2\x82\xAC";
+        const ImVec2 size        = font->CalcTextSizeA(font->FontSize, FLT_MAX, 0.0f, text);
+        const ImVec2 size_loaded = font_loaded->CalcTextSizeA(font_loaded->FontSize, FLT_MAX, 0.0f, text);
+        CHECK( (size_loaded.x == size.x) && (size_loaded.y == size.y) );
+    }
+}
+
+TEST_CASE(FontAtlasCache_RejectsWrongKey)
+{
+    const TestAtlas source;
+    const std::string data = source.Save();
+
+    ImFontAtlas loaded;
+    loaded.AddFontDefault();
+    std::vector<FontAtlasCacheRect> rects;
+
+    CHECK(!Load(data, source.Key + 1, loaded, rects));
+    CHECK(!Load(data, 0, loaded, rects));
+
+    //Atlas is left untouched
+    CHECK(!loaded.IsBuilt());
+    CHECK(loaded.Fonts.Size == 1);
+    CHECK(loaded.ConfigData.Size == 1);
+    CHECK(rects.empty());
+}
+
+TEST_CASE(FontAtlasCache_RejectsTruncated)
+{
+    const TestAtlas source;
+    const std::string data = source.Save();
+
+    ImFontAtlas loaded;
+    std::vector<FontAtlasCacheRect> rects;
+
+    //Cut off anywhere: in the header, the texture and the font data
+    for (size_t size = 0; size < data.size(); size += (size < 256) ? 1 : 997)
+    {
+        if (Load(data.substr(0, size), source.Key, loaded, rects))
+        {
+            printf("    Loaded with %zu of %zu bytes\n", size, data.size());
+            CHECK(false);
+            break;
+        }
+    }
+
+    CHECK(!Load(data.substr(0, data.size() - 1), source.Key, loaded, rects));
+    CHECK(!loaded.IsBuilt());
+    CHECK(loaded.Fonts.Size == 0);
+
+    //Still loads in full afterwards
+    CHECK(Load(data, source.Key, loaded, rects));
+}
+
+TEST_CASE(FontAtlasCache_RejectsCorruptHeader)
+{
+    const TestAtlas source;
+    const std::string data = source.Save();
+
+    ImFontAtlas loaded;
+    std::vector<FontAtlasCacheRect> rects;
+
+    //Magic and format version
+    for (size_t i = 0; i < 8; ++i)
+    {
+        std::string data_corrupt = data;
+        data_corrupt[i] ^= 0x40;
+        CHECK(!Load(data_corrupt, source.Key, loaded, rects));
+    }
+
+    CHECK(!loaded.IsBuilt());
+}
+
+TEST_CASE(FontAtlasCache_Key)
+{
+    //Same input, same key. Strings carry their length so they can't blend into each other
+    FontAtlasCacheKey key_1, key_2, key_3, key_4;
+    key_1.AddString("ab");
+    key_1.AddString("c");
+    key_2.AddString("ab");
+    key_2.AddString("c");
+    key_3.AddString("a");
+    key_3.AddString("bc");
+    key_4.AddString("abc");
+
+    CHECK(key_1.GetValue() == key_2.GetValue());
+    CHECK(key_1.GetValue() != key_3.GetValue());
+    CHECK(key_1.GetValue() != key_4.GetValue());
+
+    FontAtlasCacheKey key_int, key_float;
+    key_int.AddInt(1);
+    key_float.AddFloat(1.0f);
+    CHECK(key_int.GetValue() != key_float.GetValue());
+    CHECK(key_int.GetValue() != FontAtlasCacheKey().GetValue());
+}
@@ -0,0 +1,193 @@
+#include "TestFramework.h"
+
+#include <random>
+#include <string.h>
+
+#include "FrameTileHash.h"
+
+//Plain per-lane version of the tile sums, same as the non-SSE path in HashFrameTiles()
+namespace ScalarRef
+{
+    static uint64_t MixHash(uint64_t h)
+    {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+
+        return h;
+    }
+
+    static void HashTiles(const uint8_t* data, unsigned int row_pitch, unsigned int width, unsigned int height, unsigned int tile_size, uint64_t* hashes)
+    {
+        const unsigned int tiles_x = (width  + tile_size - 1) / tile_size;
+        const unsigned int tiles_y = (height + tile_size - 1) / tile_size;
+
+        for (unsigned int tile_y = 0; tile_y < tiles_y; ++tile_y)
+        {
+            for (unsigned int tile_x = 0; tile_x < tiles_x; ++tile_x)
+            {
+                const unsigned int column_begin = tile_x * tile_size;
+                const unsigned int byte_count   = (std::min(column_begin + tile_size, width) - column_begin) * 4;
+                uint32_t lanes_1[4] = {0}, lanes_2[4] = {0};
+
+                for (unsigned int row = tile_y * tile_size; row < std::min((tile_y + 1) * tile_size, height); ++row)
+                {
+                    const uint8_t* row_data = data + (row * row_pitch) + (column_begin * 4);
+
+                    for (unsigned int i = 0; i < byte_count; i += 16)
+                    {
+                        uint32_t chunk[4] = {0};
+                        memcpy(chunk, row_data + i, std::min(byte_count - i, 16u));
+
+                        for (int lane = 0; lane < 4; ++lane)
+                        {
+                            lanes_1[lane] += chunk[lane];
+                            lanes_2[lane] += lanes_1[lane];
+                        }
+                    }
+                }
+
+                uint64_t hash = 0;
+                for (int lane = 0; lane < 4; ++lane)
+                {
+                    hash = MixHash(hash ^ ( ((uint64_t)lanes_2[lane] << 32) | lanes_1[lane] ));
+                }
+
+                hashes[(tile_y * tiles_x) + tile_x] = hash;
+            }
+        }
+    }
+}
+
+struct TestFrame
+{
+    unsigned int Width;
+    unsigned int Height;
+    unsigned int RowPitch;
+    std::vector<uint8_t> Data;
+
+    TestFrame(unsigned int width, unsigned int height, unsigned int row_padding, uint32_t seed) : Width(width), Height(height), RowPitch((width * 4) + row_padding)
+    {
+        std::mt19937 rng(seed);
+        Data.resize(RowPitch * Height);
+
+        for (auto& byte : Data)
+            byte = (uint8_t)rng();
+    }
+
+    uint8_t* Pixel(unsigned int x, unsigned int y) { return Data.data() + (y * RowPitch) + (x * 4); }
+
+    std::vector<uint64_t> Hash(unsigned int tile_size) const
+    {
+        std::vector<uint64_t> hashes(((Width + tile_size - 1) / tile_size) * ((Height + tile_size - 1) / tile_size));
+        HashFrameTiles(Data.data(), RowPitch, Width, Height, tile_size, hashes.data());
+        return hashes;
+    }
+};
+
+TEST_CASE(FrameTileHash_MatchesScalarReference)
+{
+    //Sizes with partial tiles at the right and bottom edges, including ones narrower than the 4 pixel vector width
+    const unsigned int sizes[][2] = { {256, 256}, {480, 270}, {17, 33}, {1, 1}, {3, 16}, {250, 141} };
+
+    for (const auto& size : sizes)
+    {
+        const TestFrame frame(size[0], size[1], 12, size[0] * size[1]);
+        const std::vector<uint64_t> hashes = frame.Hash(16);
+
+        std::vector<uint64_t> hashes_ref(hashes.size());
+        ScalarRef::HashTiles(frame.Data.data(), frame.RowPitch, frame.Width, frame.Height, 16, hashes_ref.data());
+
+        CHECK(hashes == hashes_ref);
+    }
+}
+
+TEST_CASE(FrameTileHash_DetectsChangesPerTile)
+{
+    TestFrame frame(100, 70, 0, 1);
+    const std::vector<uint64_t> hashes = frame.Hash(16);
+    const unsigned int tiles_x = 7;
+
+    CHECK(hashes.size() == 7 * 5);
+
+    //Flip a single bit anywhere, including the partial edge tiles. Only that tile's hash may change
+    std::mt19937 rng(2);
+    for (int i = 0; i < 500; ++i)
+    {
+        const unsigned int x = rng() % frame.Width;
+        const unsigned int y = rng() % frame.Height;
+        const unsigned int channel = rng() % 4;
+        const uint8_t bit = (uint8_t)(1 << (rng() % 8));
+
+        frame.Pixel(x, y)[channel] ^= bit;
+        const std::vector<uint64_t> hashes_changed = frame.Hash(16);
+        frame.Pixel(x, y)[channel] ^= bit;
+
+        for (size_t tile = 0; tile < hashes.size(); ++tile)
+        {
+            CHECK( (hashes_changed[tile] != hashes[tile]) == (tile == ((y / 16) * tiles_x) + (x / 16)) );
+        }
+    }
+
+    CHECK(frame.Hash(16) == hashes);
+}
+
+TEST_CASE(FrameTileHash_DetectsMovedContent)
+{
+    //Same pixels in a different order keep the plain sums identical, the running second sum has to catch it
+    TestFrame frame(16, 16, 0, 3);
+    const std::vector<uint64_t> hashes = frame.Hash(16);
+
+    uint8_t tmp[4];
+    memcpy(tmp, frame.Pixel(2, 5), 4);
+    memcpy(frame.Pixel(2, 5), frame.Pixel(2, 9), 4);
+    memcpy(frame.Pixel(2, 9), tmp, 4);
+    CHECK(frame.Hash(16) != hashes);
+
+    //Rows shifted by one
+    TestFrame frame_shifted(16, 16, 0, 3);
+    memmove(frame_shifted.Data.data() + frame_shifted.RowPitch, frame_shifted.Data.data(), frame_shifted.RowPitch * 15);
+    CHECK(frame_shifted.Hash(16) != hashes);
+}
+
+TEST_CASE(FrameTileHash_IgnoresRowPadding)
+{
+    TestFrame frame(40, 20, 24, 4);
+    const std::vector<uint64_t> hashes = frame.Hash(16);
+
+    //Garbage in the padding past the row width must not matter
+    for (unsigned int y = 0; y < frame.Height; ++y)
+        memset(frame.Pixel(frame.Width, y), 0xAB, 24);
+
+    CHECK(frame.Hash(16) == hashes);
+}
+
+BENCHMARK(FrameTileHash_HashTiles)
+{
+    //Readback size of both 1080p (mip 2) and 4K (mip 3), with and without row padding like staging textures may have, and the 512x512 maximum
+    const unsigned int sizes[][2] = { {480, 270}, {480, 270}, {512, 512} };
+    const unsigned int paddings[] = { 0, 128, 0 };
+
+    for (int i = 0; i < 3; ++i)
+    {
+        const TestFrame frame(sizes[i][0], sizes[i][1], paddings[i], 5);
+        std::vector<uint64_t> hashes(((frame.Width + 15) / 16) * ((frame.Height + 15) / 16));
+
+        char label[128];
+        snprintf(label, sizeof(label), "%ux%u, row padding %u", frame.Width, frame.Height, paddings[i]);
+        BenchmarkRun(label, 20000, [&](size_t)
+        {
+            HashFrameTiles(frame.Data.data(), frame.RowPitch, frame.Width, frame.Height, 16, hashes.data());
+            BenchmarkKeep(hashes[0]);
+        });
+
+        snprintf(label, sizeof(label), "%ux%u, scalar reference", frame.Width, frame.Height);
+        BenchmarkRun(label, 20000, [&](size_t)
+        {
+            ScalarRef::HashTiles(frame.Data.data(), frame.RowPitch, frame.Width, frame.Height, 16, hashes.data());
+            BenchmarkKeep(hashes[0]);
+        });
+    }
+}
@@ -0,0 +1,215 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <random>
+
+#include "GazeFadeBatch.h"
+
+//Per-overlay version as the old OutputManager::DetachedOverlayGazeFade() did it, with a Matrix4 offset for the gaze point
+static float GazeFadeAlphaReference(const Matrix4& mat_hmd, const Vector3& overlay_pos, float gaze_distance, float fade_rate)
+{
+    fade_rate *= 10.0f;
+    Matrix4 mat_pose = mat_hmd;
+
+    if (gaze_distance == 0.0f)
+    {
+        gaze_distance = overlay_pos.distance(mat_pose.getTranslation());
+    }
+    else
+    {
+        gaze_distance += 0.20f;
+    }
+
+    //OffsetTransformFromSelf(mat_pose, 0.0f, 0.0f, -gaze_distance)
+    mat_pose[12] += -gaze_distance * mat_pose[8];
+    mat_pose[13] += -gaze_distance * mat_pose[9];
+    mat_pose[14] += -gaze_distance * mat_pose[10];
+
+    const float distance = overlay_pos.distance(mat_pose.getTranslation());
+    gaze_distance = std::min(gaze_distance, 1.0f);
+
+    return std::max(0.0f, std::min((distance * -fade_rate) + ((gaze_distance - 0.1f) * 10.0f), 1.0f));
+}
+
+static Matrix4 RandomPose(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> dist_angle(-180.0f, 180.0f);
+    std::uniform_real_distribution<float> dist_pos(-2.0f, 2.0f);
+
+    Matrix4 mat;
+    mat.rotateX(dist_angle(rng) / 4.0f);
+    mat.rotateY(dist_angle(rng));
+    mat.translate(dist_pos(rng), 1.0f + dist_pos(rng) / 4.0f, dist_pos(rng));
+    return mat;
+}
+
+TEST_CASE(GazeFadeBatch_KnownValues)
+{
+    //HMD at the origin looking down -Z
+    const Matrix4 mat_hmd;
+    GazeFadeBatch batch;
+
+    batch.Add(10, { 0.0f, 0.0f, -0.7f}, 0.5f, 1.0f);   //Exactly at the gaze point
+    batch.Add(11, { 3.0f, 0.0f,  0.0f}, 0.5f, 1.0f);   //Far off to the side
+    batch.Add(12, { 0.1f, 0.0f, -0.5f}, 0.3f, 3.5f);   //0.1m off the gaze point, ramp ends up in the middle
+    batch.Add(13, { 0.0f, 0.0f, -2.0f}, 0.0f, 1.0f);   //Auto distance, straight ahead
+    batch.Add(14, { 2.0f, 0.0f,  0.0f}, 0.0f, 0.5f);   //Auto distance, 90 degrees off
+    batch.Add(15, { 0.0f, 0.0f,  0.5f}, 0.5f, 1.0f);   //Behind the HMD
+
+    batch.Compute(mat_hmd);
+
+    CHECK(batch.GetCount() == 6);
+    CHECK(batch.GetOverlayID(2) == 12);
+    CHECK_NEAR(batch.GetAlpha(0), 1.0f, 0.00001f);
+    CHECK_NEAR(batch.GetAlpha(1), 0.0f, 0.00001f);
+    CHECK_NEAR(batch.GetAlpha(2), 0.5f, 0.0001f);     //(0.1 * -35) + ((0.5 - 0.1) * 10)
+    CHECK_NEAR(batch.GetAlpha(3), 1.0f, 0.00001f);
+    CHECK_NEAR(batch.GetAlpha(4), 0.0f, 0.00001f);
+    CHECK_NEAR(batch.GetAlpha(5), 0.0f, 0.00001f);
+
+    //Turning the HMD towards the overlay on the side brings it back
+    Matrix4 mat_hmd_turned;
+    mat_hmd_turned.rotateY(-90.0f);
+    batch.Compute(mat_hmd_turned);
+    CHECK_NEAR(batch.GetAlpha(1), 0.0f, 0.00001f);     //Still off, gaze point is at 0.7m but the overlay at 3m
+    CHECK_NEAR(batch.GetAlpha(4), 1.0f, 0.00001f);
+    CHECK_NEAR(batch.GetAlpha(3), 0.0f, 0.00001f);
+
+    batch.Clear();
+    CHECK(batch.GetCount() == 0);
+    batch.Compute(mat_hmd);
+}
+
+TEST_CASE(GazeFadeBatch_MatchesPerOverlayReference)
+{
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<float> dist_pos(-3.0f, 3.0f);
+    std::uniform_real_distribution<float> dist_gaze(0.0f, 1.0f);
+    std::uniform_real_distribution<float> dist_rate(0.1f, 3.0f);
+
+    GazeFadeBatch batch;
+    std::vector<Vector3> positions;
+    std::vector<float> gaze_distances, rates;
+
+    for (int round = 0; round < 200; ++round)
+    {
+        batch.Clear();
+        positions.clear();
+        gaze_distances.clear();
+        rates.clear();
+
+        //Odd counts to cover the remainder of vectorized loops
+        const unsigned int overlay_count = 1 + (round % 67);
+
+        for (unsigned int i = 0; i < overlay_count; ++i)
+        {
+            positions.push_back({dist_pos(rng), 1.0f + dist_pos(rng) / 3.0f, dist_pos(rng)});
+            gaze_distances.push_back((i % 4 == 0) ? 0.0f : dist_gaze(rng));
+            rates.push_back(dist_rate(rng));
+
+            batch.Add(i, positions.back(), gaze_distances.back(), rates.back());
+        }
+
+        const Matrix4 mat_hmd = RandomPose(rng);
+        batch.Compute(mat_hmd);
+
+        CHECK(batch.GetCount() == overlay_count);
+
+        for (unsigned int i = 0; i < overlay_count; ++i)
+        {
+            CHECK(batch.GetOverlayID(i) == i);
+            CHECK_NEAR(batch.GetAlpha(i), GazeFadeAlphaReference(mat_hmd, positions[i], gaze_distances[i], rates[i]), 0.0001f);
+        }
+    }
+}
+
+TEST_CASE(GazeFadeBatch_OpacityRange)
+{
+    //Fading out: opacity 1.0, gaze fade opacity 0.2
+    CHECK_NEAR(GazeFadeBatch::MapAlphaToOpacityRange(1.0f, 1.0f, 0.2f), 1.0f, 0.00001f);
+    CHECK_NEAR(GazeFadeBatch::MapAlphaToOpacityRange(0.5f, 1.0f, 0.2f), 0.6f, 0.00001f);
+    CHECK_NEAR(GazeFadeBatch::MapAlphaToOpacityRange(0.0f, 1.0f, 0.2f), 0.2f, 0.00001f);
+
+    //Inverted: gaze fade opacity higher than overlay opacity, looking at it makes it less visible
+    CHECK_NEAR(GazeFadeBatch::MapAlphaToOpacityRange(1.0f, 0.2f, 1.0f), 0.2f, 0.00001f);
+    CHECK_NEAR(GazeFadeBatch::MapAlphaToOpacityRange(0.0f, 0.2f, 1.0f), 1.0f, 0.00001f);
+    CHECK_NEAR(GazeFadeBatch::MapAlphaToOpacityRange(0.25f, 0.2f, 1.0f), 0.8f, 0.00001f);
+
+    //Same opacity for both, nothing to fade
+    CHECK_NEAR(GazeFadeBatch::MapAlphaToOpacityRange(0.3f, 0.7f, 0.7f), 0.7f, 0.00001f);
+}
+
+TEST_CASE(GazeFadeBatch_OpacityChangeLimit)
+{
+    CHECK_NEAR(GazeFadeBatch::LimitOpacityChange(0.0f, 1.0f),   0.1f,  0.00001f);
+    CHECK_NEAR(GazeFadeBatch::LimitOpacityChange(1.0f, 0.0f),   0.9f,  0.00001f);
+    CHECK_NEAR(GazeFadeBatch::LimitOpacityChange(0.5f, 0.45f),  0.45f, 0.00001f);
+    CHECK_NEAR(GazeFadeBatch::LimitOpacityChange(0.5f, 0.5f),   0.5f,  0.00001f);
+
+    //Reaches the target in 10 frames from one end to the other and stays there
+    float opacity = 0.0f;
+    int frames = 0;
+
+    while ( (opacity < 1.0f - 0.00001f) && (frames < 100) )
+    {
+        opacity = GazeFadeBatch::LimitOpacityChange(opacity, 1.0f);
+        frames++;
+    }
+
+    CHECK(frames == 10);
+    CHECK_NEAR(GazeFadeBatch::LimitOpacityChange(opacity, 1.0f), opacity, 0.00001f);
+}
+
+BENCHMARK(GazeFadeBatch_Compute)
+{
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> dist_pos(-3.0f, 3.0f);
+
+    std::vector<Matrix4> poses;
+    for (int i = 0; i < 64; ++i)
+        poses.push_back(RandomPose(rng));
+
+    for (unsigned int overlay_count : {1u, 16u, 64u})
+    {
+        GazeFadeBatch batch;
+        std::vector<Vector3> positions;
+
+        for (unsigned int i = 0; i < overlay_count; ++i)
+        {
+            positions.push_back({dist_pos(rng), 1.0f, dist_pos(rng)});
+            batch.Add(i, positions.back(), (i % 2 == 0) ? 0.0f : 0.5f, 1.0f);
+        }
+
+        char label[128];
+        snprintf(label, sizeof(label), "Batched pass, %u overlays", overlay_count);
+        BenchmarkRun(label, 2000000, [&](size_t i)
+        {
+            batch.Compute(poses[i % poses.size()]);
+            BenchmarkKeep(batch.GetAlpha(0));
+        });
+
+        snprintf(label, sizeof(label), "Per-overlay Matrix4 math, %u overlays", overlay_count);
+        BenchmarkRun(label, 2000000, [&](size_t i)
+        {
+            float alpha_sum = 0.0f;
+
+            for (unsigned int k = 0; k < overlay_count; ++k)
+                alpha_sum += GazeFadeAlphaReference(poses[i % poses.size()], positions[k], (k % 2 == 0) ? 0.0f : 0.5f, 1.0f);
+
+            BenchmarkKeep(alpha_sum);
+        });
+
+        //What a frame does in total, including gathering the input
+        snprintf(label, sizeof(label), "Gather + batched pass, %u overlays", overlay_count);
+        BenchmarkRun(label, 2000000, [&](size_t i)
+        {
+            batch.Clear();
+
+            for (unsigned int k = 0; k < overlay_count; ++k)
+                batch.Add(k, positions[k], (k % 2 == 0) ? 0.0f : 0.5f, 1.0f);
+
+            batch.Compute(poses[i % poses.size()]);
+            BenchmarkKeep(batch.GetAlpha(0));
+        });
+    }
+}
@@ -0,0 +1,154 @@
+#include "TestFramework.h"
+
+#include "InputEventQueue.h"
+
+//Stand-ins for virtual key codes, windows.h can't be included here
+static const unsigned char k_vk_lbutton = 0x01;
+static const unsigned char k_vk_shift   = 0x10;
+static const unsigned char k_vk_a       = 0x41;
+
+static InputEvent MouseMove(int x, int y)
+{
+    InputEvent input_event;
+    input_event.Type = input_event_mouse_move;
+    input_event.X    = x;
+    input_event.Y    = y;
+    return input_event;
+}
+
+static InputEvent Wheel(InputEventType type, int delta)
+{
+    InputEvent input_event;
+    input_event.Type = type;
+    input_event.X    = delta;
+    return input_event;
+}
+
+static InputEvent Key(InputEventType type, unsigned short code, bool down)
+{
+    InputEvent input_event;
+    input_event.Type   = type;
+    input_event.IsDown = down;
+    input_event.Code   = code;
+    return input_event;
+}
+
+TEST_CASE(InputEventQueue_MouseMovesMerged)
+{
+    InputEventQueue queue;
+    CHECK(!queue.IsMouseMoveQueued());
+
+    //Only the last of consecutive moves is kept
+    queue.Push(MouseMove(10, 20));
+    queue.Push(MouseMove(30, 40));
+    queue.Push(MouseMove(50, 60));
+    CHECK(queue.IsMouseMoveQueued());
+    CHECK(queue.GetEvents().size() == 1);
+    CHECK( (queue.GetEvents()[0].X == 50) && (queue.GetEvents()[0].Y == 60) );
+
+    //Anything in between keeps them apart, so the click happens at the right position
+    queue.PushKey(k_vk_lbutton, Key(input_event_mouse_button, k_vk_lbutton, true));
+    queue.Push(MouseMove(70, 80));
+    queue.Push(MouseMove(90, 100));
+    CHECK(queue.GetEvents().size() == 3);
+    CHECK(queue.GetEvents()[0].X == 50);
+    CHECK(queue.GetEvents()[1].Type == input_event_mouse_button);
+    CHECK( (queue.GetEvents()[2].X == 90) && (queue.GetEvents()[2].Y == 100) );
+
+    queue.Clear();
+    CHECK(queue.IsEmpty());
+    CHECK(!queue.IsMouseMoveQueued());
+}
+
+TEST_CASE(InputEventQueue_WheelMerged)
+{
+    InputEventQueue queue;
+
+    //Deltas of the same axis add up, including opposite directions
+    queue.Push(Wheel(input_event_mouse_wheel,  120));
+    queue.Push(Wheel(input_event_mouse_wheel,  120));
+    queue.Push(Wheel(input_event_mouse_wheel, -60));
+    CHECK(queue.GetEvents().size() == 1);
+    CHECK(queue.GetEvents()[0].X == 180);
+
+    //Other axis is a separate event
+    queue.Push(Wheel(input_event_mouse_hwheel, -120));
+    queue.Push(Wheel(input_event_mouse_hwheel, -120));
+    CHECK(queue.GetEvents().size() == 2);
+    CHECK(queue.GetEvents()[1].X == -240);
+
+    //...and so is switching back
+    queue.Push(Wheel(input_event_mouse_wheel, 120));
+    CHECK(queue.GetEvents().size() == 3);
+    CHECK(queue.GetEvents()[2].X == 120);
+
+    //Wheel events don't merge across moves, and don't count as moves
+    CHECK(!queue.IsMouseMoveQueued());
+    queue.Push(MouseMove(0, 0));
+    queue.Push(Wheel(input_event_mouse_wheel, 120));
+    CHECK(queue.GetEvents().size() == 5);
+}
+
+TEST_CASE(InputEventQueue_KeysNotMerged)
+{
+    InputEventQueue queue;
+
+    //Repeated key events are all kept, order included
+    queue.PushKey(k_vk_a, Key(input_event_key, 0x1E, true));
+    queue.PushKey(k_vk_a, Key(input_event_key, 0x1E, false));
+    queue.PushKey(k_vk_a, Key(input_event_key, 0x1E, true));
+    queue.PushKey(k_vk_a, Key(input_event_key, 0x1E, false));
+    CHECK(queue.GetEvents().size() == 4);
+    CHECK( (queue.GetEvents()[0].IsDown) && (!queue.GetEvents()[1].IsDown) && (queue.GetEvents()[2].IsDown) && (!queue.GetEvents()[3].IsDown) );
+
+    const InputEvent text[4] = {Key(input_event_unicode, 0xE4, true), Key(input_event_unicode, 0xE4, false), Key(input_event_unicode, 0xE4, true), Key(input_event_unicode, 0xE4, false)};
+    queue.Append(text, 4);
+    CHECK(queue.GetEvents().size() == 8);
+    CHECK(queue.GetEvents()[7].Code == 0xE4);
+}
+
+TEST_CASE(InputEventQueue_KeyState)
+{
+    InputEventQueue queue;
+    CHECK(queue.GetKeyState(k_vk_shift) == 0);
+
+    queue.PushKey(k_vk_shift, Key(input_event_key, 0x2A, true));
+    CHECK(queue.GetKeyState(k_vk_shift) == 1);
+
+    //Last event decides
+    queue.PushKey(k_vk_shift, Key(input_event_key, 0x2A, false));
+    CHECK(queue.GetKeyState(k_vk_shift) == -1);
+
+    //Appended events aren't tracked
+    const InputEvent shift_down = Key(input_event_key, 0x2A, true);
+    queue.Append(&shift_down, 1);
+    CHECK(queue.GetKeyState(k_vk_shift) == -1);
+    queue.SetKeyState(k_vk_shift, true);
+    CHECK(queue.GetKeyState(k_vk_shift) == 1);
+
+    CHECK(queue.GetKeyState(k_vk_a) == 0);
+
+    queue.Clear();
+    CHECK(queue.GetKeyState(k_vk_shift) == 0);
+}
+
+TEST_CASE(InputEventQueue_Reserve)
+{
+    InputEventQueue queue;
+    queue.Reserve(100);
+    const size_t capacity = queue.GetEvents().capacity();
+    CHECK(capacity >= 100);
+
+    //Already enough room, nothing changes
+    queue.Push(MouseMove(0, 0));
+    queue.Reserve(50);
+    CHECK(queue.GetEvents().capacity() == capacity);
+
+    //Not enough, at least doubles
+    queue.Reserve(capacity);
+    CHECK(queue.GetEvents().capacity() >= capacity * 2);
+
+    //Clearing keeps the capacity
+    queue.Clear();
+    CHECK(queue.GetEvents().capacity() >= capacity * 2);
+}
@@ -0,0 +1,311 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+#include "KeyboardTextTranslator.h"
+#include "UTF8Decode.h"
+
+//Stand-ins for the virtual key codes, windows.h can't be included here
+static const unsigned short k_vk_shift = 0x10;
+
+static InputEvent KeyEvent(unsigned short code, bool down)
+{
+    InputEvent input_event;
+    input_event.Type       = input_event_key;
+    input_event.IsDown     = down;
+    input_event.IsScancode = true;
+    input_event.Code       = code;
+    return input_event;
+}
+
+static InputEvent UnicodeEvent(unsigned short code, bool down)
+{
+    InputEvent input_event;
+    input_event.Type   = input_event_unicode;
+    input_event.IsDown = down;
+    input_event.Code   = code;
+    return input_event;
+}
+
+//Table like InputSimulator::RefreshTextTable() builds it, using the virtual key codes as scancodes
+static void SetUpTable(KeyboardTextTranslator& translator)
+{
+    translator.ResetTable();
+
+    for (unsigned char c = 0; c < 128; ++c)
+    {
+        InputEvent events[KeyboardTextTranslator::k_TableSlotsPerChar];
+        int event_count = 0;
+
+        if ( ((c >= '0') && (c <= '9')) || (c == ' ') || ((c >= 'a') && (c <= 'z')) )
+        {
+            const unsigned short vkey = ((c >= 'a') && (c <= 'z')) ? c - ('a' - 'A') : c;
+            events[event_count++] = KeyEvent(vkey, true);
+            events[event_count++] = KeyEvent(vkey, false);
+        }
+        else if ((c >= 'A') && (c <= 'Z'))
+        {
+            events[event_count++] = KeyEvent(k_vk_shift, true);
+            events[event_count++] = KeyEvent(c, true);
+            events[event_count++] = KeyEvent(c, false);
+            events[event_count++] = KeyEvent(k_vk_shift, false);
+        }
+
+        if (event_count != 0)
+        {
+            translator.SetCharEvents(c, events, event_count);
+        }
+    }
+}
+
+//Straightforward per-codepoint translation to compare against
+static std::vector<InputEvent> TranslateReference(const std::string& str_utf8)
+{
+    std::vector<InputEvent> events;
+    const unsigned char* str     = (const unsigned char*)str_utf8.data();
+    const unsigned char* str_end = str + str_utf8.size();
+
+    while (str != str_end)
+    {
+        uint32_t codepoint = DecodeUTF8(str, str_end);
+
+        if ( ((codepoint >= '0') && (codepoint <= '9')) || (codepoint == ' ') || ((codepoint >= 'a') && (codepoint <= 'z')) )
+        {
+            const unsigned short vkey = ((codepoint >= 'a') && (codepoint <= 'z')) ? codepoint - ('a' - 'A') : codepoint;
+            events.push_back(KeyEvent(vkey, true));
+            events.push_back(KeyEvent(vkey, false));
+        }
+        else if ((codepoint >= 'A') && (codepoint <= 'Z'))
+        {
+            events.push_back(KeyEvent(k_vk_shift, true));
+            events.push_back(KeyEvent(codepoint, true));
+            events.push_back(KeyEvent(codepoint, false));
+            events.push_back(KeyEvent(k_vk_shift, false));
+        }
+        else if (codepoint >= 0x10000)
+        {
+            codepoint -= 0x10000;
+            events.push_back(UnicodeEvent(0xD800 + (codepoint >> 10), true));
+            events.push_back(UnicodeEvent(0xD800 + (codepoint >> 10), false));
+            events.push_back(UnicodeEvent(0xDC00 + (codepoint & 0x3FF), true));
+            events.push_back(UnicodeEvent(0xDC00 + (codepoint & 0x3FF), false));
+        }
+        else
+        {
+            events.push_back(UnicodeEvent(codepoint, true));
+            events.push_back(UnicodeEvent(codepoint, false));
+        }
+    }
+
+    return events;
+}
+
+static bool EventsEqual(const std::vector<InputEvent>& a, const std::vector<InputEvent>& b)
+{
+    if (a.size() != b.size())
+        return false;
+
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if ( (a[i].Type != b[i].Type) || (a[i].IsDown != b[i].IsDown) || (a[i].IsScancode != b[i].IsScancode) || (a[i].IsExtended != b[i].IsExtended) ||
+             (a[i].Code != b[i].Code) || (a[i].X != b[i].X) || (a[i].Y != b[i].Y) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//Checks Translate() and TranslateScalar() against the reference. Returns false on mismatch
+static bool CheckTranslation(const KeyboardTextTranslator& translator, const std::string& str_utf8)
+{
+    const std::vector<InputEvent> events_reference = TranslateReference(str_utf8);
+
+    InputEventQueue queue;
+    translator.Translate(str_utf8.data(), str_utf8.size(), queue);
+    const bool is_equal = EventsEqual(queue.GetEvents(), events_reference);
+
+    InputEventQueue queue_scalar;
+    translator.TranslateScalar(str_utf8.data(), str_utf8.size(), queue_scalar);
+    const bool is_equal_scalar = EventsEqual(queue_scalar.GetEvents(), events_reference);
+
+    return ( (is_equal) && (is_equal_scalar) );
+}
+
+TEST_CASE(KeyboardTextTranslator_ASCII)
+{
+    KeyboardTextTranslator translator;
+    CHECK(!translator.HasTable());
+    SetUpTable(translator);
+    CHECK(translator.HasTable());
+
+    InputEventQueue queue;
+    translator.Translate("aZ!", 3, queue);
+    const std::vector<InputEvent> events_expected = { KeyEvent('A', true), KeyEvent('A', false),
+                                                      KeyEvent(k_vk_shift, true), KeyEvent('Z', true), KeyEvent('Z', false), KeyEvent(k_vk_shift, false),
+                                                      UnicodeEvent('!', true), UnicodeEvent('!', false) };
+    CHECK(EventsEqual(queue.GetEvents(), events_expected));
+
+    //Every ASCII character, over several 16-byte blocks
+    std::string str_ascii;
+    for (int c = 0; c < 128; ++c)
+    {
+        str_ascii += (char)c;
+    }
+
+    CHECK(CheckTranslation(translator, str_ascii));
+
+    //Lengths around the block size
+    for (size_t length = 0; length <= 49; ++length)
+    {
+        CHECK(CheckTranslation(translator, str_ascii.substr(32, length)));
+    }
+}
+
+TEST_CASE(KeyboardTextTranslator_NonASCII)
+{
+    KeyboardTextTranslator translator;
+    SetUpTable(translator);
+
+    InputEventQueue queue;
+    const std::string str = "\xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80";  //U+00E4, U+20AC, U+1F600
+    translator.Translate(str.data(), str.size(), queue);
+    const std::vector<InputEvent> events_expected = { UnicodeEvent(0xE4, true), UnicodeEvent(0xE4, false), UnicodeEvent(0x20AC, true), UnicodeEvent(0x20AC, false),
+                                                      UnicodeEvent(0xD83D, true), UnicodeEvent(0xD83D, false), UnicodeEvent(0xDE00, true), UnicodeEvent(0xDE00, false) };
+    CHECK(EventsEqual(queue.GetEvents(), events_expected));
+
+    //Long runs without any ASCII, and invalid sequences
+    std::string str_long;
+    for (int i = 0; i < 20; ++i)
+    {
+        str_long += str;
+    }
+
+    CHECK(CheckTranslation(translator, str_long));
+    CHECK(CheckTranslation(translator, "\xFF\xC3\x80\x80\xE2\x82" "a\xF0\x9F\x98"));
+
+    //Unicode-only translation ignores the table
+    InputEventQueue queue_unicode;
+    KeyboardTextTranslator::TranslateUnicode("a\xC3\xA4", 3, queue_unicode);
+    const std::vector<InputEvent> events_unicode = { UnicodeEvent('a', true), UnicodeEvent('a', false), UnicodeEvent(0xE4, true), UnicodeEvent(0xE4, false) };
+    CHECK(EventsEqual(queue_unicode.GetEvents(), events_unicode));
+}
+
+TEST_CASE(KeyboardTextTranslator_BlockEdges)
+{
+    KeyboardTextTranslator translator;
+    SetUpTable(translator);
+
+    //A multi-byte character at every position around the 16-byte block edges, including straddling them, in ASCII text of varying length
+    const char* const chars[] = { "\xC3\xA4", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\xFF" };
+    const std::string str_ascii = "The quick brown fox jumps over the lazy dog 0123456789 THE QUICK BROWN FOX";
+
+    for (const char* chr : chars)
+    {
+        for (size_t length : {15, 16, 17, 31, 32, 33, 48, 64})
+        {
+            for (size_t pos = 0; pos <= length; ++pos)
+            {
+                std::string str = str_ascii.substr(0, length);
+                str.insert(pos, chr);
+
+                if (!CheckTranslation(translator, str))
+                {
+                    CHECK(false);
+                    return;
+                }
+
+                //Switching back and forth within the same block
+                str.insert(std::min(pos + 5, str.size()), chr);
+
+                if (!CheckTranslation(translator, str))
+                {
+                    CHECK(false);
+                    return;
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE(KeyboardTextTranslator_RandomText)
+{
+    KeyboardTextTranslator translator;
+    SetUpTable(translator);
+
+    //Mostly ASCII with runs of other characters, compared between the SIMD and scalar paths
+    std::mt19937 rng(42);
+    const char* const pieces[] = { "a", "Z", " ", "1", ".", "\n", "\xC3\xA4", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\x80", "\xE2\x82" };
+    std::uniform_int_distribution<int> piece_dist(0, 10);
+    std::uniform_int_distribution<int> ascii_dist(0, 99);
+
+    for (int i = 0; i < 200; ++i)
+    {
+        std::string str;
+        const int piece_count = i % 80;
+
+        for (int j = 0; j < piece_count; ++j)
+        {
+            str += (ascii_dist(rng) < 80) ? pieces[ascii_dist(rng) % 6] : pieces[piece_dist(rng)];
+        }
+
+        if (!CheckTranslation(translator, str))
+        {
+            CHECK(false);
+            break;
+        }
+    }
+}
+
+BENCHMARK(KeyboardTextTranslator_Translate)
+{
+    KeyboardTextTranslator translator;
+    SetUpTable(translator);
+
+    //Plain ASCII text as typed or pasted, and text mixed with 2, 3 and 4 byte sequences
+    const char* const samples_ascii[] = { "Hello World! ", "The quick brown fox jumps over the lazy dog. ", "0123456789 " };
+    const char* const samples_mixed[] = { "Hello World! ", "Gr\xC3\xBC\xC3\x9F" "e ", "\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82 ",
+                                          "\xE3\x81\x93\xE3\x82\x93\xE3\x81\xAB\xE3\x81\xA1\xE3\x81\xAF ", "\xF0\x9F\x98\x80\xF0\x9F\x91\x8D " };
+    std::string text_ascii, text_mixed;
+
+    while (text_ascii.size() < 16 * 1024)
+    {
+        for (const char* sample : samples_ascii)
+            text_ascii += sample;
+    }
+
+    while (text_mixed.size() < 16 * 1024)
+    {
+        for (const char* sample : samples_mixed)
+            text_mixed += sample;
+    }
+
+    InputEventQueue queue;
+    queue.Reserve(KeyboardTextTranslator::GetEventCountMax(std::max(text_ascii.size(), text_mixed.size())));
+
+    char label[128];
+
+    for (const std::string* text : {&text_ascii, &text_mixed})
+    {
+        const char* text_name = (text == &text_ascii) ? "ASCII text" : "Mixed text";
+
+        snprintf(label, sizeof(label), "%s, %zu bytes, Translate()", text_name, text->size());
+        BenchmarkRun(label, 500, [&](size_t)
+        {
+            queue.Clear();
+            translator.Translate(text->data(), text->size(), queue);
+            BenchmarkKeep(queue.GetEvents().size());
+        });
+
+        snprintf(label, sizeof(label), "%s, %zu bytes, TranslateScalar()", text_name, text->size());
+        BenchmarkRun(label, 500, [&](size_t)
+        {
+            queue.Clear();
+            translator.TranslateScalar(text->data(), text->size(), queue);
+            BenchmarkKeep(queue.GetEvents().size());
+        });
+    }
+}
@@ -0,0 +1,270 @@
+#include "TestFramework.h"
+
+#include <cstring>
+#include <random>
+
+#include "Matrices.h"
+
+//Scalar reference versions of the Matrix4 functions that have SSE paths, same as the code used with MATRICES_NO_SIMD.
+//These are copies instead of a second build of Matrices.h, as the inline functions would otherwise clash when linked into one executable.
+namespace ScalarRef
+{
+    static Vector4 Mul(const Matrix4& mat, const Vector4& rhs)
+    {
+        const float* m = mat.get();
+        return Vector4(m[0]*rhs.x + m[4]*rhs.y + m[8]*rhs.z  + m[12]*rhs.w,
+                       m[1]*rhs.x + m[5]*rhs.y + m[9]*rhs.z  + m[13]*rhs.w,
+                       m[2]*rhs.x + m[6]*rhs.y + m[10]*rhs.z + m[14]*rhs.w,
+                       m[3]*rhs.x + m[7]*rhs.y + m[11]*rhs.z + m[15]*rhs.w);
+    }
+
+    static Vector3 Mul(const Matrix4& mat, const Vector3& rhs)
+    {
+        const float* m = mat.get();
+        return Vector3(m[0]*rhs.x + m[4]*rhs.y + m[8]*rhs.z,
+                       m[1]*rhs.x + m[5]*rhs.y + m[9]*rhs.z,
+                       m[2]*rhs.x + m[6]*rhs.y + m[10]*rhs.z);
+    }
+
+    static Vector3 TransformPoint(const Matrix4& mat, const Vector3& point)
+    {
+        const float* m = mat.get();
+        return Vector3(m[0]*point.x + m[4]*point.y + m[8]*point.z  + m[12],
+                       m[1]*point.x + m[5]*point.y + m[9]*point.z  + m[13],
+                       m[2]*point.x + m[6]*point.y + m[10]*point.z + m[14]);
+    }
+
+    static Matrix4 Mul(const Matrix4& mat, const Matrix4& n)
+    {
+        const float* m = mat.get();
+        return Matrix4(m[0]*n[0]  + m[4]*n[1]  + m[8]*n[2]  + m[12]*n[3],   m[1]*n[0]  + m[5]*n[1]  + m[9]*n[2]  + m[13]*n[3],   m[2]*n[0]  + m[6]*n[1]  + m[10]*n[2]  + m[14]*n[3],   m[3]*n[0]  + m[7]*n[1]  + m[11]*n[2]  + m[15]*n[3],
+                       m[0]*n[4]  + m[4]*n[5]  + m[8]*n[6]  + m[12]*n[7],   m[1]*n[4]  + m[5]*n[5]  + m[9]*n[6]  + m[13]*n[7],   m[2]*n[4]  + m[6]*n[5]  + m[10]*n[6]  + m[14]*n[7],   m[3]*n[4]  + m[7]*n[5]  + m[11]*n[6]  + m[15]*n[7],
+                       m[0]*n[8]  + m[4]*n[9]  + m[8]*n[10] + m[12]*n[11],  m[1]*n[8]  + m[5]*n[9]  + m[9]*n[10] + m[13]*n[11],  m[2]*n[8]  + m[6]*n[9]  + m[10]*n[10] + m[14]*n[11],  m[3]*n[8]  + m[7]*n[9]  + m[11]*n[10] + m[15]*n[11],
+                       m[0]*n[12] + m[4]*n[13] + m[8]*n[14] + m[12]*n[15],  m[1]*n[12] + m[5]*n[13] + m[9]*n[14] + m[13]*n[15],  m[2]*n[12] + m[6]*n[13] + m[10]*n[14] + m[14]*n[15],  m[3]*n[12] + m[7]*n[13] + m[11]*n[14] + m[15]*n[15]);
+    }
+
+    static Matrix4 InvertAffine(const Matrix4& mat)
+    {
+        Matrix4 res = mat;
+
+        //Matrix3::invert() has no SSE path, so it can be used as-is
+        Matrix3 r(res[0],res[1],res[2], res[4],res[5],res[6], res[8],res[9],res[10]);
+        r.invert();
+        res[0] = r[0];  res[1] = r[1];  res[2] = r[2];
+        res[4] = r[3];  res[5] = r[4];  res[6] = r[5];
+        res[8] = r[6];  res[9] = r[7];  res[10]= r[8];
+
+        const float x = res[12];
+        const float y = res[13];
+        const float z = res[14];
+        res[12] = -(r[0] * x + r[3] * y + r[6] * z);
+        res[13] = -(r[1] * x + r[4] * y + r[7] * z);
+        res[14] = -(r[2] * x + r[5] * y + r[8] * z);
+
+        return res;
+    }
+
+    static vr::HmdMatrix34_t ToOpenVR34(const Matrix4& mat)
+    {
+        const float* m = mat.get();
+        vr::HmdMatrix34_t matrixObj;
+        matrixObj.m[0][0] = m[0];  matrixObj.m[1][0] = m[1];  matrixObj.m[2][0] = m[2];
+        matrixObj.m[0][1] = m[4];  matrixObj.m[1][1] = m[5];  matrixObj.m[2][1] = m[6];
+        matrixObj.m[0][2] = m[8];  matrixObj.m[1][2] = m[9];  matrixObj.m[2][2] = m[10];
+        matrixObj.m[0][3] = m[12]; matrixObj.m[1][3] = m[13]; matrixObj.m[2][3] = m[14];
+        return matrixObj;
+    }
+
+    static Matrix4 FromOpenVR34(const vr::HmdMatrix34_t& src)
+    {
+        return Matrix4(src.m[0][0], src.m[1][0], src.m[2][0], 0.0f,
+                       src.m[0][1], src.m[1][1], src.m[2][1], 0.0f,
+                       src.m[0][2], src.m[1][2], src.m[2][2], 0.0f,
+                       src.m[0][3], src.m[1][3], src.m[2][3], 1.0f);
+    }
+}
+
+//Bitwise compares, the SSE paths are expected to produce exactly the same results
+static bool BitEqual(const float* a, const float* b, size_t count)
+{
+    return (memcmp(a, b, count * sizeof(float)) == 0);
+}
+
+static bool BitEqual(const Vector3& a, const Vector3& b)
+{
+    const float fa[3] = {a.x, a.y, a.z}, fb[3] = {b.x, b.y, b.z};
+    return BitEqual(fa, fb, 3);
+}
+
+static bool BitEqual(const Vector4& a, const Vector4& b)
+{
+    const float fa[4] = {a.x, a.y, a.z, a.w}, fb[4] = {b.x, b.y, b.z, b.w};
+    return BitEqual(fa, fb, 4);
+}
+
+class MatrixGenerator
+{
+    private:
+        std::mt19937 m_RNG;
+        std::uniform_real_distribution<float> m_DistUnit;
+        std::uniform_real_distribution<float> m_DistPos;
+
+    public:
+        explicit MatrixGenerator(unsigned int seed) : m_RNG(seed), m_DistUnit(-2.0f, 2.0f), m_DistPos(-10.0f, 10.0f) {}
+
+        Vector3 Point() { return Vector3(m_DistPos(m_RNG), m_DistPos(m_RNG), m_DistPos(m_RNG)); }
+
+        //Rotation, non-uniform scale and translation, like overlay and pose transforms
+        Matrix4 Affine()
+        {
+            Matrix4 mat;
+            mat.scale(m_DistUnit(m_RNG) + 2.5f, m_DistUnit(m_RNG) + 2.5f, m_DistUnit(m_RNG) + 2.5f);
+            mat.rotate(m_DistPos(m_RNG) * 36.0f, Vector3(m_DistUnit(m_RNG), m_DistUnit(m_RNG), m_DistUnit(m_RNG) + 0.01f));
+            mat.translate(Point());
+            return mat;
+        }
+
+        //Arbitrary values, including the projective row
+        Matrix4 General()
+        {
+            float m[16];
+            for (float& value : m)
+                value = m_DistUnit(m_RNG);
+
+            return Matrix4(m);
+        }
+};
+
+TEST_CASE(Matrices_SSEMatchesScalar_Vector)
+{
+    MatrixGenerator gen(3);
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        const Matrix4 mat = (i % 2 == 0) ? gen.Affine() : gen.General();
+        const Vector3 v3 = gen.Point();
+        const Vector4 v4(v3.x, v3.y, v3.z, (i % 3 == 0) ? 1.0f : v3.x * 0.5f);
+
+        CHECK(BitEqual(mat * v4, ScalarRef::Mul(mat, v4)));
+        CHECK(BitEqual(mat * v3, ScalarRef::Mul(mat, v3)));
+        CHECK(BitEqual(mat.transformPoint(v3), ScalarRef::TransformPoint(mat, v3)));
+    }
+}
+
+TEST_CASE(Matrices_MatchesScalar_Matrix)
+{
+    MatrixGenerator gen(4);
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        const Matrix4 a = (i % 2 == 0) ? gen.Affine() : gen.General();
+        const Matrix4 b = (i % 3 == 0) ? gen.Affine() : gen.General();
+
+        CHECK(BitEqual((a * b).get(), ScalarRef::Mul(a, b).get(), 16));
+
+        Matrix4 a_mul = a;
+        a_mul *= b;
+        CHECK(BitEqual(a_mul.get(), ScalarRef::Mul(a, b).get(), 16));
+    }
+}
+
+TEST_CASE(Matrices_SSEMatchesScalar_InvertAffine)
+{
+    MatrixGenerator gen(5);
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        const Matrix4 mat = gen.Affine();
+        Matrix4 inv = mat;
+        inv.invertAffine();
+
+        CHECK(BitEqual(inv.get(), ScalarRef::InvertAffine(mat).get(), 16));
+
+        //And it's actually the inverse
+        const Vector3 point = gen.Point();
+        const Vector3 round_trip = inv.transformPoint(mat.transformPoint(point));
+        CHECK_NEAR(round_trip.x, point.x, 0.001f);
+        CHECK_NEAR(round_trip.y, point.y, 0.001f);
+        CHECK_NEAR(round_trip.z, point.z, 0.001f);
+    }
+
+    //Singular matrices go through the scalar path, which resets the rotation part to identity
+    Matrix4 singular(1.0f, 2.0f, 3.0f, 0.0f,  2.0f, 4.0f, 6.0f, 0.0f,  0.0f, 0.0f, 1.0f, 0.0f,  5.0f, 6.0f, 7.0f, 1.0f);
+    const Matrix4 singular_ref = ScalarRef::InvertAffine(singular);
+    singular.invertAffine();
+    CHECK(BitEqual(singular.get(), singular_ref.get(), 16));
+
+    Matrix4 zero(0.0f, 0.0f, 0.0f, 0.0f,  0.0f, 0.0f, 0.0f, 0.0f,  0.0f, 0.0f, 0.0f, 0.0f,  1.0f, 2.0f, 3.0f, 1.0f);
+    const Matrix4 zero_ref = ScalarRef::InvertAffine(zero);
+    zero.invertAffine();
+    CHECK(BitEqual(zero.get(), zero_ref.get(), 16));
+}
+
+TEST_CASE(Matrices_SSEMatchesScalar_OpenVR34)
+{
+    MatrixGenerator gen(6);
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        Matrix4 mat = gen.Affine();
+
+        const vr::HmdMatrix34_t ovr_mat = mat.toOpenVR34();
+        const vr::HmdMatrix34_t ovr_mat_ref = ScalarRef::ToOpenVR34(mat);
+        CHECK(BitEqual(&ovr_mat.m[0][0], &ovr_mat_ref.m[0][0], 12));
+
+        CHECK(BitEqual(Matrix4(ovr_mat).get(), ScalarRef::FromOpenVR34(ovr_mat).get(), 16));
+        CHECK(Matrix4(ovr_mat) == mat);
+    }
+}
+
+TEST_CASE(Matrices_TransformPoint)
+{
+    Matrix4 mat;
+    mat.rotateZ(90.0f);
+    mat.translate(1.0f, 2.0f, 3.0f);
+
+    const Vector3 point = mat.transformPoint(Vector3(1.0f, 0.0f, 0.0f));
+    CHECK_NEAR(point.x, 1.0f, 0.00001f);
+    CHECK_NEAR(point.y, 3.0f, 0.00001f);
+    CHECK_NEAR(point.z, 3.0f, 0.00001f);
+
+    //Same as multiplying with w = 1 for affine matrices
+    const Vector4 point4 = mat * Vector4(1.0f, 0.0f, 0.0f, 1.0f);
+    CHECK(BitEqual(point, Vector3(point4.x, point4.y, point4.z)));
+}
+
+BENCHMARK(Matrices_SSEvsScalar)
+{
+    #ifdef MATRICES_USE_SSE
+        printf("  SSE paths enabled\n");
+    #else
+        printf("  SSE paths disabled, both columns measure the scalar code\n");
+    #endif
+
+    MatrixGenerator gen(7);
+    const size_t set_size = 256;
+    std::vector<Matrix4> mats_a, mats_b;
+    std::vector<Vector3> points;
+
+    for (size_t i = 0; i < set_size; ++i)
+    {
+        mats_a.push_back(gen.Affine());
+        mats_b.push_back(gen.Affine());
+        points.push_back(gen.Point());
+    }
+
+    //Matrix4 * Matrix4 is scalar only, the SSE version measured slower
+    BenchmarkRun("Matrix4 * Matrix4",             10000000, [&](size_t i){ BenchmarkKeep(mats_a[i % set_size] * mats_b[(i * 7) % set_size]); });
+
+    BenchmarkRun("Matrix4 * Vector4, SSE",        10000000, [&](size_t i){ const Vector3& p = points[i % set_size]; BenchmarkKeep(mats_a[(i * 7) % set_size] * Vector4(p.x, p.y, p.z, 1.0f)); });
+    BenchmarkRun("Matrix4 * Vector4, scalar",     10000000, [&](size_t i){ const Vector3& p = points[i % set_size]; BenchmarkKeep(ScalarRef::Mul(mats_a[(i * 7) % set_size], Vector4(p.x, p.y, p.z, 1.0f))); });
+
+    BenchmarkRun("Matrix4::transformPoint(), SSE",    10000000, [&](size_t i){ BenchmarkKeep(mats_a[(i * 7) % set_size].transformPoint(points[i % set_size])); });
+    BenchmarkRun("Matrix4::transformPoint(), scalar", 10000000, [&](size_t i){ BenchmarkKeep(ScalarRef::TransformPoint(mats_a[(i * 7) % set_size], points[i % set_size])); });
+
+    BenchmarkRun("Matrix4::invertAffine(), SSE",      10000000, [&](size_t i){ Matrix4 mat = mats_a[i % set_size]; BenchmarkKeep(mat.invertAffine()); });
+    BenchmarkRun("Matrix4::invertAffine(), scalar",   10000000, [&](size_t i){ BenchmarkKeep(ScalarRef::InvertAffine(mats_a[i % set_size])); });
+
+    BenchmarkRun("Matrix4::toOpenVR34(), SSE",        10000000, [&](size_t i){ BenchmarkKeep(mats_a[i % set_size].toOpenVR34()); });
+    BenchmarkRun("Matrix4::toOpenVR34(), scalar",     10000000, [&](size_t i){ BenchmarkKeep(ScalarRef::ToOpenVR34(mats_a[i % set_size])); });
+}
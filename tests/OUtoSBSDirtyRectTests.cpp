@@ -0,0 +1,143 @@
+#include "TestFramework.h"
+
+#include <random>
+
+#include "OUtoSBSDirtyRect.h"
+
+static bool RectEquals(const DPRect& rect, int x1, int y1, int x2, int y2)
+{
+    return (rect == DPRect(x1, y1, x2, y2));
+}
+
+TEST_CASE(OUtoSBSDirtyRect_Halves)
+{
+    //100x200 crop at the origin, SBS texture is 200x100
+    DPRect sbs_rects[2];
+
+    //Top half only, goes to the left
+    CHECK(OUtoSBSRemapDirtyRect({10, 20, 30, 40}, 100, 200, 0, 0, 100, 200, sbs_rects) == 1);
+    CHECK(RectEquals(sbs_rects[0], 10, 20, 30, 40));
+
+    //Bottom half only, goes to the right
+    CHECK(OUtoSBSRemapDirtyRect({10, 120, 30, 140}, 100, 200, 0, 0, 100, 200, sbs_rects) == 1);
+    CHECK(RectEquals(sbs_rects[0], 110, 20, 130, 40));
+
+    //Crossing the middle ends up in both
+    CHECK(OUtoSBSRemapDirtyRect({10, 90, 30, 110}, 100, 200, 0, 0, 100, 200, sbs_rects) == 2);
+    CHECK(RectEquals(sbs_rects[0], 10, 90, 30, 100));
+    CHECK(RectEquals(sbs_rects[1], 110, 0, 130, 10));
+
+    //Whole source covers the whole SBS texture
+    CHECK(OUtoSBSRemapDirtyRect({0, 0, 100, 200}, 100, 200, 0, 0, 100, 200, sbs_rects) == 2);
+    CHECK(RectEquals(sbs_rects[0], 0, 0, 100, 100));
+    CHECK(RectEquals(sbs_rects[1], 100, 0, 200, 100));
+
+    //Empty rect
+    CHECK(OUtoSBSRemapDirtyRect({50, 50, 50, 60}, 100, 200, 0, 0, 100, 200, sbs_rects) == 0);
+}
+
+TEST_CASE(OUtoSBSDirtyRect_CropOffset)
+{
+    //100x200 crop at (50, 30) of a 400x400 source
+    DPRect sbs_rects[2];
+
+    CHECK(OUtoSBSRemapDirtyRect({60, 40, 70, 50}, 400, 400, 50, 30, 100, 200, sbs_rects) == 1);
+    CHECK(RectEquals(sbs_rects[0], 10, 10, 20, 20));
+
+    CHECK(OUtoSBSRemapDirtyRect({60, 140, 70, 150}, 400, 400, 50, 30, 100, 200, sbs_rects) == 1);
+    CHECK(RectEquals(sbs_rects[0], 110, 10, 120, 20));
+
+    //Outside of the crop entirely, on each side
+    CHECK(OUtoSBSRemapDirtyRect({0,   0,   50,  30 }, 400, 400, 50, 30, 100, 200, sbs_rects) == 0);
+    CHECK(OUtoSBSRemapDirtyRect({150, 40,  200, 60 }, 400, 400, 50, 30, 100, 200, sbs_rects) == 0);
+    CHECK(OUtoSBSRemapDirtyRect({60,  230, 70,  300}, 400, 400, 50, 30, 100, 200, sbs_rects) == 0);
+
+    //Partially outside of the crop is clipped to it
+    CHECK(OUtoSBSRemapDirtyRect({0, 0, 60, 40}, 400, 400, 50, 30, 100, 200, sbs_rects) == 1);
+    CHECK(RectEquals(sbs_rects[0], 0, 0, 10, 10));
+
+    CHECK(OUtoSBSRemapDirtyRect({140, 220, 400, 400}, 400, 400, 50, 30, 100, 200, sbs_rects) == 1);
+    CHECK(RectEquals(sbs_rects[0], 190, 90, 200, 100));
+}
+
+TEST_CASE(OUtoSBSDirtyRect_Clamping)
+{
+    DPRect sbs_rects[2];
+
+    //Cursor dirty rects can reach past the source texture on any side
+    CHECK(OUtoSBSRemapDirtyRect({-10, -10, 20, 20}, 100, 200, 0, 0, 100, 200, sbs_rects) == 1);
+    CHECK(RectEquals(sbs_rects[0], 0, 0, 20, 20));
+
+    CHECK(OUtoSBSRemapDirtyRect({90, 190, 150, 250}, 100, 200, 0, 0, 100, 200, sbs_rects) == 1);
+    CHECK(RectEquals(sbs_rects[0], 190, 90, 200, 100));
+
+    CHECK(OUtoSBSRemapDirtyRect({-50, -50, -10, -10}, 100, 200, 0, 0, 100, 200, sbs_rects) == 0);
+
+    //Crop reaching past the source texture, only the part inside of the source counts
+    CHECK(OUtoSBSRemapDirtyRect({0, 0, 400, 400}, 100, 200, 50, 0, 100, 200, sbs_rects) == 2);
+    CHECK(RectEquals(sbs_rects[0], 0,   0, 50,  100));
+    CHECK(RectEquals(sbs_rects[1], 100, 0, 150, 100));
+
+    //Odd crop height, the last row isn't part of either half
+    CHECK(OUtoSBSRemapDirtyRect({0, 200, 10, 201}, 100, 201, 0, 0, 100, 201, sbs_rects) == 0);
+    CHECK(OUtoSBSRemapDirtyRect({0, 199, 10, 201}, 100, 201, 0, 0, 100, 201, sbs_rects) == 1);
+    CHECK(RectEquals(sbs_rects[0], 100, 99, 110, 100));
+}
+
+TEST_CASE(OUtoSBSDirtyRect_MatchesPerPixelMapping)
+{
+    //Map every dirty source pixel on its own and compare with what the rects cover
+    std::mt19937 rng(9);
+
+    for (int round = 0; round < 2000; ++round)
+    {
+        const int source_width  = 1 + (rng() % 48);
+        const int source_height = 1 + (rng() % 48);
+        const int crop_x        = rng() % source_width;
+        const int crop_y        = rng() % source_height;
+        const int crop_width    = 1 + (rng() % (source_width  - crop_x + 4));  //Can reach past the source
+        const int crop_height   = 1 + (rng() % (source_height - crop_y + 4));
+        const int sbs_width     = crop_width * 2;
+        const int sbs_height    = crop_height / 2;
+
+        const int dirty_x = (int)(rng() % (source_width  + 16)) - 8;
+        const int dirty_y = (int)(rng() % (source_height + 16)) - 8;
+        const DPRect dirty_rect(dirty_x, dirty_y, dirty_x + (rng() % 24), dirty_y + (rng() % 24));
+
+        std::vector<char> expected(sbs_width * sbs_height, 0), covered(sbs_width * sbs_height, 0);
+
+        for (int y = std::max(dirty_rect.Min.y, 0); y < std::min(dirty_rect.Max.y, source_height); ++y)
+        {
+            for (int x = std::max(dirty_rect.Min.x, 0); x < std::min(dirty_rect.Max.x, source_width); ++x)
+            {
+                if ( (x < crop_x) || (x >= crop_x + crop_width) || (y < crop_y) || (y >= crop_y + (sbs_height * 2)) )
+                    continue;
+
+                const int half = (y - crop_y) / sbs_height;
+                expected[((y - crop_y - (half * sbs_height)) * sbs_width) + (x - crop_x) + (half * crop_width)] = 1;
+            }
+        }
+
+        DPRect sbs_rects[2];
+        const int rect_count = OUtoSBSRemapDirtyRect(dirty_rect, source_width, source_height, crop_x, crop_y, crop_width, crop_height, sbs_rects);
+
+        CHECK( (rect_count >= 0) && (rect_count <= 2) );
+
+        for (int i = 0; i < rect_count; ++i)
+        {
+            const DPRect& rect = sbs_rects[i];
+            CHECK( (rect.Min.x >= 0) && (rect.Min.y >= 0) && (rect.Max.x <= sbs_width) && (rect.Max.y <= sbs_height) );
+            CHECK( (rect.Min.x < rect.Max.x) && (rect.Min.y < rect.Max.y) );
+
+            for (int y = std::max(rect.Min.y, 0); y < std::min(rect.Max.y, sbs_height); ++y)
+            {
+                for (int x = std::max(rect.Min.x, 0); x < std::min(rect.Max.x, sbs_width); ++x)
+                {
+                    covered[(y * sbs_width) + x] = 1;
+                }
+            }
+        }
+
+        CHECK(covered == expected);
+    }
+}
@@ -0,0 +1,194 @@
+#include "TestFramework.h"
+
+#include <random>
+
+#include "OneEuroFilter.h"
+
+static const float k_fPi = 3.14159265f;
+
+//Exponential smoothing factor for a given cutoff, same formula as the filter uses
+static float SmoothingFactorReference(float time_delta, float cutoff)
+{
+    const float tau = 1.0f / (2.0f * k_fPi * cutoff);
+    return 1.0f / (1.0f + (tau / time_delta));
+}
+
+TEST_CASE(OneEuroFilter_FirstValueAndReset)
+{
+    OneEuroFilter filter(1.0f, 0.0f, 1.0f);
+    CHECK(!filter.HasPrevious());
+
+    CHECK(filter.Filter(123.0f, 10.0) == 123.0f);
+    CHECK(filter.HasPrevious());
+    CHECK(filter.GetTimePrevious() == 10.0);
+    CHECK(filter.GetVelocity() == 0.0f);
+
+    filter.Filter(200.0f, 10.1);
+    CHECK(filter.GetVelocity() != 0.0f);
+
+    //After a reset, the next value is passed through again
+    filter.Reset();
+    CHECK(!filter.HasPrevious());
+    CHECK(filter.Filter(-50.0f, 11.0) == -50.0f);
+    CHECK(filter.GetVelocity() == 0.0f);
+}
+
+TEST_CASE(OneEuroFilter_ConstantSignal)
+{
+    OneEuroFilter filter(1.0f, 0.5f, 1.0f);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        CHECK(filter.Filter(42.0f, i / 90.0) == 42.0f);
+    }
+
+    CHECK(filter.GetVelocity() == 0.0f);
+}
+
+TEST_CASE(OneEuroFilter_StepResponseWithoutBeta)
+{
+    //Beta 0 makes it a plain exponential low-pass with min_cutoff
+    const float min_cutoff = 2.0f;
+    const float time_delta = 1.0f / 90.0f;
+    OneEuroFilter filter(min_cutoff, 0.0f, 1.0f);
+
+    filter.Filter(0.0f, 0.0);
+
+    const float alpha = SmoothingFactorReference(time_delta, min_cutoff);
+    float expected = 0.0f;
+
+    for (int i = 1; i <= 100; ++i)
+    {
+        expected += alpha * (100.0f - expected);
+        CHECK_NEAR(filter.Filter(100.0f, i * (double)time_delta), expected, 0.001f);
+    }
+
+    //Approaches the target but never overshoots
+    CHECK(expected > 99.0f);
+    CHECK(expected <= 100.0f);
+}
+
+TEST_CASE(OneEuroFilter_BetaReducesLag)
+{
+    //Fast linear movement at 90 Hz. A higher beta raises the cutoff with speed, so the filtered value lags behind less
+    OneEuroFilter filter_slow(1.0f, 0.0f,  1.0f);
+    OneEuroFilter filter_fast(1.0f, 0.05f, 1.0f);
+    float value = 0.0f, out_slow = 0.0f, out_fast = 0.0f;
+
+    for (int i = 0; i < 90; ++i)
+    {
+        value = i * 20.0f;   //1800 units/second
+        out_slow = filter_slow.Filter(value, i / 90.0);
+        out_fast = filter_fast.Filter(value, i / 90.0);
+    }
+
+    CHECK(value - out_fast < value - out_slow);
+    CHECK(value - out_fast < 20.0f);
+    CHECK(value - out_fast >= 0.0f);
+
+    //Like in the paper, speed is taken against the previous filtered value. It settles a bit above the raw signal's speed, by the filter lag
+    const float velocity = filter_fast.GetVelocity();
+    filter_fast.Filter(90 * 20.0f, 90 / 90.0);
+    CHECK(velocity >= 1800.0f);
+    CHECK_NEAR(filter_fast.GetVelocity(), velocity, velocity * 0.01f);
+}
+
+TEST_CASE(OneEuroFilter_JitterReduction)
+{
+    //Jitter around a resting point, like a laser pointer held still
+    std::mt19937 rng(11);
+    std::normal_distribution<float> noise(0.0f, 2.0f);
+    OneEuroFilter filter(1.0f, 0.007f, 1.0f);
+
+    double variance_in = 0.0, variance_out = 0.0;
+    const int sample_count = 2000;
+
+    for (int i = 0; i < sample_count; ++i)
+    {
+        const float value = 500.0f + noise(rng);
+        const float out   = filter.Filter(value, i / 90.0);
+
+        if (i >= 90)    //Skip the settling time
+        {
+            variance_in  += (value - 500.0f) * (value - 500.0f);
+            variance_out += (out   - 500.0f) * (out   - 500.0f);
+        }
+    }
+
+    //Output jitter should be a fraction of the input's
+    CHECK(variance_out < variance_in * 0.1);
+}
+
+TEST_CASE(OneEuroFilter_Prediction)
+{
+    //Same movement with and without prediction. Predicting one frame ahead should get close to the next frame's raw value at constant speed
+    OneEuroFilter filter(1.0f, 0.05f, 1.0f);
+    OneEuroFilter filter_predict(1.0f, 0.05f, 1.0f);
+    filter_predict.SetPredictionTime(1.0f / 90.0f);
+
+    float value = 0.0f, out = 0.0f, out_predict = 0.0f;
+
+    for (int i = 0; i < 180; ++i)
+    {
+        value = i * 5.0f;
+        out         = filter.Filter(value, i / 90.0);
+        out_predict = filter_predict.Filter(value, i / 90.0);
+    }
+
+    const float value_next = value + 5.0f;
+    CHECK(fabs(value_next - out_predict) < fabs(value_next - out));
+    CHECK_NEAR(out_predict, value_next, 0.5f);
+
+    //Prediction doesn't feed back into the filter state
+    CHECK_NEAR(filter_predict.GetVelocity(), filter.GetVelocity(), 0.001f);
+}
+
+TEST_CASE(OneEuroFilter_TimeEdgeCases)
+{
+    OneEuroFilter filter(1.0f, 0.0f, 1.0f);
+
+    filter.Filter(0.0f, 1.0);
+    const float value_filtered = filter.Filter(10.0f, 1.1);
+    const float velocity = filter.GetVelocity();
+    CHECK(velocity > 0.0f);
+    CHECK(value_filtered < 10.0f);
+
+    //Duplicate timestamp: previous filtered value returned, state kept
+    CHECK(filter.Filter(20.0f, 1.1) == value_filtered);
+    CHECK(filter.GetVelocity() == velocity);
+    CHECK(filter.Filter(20.0f, 1.2) < 20.0f);
+
+    //Time going backwards: value passed through and the speed estimate is dropped
+    CHECK(filter.Filter(30.0f, 0.5) == 30.0f);
+    CHECK(filter.GetVelocity() == 0.0f);
+    CHECK(filter.GetTimePrevious() == 0.5);
+
+    //Disabled cutoff passes everything through
+    OneEuroFilter filter_off(0.0f, 0.0f, 1.0f);
+    filter_off.Filter(0.0f, 0.0);
+    CHECK(filter_off.Filter(77.0f, 0.1) == 77.0f);
+    CHECK(filter_off.Filter(-3.0f, 0.2) == -3.0f);
+}
+
+BENCHMARK(OneEuroFilter_Filter)
+{
+    std::mt19937 rng(3);
+    std::normal_distribution<float> noise(0.0f, 2.0f);
+    std::vector<float> values(1024);
+
+    for (size_t i = 0; i < values.size(); ++i)
+        values[i] = (i * 3.0f) + noise(rng);
+
+    //Two axes per mouse move event, like OutputManager::LaserPointerSmoothingApply()
+    OneEuroFilter filter_x(1.0f, 0.007f, 1.0f);
+    OneEuroFilter filter_y(1.0f, 0.007f, 1.0f);
+    filter_x.SetPredictionTime(0.01f);
+    filter_y.SetPredictionTime(0.01f);
+
+    BenchmarkRun("Filter() x/y pair", 10000000, [&](size_t i)
+    {
+        const double time = i / 90.0;
+        BenchmarkKeep(filter_x.Filter(values[i % values.size()], time));
+        BenchmarkKeep(filter_y.Filter(values[(i + 512) % values.size()], time));
+    });
+}
@@ -0,0 +1,218 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <random>
+
+#include "OverlayHandleMap.h"
+
+//Same as the linear search FindOverlayID() used before
+static unsigned int FindLinear(const std::vector<vr::VROverlayHandle_t>& handles, vr::VROverlayHandle_t handle)
+{
+    if (handle == vr::k_ulOverlayHandleInvalid)
+        return OverlayHandleMap::k_ulIDNone;
+
+    const auto it = std::find(handles.begin(), handles.end(), handle);
+    return (it != handles.end()) ? (unsigned int)(it - handles.begin()) : OverlayHandleMap::k_ulIDNone;
+}
+
+//Same hash as OverlayHandleMap uses, to construct handles that end up in the same probe sequence
+static size_t HashHandleForTest(vr::VROverlayHandle_t handle)
+{
+    uint64_t h = handle;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+
+    return (size_t)h;
+}
+
+//Returns count handles sharing the same home slot in a map with 16 slots (the minimum size)
+static std::vector<vr::VROverlayHandle_t> GetCollidingHandles(size_t count)
+{
+    std::vector<vr::VROverlayHandle_t> handles;
+    const size_t home_slot = HashHandleForTest(1) & 15;
+
+    for (vr::VROverlayHandle_t handle = 1; handles.size() < count; ++handle)
+    {
+        if ((HashHandleForTest(handle) & 15) == home_slot)
+            handles.push_back(handle);
+    }
+
+    return handles;
+}
+
+TEST_CASE(OverlayHandleMap_EmptyAndInvalid)
+{
+    OverlayHandleMap map;
+    CHECK(map.Find(1) == OverlayHandleMap::k_ulIDNone);
+    CHECK(map.Find(vr::k_ulOverlayHandleInvalid) == OverlayHandleMap::k_ulIDNone);
+
+    map.Build({});
+    CHECK(map.Find(1) == OverlayHandleMap::k_ulIDNone);
+
+    //Invalid handles in the list are skipped but still take up their ID
+    map.Build({vr::k_ulOverlayHandleInvalid, 50, vr::k_ulOverlayHandleInvalid, 70});
+    CHECK(map.Find(vr::k_ulOverlayHandleInvalid) == OverlayHandleMap::k_ulIDNone);
+    CHECK(map.Find(50) == 1);
+    CHECK(map.Find(70) == 3);
+    CHECK(map.Find(60) == OverlayHandleMap::k_ulIDNone);
+}
+
+TEST_CASE(OverlayHandleMap_DuplicateHandleLowerIDWins)
+{
+    OverlayHandleMap map;
+    map.Build({10, 20, 10, 30, 20});
+
+    CHECK(map.Find(10) == 0);
+    CHECK(map.Find(20) == 1);
+    CHECK(map.Find(30) == 3);
+}
+
+TEST_CASE(OverlayHandleMap_CollisionChainRemoval)
+{
+    //A, B and C share one probe sequence. Removing B is the case that needs tombstones in a map supporting deletion.
+    //This one is rebuilt instead, so C has to stay reachable after B is gone
+    const std::vector<vr::VROverlayHandle_t> colliding = GetCollidingHandles(3);
+    std::vector<vr::VROverlayHandle_t> handles = {colliding[0], colliding[1], colliding[2]};
+
+    OverlayHandleMap map;
+    map.Build(handles);
+    CHECK(map.Find(colliding[0]) == 0);
+    CHECK(map.Find(colliding[1]) == 1);
+    CHECK(map.Find(colliding[2]) == 2);
+
+    //Remove B
+    handles[1] = vr::k_ulOverlayHandleInvalid;
+    map.Build(handles);
+    CHECK(map.Find(colliding[0]) == 0);
+    CHECK(map.Find(colliding[1]) == OverlayHandleMap::k_ulIDNone);
+    CHECK(map.Find(colliding[2]) == 2);
+
+    //Reinsert B under a different ID, like after overlays got swapped around
+    handles.push_back(colliding[1]);
+    map.Build(handles);
+    CHECK(map.Find(colliding[0]) == 0);
+    CHECK(map.Find(colliding[1]) == 3);
+    CHECK(map.Find(colliding[2]) == 2);
+
+    //Remove the head of the chain
+    handles[0] = vr::k_ulOverlayHandleInvalid;
+    map.Build(handles);
+    CHECK(map.Find(colliding[0]) == OverlayHandleMap::k_ulIDNone);
+    CHECK(map.Find(colliding[1]) == 3);
+    CHECK(map.Find(colliding[2]) == 2);
+}
+
+TEST_CASE(OverlayHandleMap_FullCollisionCluster)
+{
+    //Fill the minimum sized map up to its load factor with handles all hashing to the same slot, so probing has to wrap around
+    const std::vector<vr::VROverlayHandle_t> handles = GetCollidingHandles(8);
+
+    OverlayHandleMap map;
+    map.Build(handles);
+
+    for (unsigned int i = 0; i < handles.size(); ++i)
+    {
+        CHECK(map.Find(handles[i]) == i);
+    }
+
+    //Misses with the same home slot have to walk the whole cluster and still terminate
+    const std::vector<vr::VROverlayHandle_t> more_colliding = GetCollidingHandles(12);
+
+    for (size_t i = 8; i < more_colliding.size(); ++i)
+    {
+        CHECK(map.Find(more_colliding[i]) == OverlayHandleMap::k_ulIDNone);
+    }
+}
+
+TEST_CASE(OverlayHandleMap_Rehash)
+{
+    //Rebuild with growing handle lists, crossing several slot count doublings
+    std::vector<vr::VROverlayHandle_t> handles;
+    OverlayHandleMap map;
+
+    for (vr::VROverlayHandle_t handle = 0x1000; handles.size() < 300; handle += 0x100)
+    {
+        handles.push_back(handle);
+        map.Build(handles);
+
+        CHECK(map.Find(handles.front()) == 0);
+        CHECK(map.Find(handles.back()) == handles.size() - 1);
+        CHECK(map.Find(handle + 1) == OverlayHandleMap::k_ulIDNone);
+    }
+
+    for (unsigned int i = 0; i < handles.size(); ++i)
+    {
+        CHECK(map.Find(handles[i]) == i);
+    }
+
+    //Shrinking again works the same way
+    handles.resize(5);
+    map.Build(handles);
+
+    for (unsigned int i = 0; i < handles.size(); ++i)
+    {
+        CHECK(map.Find(handles[i]) == i);
+    }
+
+    CHECK(map.Find(0x1000 + (0x100 * 200)) == OverlayHandleMap::k_ulIDNone);
+}
+
+TEST_CASE(OverlayHandleMap_RandomizedMatchesLinearSearch)
+{
+    std::mt19937_64 rng(99);
+
+    for (int round = 0; round < 100; ++round)
+    {
+        //Small handle range to get duplicates and invalid handles in there as well
+        std::uniform_int_distribution<vr::VROverlayHandle_t> handle_dist(0, (round % 2 == 0) ? 64 : 0xFFFFFFFFFFFFULL);
+        std::vector<vr::VROverlayHandle_t> handles(round);
+
+        for (auto& handle : handles)
+            handle = handle_dist(rng);
+
+        OverlayHandleMap map;
+        map.Build(handles);
+
+        for (int i = 0; i < 200; ++i)
+        {
+            const vr::VROverlayHandle_t handle = ( (i % 2 == 0) && (!handles.empty()) ) ? handles[i % handles.size()] : handle_dist(rng);
+            CHECK(map.Find(handle) == FindLinear(handles, handle));
+        }
+    }
+}
+
+BENCHMARK(OverlayHandleMap_Find)
+{
+    std::mt19937_64 rng(7);
+
+    for (size_t overlay_count : {4, 16, 64, 256})
+    {
+        //OpenVR handles are large and fairly sequential
+        std::vector<vr::VROverlayHandle_t> handles(overlay_count);
+        for (size_t i = 0; i < overlay_count; ++i)
+            handles[i] = 0x10000000ULL + (i * 0x10) + (rng() % 4);
+
+        std::vector<vr::VROverlayHandle_t> lookups(1024);
+        for (auto& lookup : lookups)
+            lookup = handles[rng() % overlay_count];
+
+        OverlayHandleMap map;
+        map.Build(handles);
+
+        char label[128];
+        snprintf(label, sizeof(label), "Hash map, %zu overlays", overlay_count);
+        BenchmarkRun(label, 5000000, [&](size_t i){ BenchmarkKeep(map.Find(lookups[i % lookups.size()])); });
+
+        snprintf(label, sizeof(label), "Linear search, %zu overlays", overlay_count);
+        BenchmarkRun(label, 5000000, [&](size_t i){ BenchmarkKeep(FindLinear(handles, lookups[i % lookups.size()])); });
+
+        snprintf(label, sizeof(label), "Hash map miss, %zu overlays", overlay_count);
+        BenchmarkRun(label, 5000000, [&](size_t i){ BenchmarkKeep(map.Find(0x20000000ULL + i)); });
+
+        snprintf(label, sizeof(label), "Rebuild, %zu overlays", overlay_count);
+        BenchmarkRun(label, 100000, [&](size_t){ map.Build(handles); });
+    }
+}
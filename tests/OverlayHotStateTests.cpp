@@ -0,0 +1,324 @@
+#include "TestFramework.h"
+
+#include <string>
+
+#include "OverlayHotState.h"
+
+//Values of OverlayCaptureSource and UpdateLimitMode from ConfigManager.h, which can't be included here
+static const int k_CapSourceDesktopDuplication = 0;
+static const int k_CapSourceWinRT              = 1;
+static const int k_UpdateLimitModeOff          = 0;
+
+//Stand-ins for the per-overlay objects the per-frame loops used to read from, with the same member layout as Overlay and OverlayConfigData
+struct LegacyOverlay
+{
+    unsigned int ID = 0;
+    vr::VROverlayHandle_t OvrlHandle = vr::k_ulOverlayHandleInvalid;
+    bool Visible = false;
+    float Opacity = 1.0f;
+    bool GlobalInteractive = false;
+    DPRect ValidatedCropRect;
+    OverlayTextureSource TextureSource = ovrl_texsource_none;
+
+    //Getters used by OverlayHotState::Update(), same as Overlay's
+    vr::VROverlayHandle_t GetHandle() const          { return OvrlHandle; }
+    bool IsVisible() const                           { return Visible; }
+    OverlayTextureSource GetTextureSource() const    { return TextureSource; }
+    const DPRect& GetValidatedCropRect() const       { return ValidatedCropRect; }
+};
+
+struct LegacyOverlayConfigData
+{
+    std::string ConfigNameStr;
+    bool ConfigBool[12] = {};
+    int ConfigInt[15] = {};
+    float ConfigFloat[11] = {};
+    intptr_t ConfigIntPtr[1] = {};
+    std::string ConfigStr[2];
+    float ConfigDetachedTransform[8][16] = {};
+    std::vector<int> ConfigActionBarOrder;
+};
+
+static const int k_ConfigIntCaptureSource      = 3;     //Arbitrary positions inside the int array, just needs to not be at the start
+static const int k_ConfigIntUpdateLimitMode    = 11;
+
+struct OverlaySet
+{
+    std::vector<LegacyOverlay> Overlays;
+    std::vector<LegacyOverlayConfigData> ConfigData;
+    OverlayHotState HotState;
+
+    explicit OverlaySet(unsigned int count)
+    {
+        Overlays.resize(count);
+        ConfigData.resize(count);
+        HotState.Resize(count);
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            LegacyOverlay& overlay = Overlays[i];
+            LegacyOverlayConfigData& data = ConfigData[i];
+
+            //Mix of visible/hidden, desktop duplication/WinRT and limiter overrides like a busy setup would have
+            overlay.ID                = i;
+            overlay.OvrlHandle        = 1000 + i;
+            overlay.Visible           = (i % 3 != 0);
+            overlay.ValidatedCropRect = DPRect(i * 10, 0, (i * 10) + 640, 480);
+            overlay.TextureSource     = (i % 4 == 0) ? ovrl_texsource_winrt_capture : (i % 5 == 0) ? ovrl_texsource_desktop_duplication_3dou_converted :
+                                                                                                       ovrl_texsource_desktop_duplication;
+            data.ConfigNameStr = "Overlay " + std::to_string(i);
+            data.ConfigInt[k_ConfigIntCaptureSource]   = (i % 4 == 0) ? k_CapSourceWinRT : k_CapSourceDesktopDuplication;
+            data.ConfigInt[k_ConfigIntUpdateLimitMode] = (i % 7 == 0) ? 1 : k_UpdateLimitModeOff;
+
+            Sync(i);
+        }
+    }
+
+    //Same as OverlayManager::UpdateHotState()
+    int Sync(unsigned int id)
+    {
+        if ( (id >= Overlays.size()) || (id >= ConfigData.size()) )
+            return ovrl_hotstate_change_none;
+
+        const LegacyOverlayConfigData& data = ConfigData[id];
+        return HotState.Update(id, Overlays[id], data.ConfigInt[k_ConfigIntCaptureSource], data.ConfigInt[k_ConfigIntUpdateLimitMode]);
+    }
+
+    //Same as OverlayManager::AddOverlay()
+    unsigned int Add()
+    {
+        const unsigned int id = (unsigned int)Overlays.size();
+
+        Overlays.emplace_back();
+        Overlays.back().ID = id;
+        ConfigData.emplace_back();
+        HotState.Resize(Overlays.size());
+        Sync(id);
+
+        return id;
+    }
+
+    //Same as OverlayManager::RemoveOverlay(), minus the OpenVR handle shuffling. Removing anything but the last overlay rebuilds the hot state
+    void Remove(unsigned int id)
+    {
+        const bool is_last = (id + 1 == Overlays.size());
+
+        Overlays.erase(Overlays.begin() + id);
+        ConfigData.erase(ConfigData.begin() + id);
+        HotState.Resize(Overlays.size());
+
+        if (!is_last)
+        {
+            for (unsigned int i = 0; i < Overlays.size(); ++i)
+            {
+                Sync(i);
+            }
+        }
+    }
+
+    bool IsInSync() const
+    {
+        const size_t count = Overlays.size();
+
+        if ( (HotState.Handle.size() != count) || (HotState.Visible.size() != count) || (HotState.TextureSource.size() != count) || (HotState.CropRect.size() != count) ||
+             (HotState.CaptureSource.size() != count) || (HotState.UpdateLimitOverrideMode.size() != count) )
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const LegacyOverlay& overlay = Overlays[i];
+            const LegacyOverlayConfigData& data = ConfigData[i];
+
+            if ( (HotState.Handle[i] != overlay.OvrlHandle) || (HotState.Visible[i] != overlay.Visible) || (HotState.TextureSource[i] != overlay.TextureSource) ||
+                 (!(HotState.CropRect[i] == overlay.ValidatedCropRect)) || (HotState.CaptureSource[i] != data.ConfigInt[k_ConfigIntCaptureSource]) ||
+                 (HotState.UpdateLimitOverrideMode[i] != data.ConfigInt[k_ConfigIntUpdateLimitMode]) )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+};
+
+//Same loop shapes as OutputManager::ResetOverlayActiveCount(), RefreshOpenVROverlayTexture() and ApplySettingUpdateLimiter()
+static unsigned int LoopsLegacy(const OverlaySet& set)
+{
+    unsigned int active_count = 0, dupl_active_count = 0, converted_count = 0, override_count = 0;
+    const unsigned int overlay_count = (unsigned int)set.Overlays.size();
+
+    for (unsigned int i = 0; i < overlay_count; ++i)
+    {
+        const bool is_visible = set.Overlays[i].Visible;
+        active_count      += is_visible;
+        dupl_active_count += ( (is_visible) && (set.ConfigData[i].ConfigInt[k_ConfigIntCaptureSource] == k_CapSourceDesktopDuplication) );
+    }
+
+    for (unsigned int i = 0; i < overlay_count; ++i)
+    {
+        if (set.ConfigData[i].ConfigInt[k_ConfigIntCaptureSource] != k_CapSourceDesktopDuplication)
+            continue;
+
+        if ( (set.Overlays[i].Visible) && (set.Overlays[i].TextureSource == ovrl_texsource_desktop_duplication_3dou_converted) )
+            converted_count++;
+    }
+
+    for (unsigned int i = 0; i < overlay_count; ++i)
+    {
+        const LegacyOverlayConfigData& data = set.ConfigData[i];
+
+        if ( (set.Overlays[i].Visible) && (data.ConfigInt[k_ConfigIntCaptureSource] == k_CapSourceDesktopDuplication) &&
+             (data.ConfigInt[k_ConfigIntUpdateLimitMode] != k_UpdateLimitModeOff) )
+        {
+            override_count++;
+        }
+    }
+
+    return active_count + (dupl_active_count << 8) + (converted_count << 16) + (override_count << 24);
+}
+
+static unsigned int LoopsHotState(const OverlayHotState& hot_state)
+{
+    unsigned int active_count = 0, dupl_active_count = 0, converted_count = 0, override_count = 0;
+    const unsigned int overlay_count = (unsigned int)hot_state.Visible.size();
+
+    for (unsigned int i = 0; i < overlay_count; ++i)
+    {
+        const bool is_visible = hot_state.Visible[i];
+        active_count      += is_visible;
+        dupl_active_count += ( (is_visible) && (hot_state.CaptureSource[i] == k_CapSourceDesktopDuplication) );
+    }
+
+    for (unsigned int i = 0; i < overlay_count; ++i)
+    {
+        if (hot_state.CaptureSource[i] != k_CapSourceDesktopDuplication)
+            continue;
+
+        if ( (hot_state.Visible[i]) && (hot_state.TextureSource[i] == ovrl_texsource_desktop_duplication_3dou_converted) )
+            converted_count++;
+    }
+
+    for (unsigned int i = 0; i < overlay_count; ++i)
+    {
+        if ( (hot_state.Visible[i]) && (hot_state.CaptureSource[i] == k_CapSourceDesktopDuplication) && (hot_state.UpdateLimitOverrideMode[i] != k_UpdateLimitModeOff) )
+        {
+            override_count++;
+        }
+    }
+
+    return active_count + (dupl_active_count << 8) + (converted_count << 16) + (override_count << 24);
+}
+
+TEST_CASE(OverlayHotState_MatchesLegacyLoops)
+{
+    const OverlaySet set(64);
+    CHECK(set.IsInSync());
+    CHECK(LoopsHotState(set.HotState) == LoopsLegacy(set));
+}
+
+TEST_CASE(OverlayHotState_ConfigChange)
+{
+    OverlaySet set(8);
+
+    //Config values only update the mirrored fields, no dependent cache needs a rebuild
+    set.ConfigData[3].ConfigInt[k_ConfigIntCaptureSource]   = k_CapSourceWinRT;
+    set.ConfigData[3].ConfigInt[k_ConfigIntUpdateLimitMode] = 2;
+    CHECK(set.Sync(3) == ovrl_hotstate_change_none);
+    CHECK( (set.HotState.CaptureSource[3] == k_CapSourceWinRT) && (set.HotState.UpdateLimitOverrideMode[3] == 2) );
+    CHECK(set.IsInSync());
+
+    //Nothing changed
+    CHECK(set.Sync(3) == ovrl_hotstate_change_none);
+
+    //Visibility, texture source and crop rect affect the rect index
+    set.Overlays[5].Visible = !set.Overlays[5].Visible;
+    CHECK(set.Sync(5) == ovrl_hotstate_change_rect_index);
+    set.Overlays[5].TextureSource = ovrl_texsource_winrt_capture;
+    CHECK(set.Sync(5) == ovrl_hotstate_change_rect_index);
+    set.Overlays[5].ValidatedCropRect = DPRect(1, 2, 3, 4);
+    CHECK(set.Sync(5) == ovrl_hotstate_change_rect_index);
+    CHECK(set.HotState.CropRect[5] == DPRect(1, 2, 3, 4));
+
+    //Handle affects the handle map
+    set.Overlays[6].OvrlHandle = 42;
+    CHECK(set.Sync(6) == ovrl_hotstate_change_handle);
+    CHECK(set.HotState.Handle[6] == 42);
+
+    set.Overlays[7].OvrlHandle = 43;
+    set.Overlays[7].Visible    = !set.Overlays[7].Visible;
+    CHECK(set.Sync(7) == (ovrl_hotstate_change_handle | ovrl_hotstate_change_rect_index));
+
+    CHECK(set.IsInSync());
+    CHECK(LoopsHotState(set.HotState) == LoopsLegacy(set));
+
+    //Out of range IDs are ignored, as overlays can call this while being added or removed
+    CHECK(set.HotState.Update(8, set.Overlays[0], 0, 0) == ovrl_hotstate_change_none);
+    CHECK(set.HotState.Handle.size() == 8);
+}
+
+TEST_CASE(OverlayHotState_AddRemove)
+{
+    OverlaySet set(4);
+
+    //Added overlays get default values until they're set up
+    const unsigned int id = set.Add();
+    CHECK(id == 4);
+    CHECK(set.IsInSync());
+    CHECK( (set.HotState.Handle[id] == vr::k_ulOverlayHandleInvalid) && (!set.HotState.Visible[id]) && (set.HotState.TextureSource[id] == ovrl_texsource_none) );
+    CHECK( (set.HotState.CaptureSource[id] == k_CapSourceDesktopDuplication) && (set.HotState.UpdateLimitOverrideMode[id] == k_UpdateLimitModeOff) );
+
+    set.Overlays[id].OvrlHandle    = 2000;
+    set.Overlays[id].Visible       = true;
+    set.Overlays[id].TextureSource = ovrl_texsource_desktop_duplication;
+    CHECK(set.Sync(id) == (ovrl_hotstate_change_handle | ovrl_hotstate_change_rect_index));
+    CHECK(set.IsInSync());
+
+    //Removing from the middle shifts everything after it down
+    const vr::VROverlayHandle_t handle_after = set.Overlays[2].OvrlHandle;
+    set.Remove(1);
+    CHECK(set.HotState.Handle.size() == 4);
+    CHECK(set.HotState.Handle[1] == handle_after);
+    CHECK(set.IsInSync());
+
+    //Removing the last one only shrinks
+    set.Remove(3);
+    CHECK(set.HotState.Handle.size() == 3);
+    CHECK(set.IsInSync());
+
+    //Down to nothing and back up
+    while (!set.Overlays.empty())
+    {
+        set.Remove(0);
+    }
+
+    CHECK(set.HotState.Visible.empty());
+    set.Add();
+    CHECK(set.IsInSync());
+    CHECK(LoopsHotState(set.HotState) == LoopsLegacy(set));
+}
+
+BENCHMARK(OverlayHotState_PerFrameLoops64)
+{
+    const OverlaySet set(64);
+
+    printf("  sizeof legacy overlay data: %zu bytes per overlay, hot state: %zu bytes per overlay\n",
+           sizeof(LegacyOverlay) + sizeof(LegacyOverlayConfigData),
+           sizeof(vr::VROverlayHandle_t) + sizeof(unsigned char) + sizeof(OverlayTextureSource) + sizeof(DPRect) + (sizeof(int) * 2));
+
+    BenchmarkRun("Overlay + OverlayConfigData (64 overlays)", 2000000, [&](size_t){ BenchmarkKeep(LoopsLegacy(set)); });
+    BenchmarkRun("OverlayHotState (64 overlays)",             2000000, [&](size_t){ BenchmarkKeep(LoopsHotState(set.HotState)); });
+
+    //Per-frame loops usually run with cold caches, as a whole frame of other work happens in-between.
+    //Cycle through enough copies of the data to not fit into the CPU caches (for the legacy layout at least) to get closer to that
+    const size_t set_count = 256;
+    std::vector<OverlaySet> sets;
+    sets.reserve(set_count);
+
+    for (size_t i = 0; i < set_count; ++i)
+        sets.emplace_back(64);
+
+    BenchmarkRun("Overlay + OverlayConfigData (64 overlays, 256 copies)", 200000, [&](size_t i){ BenchmarkKeep(LoopsLegacy(sets[(i * 97) % set_count])); });
+    BenchmarkRun("OverlayHotState (64 overlays, 256 copies)",             200000, [&](size_t i){ BenchmarkKeep(LoopsHotState(sets[(i * 97) % set_count].HotState)); });
+}
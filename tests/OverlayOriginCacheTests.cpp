@@ -0,0 +1,98 @@
+#include "TestFramework.h"
+
+#include <cmath>
+
+#include "OverlayOriginCache.h"
+
+//Stand-ins for the OverlayOrigin values, ConfigManager.h can't be included here
+static const int k_origin_room   = 0;
+static const int k_origin_hmd    = 1;
+static const int k_origin_count  = 2;
+
+static Matrix4 TranslationMatrix(float x, float y, float z)
+{
+    Matrix4 matrix;
+    matrix.translate(x, y, z);
+    return matrix;
+}
+
+static bool MatrixNear(const Matrix4& a, const Matrix4& b)
+{
+    for (int i = 0; i < 16; ++i)
+    {
+        if (std::fabs(a.get()[i] - b.get()[i]) > 0.0001f)
+            return false;
+    }
+
+    return true;
+}
+
+TEST_CASE(OverlayOriginCache_OriginStamp)
+{
+    OverlayOriginCache cache(k_origin_count);
+
+    CHECK(!cache.IsCurrent(k_origin_hmd, 1));
+
+    cache.Set(k_origin_hmd, 1, TranslationMatrix(0.0f, 1.5f, 0.0f));
+    CHECK(cache.IsCurrent(k_origin_hmd, 1));
+    CHECK(!cache.IsCurrent(k_origin_hmd, 2));
+    CHECK(!cache.IsCurrent(k_origin_room, 1));
+
+    cache.Invalidate(k_origin_hmd);
+    CHECK(!cache.IsCurrent(k_origin_hmd, 1));
+
+    cache.Set(k_origin_room, 0, Matrix4());
+    cache.Set(k_origin_hmd, 2, Matrix4());
+    cache.InvalidateAll();
+    CHECK(!cache.IsCurrent(k_origin_room, 0));
+    CHECK(!cache.IsCurrent(k_origin_hmd, 2));
+}
+
+TEST_CASE(OverlayOriginCache_OverlayMatrix)
+{
+    OverlayOriginCache cache(k_origin_count);
+
+    Matrix4 mat_origin = TranslationMatrix(0.0f, 1.5f, 0.0f);
+    mat_origin.rotateY(90.0f);
+    const Matrix4 mat_transform = TranslationMatrix(0.0f, 0.0f, -1.0f);
+
+    cache.Set(k_origin_hmd, 1, mat_origin);
+
+    //First access computes
+    CHECK(MatrixNear(cache.GetOverlayMatrix(3, k_origin_hmd, mat_transform), mat_origin * mat_transform));
+    CHECK(cache.GetOverlayComputeCount() == 1);
+
+    //Hit, nothing changed
+    for (int i = 0; i < 10; ++i)
+    {
+        CHECK(MatrixNear(cache.GetOverlayMatrix(3, k_origin_hmd, mat_transform), mat_origin * mat_transform));
+    }
+    CHECK(cache.GetOverlayComputeCount() == 1);
+
+    //Same origin stamp still being current doesn't recompute, other overlays are cached separately
+    CHECK(cache.IsCurrent(k_origin_hmd, 1));
+    cache.GetOverlayMatrix(0, k_origin_hmd, mat_transform);
+    cache.GetOverlayMatrix(3, k_origin_hmd, mat_transform);
+    CHECK(cache.GetOverlayComputeCount() == 2);
+
+    //Origin set again on the next frame invalidates, recomputed with the new origin matrix
+    const Matrix4 mat_origin_new = TranslationMatrix(1.0f, 1.5f, 0.0f);
+    cache.Set(k_origin_hmd, 2, mat_origin_new);
+    CHECK(MatrixNear(cache.GetOverlayMatrix(3, k_origin_hmd, mat_transform), mat_origin_new * mat_transform));
+    CHECK(cache.GetOverlayComputeCount() == 3);
+    cache.GetOverlayMatrix(3, k_origin_hmd, mat_transform);
+    CHECK(cache.GetOverlayComputeCount() == 3);
+
+    //Overlay transform changed
+    const Matrix4 mat_transform_new = TranslationMatrix(0.0f, 0.5f, -2.0f);
+    CHECK(MatrixNear(cache.GetOverlayMatrix(3, k_origin_hmd, mat_transform_new), mat_origin_new * mat_transform_new));
+    CHECK(cache.GetOverlayComputeCount() == 4);
+
+    //Overlay origin changed
+    const Matrix4 mat_room = TranslationMatrix(0.0f, 0.0f, 2.0f);
+    cache.Set(k_origin_room, 0, mat_room);
+    CHECK(MatrixNear(cache.GetOverlayMatrix(3, k_origin_room, mat_transform_new), mat_room * mat_transform_new));
+    CHECK(cache.GetOverlayComputeCount() == 5);
+    cache.GetOverlayMatrix(3, k_origin_room, mat_transform_new);
+    CHECK(cache.GetOverlayComputeCount() == 5);
+}
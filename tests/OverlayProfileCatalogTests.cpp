@@ -0,0 +1,319 @@
+#include "TestFramework.h"
+
+#include <fstream>
+#include <map>
+#include <string>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "OverlayProfileCatalog.h"
+#include "DirectoryWatcherInotify.h"
+
+//In-memory file system. Profile contents are just the overlay name
+struct FakeFileSystem
+{
+    struct File
+    {
+        uint64_t Size;
+        uint64_t WriteTime;
+        std::string OverlayName;
+    };
+
+    std::map<std::string, std::map<std::string, File>> Directories;    //Path -> profile name -> file
+    int ListCount = 0;
+    int ReadCount = 0;
+};
+
+class FakeBackend : public OverlayProfileCatalogBackend
+{
+    private:
+        FakeFileSystem& m_FS;
+
+    public:
+        FakeBackend(FakeFileSystem& fs) : m_FS(fs) {}
+
+        bool DirectoryExists(const std::string& path) const override
+        {
+            return (m_FS.Directories.find(path) != m_FS.Directories.end());
+        }
+
+        void ListProfileFiles(const std::string& path, std::vector<OverlayProfileFileInfo>& files) const override
+        {
+            m_FS.ListCount++;
+
+            const auto it = m_FS.Directories.find(path);
+            if (it == m_FS.Directories.end())
+                return;
+
+            for (const auto& file : it->second)
+            {
+                files.push_back({file.first, file.second.Size, file.second.WriteTime});
+            }
+        }
+
+        void ReadProfileInfo(const std::string& path, bool /*multi_overlay*/, OverlayProfileInfo& info) const override
+        {
+            m_FS.ReadCount++;
+            info.OverlayName  = m_FS.Directories.at(path).at(info.Name).OverlayName;
+            info.OverlayCount = 1;
+        }
+};
+
+//Watcher signaled by the test
+struct FakeWatcherState
+{
+    std::string Path;
+    bool IsSubdirectoriesOnly = false;
+    bool IsWatching = false;
+    bool IsSignaled = false;
+    bool CanWatch = true;
+};
+
+class FakeWatcher : public DirectoryWatcher
+{
+    private:
+        FakeWatcherState& m_State;
+
+    public:
+        FakeWatcher(FakeWatcherState& state) : m_State(state) {}
+
+        bool Watch(const std::string& path, bool subdirectories_only) override
+        {
+            m_State.Path                 = path;
+            m_State.IsSubdirectoriesOnly = subdirectories_only;
+            m_State.IsWatching           = m_State.CanWatch;
+            m_State.IsSignaled           = false;
+            return m_State.IsWatching;
+        }
+
+        void Close() override        { m_State.IsWatching = false; }
+        bool IsWatching() const override { return m_State.IsWatching; }
+
+        bool PollChanges() override
+        {
+            const bool is_signaled = m_State.IsSignaled;
+            m_State.IsSignaled = false;
+            return is_signaled;
+        }
+};
+
+struct FakeCatalog
+{
+    FakeFileSystem FS;
+    FakeWatcherState Watcher;
+    OverlayProfileCatalog Catalog;
+
+    FakeCatalog() : Catalog(std::make_unique<FakeBackend>(FS), std::make_unique<FakeWatcher>(Watcher)) {}
+};
+
+static std::vector<std::string> Names(std::initializer_list<const char*> profile_names)
+{
+    std::vector<std::string> names = {"Default"};
+    names.insert(names.end(), profile_names.begin(), profile_names.end());
+    names.push_back("[New Profile]");
+    return names;
+}
+
+TEST_CASE(OverlayProfileCatalog_AddRemoveModify)
+{
+    FakeCatalog test;
+    auto& dir = test.FS.Directories["profiles/overlays/"];
+    dir["a"] = {10, 1, "Overlay A"};
+    dir["b"] = {20, 1, "Overlay B"};
+
+    test.Catalog.SetDirectory("profiles/overlays/", false);
+    CHECK(test.Catalog.GetNameList() == Names({"a", "b"}));
+    CHECK( (test.Watcher.IsWatching) && (test.Watcher.Path == "profiles/overlays/") && (!test.Watcher.IsSubdirectoriesOnly) );
+    CHECK(test.FS.ReadCount == 2);
+
+    //Nothing changed, no file system access
+    const int list_count = test.FS.ListCount;
+    CHECK(!test.Catalog.Update());
+    CHECK(test.Catalog.GetNameList() == Names({"a", "b"}));
+    CHECK(test.Catalog.GetProfileInfo("a") != nullptr);
+    CHECK(test.FS.ListCount == list_count);
+
+    //Added, only the new profile is read
+    dir["c"] = {30, 1, "Overlay C"};
+    test.Watcher.IsSignaled = true;
+    CHECK(test.Catalog.GetNameList() == Names({"a", "b", "c"}));
+    CHECK(test.FS.ReadCount == 3);
+    CHECK( (test.Catalog.GetProfileInfo("c") != nullptr) && (test.Catalog.GetProfileInfo("c")->OverlayName == "Overlay C") );
+
+    //Modified, only that profile is read again. Either size or write time changing counts
+    dir["a"] = {10, 2, "Overlay A2"};
+    dir["b"].Size = 21;
+    dir["b"].OverlayName = "Overlay B2";
+    test.Watcher.IsSignaled = true;
+    CHECK(test.Catalog.Update());
+    CHECK(test.FS.ReadCount == 5);
+    CHECK(test.Catalog.GetProfileInfo("a")->OverlayName == "Overlay A2");
+    CHECK(test.Catalog.GetProfileInfo("b")->OverlayName == "Overlay B2");
+    CHECK(test.Catalog.GetProfileInfo("c")->OverlayName == "Overlay C");
+
+    //Removed
+    dir.erase("b");
+    test.Watcher.IsSignaled = true;
+    CHECK(test.Catalog.GetNameList() == Names({"a", "c"}));
+    CHECK(test.Catalog.GetProfileInfo("b") == nullptr);
+    CHECK(test.FS.ReadCount == 5);
+}
+
+TEST_CASE(OverlayProfileCatalog_Invalidate)
+{
+    FakeCatalog test;
+    test.FS.Directories["profiles/"]["a"] = {10, 1, "A"};
+    test.Catalog.SetDirectory("profiles/", false);
+    CHECK(test.Catalog.GetNameList() == Names({"a"}));
+
+    //Written by this process, no notification seen yet
+    test.FS.Directories["profiles/"]["b"] = {10, 1, "B"};
+    CHECK(test.Catalog.GetNameList() == Names({"a"}));
+    test.Catalog.Invalidate();
+    CHECK(test.Catalog.GetNameList() == Names({"a", "b"}));
+}
+
+TEST_CASE(OverlayProfileCatalog_MissingDirectory)
+{
+    FakeCatalog test;
+    test.FS.Directories["app/"];
+
+    //Closest existing parent is watched for directories
+    test.Catalog.SetDirectory("app/profiles/overlays/", false);
+    CHECK(test.Catalog.GetNameList() == Names({}));
+    CHECK( (test.Watcher.IsWatching) && (test.Watcher.Path == "app/") && (test.Watcher.IsSubdirectoriesOnly) );
+    CHECK(test.FS.ListCount == 0);
+
+    CHECK(!test.Catalog.Update());
+
+    //Intermediate directory moves the watch one level closer
+    test.FS.Directories["app/profiles/"];
+    test.Watcher.IsSignaled = true;
+    CHECK(test.Catalog.Update());
+    CHECK( (test.Watcher.Path == "app/profiles/") && (test.Watcher.IsSubdirectoriesOnly) );
+
+    //Profile directory created, now it's watched itself
+    test.FS.Directories["app/profiles/overlays/"]["a"] = {10, 1, "A"};
+    test.Watcher.IsSignaled = true;
+    CHECK(test.Catalog.GetNameList() == Names({"a"}));
+    CHECK( (test.Watcher.Path == "app/profiles/overlays/") && (!test.Watcher.IsSubdirectoriesOnly) );
+}
+
+TEST_CASE(OverlayProfileCatalog_NoWatcher)
+{
+    //Without change notifications every access rescans, like before the catalog existed
+    FakeCatalog test;
+    test.Watcher.CanWatch = false;
+    test.FS.Directories["profiles/"]["a"] = {10, 1, "A"};
+    test.Catalog.SetDirectory("profiles/", false);
+
+    CHECK(test.Catalog.GetNameList() == Names({"a"}));
+    CHECK(test.Catalog.Update());
+
+    test.FS.Directories["profiles/"]["b"] = {10, 1, "B"};
+    CHECK(test.Catalog.GetNameList() == Names({"a", "b"}));
+    CHECK(test.FS.ReadCount == 2);
+}
+
+//Real files in a temporary directory, watched with inotify
+class PosixBackend : public OverlayProfileCatalogBackend
+{
+    public:
+        bool DirectoryExists(const std::string& path) const override
+        {
+            struct stat st;
+            return ( (::stat(path.c_str(), &st) == 0) && (S_ISDIR(st.st_mode)) );
+        }
+
+        void ListProfileFiles(const std::string& path, std::vector<OverlayProfileFileInfo>& files) const override
+        {
+            DIR* dir = ::opendir(path.c_str());
+            if (dir == nullptr)
+                return;
+
+            while (const dirent* entry = ::readdir(dir))
+            {
+                const std::string name = entry->d_name;
+                struct stat st;
+
+                if ( (name.size() <= 4) || (name.compare(name.size() - 4, 4, ".ini") != 0) || (::stat((path + name).c_str(), &st) != 0) )
+                    continue;
+
+                files.push_back({name.substr(0, name.size() - 4), (uint64_t)st.st_size, ((uint64_t)st.st_mtim.tv_sec * 1000000000ULL) + st.st_mtim.tv_nsec});
+            }
+
+            ::closedir(dir);
+        }
+
+        void ReadProfileInfo(const std::string& path, bool /*multi_overlay*/, OverlayProfileInfo& info) const override
+        {
+            std::ifstream file(path + info.Name + ".ini");
+            std::getline(file, info.OverlayName);
+            info.OverlayCount = 1;
+        }
+};
+
+static void WriteProfile(const std::string& path, const std::string& content)
+{
+    std::ofstream file(path);
+    file << content << "\n";
+}
+
+TEST_CASE(OverlayProfileCatalog_Inotify)
+{
+    char dir_template[] = "/tmp/dplus_catalog_XXXXXX";
+    const char* temp_dir = ::mkdtemp(dir_template);
+    CHECK(temp_dir != nullptr);
+    if (temp_dir == nullptr)
+        return;
+
+    const std::string base_path    = std::string(temp_dir) + "/";
+    const std::string profile_path = base_path + "overlays/";
+
+    {
+        OverlayProfileCatalog catalog(std::make_unique<PosixBackend>(), std::make_unique<DirectoryWatcherInotify>());
+        catalog.SetDirectory(profile_path, false);
+
+        //Missing directory, parent is watched
+        CHECK(catalog.GetNameList() == Names({}));
+        CHECK(!catalog.Update());
+
+        //Directory created, picked up without invalidating
+        ::mkdir(profile_path.c_str(), 0755);
+        CHECK(catalog.Update());
+        CHECK(catalog.GetNameList() == Names({}));
+
+        //Add
+        WriteProfile(profile_path + "a.ini", "Overlay A");
+        CHECK(catalog.GetNameList() == Names({"a"}));
+        CHECK( (catalog.GetProfileInfo("a") != nullptr) && (catalog.GetProfileInfo("a")->OverlayName == "Overlay A") );
+        CHECK(!catalog.Update());
+
+        //Modify
+        WriteProfile(profile_path + "a.ini", "Overlay A, modified");
+        CHECK(catalog.Update());
+        CHECK(catalog.GetProfileInfo("a")->OverlayName == "Overlay A, modified");
+
+        //Files that aren't profiles still trigger a rescan but don't show up
+        WriteProfile(profile_path + "b.ini", "Overlay B");
+        WriteProfile(profile_path + "notes.txt", "");
+        CHECK(catalog.GetNameList() == Names({"a", "b"}));
+
+        //Remove
+        ::unlink((profile_path + "a.ini").c_str());
+        CHECK(catalog.Update());
+        CHECK(catalog.GetNameList() == Names({"b"}));
+        CHECK(catalog.GetProfileInfo("a") == nullptr);
+
+        //Directory removed, back to watching the parent
+        ::unlink((profile_path + "b.ini").c_str());
+        ::unlink((profile_path + "notes.txt").c_str());
+        ::rmdir(profile_path.c_str());
+        CHECK(catalog.GetNameList() == Names({}));
+        CHECK(!catalog.Update());
+    }
+
+    ::rmdir(temp_dir);
+}
@@ -0,0 +1,223 @@
+#include "TestFramework.h"
+
+#include <map>
+
+#include "OverlayPropertyWriter.h"
+
+//Stands in for IVROverlay, counting the calls that would be RPCs into vrserver
+struct MockOverlayState
+{
+    struct OverlayProperties
+    {
+        float Alpha = 1.0f;
+        vr::ETrackingUniverseOrigin Origin = vr::TrackingUniverseStanding;
+        vr::TrackedDeviceIndex_t DeviceIndex = vr::k_unTrackedDeviceIndexInvalid;
+        vr::HmdMatrix34_t Matrix = {0};
+    };
+
+    std::map<vr::VROverlayHandle_t, OverlayProperties> Overlays;
+    bool IsAvailable = true;
+    unsigned int FrameRPCCount = 0;                 //Reset by the test at the start of each frame
+};
+
+class MockOverlay : public OverlayPropertyBackend
+{
+    private:
+        MockOverlayState& m_State;
+
+    public:
+        MockOverlay(MockOverlayState& state) : m_State(state) {}
+
+        bool IsAvailable() const override { return m_State.IsAvailable; }
+
+        void SetOverlayAlpha(vr::VROverlayHandle_t handle, float alpha) override
+        {
+            CHECK(m_State.IsAvailable);
+            m_State.Overlays[handle].Alpha = alpha;
+            m_State.FrameRPCCount++;
+        }
+
+        void SetOverlayTransformAbsolute(vr::VROverlayHandle_t handle, vr::ETrackingUniverseOrigin origin, const vr::HmdMatrix34_t& matrix) override
+        {
+            CHECK(m_State.IsAvailable);
+            auto& overlay = m_State.Overlays[handle];
+            overlay.Origin      = origin;
+            overlay.DeviceIndex = vr::k_unTrackedDeviceIndexInvalid;
+            overlay.Matrix      = matrix;
+            m_State.FrameRPCCount++;
+        }
+
+        void SetOverlayTransformTrackedDeviceRelative(vr::VROverlayHandle_t handle, vr::TrackedDeviceIndex_t device_index, const vr::HmdMatrix34_t& matrix) override
+        {
+            CHECK(m_State.IsAvailable);
+            auto& overlay = m_State.Overlays[handle];
+            overlay.DeviceIndex = device_index;
+            overlay.Matrix      = matrix;
+            m_State.FrameRPCCount++;
+        }
+};
+
+struct MockWriter
+{
+    MockOverlayState VROverlay;
+    OverlayPropertyWriter Writer;
+
+    MockWriter() : Writer(std::make_unique<MockOverlay>(VROverlay)) {}
+
+    //Flushes and returns the RPCs done during the frame
+    unsigned int EndFrame()
+    {
+        Writer.Flush();
+        const unsigned int rpc_count = VROverlay.FrameRPCCount;
+        VROverlay.FrameRPCCount = 0;
+
+        CHECK(Writer.GetRPCCountLastFrame() == rpc_count);
+        return rpc_count;
+    }
+};
+
+static vr::HmdMatrix34_t TranslationMatrix(float x, float y, float z)
+{
+    vr::HmdMatrix34_t matrix = {{{1.0f, 0.0f, 0.0f, x}, {0.0f, 1.0f, 0.0f, y}, {0.0f, 0.0f, 1.0f, z}}};
+    return matrix;
+}
+
+//Per-frame writes like gaze fade and HMD floor origin do them, values mostly not changing
+static void WriteFrame(OverlayPropertyWriter& writer, float alpha_1, float alpha_2, float z)
+{
+    writer.SetAlpha(1, alpha_1);
+    writer.SetAlpha(2, alpha_2);
+    writer.SetTransformAbsolute(1, vr::TrackingUniverseStanding, TranslationMatrix(0.0f, 1.0f, z));
+    writer.SetTransformTrackedDeviceRelative(2, vr::k_unTrackedDeviceIndex_Hmd, TranslationMatrix(0.0f, 0.0f, -1.0f));
+}
+
+TEST_CASE(OverlayPropertyWriter_RedundantWritesSuppressed)
+{
+    MockWriter test;
+    test.Writer.RegisterOverlay(1);
+    test.Writer.RegisterOverlay(2);
+
+    //Nothing is written before the flush
+    WriteFrame(test.Writer, 1.0f, 0.5f, -2.0f);
+    CHECK(test.VROverlay.FrameRPCCount == 0);
+    CHECK(test.EndFrame() == 4);
+    CHECK(test.VROverlay.Overlays[2].Alpha == 0.5f);
+    CHECK(test.VROverlay.Overlays[2].DeviceIndex == vr::k_unTrackedDeviceIndex_Hmd);
+
+    //Same values, no RPCs at all
+    for (int i = 0; i < 10; ++i)
+    {
+        WriteFrame(test.Writer, 1.0f, 0.5f, -2.0f);
+        CHECK(test.EndFrame() == 0);
+        CHECK(test.Writer.GetSkippedCountLastFrame() == 4);
+    }
+
+    //Float noise on unchanged values is dropped as well
+    WriteFrame(test.Writer, 1.0f - 0.0001f, 0.5f, -2.0f + 0.000001f);
+    CHECK(test.EndFrame() == 0);
+
+    //Only what changed is written
+    WriteFrame(test.Writer, 1.0f, 0.25f, -2.0f);
+    CHECK(test.EndFrame() == 1);
+    CHECK(test.VROverlay.Overlays[2].Alpha == 0.25f);
+
+    WriteFrame(test.Writer, 1.0f, 0.25f, -3.0f);
+    CHECK(test.EndFrame() == 1);
+    CHECK(test.VROverlay.Overlays[1].Matrix.m[2][3] == -3.0f);
+
+    //Several writes in one frame end up as one RPC with the last value
+    test.Writer.SetAlpha(1, 0.2f);
+    test.Writer.SetAlpha(1, 0.3f);
+    test.Writer.SetAlpha(1, 0.4f);
+    CHECK(test.EndFrame() == 1);
+    CHECK(test.VROverlay.Overlays[1].Alpha == 0.4f);
+
+    //Switching transform type with the same matrix is a change
+    test.Writer.SetTransformTrackedDeviceRelative(1, vr::k_unTrackedDeviceIndex_Hmd, TranslationMatrix(0.0f, 1.0f, -3.0f));
+    CHECK(test.EndFrame() == 1);
+    CHECK(test.VROverlay.Overlays[1].DeviceIndex == vr::k_unTrackedDeviceIndex_Hmd);
+}
+
+TEST_CASE(OverlayPropertyWriter_UnregisteredWriteThrough)
+{
+    MockWriter test;
+    test.Writer.RegisterOverlay(1);
+
+    //Overlays of other applications can change without us knowing, so every write goes through right away and nothing is cached
+    const vr::VROverlayHandle_t handle_foreign = 100;
+    test.Writer.SetAlpha(handle_foreign, 0.0f);
+    CHECK(test.VROverlay.FrameRPCCount == 1);
+    test.Writer.SetAlpha(handle_foreign, 0.0f);
+    CHECK(test.VROverlay.FrameRPCCount == 2);
+    test.Writer.SetTransformAbsolute(handle_foreign, vr::TrackingUniverseStanding, TranslationMatrix(0.0f, 0.0f, 0.0f));
+    CHECK(test.VROverlay.FrameRPCCount == 3);
+
+    vr::ETrackingUniverseOrigin origin;
+    vr::TrackedDeviceIndex_t device_index;
+    vr::HmdMatrix34_t matrix;
+    CHECK(!test.Writer.GetLastTransform(handle_foreign, origin, device_index, matrix));
+
+    CHECK(test.EndFrame() == 3);
+
+    //Invalid handle isn't written at all
+    test.Writer.SetAlpha(vr::k_ulOverlayHandleInvalid, 1.0f);
+    CHECK(test.EndFrame() == 0);
+    CHECK(test.VROverlay.Overlays.count(vr::k_ulOverlayHandleInvalid) == 0);
+}
+
+TEST_CASE(OverlayPropertyWriter_RegisterUnregister)
+{
+    MockWriter test;
+    test.Writer.RegisterOverlay(1);
+
+    test.Writer.SetAlpha(1, 0.5f);
+    test.Writer.SetTransformAbsolute(1, vr::TrackingUniverseStanding, TranslationMatrix(1.0f, 2.0f, 3.0f));
+    CHECK(test.EndFrame() == 2);
+
+    vr::ETrackingUniverseOrigin origin;
+    vr::TrackedDeviceIndex_t device_index;
+    vr::HmdMatrix34_t matrix;
+    CHECK(test.Writer.GetLastTransform(1, origin, device_index, matrix));
+    CHECK( (origin == vr::TrackingUniverseStanding) && (device_index == vr::k_unTrackedDeviceIndexInvalid) && (matrix.m[1][3] == 2.0f) );
+
+    //Queued writes of a destroyed overlay are dropped
+    test.Writer.SetAlpha(1, 0.75f);
+    test.Writer.UnregisterOverlay(1);
+    CHECK(test.EndFrame() == 0);
+    CHECK(test.VROverlay.Overlays[1].Alpha == 0.5f);
+
+    //New overlay with the same handle value doesn't inherit the old state
+    test.Writer.RegisterOverlay(1);
+    CHECK(!test.Writer.GetLastTransform(1, origin, device_index, matrix));
+    test.Writer.SetAlpha(1, 0.5f);
+    CHECK(test.EndFrame() == 1);
+
+    //Re-registering while a write is queued still applies it
+    test.Writer.SetAlpha(1, 0.25f);
+    test.Writer.RegisterOverlay(1);
+    test.Writer.SetAlpha(1, 0.75f);
+    CHECK(test.EndFrame() == 1);
+    CHECK(test.VROverlay.Overlays[1].Alpha == 0.75f);
+}
+
+TEST_CASE(OverlayPropertyWriter_Unavailable)
+{
+    MockWriter test;
+    test.Writer.RegisterOverlay(1);
+
+    test.Writer.SetAlpha(1, 0.5f);
+    CHECK(test.EndFrame() == 1);
+
+    //Queued writes are dropped while nothing can be written. Foreign handles aren't even attempted
+    test.VROverlay.IsAvailable = false;
+    test.Writer.SetAlpha(1, 0.25f);
+    test.Writer.SetAlpha(100, 0.25f);
+    CHECK(test.EndFrame() == 0);
+
+    //State is unknown afterwards, so the same value is written again
+    test.VROverlay.IsAvailable = true;
+    test.Writer.SetAlpha(1, 0.5f);
+    CHECK(test.EndFrame() == 1);
+    test.Writer.SetAlpha(1, 0.5f);
+    CHECK(test.EndFrame() == 0);
+}
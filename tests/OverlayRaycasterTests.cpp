@@ -0,0 +1,349 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <random>
+
+#include "OverlayRaycaster.h"
+
+static const float k_fPi = 3.14159265f;
+
+static OverlayRaycastShape MakeShape(unsigned int id, const Matrix4& transform, float width, float height, float curvature = 0.0f)
+{
+    OverlayRaycastShape shape;
+    shape.OverlayID = id;
+    shape.Transform = transform;
+    shape.Width     = width;
+    shape.Height    = height;
+    shape.Curvature = curvature;
+
+    return shape;
+}
+
+static Matrix4 MakeTranslation(float x, float y, float z)
+{
+    Matrix4 mat;
+    mat.translate(x, y, z);
+    return mat;
+}
+
+static std::vector<OverlayRaycastHit> Cast(const std::vector<OverlayRaycastShape>& shapes, const Vector3& origin, const Vector3& direction, float edge_margin = 0.0f)
+{
+    OverlayRaycaster raycaster(edge_margin);
+    raycaster.Update(shapes);
+
+    std::vector<OverlayRaycastHit> hits;
+    raycaster.Raycast(origin, direction, 1000.0f, hits);
+
+    return hits;
+}
+
+TEST_CASE(OverlayRaycaster_Flat)
+{
+    //2m x 1m overlay 3m in front of the origin, facing it
+    const std::vector<OverlayRaycastShape> shapes = {MakeShape(4, MakeTranslation(0.0f, 1.0f, -3.0f), 2.0f, 1.0f)};
+
+    std::vector<OverlayRaycastHit> hits = Cast(shapes, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, -1.0f});
+    CHECK(hits.size() == 1);
+    CHECK(hits[0].OverlayID == 4);
+    CHECK_NEAR(hits[0].Distance, 3.0f, 0.0001f);
+    CHECK_NEAR(hits[0].UV.x, 0.5f, 0.0001f);
+    CHECK_NEAR(hits[0].UV.y, 0.5f, 0.0001f);
+
+    //UV origin is bottom left
+    hits = Cast(shapes, {-0.9f, 0.6f, 0.0f}, {0.0f, 0.0f, -1.0f});
+    CHECK(hits.size() == 1);
+    CHECK_NEAR(hits[0].UV.x, 0.05f, 0.0001f);
+    CHECK_NEAR(hits[0].UV.y, 0.1f,  0.0001f);
+
+    //Angled ray, direction not normalized means distance is in units of the direction length
+    hits = Cast(shapes, {0.0f, 1.0f, 0.0f}, {0.25f, 0.0f, -1.5f});
+    CHECK(hits.size() == 1);
+    CHECK_NEAR(hits[0].Distance, 2.0f, 0.0001f);
+    CHECK_NEAR(hits[0].UV.x, 0.75f, 0.0001f);
+
+    //Misses: past the edges, pointing away, parallel, starting behind the overlay
+    CHECK(Cast(shapes, {1.01f, 1.0f, 0.0f}, {0.0f, 0.0f, -1.0f}).empty());
+    CHECK(Cast(shapes, {0.0f, 1.51f, 0.0f}, {0.0f, 0.0f, -1.0f}).empty());
+    CHECK(Cast(shapes, {0.0f, 1.0f, 0.0f},  {0.0f, 0.0f,  1.0f}).empty());
+    CHECK(Cast(shapes, {0.0f, 1.0f, -3.0f}, {1.0f, 0.0f,  0.0f}).empty());
+    CHECK(Cast(shapes, {0.0f, 1.0f, -4.0f}, {0.0f, 0.0f, -1.0f}).empty());
+
+    //Edge margin extends the shape, but UVs still refer to the real size
+    hits = Cast(shapes, {1.04f, 1.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, 0.05f);
+    CHECK(hits.size() == 1);
+    CHECK(hits[0].UV.x > 1.0f);
+
+    //Back side is hit as well, like SteamVR does
+    hits = Cast(shapes, {0.0f, 1.0f, -6.0f}, {0.0f, 0.0f, 1.0f});
+    CHECK(hits.size() == 1);
+    CHECK_NEAR(hits[0].Distance, 3.0f, 0.0001f);
+}
+
+TEST_CASE(OverlayRaycaster_Curved)
+{
+    //Curvature 0.25 bends the overlay into a quarter of a cylinder, edges towards the viewer
+    const float width = 2.0f;
+    const float curvature = 0.25f;
+    const float radius = width / (2.0f * k_fPi * curvature);
+    const std::vector<OverlayRaycastShape> shapes = {MakeShape(1, MakeTranslation(0.0f, 0.0f, -3.0f), width, 1.0f, curvature)};
+
+    std::vector<OverlayRaycastHit> hits = Cast(shapes, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f});
+    CHECK(hits.size() == 1);
+    CHECK_NEAR(hits[0].Distance, 3.0f, 0.0001f);
+    CHECK_NEAR(hits[0].UV.x, 0.5f, 0.0001f);
+
+    //Point on the arc at a known angle. Arc length from the center is angle * radius
+    const float angle = 0.5f;
+    const float x = radius * sinf(angle);
+    const float z = radius * (1.0f - cosf(angle));
+
+    hits = Cast(shapes, {x, 0.25f, 0.0f}, {0.0f, 0.0f, -1.0f});
+    CHECK(hits.size() == 1);
+    CHECK_NEAR(hits[0].Distance, 3.0f - z, 0.0001f);
+    CHECK_NEAR(hits[0].UV.x, 0.5f + ((angle * radius) / width), 0.0001f);
+    CHECK_NEAR(hits[0].UV.y, 0.75f, 0.0001f);
+
+    //Left side mirrors it
+    hits = Cast(shapes, {-x, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f});
+    CHECK(hits.size() == 1);
+    CHECK_NEAR(hits[0].UV.x, 0.5f - ((angle * radius) / width), 0.0001f);
+
+    //Past the arc's end (at 45 degrees for this curvature). The ray passes through the cylinder behind the overlay, which must not count
+    const float x_end = radius * sinf(k_fPi / 4.0f);
+    CHECK(Cast(shapes, {x_end + 0.01f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}).empty());
+    CHECK(Cast(shapes, {x_end - 0.01f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}).size() == 1);
+
+    //A flat overlay of the same width would be hit there, the curved one isn't as it's narrower in projection
+    CHECK(Cast({MakeShape(1, MakeTranslation(0.0f, 0.0f, -3.0f), width, 1.0f)}, {x_end + 0.01f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}).size() == 1);
+
+    //Ray from inside the cylinder towards one edge hits the inner side
+    hits = Cast(shapes, {0.0f, 0.0f, -3.0f + radius}, {sinf(0.6f), 0.0f, -cosf(0.6f)});
+    CHECK(hits.size() == 1);
+    CHECK_NEAR(hits[0].Distance, radius, 0.0001f);
+    CHECK_NEAR(hits[0].UV.x, 0.5f + ((0.6f * radius) / width), 0.0001f);
+}
+
+TEST_CASE(OverlayRaycaster_Rotated)
+{
+    //Overlay rotated 90 degrees around Y faces +X, then placed at x = -2
+    Matrix4 transform;
+    transform.rotateY(-90.0f);
+    transform.translate(-2.0f, 0.0f, 0.0f);
+
+    const std::vector<OverlayRaycastShape> shapes = {MakeShape(2, transform, 1.0f, 1.0f)};
+
+    CHECK(Cast(shapes, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}).empty());
+
+    std::vector<OverlayRaycastHit> hits = Cast(shapes, {0.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f});
+    CHECK(hits.size() == 1);
+    CHECK_NEAR(hits[0].Distance, 2.0f, 0.0001f);
+    CHECK_NEAR(hits[0].UV.x, 0.5f, 0.0001f);
+
+    //U follows the overlay's local X axis, which now lies along world Z
+    hits = Cast(shapes, {0.0f, 0.0f, 0.25f}, {-1.0f, 0.0f, 0.0f});
+    CHECK(hits.size() == 1);
+    const Vector3 local_x = transform * Vector3(1.0f, 0.0f, 0.0f);
+    CHECK_NEAR(hits[0].UV.x, 0.5f + (0.25f * local_x.z), 0.0001f);
+
+    //Tilted 45 degrees around X, so the visible height shrinks
+    Matrix4 tilted;
+    tilted.rotateX(45.0f);
+    tilted.translate(0.0f, 0.0f, -2.0f);
+    const std::vector<OverlayRaycastShape> shapes_tilted = {MakeShape(3, tilted, 1.0f, 1.0f)};
+
+    const float half_projected = 0.5f * cosf(k_fPi / 4.0f);
+    CHECK(Cast(shapes_tilted, {0.0f, half_projected - 0.01f, 0.0f}, {0.0f, 0.0f, -1.0f}).size() == 1);
+    CHECK(Cast(shapes_tilted, {0.0f, half_projected + 0.01f, 0.0f}, {0.0f, 0.0f, -1.0f}).empty());
+}
+
+TEST_CASE(OverlayRaycaster_DeviceRelative)
+{
+    //Device-relative overlays are placed as device pose * relative transform, like OutputManager::DetachedOverlayGetRaycastShape() does
+    Matrix4 device_pose;
+    device_pose.rotateY(30.0f);
+    device_pose.translate(1.0f, 1.2f, -0.5f);
+
+    Matrix4 relative;
+    relative.rotateX(-20.0f);
+    relative.translate(0.0f, 0.05f, -0.3f);
+
+    const std::vector<OverlayRaycastShape> shapes = {MakeShape(5, device_pose * relative, 0.3f, 0.2f)};
+
+    //Ray from a point in front of the overlay center, pointing back along its normal, both expressed in world space
+    const Vector3 center = (device_pose * relative).transformPoint({0.0f, 0.0f, 0.0f});
+    const Vector3 normal = (device_pose * relative) * Vector3(0.0f, 0.0f, 1.0f);
+    const Vector3 right  = (device_pose * relative) * Vector3(1.0f, 0.0f, 0.0f);
+    const Vector3 origin = center + (normal * 2.0f) + (right * 0.075f);
+
+    std::vector<OverlayRaycastHit> hits = Cast(shapes, origin, normal * -1.0f);
+    CHECK(hits.size() == 1);
+    CHECK_NEAR(hits[0].Distance, 2.0f, 0.0001f);
+    CHECK_NEAR(hits[0].UV.x, 0.75f, 0.0001f);
+    CHECK_NEAR(hits[0].UV.y, 0.5f,  0.0001f);
+
+    //Same ray against the relative transform alone (device at origin) misses
+    CHECK(Cast({MakeShape(5, relative, 0.3f, 0.2f)}, origin, normal * -1.0f).empty());
+}
+
+TEST_CASE(OverlayRaycaster_SortedAndRebuild)
+{
+    //Stack of overlays along the ray, inserted out of order
+    std::vector<OverlayRaycastShape> shapes;
+    for (unsigned int i : {3u, 0u, 4u, 1u, 2u})
+        shapes.push_back(MakeShape(i, MakeTranslation(0.0f, 0.0f, -1.0f - (float)i), 1.0f, 1.0f));
+
+    OverlayRaycaster raycaster;
+    CHECK(raycaster.IsEmpty());
+    CHECK(raycaster.Update(shapes));
+    CHECK(!raycaster.Update(shapes));   //Unchanged, no rebuild
+
+    std::vector<OverlayRaycastHit> hits;
+    raycaster.Raycast({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, 1000.0f, hits);
+    CHECK(hits.size() == 5);
+
+    for (unsigned int i = 0; i < hits.size(); ++i)
+        CHECK(hits[i].OverlayID == i);
+
+    //Max distance cuts off
+    raycaster.Raycast({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, 2.5f, hits);
+    CHECK(hits.size() == 2);
+
+    //Move one out of the way
+    shapes[0].Transform = MakeTranslation(5.0f, 0.0f, -4.0f);
+    CHECK(raycaster.Update(shapes));
+    raycaster.Raycast({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, 1000.0f, hits);
+    CHECK(hits.size() == 4);
+    CHECK(std::none_of(hits.begin(), hits.end(), [](const OverlayRaycastHit& hit){ return (hit.OverlayID == 3); }));
+
+    CHECK(raycaster.Update({}));
+    CHECK(raycaster.IsEmpty());
+    raycaster.Raycast({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, 1000.0f, hits);
+    CHECK(hits.empty());
+}
+
+TEST_CASE(OverlayRaycaster_AspectRatio)
+{
+    //Plain content aspect
+    CHECK_NEAR(OverlayRaycaster::GetOverlayAspectRatio(1920, 1080, 0, 0, false, false), 1080.0f / 1920.0f, 0.00001f);
+    CHECK(OverlayRaycaster::GetOverlayAspectRatio(0, 1080, 0, 0, false, false) == 0.0f);
+    CHECK(OverlayRaycaster::GetOverlayAspectRatio(1920, 0, 0, 0, false, false) == 0.0f);
+
+    //Desktop duplication: mouse scale is the full desktop, which wins when it's taller than the cropped content
+    CHECK_NEAR(OverlayRaycaster::GetOverlayAspectRatio(1920, 400, 3840, 2160, false, false), 2160.0f / 3840.0f, 0.00001f);
+    CHECK_NEAR(OverlayRaycaster::GetOverlayAspectRatio(400, 1080, 3840, 2160, false, false), 1080.0f / 400.0f, 0.00001f);
+
+    //Full SBS doubles the height, half SBS/OU don't change anything
+    CHECK_NEAR(OverlayRaycaster::GetOverlayAspectRatio(1920, 1080, 0, 0, true, false), 2.0f * 1080.0f / 1920.0f, 0.00001f);
+
+    //Full OU is converted to SBS (twice as wide, half as tall), then doubled in height. Ends up at half the content aspect
+    CHECK_NEAR(OverlayRaycaster::GetOverlayAspectRatio(1920, 2160, 0, 0, true, true), 0.5f * 2160.0f / 1920.0f, 0.00001f);
+
+    //Same as ApplySettingTransform() computes for the dashboard overlay via crop size changes
+    int crop_width = 1920, crop_height = 2160;
+    crop_width  *= 2;
+    crop_height /= 2;
+    crop_height *= 2;
+    CHECK_NEAR(OverlayRaycaster::GetOverlayAspectRatio(1920, 2160, 0, 0, true, true), (float)crop_height / crop_width, 0.00001f);
+}
+
+TEST_CASE(OverlayRaycaster_RandomizedMatchesBruteForce)
+{
+    std::mt19937 rng(21);
+    std::uniform_real_distribution<float> dist_pos(-5.0f, 5.0f);
+    std::uniform_real_distribution<float> dist_angle(0.0f, 360.0f);
+    std::uniform_real_distribution<float> dist_size(0.2f, 2.0f);
+    std::uniform_real_distribution<float> dist_curve(0.0f, 0.5f);
+
+    for (int round = 0; round < 20; ++round)
+    {
+        std::vector<OverlayRaycastShape> shapes;
+
+        for (unsigned int i = 0; i < 32; ++i)
+        {
+            Matrix4 transform;
+            transform.rotate(dist_angle(rng), Vector3(dist_pos(rng), dist_pos(rng), dist_pos(rng) + 0.01f));
+            transform.translate(dist_pos(rng), dist_pos(rng), dist_pos(rng));
+            shapes.push_back(MakeShape(i, transform, dist_size(rng), dist_size(rng), (i % 2 == 0) ? 0.0f : dist_curve(rng)));
+        }
+
+        OverlayRaycaster raycaster;
+        raycaster.Update(shapes);
+
+        for (int i = 0; i < 100; ++i)
+        {
+            const Vector3 origin(dist_pos(rng), dist_pos(rng), dist_pos(rng));
+            const Vector3 direction = Vector3(dist_pos(rng), dist_pos(rng), dist_pos(rng)).normalize();
+
+            std::vector<OverlayRaycastHit> hits;
+            raycaster.Raycast(origin, direction, 1000.0f, hits);
+
+            //Each shape on its own, no hierarchy involved
+            std::vector<OverlayRaycastHit> hits_single, hits_brute;
+            for (const OverlayRaycastShape& shape : shapes)
+            {
+                hits_single = Cast({shape}, origin, direction);
+                hits_brute.insert(hits_brute.end(), hits_single.begin(), hits_single.end());
+            }
+
+            std::sort(hits_brute.begin(), hits_brute.end(), [](const OverlayRaycastHit& a, const OverlayRaycastHit& b){ return (a.Distance < b.Distance); });
+
+            CHECK(hits.size() == hits_brute.size());
+
+            for (size_t j = 0; j < std::min(hits.size(), hits_brute.size()); ++j)
+            {
+                CHECK(hits[j].OverlayID == hits_brute[j].OverlayID);
+            }
+        }
+    }
+}
+
+BENCHMARK(OverlayRaycaster_Raycast)
+{
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<float> dist_angle(-60.0f, 60.0f);
+
+    for (unsigned int overlay_count : {4u, 16u, 64u})
+    {
+        //Overlays spread around the user like a typical setup
+        std::vector<OverlayRaycastShape> shapes;
+
+        for (unsigned int i = 0; i < overlay_count; ++i)
+        {
+            Matrix4 transform;
+            transform.translate(0.0f, 0.0f, -1.5f - (i % 3) * 0.5f);
+            transform.rotateY(dist_angle(rng) * 3.0f);
+            transform.translate(0.0f, 1.2f + dist_angle(rng) / 100.0f, 0.0f);
+            shapes.push_back(MakeShape(i, transform, 0.8f, 0.45f, (i % 2 == 0) ? 0.0f : 0.1f));
+        }
+
+        std::vector<Vector3> directions(256);
+        for (Vector3& direction : directions)
+        {
+            Matrix4 rotation;
+            rotation.rotateX(dist_angle(rng) / 3.0f);
+            rotation.rotateY(dist_angle(rng) * 3.0f);
+            direction = rotation * Vector3(0.0f, 0.0f, -1.0f);
+        }
+
+        OverlayRaycaster raycaster(0.05f);
+        raycaster.Update(shapes);
+        std::vector<OverlayRaycastHit> hits;
+
+        char label[128];
+        snprintf(label, sizeof(label), "Raycast, %u overlays", overlay_count);
+        BenchmarkRun(label, 1000000, [&](size_t i)
+        {
+            raycaster.Raycast({0.0f, 1.2f, 0.0f}, directions[i % directions.size()], 1000.0f, hits);
+            BenchmarkKeep(hits.size());
+        });
+
+        //Hierarchy rebuild happens whenever any overlay moved
+        snprintf(label, sizeof(label), "Rebuild, %u overlays", overlay_count);
+        std::vector<OverlayRaycastShape> shapes_moved = shapes;
+        BenchmarkRun(label, 20000, [&](size_t i)
+        {
+            shapes_moved[0].Width = (i % 2 == 0) ? 0.8f : 0.81f;
+            BenchmarkKeep(raycaster.Update(shapes_moved));
+        });
+    }
+}
@@ -0,0 +1,240 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <random>
+
+#include "OverlayRectIndex.h"
+
+static std::vector<unsigned int> QueryIndex(const OverlayRectIndex& index, const DPRect& rect)
+{
+    std::vector<unsigned int> ids;
+    index.ForEachOverlapping(rect, [&](unsigned int id, const DPRect&){ ids.push_back(id); });
+    std::sort(ids.begin(), ids.end());
+
+    return ids;
+}
+
+static std::vector<unsigned int> QueryBruteForce(const std::vector<DPRect>& rects, const DPRect& rect)
+{
+    std::vector<unsigned int> ids;
+
+    for (unsigned int i = 0; i < rects.size(); ++i)
+    {
+        if ( (rects[i].GetWidth() > 0) && (rects[i].GetHeight() > 0) && (rects[i].Overlaps(rect)) )
+        {
+            ids.push_back(i);
+        }
+    }
+
+    return ids;
+}
+
+static void BuildIndex(OverlayRectIndex& index, const std::vector<DPRect>& rects)
+{
+    index.Clear();
+
+    for (unsigned int i = 0; i < rects.size(); ++i)
+    {
+        index.AddRect(i, rects[i]);
+    }
+
+    index.Build();
+}
+
+TEST_CASE(OverlayRectIndex_Empty)
+{
+    OverlayRectIndex index;
+    CHECK(index.IsEmpty());
+    CHECK(QueryIndex(index, DPRect(0, 0, 1000, 1000)).empty());
+
+    index.Build();
+    CHECK(QueryIndex(index, DPRect(0, 0, 1000, 1000)).empty());
+
+    //Rects without area are not indexed
+    index.AddRect(0, DPRect(10, 10, 10, 50));
+    index.AddRect(1, DPRect(10, 10, 50, 10));
+    index.AddRect(2, DPRect(50, 50, 10, 10));
+    index.Build();
+    CHECK(index.IsEmpty());
+}
+
+TEST_CASE(OverlayRectIndex_Insert)
+{
+    OverlayRectIndex index;
+    index.AddRect(7, DPRect(0, 0, 100, 100));
+    index.AddRect(9, DPRect(200, 0, 300, 100));
+    index.Build();
+
+    CHECK(!index.IsEmpty());
+    CHECK(QueryIndex(index, DPRect(50, 50, 60, 60))   == std::vector<unsigned int>({7}));
+    CHECK(QueryIndex(index, DPRect(250, 50, 260, 60)) == std::vector<unsigned int>({9}));
+    CHECK(QueryIndex(index, DPRect(50, 50, 250, 60))  == std::vector<unsigned int>({7, 9}));
+    CHECK(QueryIndex(index, DPRect(120, 0, 180, 100)).empty());  //Gap in-between
+}
+
+TEST_CASE(OverlayRectIndex_RemoveAndMove)
+{
+    //The index is rebuilt as a whole, so removing or moving a rect means building it again without it or with the new position
+    std::vector<DPRect> rects = {DPRect(0, 0, 100, 100), DPRect(100, 0, 200, 100), DPRect(0, 100, 100, 200)};
+    OverlayRectIndex index;
+    BuildIndex(index, rects);
+
+    CHECK(QueryIndex(index, DPRect(150, 50, 151, 51)) == std::vector<unsigned int>({1}));
+
+    //Remove rect 1 (keep the ID slot, like a hidden overlay)
+    rects[1] = DPRect();
+    BuildIndex(index, rects);
+    CHECK(QueryIndex(index, DPRect(150, 50, 151, 51)).empty());
+    CHECK(QueryIndex(index, DPRect(0, 0, 200, 200)) == std::vector<unsigned int>({0, 2}));
+
+    //Move rect 2 far away, which also grows the grid bounds
+    rects[2] = DPRect(5000, 5000, 5100, 5100);
+    BuildIndex(index, rects);
+    CHECK(QueryIndex(index, DPRect(0, 100, 100, 200)).empty());
+    CHECK(QueryIndex(index, DPRect(5050, 5050, 5051, 5051)) == std::vector<unsigned int>({2}));
+
+    //Clear drops everything
+    index.Clear();
+    index.Build();
+    CHECK(index.IsEmpty());
+    CHECK(QueryIndex(index, DPRect(0, 0, 10000, 10000)).empty());
+}
+
+TEST_CASE(OverlayRectIndex_SpanningCellsReportedOnce)
+{
+    //Many small rects force a fine grid, the large one spans all its cells
+    std::vector<DPRect> rects;
+
+    for (int y = 0; y < 8; ++y)
+    {
+        for (int x = 0; x < 8; ++x)
+        {
+            rects.push_back(DPRect(x * 100, y * 100, (x * 100) + 10, (y * 100) + 10));
+        }
+    }
+
+    rects.push_back(DPRect(0, 0, 800, 800));
+    const unsigned int large_id = (unsigned int)rects.size() - 1;
+
+    OverlayRectIndex index;
+    BuildIndex(index, rects);
+
+    //Whole area, every rect exactly once
+    std::vector<unsigned int> ids = QueryIndex(index, DPRect(0, 0, 800, 800));
+    CHECK(ids.size() == rects.size());
+    CHECK(std::adjacent_find(ids.begin(), ids.end()) == ids.end());
+
+    //Query spanning several cells but starting in the middle of the large rect
+    ids = QueryIndex(index, DPRect(350, 350, 750, 450));
+    CHECK(std::count(ids.begin(), ids.end(), large_id) == 1);
+    CHECK(ids == QueryBruteForce(rects, DPRect(350, 350, 750, 450)));
+}
+
+TEST_CASE(OverlayRectIndex_Edges)
+{
+    std::vector<DPRect> rects = {DPRect(0, 0, 100, 100), DPRect(100, 0, 200, 100), DPRect(-50, -50, 0, 0)};
+    OverlayRectIndex index;
+    BuildIndex(index, rects);
+
+    //Max is exclusive, so rects sharing an edge don't overlap a query sitting on the other side of it
+    CHECK(QueryIndex(index, DPRect(100, 0, 101, 1))  == std::vector<unsigned int>({1}));
+    CHECK(QueryIndex(index, DPRect(99, 0, 100, 1))   == std::vector<unsigned int>({0}));
+    CHECK(QueryIndex(index, DPRect(99, 0, 101, 1))   == std::vector<unsigned int>({0, 1}));
+    CHECK(QueryIndex(index, DPRect(-1, -1, 0, 0))    == std::vector<unsigned int>({2}));
+    CHECK(QueryIndex(index, DPRect(0, 0, 1, 1))      == std::vector<unsigned int>({0}));
+
+    //Bounds corners and outside
+    CHECK(QueryIndex(index, DPRect(199, 99, 200, 100)) == std::vector<unsigned int>({1}));
+    CHECK(QueryIndex(index, DPRect(200, 100, 300, 300)).empty());
+    CHECK(QueryIndex(index, DPRect(-100, -100, -50, -50)).empty());
+    CHECK(QueryIndex(index, DPRect(-1000, -1000, 1000, 1000)) == std::vector<unsigned int>({0, 1, 2}));
+
+    //Queries partially outside the bounds still find what's inside
+    CHECK(QueryIndex(index, DPRect(150, -500, 500, 10)) == std::vector<unsigned int>({1}));
+}
+
+TEST_CASE(OverlayRectIndex_RandomizedMatchesBruteForce)
+{
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> pos_dist(-2000, 6000);
+    std::uniform_int_distribution<int> size_dist(0, 2500);
+
+    for (int round = 0; round < 50; ++round)
+    {
+        std::vector<DPRect> rects(1 + (round % 40));
+
+        for (DPRect& rect : rects)
+        {
+            const int x = pos_dist(rng), y = pos_dist(rng);
+            rect = DPRect(x, y, x + size_dist(rng), y + size_dist(rng));
+        }
+
+        OverlayRectIndex index;
+        BuildIndex(index, rects);
+
+        for (int i = 0; i < 200; ++i)
+        {
+            const int x = pos_dist(rng), y = pos_dist(rng);
+            const DPRect query(x, y, x + 1 + size_dist(rng) / 4, y + 1 + size_dist(rng) / 4);
+
+            CHECK(QueryIndex(index, query) == QueryBruteForce(rects, query));
+        }
+    }
+}
+
+BENCHMARK(OverlayRectIndex_Query)
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> pos_dist(0, 7680 - 640);
+    std::uniform_int_distribution<int> dirty_dist(0, 7680 - 64);
+
+    for (unsigned int overlay_count : {4u, 16u, 64u})
+    {
+        std::vector<DPRect> rects(overlay_count);
+
+        for (DPRect& rect : rects)
+        {
+            const int x = pos_dist(rng), y = pos_dist(rng) % (2160 - 480);
+            rect = DPRect(x, y, x + 640, y + 480);
+        }
+
+        //Typical dirty regions are small, like a blinking cursor or a scrolling text box
+        std::vector<DPRect> queries(1024);
+
+        for (DPRect& query : queries)
+        {
+            const int x = dirty_dist(rng), y = dirty_dist(rng) % (2160 - 64);
+            query = DPRect(x, y, x + 64, y + 64);
+        }
+
+        OverlayRectIndex index;
+        BuildIndex(index, rects);
+
+        char label[128];
+        snprintf(label, sizeof(label), "Grid index, %u overlays", overlay_count);
+        BenchmarkRun(label, 2000000, [&](size_t i)
+        {
+            unsigned int hits = 0;
+            index.ForEachOverlapping(queries[i % queries.size()], [&](unsigned int id, const DPRect&){ hits += id; });
+            BenchmarkKeep(hits);
+        });
+
+        snprintf(label, sizeof(label), "Testing every rect, %u overlays", overlay_count);
+        BenchmarkRun(label, 2000000, [&](size_t i)
+        {
+            unsigned int hits = 0;
+            const DPRect& query = queries[i % queries.size()];
+
+            for (unsigned int id = 0; id < rects.size(); ++id)
+            {
+                if (rects[id].Overlaps(query))
+                    hits += id;
+            }
+
+            BenchmarkKeep(hits);
+        });
+
+        snprintf(label, sizeof(label), "Index rebuild, %u overlays", overlay_count);
+        BenchmarkRun(label, 20000, [&](size_t){ BuildIndex(index, rects); });
+    }
+}
@@ -0,0 +1,81 @@
+//Tiny test and benchmark registry for the platform-independent parts of Desktop+
+//Only code that builds without Windows headers is covered, so this runs anywhere CMake and a C++17 compiler are available.
+//No external dependencies on purpose, see CONTRIBUTING
+
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+struct TestEntry
+{
+    const char* Name;
+    void (*Func)();
+};
+
+class TestRegistry
+{
+    public:
+        static std::vector<TestEntry>& GetTests();
+        static std::vector<TestEntry>& GetBenchmarks();
+
+        static void ReportFailure(const char* file, int line, const char* expr);
+        static int GetFailureCount();
+        static bool IsQuickMode();                              //Benchmarks run with reduced iteration counts (used for the smoke test in ctest)
+};
+
+struct TestRegistrar
+{
+    TestRegistrar(std::vector<TestEntry>& list, const char* name, void (*func)()) { list.push_back({name, func}); }
+};
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static TestRegistrar name##_registrar(TestRegistry::GetTests(), #name, name); \
+    static void name()
+
+#define BENCHMARK(name) \
+    static void name(); \
+    static TestRegistrar name##_registrar(TestRegistry::GetBenchmarks(), #name, name); \
+    static void name()
+
+#define CHECK(expr) \
+    do { if (!(expr)) TestRegistry::ReportFailure(__FILE__, __LINE__, #expr); } while (0)
+
+#define CHECK_NEAR(a, b, eps) \
+    do { if (!(std::fabs((double)(a) - (double)(b)) <= (double)(eps))) TestRegistry::ReportFailure(__FILE__, __LINE__, #a " ~= " #b); } while (0)
+
+//Keeps the compiler from optimizing away benchmarked results
+template<typename T>
+inline void BenchmarkKeep(const T& value)
+{
+    #if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r"(&value) : "memory");
+    #else
+        static const void* volatile s_Sink;
+        s_Sink = &value;
+    #endif
+}
+
+//Runs func iterations times (reduced in quick mode) and prints the time per iteration
+template<typename Func>
+inline void BenchmarkRun(const char* label, size_t iterations, Func func)
+{
+    if (TestRegistry::IsQuickMode())
+    {
+        iterations = (iterations / 1000) + 1;
+    }
+
+    const auto time_start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        func(i);
+    }
+
+    const double ns_total = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - time_start).count();
+
+    printf("  %-56s %12.1f ns/iter (%zu iterations)\n", label, ns_total / iterations, iterations);
+}
@@ -0,0 +1,93 @@
+//Test runner. Usage: DesktopPlusTests [--bench] [--quick] [name filter]
+//Runs all tests by default, or all benchmarks with --bench. The filter only runs entries with the given string in their name
+
+#include "TestFramework.h"
+
+#include <cstring>
+#include <string>
+
+static int g_FailureCount = 0;
+static bool g_QuickMode = false;
+
+std::vector<TestEntry>& TestRegistry::GetTests()
+{
+    static std::vector<TestEntry> tests;
+    return tests;
+}
+
+std::vector<TestEntry>& TestRegistry::GetBenchmarks()
+{
+    static std::vector<TestEntry> benchmarks;
+    return benchmarks;
+}
+
+void TestRegistry::ReportFailure(const char* file, int line, const char* expr)
+{
+    //Don't flood the output when a check fails inside a loop
+    if (g_FailureCount < 50)
+    {
+        printf("    FAILED: %s (%s:%d)\n", expr, file, line);
+    }
+
+    g_FailureCount++;
+}
+
+int TestRegistry::GetFailureCount()
+{
+    return g_FailureCount;
+}
+
+bool TestRegistry::IsQuickMode()
+{
+    return g_QuickMode;
+}
+
+int main(int argc, char* argv[])
+{
+    bool run_benchmarks = false;
+    std::string filter;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--bench") == 0)
+        {
+            run_benchmarks = true;
+        }
+        else if (strcmp(argv[i], "--quick") == 0)
+        {
+            g_QuickMode = true;
+        }
+        else
+        {
+            filter = argv[i];
+        }
+    }
+
+    const std::vector<TestEntry>& entries = (run_benchmarks) ? TestRegistry::GetBenchmarks() : TestRegistry::GetTests();
+    int run_count = 0;
+    int failed_count = 0;
+
+    for (const TestEntry& entry : entries)
+    {
+        if ( (!filter.empty()) && (strstr(entry.Name, filter.c_str()) == nullptr) )
+            continue;
+
+        const int failures_before = g_FailureCount;
+
+        printf("%s\n", entry.Name);
+        fflush(stdout);
+
+        entry.Func();
+        run_count++;
+
+        if (g_FailureCount != failures_before)
+        {
+            printf("  -> %d check(s) failed\n", g_FailureCount - failures_before);
+            failed_count++;
+        }
+    }
+
+    printf("\n%d %s run, %d failed\n", run_count, (run_benchmarks) ? "benchmarks" : "tests", failed_count);
+
+    return (g_FailureCount == 0) ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+#include "TestFramework.h"
+
+#include <string>
+
+#include "UTF8Decode.h"
+
+//Decodes the whole string, like InputSimulator::KeyboardText() does
+static std::vector<uint32_t> DecodeAll(const std::string& str_utf8)
+{
+    std::vector<uint32_t> codepoints;
+    const unsigned char* str     = (const unsigned char*)str_utf8.data();
+    const unsigned char* str_end = str + str_utf8.size();
+
+    while (str != str_end)
+    {
+        codepoints.push_back(DecodeUTF8(str, str_end));
+    }
+
+    return codepoints;
+}
+
+static std::string EncodeUTF8(uint32_t codepoint)
+{
+    std::string str;
+
+    if (codepoint < 0x80)
+    {
+        str += (char)codepoint;
+    }
+    else if (codepoint < 0x800)
+    {
+        str += (char)(0xC0 | (codepoint >> 6));
+        str += (char)(0x80 | (codepoint & 0x3F));
+    }
+    else if (codepoint < 0x10000)
+    {
+        str += (char)(0xE0 | (codepoint >> 12));
+        str += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        str += (char)(0x80 | (codepoint & 0x3F));
+    }
+    else
+    {
+        str += (char)(0xF0 | (codepoint >> 18));
+        str += (char)(0x80 | ((codepoint >> 12) & 0x3F));
+        str += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        str += (char)(0x80 | (codepoint & 0x3F));
+    }
+
+    return str;
+}
+
+TEST_CASE(UTF8Decode_AllCodepoints)
+{
+    //Every valid scalar value decodes back to itself and consumes exactly its encoding
+    for (uint32_t codepoint = 0; codepoint <= 0x10FFFF; ++codepoint)
+    {
+        if ( (codepoint >= 0xD800) && (codepoint <= 0xDFFF) )
+            continue;
+
+        const std::string str_utf8 = EncodeUTF8(codepoint);
+        const unsigned char* str     = (const unsigned char*)str_utf8.data();
+        const unsigned char* str_end = str + str_utf8.size();
+
+        if (DecodeUTF8(str, str_end) != codepoint)
+        {
+            CHECK(false);
+            break;
+        }
+
+        CHECK(str == str_end);
+    }
+}
+
+TEST_CASE(UTF8Decode_Boundaries)
+{
+    CHECK(DecodeAll("\x7F")                 == std::vector<uint32_t>({0x7F}));
+    CHECK(DecodeAll("\xC2\x80")             == std::vector<uint32_t>({0x80}));
+    CHECK(DecodeAll("\xDF\xBF")             == std::vector<uint32_t>({0x7FF}));
+    CHECK(DecodeAll("\xE0\xA0\x80")         == std::vector<uint32_t>({0x800}));
+    CHECK(DecodeAll("\xEF\xBF\xBF")         == std::vector<uint32_t>({0xFFFF}));
+    CHECK(DecodeAll("\xF0\x90\x80\x80")     == std::vector<uint32_t>({0x10000}));
+    CHECK(DecodeAll("\xF4\x8F\xBF\xBF")     == std::vector<uint32_t>({0x10FFFF}));
+    CHECK(DecodeAll("A\xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80z") == std::vector<uint32_t>({'A', 0xE4, 0x20AC, 0x1F600, 'z'}));
+}
+
+TEST_CASE(UTF8Decode_Invalid)
+{
+    //Overlong encodings
+    CHECK(DecodeAll("\xC0\x80")             == std::vector<uint32_t>({0xFFFD}));
+    CHECK(DecodeAll("\xC1\xBF")             == std::vector<uint32_t>({0xFFFD}));
+    CHECK(DecodeAll("\xE0\x80\x80")         == std::vector<uint32_t>({0xFFFD}));
+    CHECK(DecodeAll("\xE0\x9F\xBF")         == std::vector<uint32_t>({0xFFFD}));
+    CHECK(DecodeAll("\xF0\x80\x80\x80")     == std::vector<uint32_t>({0xFFFD}));
+    CHECK(DecodeAll("\xF0\x8F\xBF\xBF")     == std::vector<uint32_t>({0xFFFD}));
+
+    //Surrogates and values past U+10FFFF
+    CHECK(DecodeAll("\xED\xA0\x80")         == std::vector<uint32_t>({0xFFFD}));
+    CHECK(DecodeAll("\xED\xBF\xBF")         == std::vector<uint32_t>({0xFFFD}));
+    CHECK(DecodeAll("\xF4\x90\x80\x80")     == std::vector<uint32_t>({0xFFFD}));
+    CHECK(DecodeAll("\xF7\xBF\xBF\xBF")     == std::vector<uint32_t>({0xFFFD}));
+
+    //Invalid lead bytes and stray continuation bytes, one replacement each
+    CHECK(DecodeAll("\xF8\x88\x80\x80\x80") == std::vector<uint32_t>({0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD}));
+    CHECK(DecodeAll("\xFF" "a")             == std::vector<uint32_t>({0xFFFD, 'a'}));
+    CHECK(DecodeAll("\x80\xBF")             == std::vector<uint32_t>({0xFFFD, 0xFFFD}));
+}
+
+TEST_CASE(UTF8Decode_Truncated)
+{
+    //Cut off at the end of the string
+    CHECK(DecodeAll("\xC3")                 == std::vector<uint32_t>({0xFFFD}));
+    CHECK(DecodeAll("\xE2\x82")             == std::vector<uint32_t>({0xFFFD}));
+    CHECK(DecodeAll("\xF0\x9F\x98")         == std::vector<uint32_t>({0xFFFD}));
+
+    //Interrupted by a byte that isn't a continuation. That byte isn't consumed and decodes on its own
+    CHECK(DecodeAll("\xC3" "a")             == std::vector<uint32_t>({0xFFFD, 'a'}));
+    CHECK(DecodeAll("\xE2\x82" "a")         == std::vector<uint32_t>({0xFFFD, 'a'}));
+    CHECK(DecodeAll("\xF0\x9F\xC3\xA4")     == std::vector<uint32_t>({0xFFFD, 0xE4}));
+    CHECK(DecodeAll("\xE2\xF0\x9F\x98\x80") == std::vector<uint32_t>({0xFFFD, 0x1F600}));
+
+    //The end pointer is respected even if the buffer goes on
+    const char buffer[] = "\xE2\x82\xAC";
+    const unsigned char* str = (const unsigned char*)buffer;
+    CHECK(DecodeUTF8(str, str + 2) == 0xFFFD);
+    CHECK(str == (const unsigned char*)buffer + 2);
+}
+
+BENCHMARK(UTF8Decode_DecodeUTF8)
+{
+    //Text as it may come from the keyboard or clipboard, ASCII mixed with 2, 3 and 4 byte sequences
+    const char* const samples[] = { "Hello World! ", "Gr\xC3\xBC\xC3\x9F" "e ", "\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82 ",
+                                    "\xE3\x81\x93\xE3\x82\x93\xE3\x81\xAB\xE3\x81\xA1\xE3\x81\xAF ", "\xF0\x9F\x98\x80\xF0\x9F\x91\x8D " };
+    std::string text;
+
+    while (text.size() < 64 * 1024)
+    {
+        for (const char* sample : samples)
+            text += sample;
+    }
+
+    const unsigned char* text_begin = (const unsigned char*)text.data();
+    const unsigned char* text_end   = text_begin + text.size();
+
+    char label[128];
+    snprintf(label, sizeof(label), "Mixed text, %zu bytes", text.size());
+    BenchmarkRun(label, 2000, [&](size_t)
+    {
+        const unsigned char* str = text_begin;
+        uint32_t sum = 0;
+
+        while (str != text_end)
+            sum += DecodeUTF8(str, text_end);
+
+        BenchmarkKeep(sum);
+    });
+}
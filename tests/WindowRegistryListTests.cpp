@@ -0,0 +1,189 @@
+#include "TestFramework.h"
+
+#include <string>
+
+#include "WindowRegistryList.h"
+
+//Handles are plain integers and window data is the title, fed with the same calls WindowRegistry makes for each event
+typedef WindowRegistryList<uintptr_t, std::string> TestRegistryList;
+
+static std::vector<std::string> GetTitles(const TestRegistryList& list)
+{
+    std::vector<std::string> titles;
+    list.GetData(titles);
+    return titles;
+}
+
+TEST_CASE(WindowRegistryList_CreateRenameDestroy)
+{
+    TestRegistryList list;
+
+    //EVENT_OBJECT_CREATE/SHOW of a capturable window
+    list.Set(1, 100, "app.exe", "Untitled");
+    CHECK(list.IsListed(1));
+    CHECK(list.GetWindowCount() == 1);
+    CHECK(list.GetProcessCount() == 1);
+
+    //EVENT_OBJECT_NAMECHANGE updates in place
+    list.Set(1, 100, "app.exe", "Document");
+    CHECK(list.GetWindowCount() == 1);
+    CHECK(GetTitles(list) == std::vector<std::string>({"Document"}));
+
+    //EVENT_OBJECT_HIDE/CLOAKED, the window isn't capturable anymore
+    list.Remove(1);
+    CHECK(!list.IsListed(1));
+    CHECK(list.GetWindowCount() == 0);
+    CHECK(list.GetProcessCount() == 0);
+
+    //Shown again, then EVENT_OBJECT_DESTROY
+    list.Set(1, 100, "app.exe", "Document");
+    list.Remove(1);
+    CHECK(list.GetWindowCount() == 0);
+
+    //Events for windows that were never listed do nothing
+    list.Remove(2);
+    CHECK(list.GetWindowCount() == 0);
+    CHECK(list.GetProcessCount() == 0);
+}
+
+TEST_CASE(WindowRegistryList_ExeNameCache)
+{
+    TestRegistryList list;
+    std::string exe_name;
+
+    CHECK(!list.FindExeName(100, exe_name));
+
+    list.Set(1, 100, "app.exe", "Main");
+    list.Set(2, 100, "ignored.exe", "Tool window");     //Cached name wins while the process has windows listed
+    CHECK(list.GetProcessCount() == 1);
+    CHECK( (list.FindExeName(100, exe_name)) && (exe_name == "app.exe") );
+
+    list.Remove(1);
+    CHECK( (list.FindExeName(100, exe_name)) && (exe_name == "app.exe") );
+
+    //Gone with the last window, a reused process ID must not get the old name
+    list.Remove(2);
+    CHECK(!list.FindExeName(100, exe_name));
+
+    list.Set(3, 100, "other.exe", "Other");
+    CHECK( (list.FindExeName(100, exe_name)) && (exe_name == "other.exe") );
+}
+
+TEST_CASE(WindowRegistryList_HandleReuse)
+{
+    TestRegistryList list;
+    std::string exe_name;
+
+    //Destroy event got lost and the handle shows up again for a different process
+    list.Set(1, 100, "app.exe", "Old");
+    list.Set(1, 200, "new.exe", "New");
+
+    CHECK(list.GetWindowCount() == 1);
+    CHECK(list.GetProcessCount() == 1);
+    CHECK(!list.FindExeName(100, exe_name));
+    CHECK( (list.FindExeName(200, exe_name)) && (exe_name == "new.exe") );
+    CHECK(GetTitles(list) == std::vector<std::string>({"New"}));
+
+    list.Remove(1);
+    CHECK(list.GetProcessCount() == 0);
+}
+
+TEST_CASE(WindowRegistryList_ZOrder)
+{
+    TestRegistryList list;
+
+    //Seeded in enumeration order, which is z-order already. New windows go to the bottom
+    list.Set(1, 100, "a.exe", "A");
+    list.Set(2, 100, "a.exe", "B");
+    list.Set(3, 200, "c.exe", "C");
+    CHECK(GetTitles(list) == std::vector<std::string>({"A", "B", "C"}));
+
+    //Updates don't change the order
+    list.Set(1, 100, "a.exe", "A2");
+    CHECK(GetTitles(list) == std::vector<std::string>({"A2", "B", "C"}));
+
+    //EVENT_SYSTEM_FOREGROUND with no listed window above it
+    list.MoveBehind(3, 0);
+    CHECK(GetTitles(list) == std::vector<std::string>({"C", "A2", "B"}));
+
+    //Placed behind the next listed window above it
+    list.MoveBehind(1, 2);
+    CHECK(GetTitles(list) == std::vector<std::string>({"C", "B", "A2"}));
+    list.MoveBehind(2, 3);
+    CHECK(GetTitles(list) == std::vector<std::string>({"C", "B", "A2"}));
+    list.MoveBehind(3, 1);
+    CHECK(GetTitles(list) == std::vector<std::string>({"B", "A2", "C"}));
+
+    //Unlisted windows and moving behind itself do nothing
+    list.MoveBehind(9, 0);
+    list.MoveBehind(2, 2);
+    CHECK(GetTitles(list) == std::vector<std::string>({"B", "A2", "C"}));
+
+    //Removal keeps the order of the rest, windows listed later go to the bottom
+    list.Remove(1);
+    list.Set(4, 300, "d.exe", "D");
+    CHECK(GetTitles(list) == std::vector<std::string>({"B", "C", "D"}));
+
+    //Handle reuse is a new window
+    list.Set(2, 400, "e.exe", "E");
+    CHECK(GetTitles(list) == std::vector<std::string>({"C", "D", "E"}));
+}
+
+TEST_CASE(WindowRegistryList_SetOrder)
+{
+    TestRegistryList list;
+
+    list.Set(1, 100, "a.exe", "A");
+    list.Set(2, 100, "a.exe", "B");
+    list.Set(3, 200, "c.exe", "C");
+
+    //Resync after EVENT_OBJECT_REORDER on the desktop. Handles not listed (not capturable) are skipped
+    list.SetOrder({9, 3, 8, 1, 2});
+    CHECK(GetTitles(list) == std::vector<std::string>({"C", "A", "B"}));
+
+    //Listed windows missing from the order (destroyed in-between) end up at the bottom
+    list.SetOrder({2, 3});
+    CHECK(GetTitles(list) == std::vector<std::string>({"B", "C", "A"}));
+
+    list.SetOrder({});
+    CHECK(GetTitles(list) == std::vector<std::string>({"B", "C", "A"}));
+}
+
+TEST_CASE(WindowRegistryList_ZOrderTieBreak)
+{
+    //FindClosestWindowForTitle() picks the first of equally good matches, which has to be the topmost window like with plain enumeration
+    //Titles are identical, so the handle is used as data to tell them apart
+    WindowRegistryList<uintptr_t, uintptr_t> list;
+    std::vector<uintptr_t> ordered;
+
+    list.Set(1, 100, "editor.exe", 1);
+    list.Set(2, 100, "editor.exe", 2);
+
+    list.GetData(ordered);
+    CHECK(ordered == std::vector<uintptr_t>({1, 2}));
+
+    //Window 2 brought to the front
+    list.MoveBehind(2, 0);
+    list.GetData(ordered);
+    CHECK(ordered == std::vector<uintptr_t>({2, 1}));
+}
+
+TEST_CASE(WindowRegistryList_Clear)
+{
+    //StopTracking() clears everything, lookups fall back to enumeration afterwards
+    TestRegistryList list;
+    std::string exe_name;
+
+    list.Set(1, 100, "app.exe", "A");
+    list.Set(2, 200, "b.exe", "B");
+    list.Clear();
+
+    CHECK(list.GetWindowCount() == 0);
+    CHECK(list.GetProcessCount() == 0);
+    CHECK(!list.FindExeName(100, exe_name));
+    CHECK(GetTitles(list).empty());
+
+    //Seeding again after restarting works as before
+    list.Set(1, 100, "app.exe", "A");
+    CHECK(GetTitles(list) == std::vector<std::string>({"A"}));
+}
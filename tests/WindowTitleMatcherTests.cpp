@@ -0,0 +1,299 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+#include "WindowTitleMatcher.h"
+
+struct TestWindow
+{
+    std::wstring Title;
+    std::string ExeName;
+};
+
+//Previous implementation of WindowInfo::FindClosestWindowForTitle(), running one full search over the list per removed word
+namespace OldMatcher
+{
+    static int FindClosestWindow(const std::vector<TestWindow>& window_list, const std::wstring& title_wstr, const std::string& exe_str)
+    {
+        auto to_id = [&](std::vector<TestWindow>::const_iterator it) { return (int)(it - window_list.begin()); };
+
+        //Look for a complete match first
+        auto it = std::find_if(window_list.begin(), window_list.end(), [&](const auto& info){ return ( (info.ExeName == exe_str) && (info.Title == title_wstr) ); });
+        if (it != window_list.end())
+        {
+            return to_id(it);
+        }
+
+        //Cut off document part of title if it there is one
+        std::wstring title_search = title_wstr;
+        std::wstring app_name;
+        size_t search_pos = title_wstr.rfind(L" - ");
+
+        if (search_pos != std::wstring::npos)
+        {
+            app_name = title_wstr.substr(search_pos);
+        }
+
+        //Try to find a partial match by removing the last word from the title string and appending the application name
+        for (;;)
+        {
+            if (search_pos == 0)
+                break;
+
+            search_pos--;
+            search_pos = title_wstr.find_last_of(L' ', search_pos);
+
+            if (search_pos != std::wstring::npos)
+            {
+                title_search = title_wstr.substr(0, search_pos) + app_name;
+            }
+            else if (!app_name.empty()) //Last attempt, just the app-name
+            {
+                title_search = app_name;
+            }
+
+            auto it = std::find_if(window_list.begin(), window_list.end(), [&](const auto& info){ return ( (info.ExeName == exe_str) && (info.Title.find(title_search) != std::wstring::npos) ); });
+
+            if (it != window_list.end())
+            {
+                return to_id(it);
+            }
+
+            if (search_pos == std::wstring::npos)
+                break;
+        }
+
+        //Nothing found, try to get a window from the same exe name at least
+        it = std::find_if(window_list.begin(), window_list.end(), [&](const auto& info){ return (info.ExeName == exe_str); });
+
+        if (it != window_list.end())
+        {
+            return to_id(it);
+        }
+
+        return -1; //We tried
+    }
+}
+
+static int FindClosestWindow(const std::vector<TestWindow>& window_list, const std::wstring& title, const std::string& exe_name)
+{
+    WindowTitleMatcher matcher;
+
+    for (const TestWindow& window : window_list)
+    {
+        matcher.AddWindow(window.Title, window.ExeName);
+    }
+
+    return matcher.FindClosestWindow(title, exe_name);
+}
+
+//Builds a random title from a small vocabulary, so titles share words a lot. Includes separators, doubled and leading/trailing spaces
+static std::wstring RandomTitle(std::mt19937& rng)
+{
+    static const wchar_t* const words[] = { L"Document", L"Untitled", L"notes.txt", L"-", L"Editor", L"Browser", L"Mozilla", L"Firefox", L"Page", L"(1)",
+                                            L"*", L"New", L"Tab", L"Docs", L"Doc", L"Settings", L"Visual", L"Studio", L"Code", L"a", L"ab", L"" };
+    const size_t word_count = sizeof(words) / sizeof(words[0]);
+    std::wstring title;
+
+    const unsigned int title_words = rng() % 8;
+    for (unsigned int i = 0; i < title_words; ++i)
+    {
+        if (i != 0)
+        {
+            title += ((rng() % 8) == 0) ? L"  " : L" ";
+        }
+
+        title += words[rng() % word_count];
+
+        if ((rng() % 6) == 0)
+        {
+            title += L" - ";
+            title += words[rng() % word_count];
+        }
+    }
+
+    if ((rng() % 10) == 0)
+    {
+        title = L" " + title;
+    }
+
+    if ((rng() % 10) == 0)
+    {
+        title += L" ";
+    }
+
+    return title;
+}
+
+static std::vector<TestWindow> RandomWindowList(std::mt19937& rng, size_t window_count)
+{
+    static const char* const exe_names[] = { "editor.exe", "browser.exe", "code.exe", "explorer.exe" };
+    std::vector<TestWindow> window_list;
+
+    for (size_t i = 0; i < window_count; ++i)
+    {
+        window_list.push_back({RandomTitle(rng), exe_names[rng() % 4]});
+    }
+
+    return window_list;
+}
+
+//Mutates a title the way apps change them: appended or removed words and a different document name
+static std::wstring MutateTitle(std::mt19937& rng, const std::wstring& title)
+{
+    std::wstring title_mutated = title;
+
+    switch (rng() % 4)
+    {
+        case 0: break;
+        case 1: title_mutated += L" (1)";                                                                               break;
+        case 2: title_mutated = L"Other " + title_mutated;                                                              break;
+        case 3: title_mutated = title_mutated.substr(0, title_mutated.find_last_of(L' ', title_mutated.size() / 2));    break;
+    }
+
+    return title_mutated;
+}
+
+TEST_CASE(WindowTitleMatcher_Corpus)
+{
+    const std::vector<TestWindow> window_list =
+    {
+        { L"notes.txt - Editor",                        "editor.exe"   },
+        { L"todo.txt - Editor",                         "editor.exe"   },
+        { L"Page Title - Mozilla Firefox",              "browser.exe"  },
+        { L"Other Page (1) - Mozilla Firefox",          "browser.exe"  },
+        { L"main.cpp - project - Visual Studio Code",   "code.exe"     },
+        { L"Settings",                                  "settings.exe" },
+        { L"notes.txt - Editor",                        "editor.exe"   },   //Duplicate title, the first one wins
+        { L"",                                          "empty.exe"    },
+    };
+
+    const struct
+    {
+        const wchar_t* Title;
+        const char* ExeName;
+        int ExpectedID;
+    }
+    corpus[] =
+    {
+        //Complete matches, exe name has to match too
+        { L"notes.txt - Editor",                        "editor.exe",   0  },
+        { L"todo.txt - Editor",                         "editor.exe",   1  },
+        { L"notes.txt - Editor",                        "browser.exe",  2  },
+        { L"",                                          "empty.exe",    7  },
+
+        //Document changed, app name after the last dash stays
+        { L"readme.md - Editor",                        "editor.exe",   0  },
+        { L"Page Title Extended - Mozilla Firefox",     "browser.exe",  2  },
+        { L"Other Page (1) Draft - Mozilla Firefox",    "browser.exe",  3  },
+        { L"Other Page (2) - Mozilla Firefox",          "browser.exe",  2  },   //Only the app name is left in common, first window of it wins
+        { L"main.cpp - other - Visual Studio Code",     "code.exe",     4  },
+
+        //No dash, words appended to the known title
+        { L"Settings Advanced Display",                 "settings.exe", 5  },
+
+        //Exe name only
+        { L"Something else",                            "editor.exe",   0  },
+        { L"Unrelated",                                 "settings.exe", 5  },
+
+        //Unknown exe
+        { L"notes.txt - Editor",                        "unknown.exe",  -1 },
+        { L"",                                          "",             -1 },
+    };
+
+    for (const auto& entry : corpus)
+    {
+        const int window_id = FindClosestWindow(window_list, entry.Title, entry.ExeName);
+
+        CHECK(window_id == entry.ExpectedID);
+        CHECK(window_id == OldMatcher::FindClosestWindow(window_list, entry.Title, entry.ExeName));
+    }
+}
+
+TEST_CASE(WindowTitleMatcher_MatchesOldImplementation)
+{
+    //Random lists and searches built from titles in the list (mutated or not) as well as unrelated ones
+    std::mt19937 rng(45);
+
+    for (int round = 0; round < 300; ++round)
+    {
+        const std::vector<TestWindow> window_list = RandomWindowList(rng, rng() % 40);
+        WindowTitleMatcher matcher;
+
+        for (const TestWindow& window : window_list)
+        {
+            matcher.AddWindow(window.Title, window.ExeName);
+        }
+
+        for (int search = 0; search < 50; ++search)
+        {
+            std::wstring title;
+            std::string exe_name;
+
+            if ( (!window_list.empty()) && ((rng() % 4) != 0) )
+            {
+                const TestWindow& window = window_list[rng() % window_list.size()];
+                title    = MutateTitle(rng, window.Title);
+                exe_name = window.ExeName;
+            }
+            else
+            {
+                title    = RandomTitle(rng);
+                exe_name = ((rng() % 2) == 0) ? "editor.exe" : "missing.exe";
+            }
+
+            const int window_id     = matcher.FindClosestWindow(title, exe_name);
+            const int window_id_old = OldMatcher::FindClosestWindow(window_list, title, exe_name);
+
+            if (window_id != window_id_old)
+            {
+                printf("    Mismatch for \"%ls\" (%s): %d, old %d\n", title.c_str(), exe_name.c_str(), window_id, window_id_old);
+                CHECK(false);
+            }
+        }
+    }
+}
+
+BENCHMARK(WindowTitleMatcher_FindClosestWindow)
+{
+    //Restoring a set of window overlays, each looking up a previously known title with a changed document part
+    std::mt19937 rng(46);
+    const std::vector<TestWindow> window_list = RandomWindowList(rng, 200);
+
+    std::vector<TestWindow> searches;
+    for (int i = 0; i < 16; ++i)
+    {
+        const TestWindow& window = window_list[rng() % window_list.size()];
+        searches.push_back({MutateTitle(rng, window.Title), window.ExeName});
+    }
+
+    char label[128];
+    snprintf(label, sizeof(label), "%zu windows, %zu lookups", window_list.size(), searches.size());
+    BenchmarkRun(label, 2000, [&](size_t)
+    {
+        WindowTitleMatcher matcher;
+
+        for (const TestWindow& window : window_list)
+        {
+            matcher.AddWindow(window.Title, window.ExeName);
+        }
+
+        int sum = 0;
+        for (const TestWindow& search : searches)
+            sum += matcher.FindClosestWindow(search.Title, search.ExeName);
+
+        BenchmarkKeep(sum);
+    });
+
+    snprintf(label, sizeof(label), "%zu windows, %zu lookups, old implementation", window_list.size(), searches.size());
+    BenchmarkRun(label, 2000, [&](size_t)
+    {
+        int sum = 0;
+        for (const TestWindow& search : searches)
+            sum += OldMatcher::FindClosestWindow(window_list, search.Title, search.ExeName);
+
+        BenchmarkKeep(sum);
+    });
+}